@@ -0,0 +1,445 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CameraPath.h"
+
+#define DEGREES 0.0174532925f
+
+void CameraStep(struct CameraState* State, uint32_t Keys, float Seconds)
+{
+	float Move[2] = { 0.0f, 0.0f };//x and z in camera space
+
+	if (Keys & CAMERA_KEY_LEFT)
+		Move[0] -= 1.0f;
+	if (Keys & CAMERA_KEY_RIGHT)
+		Move[0] += 1.0f;
+	if (Keys & CAMERA_KEY_FORWARD)
+		Move[1] -= 1.0f;
+	if (Keys & CAMERA_KEY_BACK)
+		Move[1] += 1.0f;
+
+	//diagonals go no faster than straight lines
+	if (fabsf(Move[0]) > 0.1f && fabsf(Move[1]) > 0.1f)
+	{
+		Move[0] *= 0.70710678f;
+		Move[1] *= 0.70710678f;
+	}
+
+	const float MoveInterval = CAMERA_MOVE_SPEED * Seconds;
+	const float RotateInterval = CAMERA_TURN_SPEED * Seconds;
+
+	if (Keys & CAMERA_KEY_TURN_LEFT)
+		State->Yaw += RotateInterval;
+	if (Keys & CAMERA_KEY_TURN_RIGHT)
+		State->Yaw -= RotateInterval;
+	if (Keys & CAMERA_KEY_LOOK_UP)
+		State->Pitch += RotateInterval;
+	if (Keys & CAMERA_KEY_LOOK_DOWN)
+		State->Pitch -= RotateInterval;
+
+	State->Pitch = fminf(State->Pitch, CAMERA_MAX_PITCH);
+	State->Pitch = fmaxf(-CAMERA_MAX_PITCH, State->Pitch);
+
+	//the turn made this step already counts for the move
+	State->Position[0] += (Move[0] * -cosf(State->Yaw) - Move[1] * sinf(State->Yaw)) * MoveInterval;
+	State->Position[2] += (Move[0] * sinf(State->Yaw) - Move[1] * cosf(State->Yaw)) * MoveInterval;
+}
+
+void CameraLookDirection(const struct CameraState* State, float Out[3])
+{
+	const float r = cosf(State->Pitch);
+	Out[0] = r * sinf(State->Yaw);
+	Out[1] = sinf(State->Pitch);
+	Out[2] = r * cosf(State->Yaw);
+}
+
+void CameraViewProjection(const struct CameraState* State, float FovY, float Aspect, float NearZ, float FarZ, float Out[16])
+{
+	float f[3];
+	CameraLookDirection(State, f);
+
+	//s = f x up with up = +y, normalized; u = s x f
+	float s[3] = { -f[2], 0.0f, f[0] };
+	const float Length = sqrtf(s[0] * s[0] + s[2] * s[2]);
+	s[0] /= Length;
+	s[2] /= Length;
+
+	const float u[3] = { s[1] * f[2] - s[2] * f[1], s[2] * f[0] - s[0] * f[2], s[0] * f[1] - s[1] * f[0] };
+	const float* e = State->Position;
+
+	const float View[16] =
+	{
+		s[0], u[0], -f[0], 0.0f,
+		s[1], u[1], -f[1], 0.0f,
+		s[2], u[2], -f[2], 0.0f,
+		-(s[0] * e[0] + s[1] * e[1] + s[2] * e[2]), -(u[0] * e[0] + u[1] * e[1] + u[2] * e[2]), f[0] * e[0] + f[1] * e[1] + f[2] * e[2], 1.0f
+	};
+
+	const float Focal = 1.0f / tanf(FovY * 0.5f);
+	const float Depth = 1.0f / (NearZ - FarZ);
+
+	float Proj[16] = { 0 };
+	Proj[0] = Focal / Aspect;
+	Proj[5] = Focal;
+	Proj[10] = (NearZ + FarZ) * Depth;
+	Proj[11] = -1.0f;
+	Proj[14] = 2.0f * NearZ * FarZ * Depth;
+
+	for (int c = 0; c < 4; c++)
+	{
+		for (int r = 0; r < 4; r++)
+		{
+			float Sum = 0.0f;
+			for (int k = 0; k < 4; k++)
+				Sum += Proj[k * 4 + r] * View[c * 4 + k];
+			Out[c * 4 + r] = Sum;
+		}
+	}
+}
+
+static uint32_t ParseKeys(const char* Text, bool* bOk)
+{
+	static const char LETTERS[] = "wasdlrud";
+	static const uint32_t KEYS[] =
+	{
+		CAMERA_KEY_FORWARD, CAMERA_KEY_LEFT, CAMERA_KEY_BACK, CAMERA_KEY_RIGHT,
+		CAMERA_KEY_TURN_LEFT, CAMERA_KEY_TURN_RIGHT, CAMERA_KEY_LOOK_UP, CAMERA_KEY_LOOK_DOWN
+	};
+
+	*bOk = true;
+
+	if (strcmp(Text, "-") == 0)
+		return 0;
+
+	uint32_t Keys = 0;
+
+	for (const char* c = Text; *c != '\0'; c++)
+	{
+		const char* Letter = strchr(LETTERS, *c);
+
+		if (Letter == NULL)
+		{
+			*bOk = false;
+			return 0;
+		}
+
+		Keys |= KEYS[Letter - LETTERS];
+	}
+
+	return Keys;
+}
+
+void CameraPathBeginInput(struct CameraPath* Path, const struct CameraState* State)
+{
+	memset(Path, 0, sizeof(*Path));
+	Path->Type = CAMERA_PATH_INPUT;
+	Path->Start = *State;
+}
+
+//adds FrameCount frames of Keys, merged into the last run when it holds the same keys
+static bool AddRun(struct CameraPath* Path, uint32_t FrameCount, uint32_t Keys)
+{
+	if (FrameCount == 0)
+		return true;
+
+	if (Path->RunCount != 0 && Path->Runs[Path->RunCount - 1].Keys == Keys)
+	{
+		Path->Runs[Path->RunCount - 1].FrameCount += FrameCount;
+		Path->FrameCount += FrameCount;
+		return true;
+	}
+
+	if (Path->RunCount == Path->RunCapacity)
+	{
+		const uint32_t NewCapacity = Path->RunCapacity ? Path->RunCapacity * 2 : 64;
+		struct CameraInputRun* NewRuns = realloc(Path->Runs, sizeof(struct CameraInputRun) * NewCapacity);
+
+		if (NewRuns == NULL)
+			return false;
+
+		Path->Runs = NewRuns;
+		Path->RunCapacity = NewCapacity;
+	}
+
+	struct CameraInputRun* Run = &Path->Runs[Path->RunCount++];
+	Run->FirstFrame = Path->FrameCount;
+	Run->FrameCount = FrameCount;
+	Run->Keys = Keys;
+
+	Path->FrameCount += FrameCount;
+	return true;
+}
+
+bool CameraPathAddFrame(struct CameraPath* Path, uint32_t Keys)
+{
+	return AddRun(Path, 1, Keys);
+}
+
+bool CameraPathLoad(const char* Path, struct CameraPath* Out, uint32_t* ErrorLine)
+{
+	memset(Out, 0, sizeof(*Out));
+	*ErrorLine = 0;
+
+	FILE* File = fopen(Path, "r");
+
+	if (File == NULL)
+		return false;
+
+	uint32_t KeyCapacity = 0;
+	bool bStart = false;
+	bool bOk = true;
+	char Line[512];
+
+	for (uint32_t LineNumber = 1; bOk && fgets(Line, sizeof(Line), File) != NULL; LineNumber++)
+	{
+		char Command[16];
+		int Used = 0;
+
+		if (sscanf(Line, " %15s%n", Command, &Used) != 1 || Command[0] == '#')
+			continue;
+
+		const char* Rest = Line + Used;
+		*ErrorLine = LineNumber;
+
+		if (strcmp(Command, "key") == 0 && Out->RunCount == 0 && !bStart)
+		{
+			struct CameraKey Key;
+			if (sscanf(Rest, "%f %f %f %f %f %f", &Key.Time, &Key.State.Position[0], &Key.State.Position[1], &Key.State.Position[2], &Key.State.Yaw, &Key.State.Pitch) != 6 ||
+				(Out->KeyCount != 0 && !(Key.Time > Out->Keys[Out->KeyCount - 1].Time)))
+			{
+				bOk = false;
+				break;
+			}
+
+			Key.State.Yaw *= DEGREES;
+			Key.State.Pitch *= DEGREES;
+
+			if (Out->KeyCount == KeyCapacity)
+			{
+				KeyCapacity = KeyCapacity ? KeyCapacity * 2 : 16;
+				struct CameraKey* NewKeys = realloc(Out->Keys, sizeof(struct CameraKey) * KeyCapacity);
+
+				if (NewKeys == NULL)
+				{
+					*ErrorLine = 0;
+					bOk = false;
+					break;
+				}
+
+				Out->Keys = NewKeys;
+			}
+
+			Out->Keys[Out->KeyCount++] = Key;
+		}
+		else if (strcmp(Command, "start") == 0 && Out->KeyCount == 0 && !bStart)
+		{
+			struct CameraState* Start = &Out->Start;
+			if (sscanf(Rest, "%f %f %f %f %f", &Start->Position[0], &Start->Position[1], &Start->Position[2], &Start->Yaw, &Start->Pitch) != 5)
+			{
+				bOk = false;
+				break;
+			}
+
+			Start->Yaw *= DEGREES;
+			Start->Pitch *= DEGREES;
+			bStart = true;
+		}
+		else if (strcmp(Command, "hold") == 0 && bStart)
+		{
+			unsigned int FrameCount;
+			char KeyText[16];
+			bool bKeysOk;
+
+			if (sscanf(Rest, "%u %15s", &FrameCount, KeyText) != 2)
+			{
+				bOk = false;
+				break;
+			}
+
+			const uint32_t Keys = ParseKeys(KeyText, &bKeysOk);
+
+			if (!bKeysOk)
+			{
+				bOk = false;
+				break;
+			}
+
+			if (!AddRun(Out, FrameCount, Keys))
+			{
+				*ErrorLine = 0;
+				bOk = false;
+				break;
+			}
+		}
+		else
+		{
+			bOk = false;
+		}
+	}
+
+	fclose(File);
+
+	if (bOk && Out->KeyCount == 0 && !bStart)
+	{
+		*ErrorLine = 0;
+		bOk = false;
+	}
+
+	if (!bOk)
+	{
+		CameraPathFree(Out);
+		return false;
+	}
+
+	*ErrorLine = 0;
+
+	if (Out->KeyCount != 0)
+	{
+		Out->Type = CAMERA_PATH_SPLINE;
+		Out->Start = Out->Keys[0].State;
+		Out->Duration = Out->Keys[Out->KeyCount - 1].Time;
+	}
+	else
+	{
+		Out->Type = CAMERA_PATH_INPUT;
+	}
+
+	return true;
+}
+
+bool CameraPathWrite(const char* FilePath, const struct CameraPath* Path)
+{
+	FILE* File = fopen(FilePath, "w");
+
+	if (File == NULL)
+		return false;
+
+	if (Path->Type == CAMERA_PATH_SPLINE)
+	{
+		for (uint32_t i = 0; i < Path->KeyCount; i++)
+		{
+			const struct CameraKey* Key = &Path->Keys[i];
+			fprintf(File, "key %.6g %.6g %.6g %.6g %.6g %.6g\n", Key->Time, Key->State.Position[0], Key->State.Position[1], Key->State.Position[2],
+				Key->State.Yaw / DEGREES, Key->State.Pitch / DEGREES);
+		}
+	}
+	else
+	{
+		fprintf(File, "start %.9g %.9g %.9g %.9g %.9g\n", Path->Start.Position[0], Path->Start.Position[1], Path->Start.Position[2],
+			Path->Start.Yaw / DEGREES, Path->Start.Pitch / DEGREES);
+
+		for (uint32_t i = 0; i < Path->RunCount; i++)
+		{
+			char KeyText[9];
+			uint32_t Length = 0;
+
+			for (uint32_t k = 0; k < 8; k++)
+			{
+				if (Path->Runs[i].Keys & (1u << k))
+					KeyText[Length++] = "wasdlrud"[k];
+			}
+
+			if (Length == 0)
+				KeyText[Length++] = '-';
+
+			KeyText[Length] = '\0';
+			fprintf(File, "hold %u %s\n", Path->Runs[i].FrameCount, KeyText);
+		}
+	}
+
+	const bool bOk = !ferror(File);
+	return fclose(File) == 0 && bOk;
+}
+
+void CameraPathFree(struct CameraPath* Path)
+{
+	free(Path->Keys);
+	free(Path->Runs);
+	memset(Path, 0, sizeof(*Path));
+}
+
+uint32_t CameraPathKeys(const struct CameraPath* Path, uint32_t Frame)
+{
+	if (Path->Type != CAMERA_PATH_INPUT || Frame >= Path->FrameCount)
+		return 0;
+
+	//the last run starting at or before Frame
+	uint32_t Low = 0;
+	uint32_t High = Path->RunCount;
+
+	while (High - Low > 1)
+	{
+		const uint32_t Middle = (Low + High) / 2;
+
+		if (Path->Runs[Middle].FirstFrame <= Frame)
+			Low = Middle;
+		else
+			High = Middle;
+	}
+
+	return Path->Runs[Low].Keys;
+}
+
+static float CatmullRom(float p0, float p1, float p2, float p3, float t)
+{
+	return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t * t + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t * t * t);
+}
+
+void CameraPathAdvance(const struct CameraPath* Path, uint32_t Frame, float TimeStep, struct CameraState* State)
+{
+	if (Path->Type == CAMERA_PATH_INPUT)
+	{
+		CameraStep(State, CameraPathKeys(Path, Frame), TimeStep);
+		return;
+	}
+
+	const float Time = (float)((double)Frame * TimeStep);
+
+	if (Path->KeyCount == 1 || Time <= Path->Keys[0].Time)
+	{
+		*State = Path->Keys[0].State;
+		return;
+	}
+
+	if (Time >= Path->Duration)
+	{
+		*State = Path->Keys[Path->KeyCount - 1].State;
+		return;
+	}
+
+	//the segment Time falls in, and its neighbours with the end keys repeated
+	uint32_t i = 0;
+	while (Path->Keys[i + 1].Time <= Time)
+		i++;
+
+	const struct CameraState* k0 = &Path->Keys[i > 0 ? i - 1 : 0].State;
+	const struct CameraState* k1 = &Path->Keys[i].State;
+	const struct CameraState* k2 = &Path->Keys[i + 1].State;
+	const struct CameraState* k3 = &Path->Keys[i + 2 < Path->KeyCount ? i + 2 : i + 1].State;
+
+	const float t = (Time - Path->Keys[i].Time) / (Path->Keys[i + 1].Time - Path->Keys[i].Time);
+
+	for (int c = 0; c < 3; c++)
+		State->Position[c] = CatmullRom(k0->Position[c], k1->Position[c], k2->Position[c], k3->Position[c], t);
+
+	State->Yaw = CatmullRom(k0->Yaw, k1->Yaw, k2->Yaw, k3->Yaw, t);
+	State->Pitch = CatmullRom(k0->Pitch, k1->Pitch, k2->Pitch, k3->Pitch, t);
+}
@@ -0,0 +1,120 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//the fly camera the renderer is driven with, and scripted paths for it. CameraStep is the one place camera motion
+//is worked out, so a path of recorded input replays the same way it was flown.
+//
+//a path is a text file, one command per line; blank lines and lines starting with # are skipped. angles are in
+//degrees, yaw from the +z axis and pitch from the xz plane:
+//
+//  key <seconds> <x> <y> <z> <yaw> <pitch>     a point of a catmull-rom spline through the keys, in time order
+//  start <x> <y> <z> <yaw> <pitch>             where recorded input starts from
+//  hold <frames> <keys>                        the keys held for that many frames: any of wasd to move, lrud to
+//                                              turn and look, - for none
+//
+//a path is either keys or start and holds, not both
+
+#define CAMERA_KEY_FORWARD (1u << 0)
+#define CAMERA_KEY_LEFT (1u << 1)
+#define CAMERA_KEY_BACK (1u << 2)
+#define CAMERA_KEY_RIGHT (1u << 3)
+#define CAMERA_KEY_TURN_LEFT (1u << 4)
+#define CAMERA_KEY_TURN_RIGHT (1u << 5)
+#define CAMERA_KEY_LOOK_UP (1u << 6)
+#define CAMERA_KEY_LOOK_DOWN (1u << 7)
+
+#define CAMERA_MOVE_SPEED 150.0f//units a second
+#define CAMERA_TURN_SPEED 1.57079633f//radians a second
+#define CAMERA_MAX_PITCH 0.785398163f
+
+struct CameraState
+{
+	float Position[3];
+	float Yaw;
+	float Pitch;
+};
+
+struct CameraKey
+{
+	float Time;
+	struct CameraState State;
+};
+
+struct CameraInputRun
+{
+	uint32_t FirstFrame;
+	uint32_t FrameCount;
+	uint32_t Keys;//CAMERA_KEY_
+};
+
+enum CameraPathType
+{
+	CAMERA_PATH_SPLINE,
+	CAMERA_PATH_INPUT,
+};
+
+struct CameraPath
+{
+	enum CameraPathType Type;
+
+	struct CameraKey* Keys;
+	uint32_t KeyCount;
+
+	struct CameraState Start;
+	struct CameraInputRun* Runs;
+	uint32_t RunCount;
+	uint32_t RunCapacity;
+
+	uint32_t FrameCount;//what the input covers, 0 for splines
+	float Duration;//of the spline, 0 for input
+};
+
+//moves and turns the camera by Seconds of the keys being held, then clamps the pitch
+void CameraStep(struct CameraState* State, uint32_t Keys, float Seconds);
+
+void CameraLookDirection(const struct CameraState* State, float Out[3]);
+
+//column-major (cglm's layout) right handed view and [-1,1] depth projection, the same as glm_look_rh and
+//glm_perspective give
+void CameraViewProjection(const struct CameraState* State, float FovY, float Aspect, float NearZ, float FarZ, float Out[16]);
+
+//false if the file can't be read or has a bad line; ErrorLine gets its number, 0 when it is the file itself or
+//memory ran out
+bool CameraPathLoad(const char* Path, struct CameraPath* Out, uint32_t* ErrorLine);
+
+//starts an empty input path from State, for recording
+void CameraPathBeginInput(struct CameraPath* Path, const struct CameraState* State);
+
+//adds one frame of held keys to an input path. false if memory runs out
+bool CameraPathAddFrame(struct CameraPath* Path, uint32_t Keys);
+
+//writes the path in the format CameraPathLoad reads. false if the file can't be written
+bool CameraPathWrite(const char* FilePath, const struct CameraPath* Path);
+
+void CameraPathFree(struct CameraPath* Path);
+
+//where frame Frame of a run at TimeStep seconds a frame puts the camera. spline points are worked out from the
+//frame's time alone and hold at the ends; input applies the frame's keys to State, which must be the previous frame's
+//(the path's Start before frame 0)
+void CameraPathAdvance(const struct CameraPath* Path, uint32_t Frame, float TimeStep, struct CameraState* State);
+
+//the keys input holds on Frame, 0 past the end and for splines
+uint32_t CameraPathKeys(const struct CameraPath* Path, uint32_t Frame);
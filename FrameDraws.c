@@ -0,0 +1,292 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <string.h>
+
+#include "MeshletDag.h"
+#include "FrameDraws.h"
+
+//draws covering a grid of Meshlets times Instances, each as big as DispatchMesh takes
+static uint32_t DrawsForGrid(uint32_t Meshlets, uint32_t Instances)
+{
+	uint32_t DrawCount = 0;
+
+	for (uint32_t m = 0; m < Meshlets; m += FRAME_DRAW_MAX_GROUPS_PER_AXIS)
+	{
+		const uint32_t Width = Meshlets - m < FRAME_DRAW_MAX_GROUPS_PER_AXIS ? Meshlets - m : FRAME_DRAW_MAX_GROUPS_PER_AXIS;
+		const uint32_t Batch = FRAME_DRAW_MAX_GROUPS / Width < FRAME_DRAW_MAX_GROUPS_PER_AXIS ? FRAME_DRAW_MAX_GROUPS / Width : FRAME_DRAW_MAX_GROUPS_PER_AXIS;
+
+		DrawCount += (Instances + Batch - 1) / Batch;
+	}
+
+	return DrawCount;
+}
+
+static void EmitDraws(uint32_t Mesh, uint32_t Subset, uint32_t VisibleOffset, uint32_t VisibleCount, uint32_t InstanceOffset, uint32_t InstanceCount, struct FrameDraw* Draws, uint32_t* DrawCount)
+{
+	for (uint32_t m = 0; m < VisibleCount; m += FRAME_DRAW_MAX_GROUPS_PER_AXIS)
+	{
+		const uint32_t Width = VisibleCount - m < FRAME_DRAW_MAX_GROUPS_PER_AXIS ? VisibleCount - m : FRAME_DRAW_MAX_GROUPS_PER_AXIS;
+		const uint32_t Batch = FRAME_DRAW_MAX_GROUPS / Width < FRAME_DRAW_MAX_GROUPS_PER_AXIS ? FRAME_DRAW_MAX_GROUPS / Width : FRAME_DRAW_MAX_GROUPS_PER_AXIS;
+
+		for (uint32_t k = 0; k < InstanceCount; k += Batch)
+		{
+			struct FrameDraw* Draw = &Draws[(*DrawCount)++];
+			Draw->Mesh = Mesh;
+			Draw->Subset = Subset;
+			Draw->VisibleOffset = VisibleOffset + m;
+			Draw->VisibleCount = Width;
+			Draw->InstanceOffset = InstanceOffset + k;
+			Draw->InstanceCount = InstanceCount - k < Batch ? InstanceCount - k : Batch;
+		}
+	}
+}
+
+uint32_t FrameDrawCapacity(const struct MeshScene* Scene, const struct SceneInstances* Instances)
+{
+	uint32_t Capacity = 0;
+
+	//every level is counted although only one is drawn without instances, and with them a level never has more
+	//than all of its chain's instances
+	for (uint32_t c = 0; c < Scene->LodChainCount; c++)
+	{
+		const struct MeshLodChain* Chain = &Scene->LodChains[c];
+		const uint32_t InstanceCount = Instances != NULL ? Instances->ChainOffsets[c + 1] - Instances->ChainOffsets[c] : 1;
+
+		for (uint32_t l = 0; l < Chain->LevelCount; l++)
+		{
+			const struct Mesh* Mesh = &Scene->MeshList[Chain->Meshes[l]];
+
+			for (uint32_t j = 0; j < Mesh->MeshletSubsetCount; j++)
+				Capacity += DrawsForGrid(Mesh->MeshletSubsets[j].Count, InstanceCount);
+		}
+	}
+
+	return Capacity;
+}
+
+size_t FrameDrawScratchSize(const struct MeshScene* Scene, const struct SceneInstances* Instances)
+{
+	//culled instances' bounds, then their indices, then their levels
+	if (Instances != NULL)
+		return (sizeof(struct BoundingSphere) + sizeof(uint32_t) + sizeof(uint8_t)) * (size_t)Instances->Count;
+
+	//without them a dag cut, which is never more than its subset's level 0 meshlets
+	uint32_t CutCapacity = 0;
+
+	for (uint32_t i = 0; i < Scene->MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &Scene->MeshList[i];
+
+		for (uint32_t j = 0; Mesh->ClusterLodCount != 0 && j < Mesh->MeshletSubsetCount; j++)
+			CutCapacity = Mesh->MeshletSubsets[j].Count > CutCapacity ? Mesh->MeshletSubsets[j].Count : CutCapacity;
+	}
+
+	return sizeof(uint32_t) * (size_t)CutCapacity;
+}
+
+static void BuildChainDraws(const struct FrameDrawDesc* Desc, const struct MeshLodChain* Chain, uint32_t* Visible, struct FrameDraw* Draws, struct FrameDrawStats* Counts, bool bTriangles)
+{
+	const struct MeshScene* Scene = Desc->Scene;
+
+	//only the coarsest level that still looks right is drawn for each chain
+	const uint32_t i = Chain->Meshes[SelectLod(Desc->View, Chain, &Chain->Bounds)];
+	const struct Mesh* Mesh = &Scene->MeshList[i];
+
+	if (Desc->Resident != NULL && !Desc->Resident(Desc->Context, i))
+	{
+		Counts->MeshesSkipped++;
+		return;
+	}
+
+	Counts->MeshesDrawn++;
+	uint32_t VisibleOffset = Scene->MeshletOffsets[i];
+
+	for (uint32_t j = 0; j < Mesh->MeshletSubsetCount; j++)
+	{
+		const struct Subset* MeshletSubset = &Mesh->MeshletSubsets[j];
+		uint32_t* Out = Visible + VisibleOffset;
+		uint32_t VisibleCount;
+
+		if (Mesh->ClusterLodCount != 0)
+		{
+			//meshes with a cluster dag pick their detail per meshlet, then cull what the cut left. the cut goes to
+			//Scratch so only the survivors are written to Visible
+			uint32_t* Cut = Desc->Scratch;
+			const uint32_t CutCount = CutMeshletDag(Desc->View, Mesh, j, Cut);
+			Counts->MeshletsTested += CutCount;
+			VisibleCount = 0;
+
+			for (uint32_t k = 0; k < CutCount; k++)
+			{
+				if (!Desc->bCullMeshlets || CullMeshletVisible(Desc->Frustum, &Mesh->CullingData[Cut[k]]))
+					Out[VisibleCount++] = Cut[k];
+			}
+		}
+		else if (Desc->bCullMeshlets)
+		{
+			Counts->MeshletsTested += MeshletSubset->Count;
+			VisibleCount = CullMeshlets(Desc->Frustum, Mesh->CullingData, MeshletSubset->Offset, MeshletSubset->Count, Desc->Kernel, Out);
+		}
+		else
+		{
+			Counts->MeshletsTested += MeshletSubset->Count;
+
+			for (uint32_t k = 0; k < MeshletSubset->Count; k++)
+				Out[k] = MeshletSubset->Offset + k;
+			VisibleCount = MeshletSubset->Count;
+		}
+
+		if (VisibleCount == 0)
+			continue;
+
+		//Visible may be write combined upload memory, only read it back when asked to
+		if (bTriangles)
+		{
+			for (uint32_t k = 0; k < VisibleCount; k++)
+				Counts->TrianglesSubmitted += Mesh->Meshlets[Out[k]].PrimCount;
+		}
+
+		EmitDraws(i, j, VisibleOffset, VisibleCount, 0, 1, Draws, &Counts->DrawCount);
+
+		Counts->MeshletsDispatched += VisibleCount;
+		VisibleOffset += VisibleCount;
+	}
+}
+
+//writes the chain's visible instances to VisibleInstances from InstanceOffset on and returns how many there were
+static uint32_t BuildInstancedChainDraws(const struct FrameDrawDesc* Desc, uint32_t c, uint32_t* Visible, uint32_t* VisibleInstances, uint32_t InstanceOffset, struct FrameDraw* Draws, struct FrameDrawStats* Counts, bool bTriangles)
+{
+	const struct MeshScene* Scene = Desc->Scene;
+	const struct SceneInstances* Instances = Desc->Instances;
+	const struct MeshLodChain* Chain = &Scene->LodChains[c];
+
+	const uint32_t First = Instances->ChainOffsets[c];
+	const uint32_t Count = Instances->ChainOffsets[c + 1] - First;
+
+	struct BoundingSphere* Bounds = Desc->Scratch;
+	uint32_t* Culled = (uint32_t*)(Bounds + Instances->Count);
+	uint8_t* Levels = (uint8_t*)(Culled + Instances->Count);
+
+	Counts->InstancesTested += Count;
+
+	uint32_t VisibleCount;
+
+	if (Desc->bCullInstances)
+	{
+		VisibleCount = CullInstances(Desc->Frustum, Instances->Bounds, First, Count, Desc->Kernel, Culled);
+	}
+	else
+	{
+		for (uint32_t k = 0; k < Count; k++)
+			Culled[k] = First + k;
+		VisibleCount = Count;
+	}
+
+	Counts->InstancesVisible += VisibleCount;
+
+	if (VisibleCount == 0)
+		return 0;
+
+	//each visible instance gets its own level, from its own sphere
+	for (uint32_t k = 0; k < VisibleCount; k++)
+		Bounds[k] = Instances->Bounds[Culled[k]];
+
+	SelectLods(Desc->View, Chain, Bounds, VisibleCount, Desc->Kernel, Levels);
+
+	//grouped by level, each group still in ascending order
+	uint32_t LevelStarts[MESH_LOD_MAX_LEVELS + 1] = { 0 };
+
+	for (uint32_t k = 0; k < VisibleCount; k++)
+		LevelStarts[Levels[k] + 1]++;
+
+	for (uint32_t l = 0; l < MESH_LOD_MAX_LEVELS; l++)
+		LevelStarts[l + 1] += LevelStarts[l];
+
+	uint32_t Cursors[MESH_LOD_MAX_LEVELS];
+	memcpy(Cursors, LevelStarts, sizeof(Cursors));
+
+	for (uint32_t k = 0; k < VisibleCount; k++)
+		VisibleInstances[InstanceOffset + Cursors[Levels[k]]++] = Culled[k];
+
+	for (uint32_t l = 0; l < Chain->LevelCount; l++)
+	{
+		const uint32_t InstanceCount = LevelStarts[l + 1] - LevelStarts[l];
+
+		if (InstanceCount == 0)
+			continue;
+
+		const uint32_t i = Chain->Meshes[l];
+		const struct Mesh* Mesh = &Scene->MeshList[i];
+
+		if (Desc->Resident != NULL && !Desc->Resident(Desc->Context, i))
+		{
+			Counts->MeshesSkipped++;
+			continue;
+		}
+
+		Counts->MeshesDrawn++;
+		uint32_t VisibleOffset = Scene->MeshletOffsets[i];
+
+		for (uint32_t j = 0; j < Mesh->MeshletSubsetCount; j++)
+		{
+			const struct Subset* MeshletSubset = &Mesh->MeshletSubsets[j];
+
+			if (MeshletSubset->Count == 0)
+				continue;
+
+			for (uint32_t k = 0; k < MeshletSubset->Count; k++)
+				Visible[VisibleOffset + k] = MeshletSubset->Offset + k;
+
+			if (bTriangles)
+			{
+				uint64_t Triangles = 0;
+				for (uint32_t k = 0; k < MeshletSubset->Count; k++)
+					Triangles += Mesh->Meshlets[MeshletSubset->Offset + k].PrimCount;
+
+				Counts->TrianglesSubmitted += Triangles * InstanceCount;
+			}
+
+			EmitDraws(i, j, VisibleOffset, MeshletSubset->Count, InstanceOffset + LevelStarts[l], InstanceCount, Draws, &Counts->DrawCount);
+
+			Counts->MeshletsDispatched += (uint64_t)MeshletSubset->Count * InstanceCount;
+			VisibleOffset += MeshletSubset->Count;
+		}
+	}
+
+	return VisibleCount;
+}
+
+uint32_t BuildFrameDraws(const struct FrameDrawDesc* Desc, uint32_t* Visible, uint32_t* VisibleInstances, struct FrameDraw* Draws, struct FrameDrawStats* Stats)
+{
+	struct FrameDrawStats Counts;
+	memset(&Counts, 0, sizeof(Counts));
+
+	uint32_t InstanceOffset = 0;
+
+	for (uint32_t c = 0; c < Desc->Scene->LodChainCount; c++)
+	{
+		if (Desc->Instances != NULL)
+			InstanceOffset += BuildInstancedChainDraws(Desc, c, Visible, VisibleInstances, InstanceOffset, Draws, &Counts, Stats != NULL);
+		else
+			BuildChainDraws(Desc, &Desc->Scene->LodChains[c], Visible, Draws, &Counts, Stats != NULL);
+	}
+
+	if (Stats != NULL)
+		*Stats = Counts;
+
+	return Counts.DrawCount;
+}
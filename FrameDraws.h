@@ -0,0 +1,98 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "Platform.h"
+#include "MeshScene.h"
+#include "MeshLod.h"
+#include "MeshletCull.h"
+#include "MeshInstances.h"
+
+//the cpu side of a frame: picks each lod chain's level, cuts cluster dags, culls meshlets and lists the mesh shader
+//dispatches to make, with nothing of d3d12 in it, so the renderer records its command list from the list and
+//MeshTool bench runs the same work without a window or a gpu.
+//
+//every mesh owns a region of the frame's visible meshlet list at its MeshletOffsets entry, as the renderer's visible
+//meshlet buffer is laid out; a draw is one dispatch over a run of that region.
+//
+//with instances every chain is drawn at each of its instances instead: the instances are culled, each visible one
+//gets its own level, and each level is one draw of all its level 0 meshlets (cluster dags are cut per view, not per
+//instance) over a run of the frame's visible instance list. such a draw is a grid of meshlets times instances,
+//split to fit DispatchMesh's limits
+
+//DispatchMesh takes at most this many thread groups along an axis, and FRAME_DRAW_MAX_GROUPS in all
+#define FRAME_DRAW_MAX_GROUPS_PER_AXIS 65535u
+#define FRAME_DRAW_MAX_GROUPS (1u << 22)
+
+struct FrameDraw
+{
+	uint32_t Mesh;
+	uint32_t Subset;//meshlet subset of the mesh
+	uint32_t VisibleOffset;//first entry of the visible list the dispatch reads
+	uint32_t VisibleCount;//thread groups along x, one per meshlet
+	uint32_t InstanceOffset;//first entry of the visible instance list, 0 without instances
+	uint32_t InstanceCount;//thread groups along y, one per instance; 1 without instances
+};
+
+struct FrameDrawStats
+{
+	uint32_t MeshesDrawn;
+	uint32_t MeshesSkipped;//not resident
+	uint32_t DrawCount;
+	uint32_t MeshletsTested;//after dag cuts, before culling; instanced meshlets aren't tested
+	uint32_t InstancesTested;
+	uint32_t InstancesVisible;
+	uint64_t MeshletsDispatched;//meshlets times instances
+	uint64_t TrianglesSubmitted;
+};
+
+struct FrameDrawDesc
+{
+	const struct MeshScene* Scene;
+	const struct LodView* View;
+	const struct CullFrustum* Frustum;
+	bool bCullMeshlets;//false when MeshletAS.hlsl culls them on the gpu
+	bool bCullInstances;
+	enum SimdLevel Kernel;
+
+	//NULL when every mesh is
+	bool (*Resident)(const void* Context, uint32_t Mesh);
+	const void* Context;
+
+	//NULL to draw every chain once where it is. with instances Frustum and View are in world space
+	const struct SceneInstances* Instances;
+
+	//FrameDrawScratchSize bytes of cpu memory for the frame to use
+	void* Scratch;
+};
+
+//the most draws a frame can have: every meshlet subset of every mesh, split to fit the dispatch limits, and for
+//instances as many times as all the chain's instances need. Instances may be NULL
+uint32_t FrameDrawCapacity(const struct MeshScene* Scene, const struct SceneInstances* Instances);
+
+//Instances may be NULL
+size_t FrameDrawScratchSize(const struct MeshScene* Scene, const struct SceneInstances* Instances);
+
+//writes the frame's visible meshlets to Visible (Scene->MeshletCount entries), its visible instances to
+//VisibleInstances (Instances->Count entries, NULL without instances) and its draws to Draws (FrameDrawCapacity
+//entries), in lod chain order. returns the draw count. Stats may be NULL, and counting triangles without instances
+//reads Visible back, so leave it NULL when Visible is upload memory
+uint32_t BuildFrameDraws(const struct FrameDrawDesc* Desc, uint32_t* Visible, uint32_t* VisibleInstances, struct FrameDraw* Draws, struct FrameDrawStats* Stats);
@@ -0,0 +1,89 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <string.h>
+#include <assert.h>
+
+#include "FramePacer.h"
+
+bool FramePacerInit(struct FramePacer* Pacer, const struct FrameFence* Fence, uint32_t SlotCount, uint32_t MaxFramesInFlight)
+{
+	memset(Pacer, 0, sizeof(*Pacer));
+
+	if (SlotCount == 0 || SlotCount > FRAME_PACER_MAX_SLOTS || MaxFramesInFlight > SlotCount)
+		return false;
+
+	Pacer->Fence = *Fence;
+	Pacer->SlotCount = SlotCount;
+	Pacer->MaxFramesInFlight = MaxFramesInFlight == 0 ? SlotCount : MaxFramesInFlight;
+	return true;
+}
+
+//waits for Value unless it has already completed. true if it had to wait
+static bool WaitFor(struct FramePacer* Pacer, uint64_t Value)
+{
+	if (Value <= Pacer->CompletedValue)
+		return false;
+
+	Pacer->CompletedValue = Pacer->Fence.CompletedValue(Pacer->Fence.Context);
+
+	if (Value <= Pacer->CompletedValue)
+		return false;
+
+	Pacer->Fence.Wait(Pacer->Fence.Context, Value);
+	Pacer->CompletedValue = Value;
+	return true;
+}
+
+uint64_t FramePacerBeginFrame(struct FramePacer* Pacer, uint32_t Slot)
+{
+	assert(!Pacer->bInFrame && Slot < Pacer->SlotCount);
+
+	//the frame about to be signalled is FenceValue + 1; for it to be one of MaxFramesInFlight, every frame up to
+	//FenceValue + 1 - MaxFramesInFlight has to be done
+	uint64_t Value = Pacer->SlotFenceValues[Slot];
+
+	if (Pacer->FenceValue + 1 > Pacer->MaxFramesInFlight && Pacer->FenceValue + 1 - Pacer->MaxFramesInFlight > Value)
+		Value = Pacer->FenceValue + 1 - Pacer->MaxFramesInFlight;
+
+	if (WaitFor(Pacer, Value))
+		Pacer->WaitCount++;
+
+	Pacer->Slot = Slot;
+	Pacer->bInFrame = true;
+	return Pacer->FenceValue + 1;
+}
+
+void FramePacerEndFrame(struct FramePacer* Pacer)
+{
+	assert(Pacer->bInFrame);
+
+	Pacer->Fence.Signal(Pacer->Fence.Context, ++Pacer->FenceValue);
+	Pacer->SlotFenceValues[Pacer->Slot] = Pacer->FenceValue;
+	Pacer->bInFrame = false;
+	Pacer->FrameCount++;
+}
+
+uint32_t FramePacerFramesInFlight(struct FramePacer* Pacer)
+{
+	Pacer->CompletedValue = Pacer->Fence.CompletedValue(Pacer->Fence.Context);
+	return (uint32_t)(Pacer->FenceValue - Pacer->CompletedValue);
+}
+
+void FramePacerFlush(struct FramePacer* Pacer)
+{
+	WaitFor(Pacer, Pacer->FenceValue);
+}
@@ -0,0 +1,76 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//keeps up to MaxFramesInFlight frames queued on the gpu. each frame records into one of SlotCount sets of per frame
+//resources (command allocator, constant buffer slot ..), picked by the caller, usually the swap chain's back buffer
+//index. FramePacerBeginFrame waits only for what stops the frame from starting: the last frame that used the same
+//slot, and the oldest frame when MaxFramesInFlight are already queued. FramePacerEndFrame signals the next value of
+//one fence that counts frames, so a frame's fence value is its frame number.
+//
+//the fence is a set of callbacks, so the same pacer drives a d3d12 fence or a simulated one
+
+#define FRAME_PACER_MAX_SLOTS 8
+
+struct FrameFence
+{
+	void* Context;
+
+	//queues a signal of Value behind the work submitted so far
+	void (*Signal)(void* Context, uint64_t Value);
+
+	uint64_t (*CompletedValue)(void* Context);
+
+	//blocks until Value has completed
+	void (*Wait)(void* Context, uint64_t Value);
+};
+
+struct FramePacer
+{
+	struct FrameFence Fence;
+	uint32_t SlotCount;
+	uint32_t MaxFramesInFlight;
+
+	uint64_t SlotFenceValues[FRAME_PACER_MAX_SLOTS];//the last frame each slot was used for
+	uint64_t FenceValue;//last one signalled
+	uint64_t CompletedValue;//as of the last time it was read
+	uint32_t Slot;//the frame being recorded, between Begin and End
+	bool bInFrame;
+
+	uint64_t FrameCount;
+	uint64_t WaitCount;//frames that had to wait to begin
+};
+
+//SlotCount is at most FRAME_PACER_MAX_SLOTS. MaxFramesInFlight 0 = SlotCount, and is never more than SlotCount
+//since a slot can't be reused before its frame has completed. false if the counts are out of range
+bool FramePacerInit(struct FramePacer* Pacer, const struct FrameFence* Fence, uint32_t SlotCount, uint32_t MaxFramesInFlight);
+
+//waits until Slot's resources are free and fewer than MaxFramesInFlight frames are queued, and returns the frame's
+//fence value
+uint64_t FramePacerBeginFrame(struct FramePacer* Pacer, uint32_t Slot);
+
+//signals the frame's fence value; call after the frame's work is submitted
+void FramePacerEndFrame(struct FramePacer* Pacer);
+
+//frames signalled that haven't completed
+uint32_t FramePacerFramesInFlight(struct FramePacer* Pacer);
+
+//waits for every frame signalled so far, for resizes and shutdown
+void FramePacerFlush(struct FramePacer* Pacer);
@@ -0,0 +1,215 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Platform.h"
+#include "FrameTelemetry.h"
+
+static const char* PHASE_NAMES[FRAME_PHASE_COUNT] = { "frame", "wait", "update", "record", "submit", "present", "gpu" };
+
+const char* FramePhaseName(enum FramePhase Phase)
+{
+	return Phase < FRAME_PHASE_COUNT ? PHASE_NAMES[Phase] : "unknown";
+}
+
+bool FrameTelemetryInit(struct FrameTelemetry* Telemetry, uint32_t Capacity)
+{
+	memset(Telemetry, 0, sizeof(*Telemetry));
+
+	Telemetry->Capacity = 1;
+	while (Telemetry->Capacity < Capacity && Telemetry->Capacity < 0x80000000u)
+		Telemetry->Capacity *= 2;
+
+	Telemetry->Samples = malloc(sizeof(struct FrameSample) * Telemetry->Capacity);
+	return Telemetry->Samples != NULL;
+}
+
+void FrameTelemetryFree(struct FrameTelemetry* Telemetry)
+{
+	free(Telemetry->Samples);
+	memset(Telemetry, 0, sizeof(*Telemetry));
+}
+
+//bin 0 holds everything under 1 us, bin b the values up to 2^(b / FRAME_HISTOGRAM_BINS_PER_OCTAVE) us
+static uint32_t BinOf(float Milliseconds)
+{
+	const double Microseconds = Milliseconds * 1000.0;
+
+	if (!(Microseconds > 1.0))
+		return 0;
+
+	const double Bin = ceil(log2(Microseconds) * FRAME_HISTOGRAM_BINS_PER_OCTAVE);
+	return Bin < FRAME_HISTOGRAM_BINS - 1 ? (uint32_t)Bin : FRAME_HISTOGRAM_BINS - 1;
+}
+
+void FrameHistogramAdd(struct FrameHistogram* Histogram, float Milliseconds)
+{
+	Histogram->Bins[BinOf(Milliseconds)]++;
+	Histogram->Count++;
+	Histogram->Sum += Milliseconds;
+
+	if (Milliseconds > Histogram->Max)
+		Histogram->Max = Milliseconds;
+}
+
+float FrameHistogramPercentile(const struct FrameHistogram* Histogram, double Percentile)
+{
+	if (Histogram->Count == 0)
+		return 0.0f;
+
+	//the smallest value with at least Percentile of the samples at or below it
+	uint64_t Rank = (uint64_t)ceil(Percentile / 100.0 * Histogram->Count);
+	if (Rank < 1)
+		Rank = 1;
+	if (Rank > Histogram->Count)
+		Rank = Histogram->Count;
+
+	uint64_t Seen = 0;
+	uint32_t Bin = 0;
+
+	for (; Bin < FRAME_HISTOGRAM_BINS - 1; Bin++)
+	{
+		Seen += Histogram->Bins[Bin];
+
+		if (Seen >= Rank)
+			break;
+	}
+
+	const float Top = (float)(exp2((double)Bin / FRAME_HISTOGRAM_BINS_PER_OCTAVE) / 1000.0);
+	return Top < Histogram->Max ? Top : Histogram->Max;
+}
+
+bool FrameTelemetryPush(struct FrameTelemetry* Telemetry, const struct FrameSample* Sample)
+{
+	for (uint32_t p = 0; p < FRAME_PHASE_COUNT; p++)
+	{
+		if (Sample->Milliseconds[p] < 0.0f)
+			continue;
+
+		FrameHistogramAdd(&Telemetry->Totals[p], Sample->Milliseconds[p]);
+		FrameHistogramAdd(&Telemetry->Recent[p], Sample->Milliseconds[p]);
+	}
+
+	//the consumer only ever moves Tail forward, so a stale read can only make the ring look fuller than it is
+	const uint32_t Head = Telemetry->Head;
+
+	if (Head - PlatformAtomicLoadAcquire(&Telemetry->Tail) >= Telemetry->Capacity)
+	{
+		Telemetry->Dropped++;
+		return false;
+	}
+
+	Telemetry->Samples[Head & (Telemetry->Capacity - 1)] = *Sample;
+	PlatformAtomicStoreRelease(&Telemetry->Head, Head + 1);
+	return true;
+}
+
+void FrameTelemetryResetRecent(struct FrameTelemetry* Telemetry)
+{
+	memset(Telemetry->Recent, 0, sizeof(Telemetry->Recent));
+}
+
+static void WriteSample(FILE* Out, enum TelemetryFormat Format, const struct FrameSample* Sample)
+{
+	if (Format == TELEMETRY_FORMAT_CSV)
+	{
+		fprintf(Out, "%llu,%.6f", (unsigned long long)Sample->Frame, Sample->Time);
+
+		for (uint32_t p = 0; p < FRAME_PHASE_COUNT; p++)
+		{
+			if (Sample->Milliseconds[p] < 0.0f)
+				fputs(",", Out);
+			else
+				fprintf(Out, ",%.4f", Sample->Milliseconds[p]);
+		}
+
+		fputs("\n", Out);
+		return;
+	}
+
+	fprintf(Out, "{\"frame\":%llu,\"time\":%.6f", (unsigned long long)Sample->Frame, Sample->Time);
+
+	for (uint32_t p = 0; p < FRAME_PHASE_COUNT; p++)
+	{
+		if (Sample->Milliseconds[p] < 0.0f)
+			fprintf(Out, ",\"%s_ms\":null", PHASE_NAMES[p]);
+		else
+			fprintf(Out, ",\"%s_ms\":%.4f", PHASE_NAMES[p], Sample->Milliseconds[p]);
+	}
+
+	fputs("}\n", Out);
+}
+
+uint32_t FrameTelemetryDrain(struct FrameTelemetry* Telemetry, FILE* Out, enum TelemetryFormat Format)
+{
+	const uint32_t Tail = Telemetry->Tail;
+	const uint32_t Head = PlatformAtomicLoadAcquire(&Telemetry->Head);
+
+	if (Out != NULL)
+	{
+		for (uint32_t i = Tail; i != Head; i++)
+			WriteSample(Out, Format, &Telemetry->Samples[i & (Telemetry->Capacity - 1)]);
+	}
+
+	//the slots are the producer's again only once they have been written out
+	PlatformAtomicStoreRelease(&Telemetry->Tail, Head);
+	return Head - Tail;
+}
+
+void FrameTelemetryWriteHeader(FILE* Out, enum TelemetryFormat Format)
+{
+	if (Format != TELEMETRY_FORMAT_CSV)
+		return;
+
+	fputs("frame,time", Out);
+
+	for (uint32_t p = 0; p < FRAME_PHASE_COUNT; p++)
+		fprintf(Out, ",%s_ms", PHASE_NAMES[p]);
+
+	fputs("\n", Out);
+}
+
+void FrameTelemetryWriteSummary(const struct FrameTelemetry* Telemetry, FILE* Out, enum TelemetryFormat Format)
+{
+	if (Format == TELEMETRY_FORMAT_CSV)
+		fputs("phase,count,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n", Out);
+	else
+		fprintf(Out, "{\n  \"frames\": %llu,\n  \"dropped\": %llu,\n  \"phases\": {\n", (unsigned long long)Telemetry->Totals[FRAME_PHASE_FRAME].Count, (unsigned long long)Telemetry->Dropped);
+
+	for (uint32_t p = 0; p < FRAME_PHASE_COUNT; p++)
+	{
+		const struct FrameHistogram* Histogram = &Telemetry->Totals[p];
+		const double Mean = Histogram->Count ? Histogram->Sum / Histogram->Count : 0.0;
+
+		if (Format == TELEMETRY_FORMAT_CSV)
+		{
+			fprintf(Out, "%s,%llu,%.4f,%.4f,%.4f,%.4f,%.4f\n", PHASE_NAMES[p], (unsigned long long)Histogram->Count, Mean,
+				FrameHistogramPercentile(Histogram, 50.0), FrameHistogramPercentile(Histogram, 95.0), FrameHistogramPercentile(Histogram, 99.0), Histogram->Max);
+		}
+		else
+		{
+			fprintf(Out, "    \"%s\": { \"count\": %llu, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f }%s\n",
+				PHASE_NAMES[p], (unsigned long long)Histogram->Count, Mean, FrameHistogramPercentile(Histogram, 50.0), FrameHistogramPercentile(Histogram, 95.0),
+				FrameHistogramPercentile(Histogram, 99.0), Histogram->Max, p + 1 < FRAME_PHASE_COUNT ? "," : "");
+		}
+	}
+
+	if (Format != TELEMETRY_FORMAT_CSV)
+		fputs("  }\n}\n", Out);
+}
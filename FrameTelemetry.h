@@ -0,0 +1,105 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//per frame timings. the thread that renders pushes one sample a frame into a single producer, single consumer ring
+//and folds it into percentile histograms as it goes; another thread drains the ring to csv or json lines, so
+//writing never stalls a frame. a full ring drops the sample from the export (it is still in the histograms)
+//
+//histograms are logarithmic, FRAME_HISTOGRAM_BINS_PER_OCTAVE bins per doubling from 1 us to 16 s, so a percentile
+//is never more than 2.2% above the true value
+
+enum FramePhase
+{
+	FRAME_PHASE_FRAME,//start of this frame to start of the next, what the user sees
+	FRAME_PHASE_WAIT,//waiting for the gpu or the swap chain before the frame could start
+	FRAME_PHASE_UPDATE,//input, camera, constants and uploads
+	FRAME_PHASE_RECORD,
+	FRAME_PHASE_SUBMIT,
+	FRAME_PHASE_PRESENT,
+	FRAME_PHASE_GPU,//between timestamps at the start and end of the frame's command list, < 0 if not measured
+	FRAME_PHASE_COUNT
+};
+
+#define FRAME_HISTOGRAM_BINS_PER_OCTAVE 32
+#define FRAME_HISTOGRAM_BINS (FRAME_HISTOGRAM_BINS_PER_OCTAVE * 24 + 1)
+
+struct FrameHistogram
+{
+	uint32_t Bins[FRAME_HISTOGRAM_BINS];
+	uint64_t Count;
+	double Sum;
+	float Max;
+};
+
+struct FrameSample
+{
+	uint64_t Frame;
+	double Time;//seconds, when the frame started
+	float Milliseconds[FRAME_PHASE_COUNT];
+};
+
+enum TelemetryFormat
+{
+	TELEMETRY_FORMAT_CSV,
+	TELEMETRY_FORMAT_JSON,//one object per line while streaming, one document for the summary
+};
+
+struct FrameTelemetry
+{
+	struct FrameSample* Samples;
+	uint32_t Capacity;//a power of two
+	volatile uint32_t Head;//next to write, only the producer stores it
+	volatile uint32_t Tail;//next to read, only the consumer stores it
+
+	//producer side
+	uint64_t Dropped;
+	struct FrameHistogram Totals[FRAME_PHASE_COUNT];//since init
+	struct FrameHistogram Recent[FRAME_PHASE_COUNT];//since FrameTelemetryResetRecent
+};
+
+//Capacity is rounded up to a power of two. false if memory runs out
+bool FrameTelemetryInit(struct FrameTelemetry* Telemetry, uint32_t Capacity);
+void FrameTelemetryFree(struct FrameTelemetry* Telemetry);
+
+const char* FramePhaseName(enum FramePhase Phase);
+
+//producer: adds the sample to the histograms and the ring. false if the ring was full and the sample was dropped
+bool FrameTelemetryPush(struct FrameTelemetry* Telemetry, const struct FrameSample* Sample);
+
+//producer
+void FrameTelemetryResetRecent(struct FrameTelemetry* Telemetry);
+
+//consumer: takes every sample in the ring and writes it to Out as a csv row or a json line (Out may be NULL to
+//discard them). returns how many were taken
+uint32_t FrameTelemetryDrain(struct FrameTelemetry* Telemetry, FILE* Out, enum TelemetryFormat Format);
+
+//the csv column names, json lines need no header
+void FrameTelemetryWriteHeader(FILE* Out, enum TelemetryFormat Format);
+
+void FrameHistogramAdd(struct FrameHistogram* Histogram, float Milliseconds);
+
+//Percentile in 0..100; the top of the bin holding it, clamped to the largest value seen. 0 when empty
+float FrameHistogramPercentile(const struct FrameHistogram* Histogram, double Percentile);
+
+//count, mean, p50, p95, p99 and max of each phase's Totals, plus the dropped sample count. read it from the producer,
+//or once the producer has stopped
+void FrameTelemetryWriteSummary(const struct FrameTelemetry* Telemetry, FILE* Out, enum TelemetryFormat Format);
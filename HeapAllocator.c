@@ -0,0 +1,632 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "HeapAllocator.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static inline uint32_t HighestBit(uint64_t Value)
+{
+#ifdef _MSC_VER
+	unsigned long Index;
+	_BitScanReverse64(&Index, Value);
+	return Index;
+#else
+	return 63 - __builtin_clzll(Value);
+#endif
+}
+
+static inline uint32_t LowestBit(uint64_t Value)
+{
+#ifdef _MSC_VER
+	unsigned long Index;
+	_BitScanForward64(&Index, Value);
+	return Index;
+#else
+	return __builtin_ctzll(Value);
+#endif
+}
+
+//list a free block of Units granules belongs in. the first level is the power of two, the second splits it
+//linearly; below HEAP_ALLOCATOR_SECOND_LEVELS granules every size has its own list
+static void MapInsert(uint64_t Units, uint32_t* Fl, uint32_t* Sl)
+{
+	if (Units < HEAP_ALLOCATOR_SECOND_LEVELS)
+	{
+		*Fl = 0;
+		*Sl = (uint32_t)Units;
+		return;
+	}
+
+	const uint32_t Log = HighestBit(Units);
+	*Fl = Log - HEAP_ALLOCATOR_SECOND_LEVEL_BITS + 1;
+	*Sl = (uint32_t)(Units >> (Log - HEAP_ALLOCATOR_SECOND_LEVEL_BITS)) - HEAP_ALLOCATOR_SECOND_LEVELS;
+}
+
+//first list whose every block holds Units granules: the request is rounded up to the next list's smallest size
+static void MapSearch(uint64_t Units, uint32_t* Fl, uint32_t* Sl)
+{
+	if (Units >= HEAP_ALLOCATOR_SECOND_LEVELS)
+		Units += (1ull << (HighestBit(Units) - HEAP_ALLOCATOR_SECOND_LEVEL_BITS)) - 1;
+
+	MapInsert(Units, Fl, Sl);
+}
+
+static uint32_t TakeBlock(struct HeapAllocator* Allocator)
+{
+	if (Allocator->FirstSpareBlock == HEAP_ALLOCATION_NONE)
+	{
+		const uint32_t NewCapacity = Allocator->BlockCapacity ? Allocator->BlockCapacity * 2 : 256;
+		struct HeapBlock* NewBlocks = realloc(Allocator->Blocks, sizeof(struct HeapBlock) * NewCapacity);
+
+		if (!NewBlocks)
+			return HEAP_ALLOCATION_NONE;
+
+		for (uint32_t i = Allocator->BlockCapacity; i < NewCapacity; i++)
+		{
+			NewBlocks[i].bUsed = false;
+			NewBlocks[i].NextFree = i + 1 < NewCapacity ? i + 1 : HEAP_ALLOCATION_NONE;
+		}
+
+		Allocator->Blocks = NewBlocks;
+		Allocator->FirstSpareBlock = Allocator->BlockCapacity;
+		Allocator->BlockCapacity = NewCapacity;
+	}
+
+	const uint32_t Index = Allocator->FirstSpareBlock;
+	Allocator->FirstSpareBlock = Allocator->Blocks[Index].NextFree;
+
+	memset(&Allocator->Blocks[Index], 0, sizeof(struct HeapBlock));
+	Allocator->Blocks[Index].PrevPhysical = HEAP_ALLOCATION_NONE;
+	Allocator->Blocks[Index].NextPhysical = HEAP_ALLOCATION_NONE;
+	Allocator->Blocks[Index].PrevFree = HEAP_ALLOCATION_NONE;
+	Allocator->Blocks[Index].NextFree = HEAP_ALLOCATION_NONE;
+	Allocator->Blocks[Index].bUsed = true;
+	return Index;
+}
+
+static void GiveBlock(struct HeapAllocator* Allocator, uint32_t Index)
+{
+	Allocator->Blocks[Index].bUsed = false;
+	Allocator->Blocks[Index].NextFree = Allocator->FirstSpareBlock;
+	Allocator->FirstSpareBlock = Index;
+}
+
+static void InsertFree(struct HeapAllocator* Allocator, uint32_t Index)
+{
+	struct HeapBlock* Block = &Allocator->Blocks[Index];
+	Block->bFree = true;
+	Block->PrevFree = HEAP_ALLOCATION_NONE;
+	Block->NextFree = HEAP_ALLOCATION_NONE;
+
+	if (Allocator->Heaps[Block->Heap].bExcluded)
+		return;
+
+	uint32_t Fl, Sl;
+	MapInsert(Block->Size / Allocator->Desc.Granularity, &Fl, &Sl);
+
+	Block->NextFree = Allocator->FreeLists[Fl][Sl];
+	if (Block->NextFree != HEAP_ALLOCATION_NONE)
+		Allocator->Blocks[Block->NextFree].PrevFree = Index;
+
+	Allocator->FreeLists[Fl][Sl] = Index;
+	Allocator->FirstLevelBitmap |= 1ull << Fl;
+	Allocator->SecondLevelBitmaps[Fl] |= 1u << Sl;
+}
+
+static void RemoveFree(struct HeapAllocator* Allocator, uint32_t Index)
+{
+	const struct HeapBlock* Block = &Allocator->Blocks[Index];
+
+	if (Allocator->Heaps[Block->Heap].bExcluded)
+		return;
+
+	uint32_t Fl, Sl;
+	MapInsert(Block->Size / Allocator->Desc.Granularity, &Fl, &Sl);
+
+	if (Block->PrevFree != HEAP_ALLOCATION_NONE)
+		Allocator->Blocks[Block->PrevFree].NextFree = Block->NextFree;
+	else
+		Allocator->FreeLists[Fl][Sl] = Block->NextFree;
+
+	if (Block->NextFree != HEAP_ALLOCATION_NONE)
+		Allocator->Blocks[Block->NextFree].PrevFree = Block->PrevFree;
+
+	if (Allocator->FreeLists[Fl][Sl] == HEAP_ALLOCATION_NONE)
+	{
+		Allocator->SecondLevelBitmaps[Fl] &= ~(1u << Sl);
+		if (Allocator->SecondLevelBitmaps[Fl] == 0)
+			Allocator->FirstLevelBitmap &= ~(1ull << Fl);
+	}
+}
+
+static uint32_t FindFree(const struct HeapAllocator* Allocator, uint64_t Units)
+{
+	uint32_t Fl, Sl;
+	MapSearch(Units, &Fl, &Sl);
+
+	if (Fl >= HEAP_ALLOCATOR_FIRST_LEVELS)
+		return HEAP_ALLOCATION_NONE;
+
+	uint32_t SlMap = Allocator->SecondLevelBitmaps[Fl] & (~0u << Sl);
+
+	if (SlMap == 0)
+	{
+		const uint64_t FlMap = Fl + 1 < HEAP_ALLOCATOR_FIRST_LEVELS ? Allocator->FirstLevelBitmap & (~0ull << (Fl + 1)) : 0;
+		if (FlMap == 0)
+			return HEAP_ALLOCATION_NONE;
+
+		Fl = LowestBit(FlMap);
+		SlMap = Allocator->SecondLevelBitmaps[Fl];
+	}
+
+	return Allocator->FreeLists[Fl][LowestBit(SlMap)];
+}
+
+static bool AddHeap(struct HeapAllocator* Allocator, uint64_t Size)
+{
+	uint32_t HeapIndex = 0;
+	while (HeapIndex < Allocator->HeapCapacity && Allocator->Heaps[HeapIndex].bAlive)
+		HeapIndex++;
+
+	if (HeapIndex == Allocator->HeapCapacity)
+	{
+		const uint32_t NewCapacity = Allocator->HeapCapacity ? Allocator->HeapCapacity * 2 : 4;
+		struct HeapInfo* NewHeaps = realloc(Allocator->Heaps, sizeof(struct HeapInfo) * NewCapacity);
+
+		if (!NewHeaps)
+			return false;
+
+		memset(NewHeaps + Allocator->HeapCapacity, 0, sizeof(struct HeapInfo) * (NewCapacity - Allocator->HeapCapacity));
+		Allocator->Heaps = NewHeaps;
+		Allocator->HeapCapacity = NewCapacity;
+	}
+
+	const uint32_t Index = TakeBlock(Allocator);
+	if (Index == HEAP_ALLOCATION_NONE)
+		return false;
+
+	if (Allocator->Desc.CreateHeap && !Allocator->Desc.CreateHeap(Allocator->Desc.Context, HeapIndex, Size))
+	{
+		GiveBlock(Allocator, Index);
+		return false;
+	}
+
+	struct HeapInfo* Heap = &Allocator->Heaps[HeapIndex];
+	memset(Heap, 0, sizeof(*Heap));
+	Heap->Size = Size;
+	Heap->FirstBlock = Index;
+	Heap->bAlive = true;
+
+	Allocator->Blocks[Index].Heap = HeapIndex;
+	Allocator->Blocks[Index].Size = Size;
+	InsertFree(Allocator, Index);
+	return true;
+}
+
+//splits Size bytes at Alignment off the free block; the leftovers either side go back in the lists
+static bool Carve(struct HeapAllocator* Allocator, uint32_t Index, uint64_t Size, uint64_t Alignment, struct HeapAllocation* Out)
+{
+	//both leftover blocks are taken up front, so running out of memory leaves the free block as it was
+	const uint32_t Front = TakeBlock(Allocator);
+	const uint32_t Back = TakeBlock(Allocator);
+
+	if (Front == HEAP_ALLOCATION_NONE || Back == HEAP_ALLOCATION_NONE)
+	{
+		if (Front != HEAP_ALLOCATION_NONE)
+			GiveBlock(Allocator, Front);
+		return false;
+	}
+
+	RemoveFree(Allocator, Index);
+
+	struct HeapBlock* Block = &Allocator->Blocks[Index];
+	struct HeapInfo* Heap = &Allocator->Heaps[Block->Heap];
+	Block->bFree = false;
+
+	const uint64_t Aligned = (Block->Offset + Alignment - 1) & ~(Alignment - 1);
+
+	if (Aligned != Block->Offset)
+	{
+		struct HeapBlock* Padding = &Allocator->Blocks[Front];
+		Padding->Offset = Block->Offset;
+		Padding->Size = Aligned - Block->Offset;
+		Padding->Heap = Block->Heap;
+		Padding->PrevPhysical = Block->PrevPhysical;
+		Padding->NextPhysical = Index;
+
+		if (Block->PrevPhysical != HEAP_ALLOCATION_NONE)
+			Allocator->Blocks[Block->PrevPhysical].NextPhysical = Front;
+		else
+			Heap->FirstBlock = Front;
+
+		Block->PrevPhysical = Front;
+		Block->Offset = Aligned;
+		Block->Size -= Padding->Size;
+		InsertFree(Allocator, Front);
+	}
+	else
+		GiveBlock(Allocator, Front);
+
+	if (Block->Size != Size)
+	{
+		struct HeapBlock* Rest = &Allocator->Blocks[Back];
+		Rest->Offset = Block->Offset + Size;
+		Rest->Size = Block->Size - Size;
+		Rest->Heap = Block->Heap;
+		Rest->PrevPhysical = Index;
+		Rest->NextPhysical = Block->NextPhysical;
+
+		if (Block->NextPhysical != HEAP_ALLOCATION_NONE)
+			Allocator->Blocks[Block->NextPhysical].PrevPhysical = Back;
+
+		Block->NextPhysical = Back;
+		Block->Size = Size;
+		InsertFree(Allocator, Back);
+	}
+	else
+		GiveBlock(Allocator, Back);
+
+	Block->Alignment = Alignment;
+	Heap->Used += Size;
+	Heap->AllocationCount++;
+
+	Out->Handle = Index;
+	Out->Heap = Block->Heap;
+	Out->Offset = Block->Offset;
+	Out->Size = Size;
+	return true;
+}
+
+static bool AllocInternal(struct HeapAllocator* Allocator, uint64_t Size, uint64_t Alignment, bool bGrow, struct HeapAllocation* Out)
+{
+	const uint64_t Granularity = Allocator->Desc.Granularity;
+
+	if (Size == 0 || (Alignment & (Alignment - 1)) != 0)
+		return false;
+
+	if (Alignment < Granularity)
+		Alignment = Granularity;
+
+	Size = (Size + Granularity - 1) & ~(Granularity - 1);
+
+	//room for the worst misalignment a free block can start at
+	const uint64_t Needed = Size + Alignment - Granularity;
+
+	uint32_t Index = FindFree(Allocator, Needed / Granularity);
+
+	if (Index == HEAP_ALLOCATION_NONE)
+	{
+		if (!bGrow)
+			return false;
+
+		const uint64_t HeapSize = Needed > Allocator->Desc.HeapSize ? Needed : Allocator->Desc.HeapSize;
+		if (!AddHeap(Allocator, HeapSize))
+			return false;
+
+		Index = FindFree(Allocator, Needed / Granularity);
+		assert(Index != HEAP_ALLOCATION_NONE);
+	}
+
+	return Carve(Allocator, Index, Size, Alignment, Out);
+}
+
+bool HeapAllocatorInit(struct HeapAllocator* Allocator, const struct HeapAllocatorDesc* Desc)
+{
+	memset(Allocator, 0, sizeof(*Allocator));
+
+	if (Desc->Granularity == 0 || (Desc->Granularity & (Desc->Granularity - 1)) != 0)
+		return false;
+
+	Allocator->Desc = *Desc;
+	Allocator->Desc.HeapSize = (Desc->HeapSize + Desc->Granularity - 1) & ~(Desc->Granularity - 1);
+	Allocator->FirstSpareBlock = HEAP_ALLOCATION_NONE;
+	memset(Allocator->FreeLists, 0xFF, sizeof(Allocator->FreeLists));
+	return true;
+}
+
+void HeapAllocatorFree(struct HeapAllocator* Allocator)
+{
+	for (uint32_t i = 0; i < Allocator->HeapCapacity; i++)
+	{
+		if (Allocator->Heaps[i].bAlive && Allocator->Desc.DestroyHeap)
+			Allocator->Desc.DestroyHeap(Allocator->Desc.Context, i);
+	}
+
+	free(Allocator->Blocks);
+	free(Allocator->Heaps);
+	memset(Allocator, 0, sizeof(*Allocator));
+}
+
+bool HeapAllocatorAlloc(struct HeapAllocator* Allocator, uint64_t Size, uint64_t Alignment, struct HeapAllocation* Out)
+{
+	return AllocInternal(Allocator, Size, Alignment ? Alignment : Allocator->Desc.Granularity, true, Out);
+}
+
+void HeapAllocatorRelease(struct HeapAllocator* Allocator, uint32_t Handle)
+{
+	if (Handle == HEAP_ALLOCATION_NONE)
+		return;
+
+	struct HeapBlock* Block = &Allocator->Blocks[Handle];
+	assert(Block->bUsed && !Block->bFree);
+
+	struct HeapInfo* Heap = &Allocator->Heaps[Block->Heap];
+	Heap->Used -= Block->Size;
+	Heap->AllocationCount--;
+	Block->Alignment = 0;
+
+	//free neighbours are absorbed, so the block grows to cover them before it goes back in a list
+	const uint32_t Next = Block->NextPhysical;
+	if (Next != HEAP_ALLOCATION_NONE && Allocator->Blocks[Next].bFree)
+	{
+		RemoveFree(Allocator, Next);
+		Block->Size += Allocator->Blocks[Next].Size;
+		Block->NextPhysical = Allocator->Blocks[Next].NextPhysical;
+
+		if (Block->NextPhysical != HEAP_ALLOCATION_NONE)
+			Allocator->Blocks[Block->NextPhysical].PrevPhysical = Handle;
+
+		GiveBlock(Allocator, Next);
+	}
+
+	const uint32_t Prev = Block->PrevPhysical;
+	if (Prev != HEAP_ALLOCATION_NONE && Allocator->Blocks[Prev].bFree)
+	{
+		RemoveFree(Allocator, Prev);
+		Block->Offset = Allocator->Blocks[Prev].Offset;
+		Block->Size += Allocator->Blocks[Prev].Size;
+		Block->PrevPhysical = Allocator->Blocks[Prev].PrevPhysical;
+
+		if (Block->PrevPhysical != HEAP_ALLOCATION_NONE)
+			Allocator->Blocks[Block->PrevPhysical].NextPhysical = Handle;
+		else
+			Heap->FirstBlock = Handle;
+
+		GiveBlock(Allocator, Prev);
+	}
+
+	InsertFree(Allocator, Handle);
+}
+
+//takes a heap's free blocks out of the lists, or puts them back, so allocations can't land in it
+static void ExcludeHeap(struct HeapAllocator* Allocator, uint32_t HeapIndex, bool bExclude)
+{
+	struct HeapInfo* Heap = &Allocator->Heaps[HeapIndex];
+
+	if (!bExclude)
+		Heap->bExcluded = false;
+
+	for (uint32_t b = Heap->FirstBlock; b != HEAP_ALLOCATION_NONE; b = Allocator->Blocks[b].NextPhysical)
+	{
+		if (!Allocator->Blocks[b].bFree)
+			continue;
+
+		if (bExclude)
+			RemoveFree(Allocator, b);
+		else
+			InsertFree(Allocator, b);
+	}
+
+	Heap->bExcluded = bExclude;
+}
+
+uint32_t HeapAllocatorDefragment(struct HeapAllocator* Allocator, struct HeapMove* OutMoves, uint32_t MaxMoves)
+{
+	//the least used heap with allocations empties into the others that have some; moving into an empty heap
+	//would only trade one for another
+	uint32_t Victim = HEAP_ALLOCATION_NONE;
+	uint32_t Holders = 0;
+
+	for (uint32_t i = 0; i < Allocator->HeapCapacity; i++)
+	{
+		const struct HeapInfo* Heap = &Allocator->Heaps[i];
+
+		if (!Heap->bAlive || Heap->AllocationCount == 0)
+			continue;
+
+		Holders++;
+
+		if (Victim == HEAP_ALLOCATION_NONE || Heap->Used < Allocator->Heaps[Victim].Used)
+			Victim = i;
+	}
+
+	if (Holders < 2 || MaxMoves == 0)
+		return 0;
+
+	for (uint32_t i = 0; i < Allocator->HeapCapacity; i++)
+	{
+		if (Allocator->Heaps[i].bAlive && (i == Victim || Allocator->Heaps[i].AllocationCount == 0))
+			ExcludeHeap(Allocator, i, true);
+	}
+
+	uint32_t MoveCount = 0;
+
+	for (uint32_t b = Allocator->Heaps[Victim].FirstBlock; b != HEAP_ALLOCATION_NONE && MoveCount < MaxMoves; b = Allocator->Blocks[b].NextPhysical)
+	{
+		if (Allocator->Blocks[b].bFree)
+			continue;
+
+		const uint64_t Size = Allocator->Blocks[b].Size;
+		const uint64_t Alignment = Allocator->Blocks[b].Alignment;
+
+		struct HeapAllocation To;
+		if (!AllocInternal(Allocator, Size, Alignment, false, &To))
+			continue;
+
+		//the block array may have moved
+		const struct HeapBlock* From = &Allocator->Blocks[b];
+		OutMoves[MoveCount].From = (struct HeapAllocation){ b, From->Heap, From->Offset, From->Size };
+		OutMoves[MoveCount].To = To;
+		MoveCount++;
+	}
+
+	for (uint32_t i = 0; i < Allocator->HeapCapacity; i++)
+	{
+		if (Allocator->Heaps[i].bExcluded)
+			ExcludeHeap(Allocator, i, false);
+	}
+
+	return MoveCount;
+}
+
+uint32_t HeapAllocatorTrim(struct HeapAllocator* Allocator)
+{
+	uint32_t AliveCount = 0;
+	for (uint32_t i = 0; i < Allocator->HeapCapacity; i++)
+		AliveCount += Allocator->Heaps[i].bAlive;
+
+	uint32_t Trimmed = 0;
+
+	for (uint32_t i = 0; i < Allocator->HeapCapacity && AliveCount > 1; i++)
+	{
+		struct HeapInfo* Heap = &Allocator->Heaps[i];
+
+		if (!Heap->bAlive || Heap->AllocationCount != 0)
+			continue;
+
+		//an empty heap is one free block
+		RemoveFree(Allocator, Heap->FirstBlock);
+		GiveBlock(Allocator, Heap->FirstBlock);
+		Heap->bAlive = false;
+
+		if (Allocator->Desc.DestroyHeap)
+			Allocator->Desc.DestroyHeap(Allocator->Desc.Context, i);
+
+		AliveCount--;
+		Trimmed++;
+	}
+
+	return Trimmed;
+}
+
+void HeapAllocatorGetStats(const struct HeapAllocator* Allocator, struct HeapAllocatorStats* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	for (uint32_t i = 0; i < Allocator->HeapCapacity; i++)
+	{
+		const struct HeapInfo* Heap = &Allocator->Heaps[i];
+
+		if (!Heap->bAlive)
+			continue;
+
+		Out->HeapCount++;
+		Out->AllocationCount += Heap->AllocationCount;
+		Out->ReservedBytes += Heap->Size;
+		Out->UsedBytes += Heap->Used;
+
+		for (uint32_t b = Heap->FirstBlock; b != HEAP_ALLOCATION_NONE; b = Allocator->Blocks[b].NextPhysical)
+		{
+			const struct HeapBlock* Block = &Allocator->Blocks[b];
+
+			if (!Block->bFree)
+				continue;
+
+			Out->FreeBlockCount++;
+			Out->FreeBytes += Block->Size;
+
+			if (Block->Size > Out->LargestFreeBlock)
+				Out->LargestFreeBlock = Block->Size;
+		}
+	}
+
+	Out->Fragmentation = Out->FreeBytes ? 1.0f - (float)((double)Out->LargestFreeBlock / Out->FreeBytes) : 0.0f;
+}
+
+uint32_t HeapAllocatorValidate(const struct HeapAllocator* Allocator)
+{
+	const uint64_t Granularity = Allocator->Desc.Granularity;
+	uint32_t Problems = 0;
+	uint32_t ChainFreeCount = 0;
+
+	for (uint32_t i = 0; i < Allocator->HeapCapacity; i++)
+	{
+		const struct HeapInfo* Heap = &Allocator->Heaps[i];
+
+		if (!Heap->bAlive)
+			continue;
+
+		uint64_t Offset = 0;
+		uint64_t Used = 0;
+		uint32_t AllocationCount = 0;
+		uint32_t Prev = HEAP_ALLOCATION_NONE;
+
+		for (uint32_t b = Heap->FirstBlock; b != HEAP_ALLOCATION_NONE; b = Allocator->Blocks[b].NextPhysical)
+		{
+			const struct HeapBlock* Block = &Allocator->Blocks[b];
+
+			Problems += !Block->bUsed || Block->Heap != i || Block->PrevPhysical != Prev;
+			Problems += Block->Offset != Offset || Block->Size == 0 || Block->Size % Granularity != 0;
+
+			if (Block->bFree)
+			{
+				Problems += Prev != HEAP_ALLOCATION_NONE && Allocator->Blocks[Prev].bFree;
+				ChainFreeCount++;
+			}
+			else
+			{
+				Problems += Block->Alignment == 0 || Block->Offset % Block->Alignment != 0;
+				Used += Block->Size;
+				AllocationCount++;
+			}
+
+			Offset += Block->Size;
+			Prev = b;
+
+			if (Offset > Heap->Size)
+				break;
+		}
+
+		Problems += Offset != Heap->Size || Used != Heap->Used || AllocationCount != Heap->AllocationCount;
+	}
+
+	uint32_t ListedCount = 0;
+
+	for (uint32_t Fl = 0; Fl < HEAP_ALLOCATOR_FIRST_LEVELS; Fl++)
+	{
+		Problems += ((Allocator->FirstLevelBitmap >> Fl) & 1) != (Allocator->SecondLevelBitmaps[Fl] != 0);
+
+		for (uint32_t Sl = 0; Sl < HEAP_ALLOCATOR_SECOND_LEVELS; Sl++)
+		{
+			const uint32_t Head = Allocator->FreeLists[Fl][Sl];
+			Problems += ((Allocator->SecondLevelBitmaps[Fl] >> Sl) & 1) != (Head != HEAP_ALLOCATION_NONE);
+
+			uint32_t Prev = HEAP_ALLOCATION_NONE;
+			for (uint32_t b = Head; b != HEAP_ALLOCATION_NONE; b = Allocator->Blocks[b].NextFree)
+			{
+				const struct HeapBlock* Block = &Allocator->Blocks[b];
+
+				uint32_t BlockFl, BlockSl;
+				MapInsert(Block->Size / Granularity, &BlockFl, &BlockSl);
+
+				Problems += !Block->bUsed || !Block->bFree || Block->PrevFree != Prev || BlockFl != Fl || BlockSl != Sl;
+				Prev = b;
+
+				if (++ListedCount > Allocator->BlockCapacity)
+					return Problems + 1;
+			}
+		}
+	}
+
+	return Problems + (ListedCount != ChainFreeCount);
+}
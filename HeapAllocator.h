@@ -0,0 +1,140 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//two level segregated fit (TLSF) sub-allocator that places many buffers in a few big heaps. it only hands out
+//heap indices and byte offsets, so it runs the same over ID3D12Heaps or a mock heap. free blocks are kept in
+//HEAP_ALLOCATOR_SECOND_LEVELS lists per power of two of size, and a bitmap per level finds the smallest list that
+//holds a request in constant time. a freed block merges with free neighbours at once, so no two free blocks are
+//ever adjacent.
+//
+//new heaps come from Desc.CreateHeap when nothing free is big enough. HeapAllocatorDefragment plans moves that
+//empty the least used heap into the others and HeapAllocatorTrim gives back the heaps left empty
+
+#define HEAP_ALLOCATOR_SECOND_LEVEL_BITS 4
+#define HEAP_ALLOCATOR_SECOND_LEVELS (1 << HEAP_ALLOCATOR_SECOND_LEVEL_BITS)
+#define HEAP_ALLOCATOR_FIRST_LEVELS 64
+
+//a handle that names nothing
+#define HEAP_ALLOCATION_NONE UINT32_MAX
+
+struct HeapAllocatorDesc
+{
+	uint64_t HeapSize;//size of every new heap, bigger only for an allocation that doesn't fit one
+	uint64_t Granularity;//power of two; every size and offset is a multiple of it
+
+	//called for each heap the allocator takes or gives back. Size is a multiple of Granularity. returning false
+	//fails the allocation that asked for the heap. HeapIndex is reused once its heap is destroyed
+	void* Context;
+	bool (*CreateHeap)(void* Context, uint32_t HeapIndex, uint64_t Size);
+	void (*DestroyHeap)(void* Context, uint32_t HeapIndex);
+};
+
+struct HeapAllocation
+{
+	uint32_t Handle;//what HeapAllocatorFree takes
+	uint32_t Heap;
+	uint64_t Offset;//in the heap, a multiple of the requested alignment
+	uint64_t Size;//rounded up to Granularity
+};
+
+struct HeapBlock
+{
+	uint64_t Offset;
+	uint64_t Size;
+	uint64_t Alignment;//what the allocation asked for, kept so a defragment move can ask again
+	uint32_t Heap;
+	uint32_t PrevPhysical;//neighbours in the same heap by offset
+	uint32_t NextPhysical;
+	uint32_t PrevFree;//free list links; NextFree also chains the unused slots
+	uint32_t NextFree;
+	bool bFree;
+	bool bUsed;//the slot holds a block
+};
+
+struct HeapInfo
+{
+	uint64_t Size;
+	uint64_t Used;
+	uint32_t AllocationCount;
+	uint32_t FirstBlock;
+	bool bAlive;
+	bool bExcluded;//its free blocks are out of the lists while a defragment empties it
+};
+
+struct HeapAllocator
+{
+	struct HeapAllocatorDesc Desc;
+
+	struct HeapBlock* Blocks;
+	uint32_t BlockCapacity;
+	uint32_t FirstSpareBlock;
+
+	struct HeapInfo* Heaps;
+	uint32_t HeapCapacity;
+
+	uint64_t FirstLevelBitmap;
+	uint32_t SecondLevelBitmaps[HEAP_ALLOCATOR_FIRST_LEVELS];
+	uint32_t FreeLists[HEAP_ALLOCATOR_FIRST_LEVELS][HEAP_ALLOCATOR_SECOND_LEVELS];
+};
+
+struct HeapAllocatorStats
+{
+	uint32_t HeapCount;
+	uint32_t AllocationCount;
+	uint32_t FreeBlockCount;
+	uint64_t ReservedBytes;//every heap's size
+	uint64_t UsedBytes;
+	uint64_t FreeBytes;
+	uint64_t LargestFreeBlock;
+	float Fragmentation;//1 - LargestFreeBlock / FreeBytes: 0 when all free space is one block
+};
+
+//a defragment step: the caller copies From's bytes to To, points whatever used From at To and frees From
+struct HeapMove
+{
+	struct HeapAllocation From;
+	struct HeapAllocation To;
+};
+
+bool HeapAllocatorInit(struct HeapAllocator* Allocator, const struct HeapAllocatorDesc* Desc);
+
+//destroys every heap; outstanding allocations go with them
+void HeapAllocatorFree(struct HeapAllocator* Allocator);
+
+//Alignment is a power of two, 0 = Granularity. takes a new heap if nothing free fits. false if Size is 0, memory
+//runs out or CreateHeap fails
+bool HeapAllocatorAlloc(struct HeapAllocator* Allocator, uint64_t Size, uint64_t Alignment, struct HeapAllocation* Out);
+
+void HeapAllocatorRelease(struct HeapAllocator* Allocator, uint32_t Handle);
+
+//plans up to MaxMoves moves of the least used heap's allocations into free space in the other heaps, without
+//taking new ones. the To allocations are made; the caller copies, then releases each From. once a heap has no
+//allocations left HeapAllocatorTrim can give it back. returns the number of moves
+uint32_t HeapAllocatorDefragment(struct HeapAllocator* Allocator, struct HeapMove* OutMoves, uint32_t MaxMoves);
+
+//destroys the heaps with no allocations, keeping at least one. returns how many went
+uint32_t HeapAllocatorTrim(struct HeapAllocator* Allocator);
+
+void HeapAllocatorGetStats(const struct HeapAllocator* Allocator, struct HeapAllocatorStats* Out);
+
+//walks every heap and free list and checks they agree: blocks tile their heaps, free neighbours are merged, the
+//bitmaps match the lists. returns the number of problems
+uint32_t HeapAllocatorValidate(const struct HeapAllocator* Allocator);
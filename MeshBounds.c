@@ -0,0 +1,621 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+
+#include "Platform.h"
+#include "MeshBounds.h"
+
+#ifdef PLATFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef PLATFORM_AVX2
+#include <immintrin.h>
+#endif
+
+//vertices per parallel task; small enough to balance, large enough that thread hand-off is noise
+#define BOUNDS_CHUNK_SIZE (64 * 1024)
+
+//simd pre-filter shrinks r^2 by this much so a point sitting on the surface is always re-checked by the scalar test
+#define BOUNDS_PREFILTER_SLACK (1.0f - 1e-6f)
+
+//[0] = min x, [1] = max x, [2] = min y, [3] = max y, [4] = min z, [5] = max z
+struct Extremes
+{
+	float Value[6];
+	uint32_t Index[6];
+};
+
+struct BoundsJob
+{
+	const uint8_t* Positions;
+	uint32_t Stride;
+	uint32_t Count;
+	enum SimdLevel Kernel;
+	uint32_t ChunkCount;
+
+	struct Extremes* ChunkExtremes;
+	struct BoundingSphere* ChunkSpheres;
+	struct BoundingSphere Initial;
+};
+
+static inline const float* GetPosition(const uint8_t* Positions, uint32_t Stride, uint32_t Index)
+{
+	return (const float*)(Positions + (size_t)Index * Stride);
+}
+
+//keeps the lowest index on ties so every kernel and thread count agrees with the sequential scan
+static inline void KeepMin(struct Extremes* Out, int Slot, float Value, uint32_t Index)
+{
+	if (Value < Out->Value[Slot] || (Value == Out->Value[Slot] && Index < Out->Index[Slot]))
+	{
+		Out->Value[Slot] = Value;
+		Out->Index[Slot] = Index;
+	}
+}
+
+static inline void KeepMax(struct Extremes* Out, int Slot, float Value, uint32_t Index)
+{
+	if (Value > Out->Value[Slot] || (Value == Out->Value[Slot] && Index < Out->Index[Slot]))
+	{
+		Out->Value[Slot] = Value;
+		Out->Index[Slot] = Index;
+	}
+}
+
+static void InitExtremes(struct Extremes* Out, const float* Point, uint32_t Index)
+{
+	for (int Axis = 0; Axis < 3; Axis++)
+	{
+		Out->Value[Axis * 2 + 0] = Point[Axis];
+		Out->Value[Axis * 2 + 1] = Point[Axis];
+		Out->Index[Axis * 2 + 0] = Index;
+		Out->Index[Axis * 2 + 1] = Index;
+	}
+}
+
+static void MergeExtremes(struct Extremes* Out, const struct Extremes* In)
+{
+	for (int Axis = 0; Axis < 3; Axis++)
+	{
+		KeepMin(Out, Axis * 2 + 0, In->Value[Axis * 2 + 0], In->Index[Axis * 2 + 0]);
+		KeepMax(Out, Axis * 2 + 1, In->Value[Axis * 2 + 1], In->Index[Axis * 2 + 1]);
+	}
+}
+
+static void ScalarExtremes(const struct BoundsJob* Job, uint32_t Begin, uint32_t End, struct Extremes* Out)
+{
+	for (uint32_t i = Begin; i < End; i++)
+	{
+		const float* Point = GetPosition(Job->Positions, Job->Stride, i);
+
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			if (Point[Axis] < Out->Value[Axis * 2 + 0])
+			{
+				Out->Value[Axis * 2 + 0] = Point[Axis];
+				Out->Index[Axis * 2 + 0] = i;
+			}
+
+			if (Point[Axis] > Out->Value[Axis * 2 + 1])
+			{
+				Out->Value[Axis * 2 + 1] = Point[Axis];
+				Out->Index[Axis * 2 + 1] = i;
+			}
+		}
+	}
+}
+
+//grows the sphere to include any points outside it, same update rule as DirectXMath's CreateFromPoints
+static inline void GrowSphere(float Center[3], float* Radius, const float* Point)
+{
+	const float Delta[3] = { Point[0] - Center[0], Point[1] - Center[1], Point[2] - Center[2] };
+	const float Dist = sqrtf(Delta[0] * Delta[0] + Delta[1] * Delta[1] + Delta[2] * Delta[2]);
+
+	if (Dist > *Radius)
+	{
+		// Adjust sphere to include the new point.
+		*Radius = (*Radius + Dist) * 0.5f;
+		const float Scale = 1.0f - *Radius / Dist;
+		Center[0] += Scale * Delta[0];
+		Center[1] += Scale * Delta[1];
+		Center[2] += Scale * Delta[2];
+	}
+}
+
+static void ScalarGrow(const struct BoundsJob* Job, uint32_t Begin, uint32_t End, float Center[3], float* Radius)
+{
+	for (uint32_t i = Begin; i < End; i++)
+		GrowSphere(Center, Radius, GetPosition(Job->Positions, Job->Stride, i));
+}
+
+#ifdef PLATFORM_SSE2
+static inline __m128 SelectPs(__m128 Mask, __m128 A, __m128 B)
+{
+	return _mm_or_ps(_mm_and_ps(Mask, A), _mm_andnot_ps(Mask, B));
+}
+
+static inline __m128i SelectEpi32(__m128 Mask, __m128i A, __m128i B)
+{
+	const __m128i IntMask = _mm_castps_si128(Mask);
+	return _mm_or_si128(_mm_and_si128(IntMask, A), _mm_andnot_si128(IntMask, B));
+}
+
+//loads four strided float3s as x/y/z lanes. a 16 byte load of the last vertex would read past a
+//tightly packed buffer, so that case falls back to scalar loads
+static inline void LoadPositions4(const struct BoundsJob* Job, uint32_t i, __m128* X, __m128* Y, __m128* Z)
+{
+	const float* P0 = GetPosition(Job->Positions, Job->Stride, i + 0);
+	const float* P1 = GetPosition(Job->Positions, Job->Stride, i + 1);
+	const float* P2 = GetPosition(Job->Positions, Job->Stride, i + 2);
+	const float* P3 = GetPosition(Job->Positions, Job->Stride, i + 3);
+
+	if (Job->Stride >= 16 || i + 4 < Job->Count)
+	{
+		__m128 R0 = _mm_loadu_ps(P0);
+		__m128 R1 = _mm_loadu_ps(P1);
+		__m128 R2 = _mm_loadu_ps(P2);
+		__m128 R3 = _mm_loadu_ps(P3);
+		_MM_TRANSPOSE4_PS(R0, R1, R2, R3);
+		*X = R0;
+		*Y = R1;
+		*Z = R2;
+	}
+	else
+	{
+		*X = _mm_setr_ps(P0[0], P1[0], P2[0], P3[0]);
+		*Y = _mm_setr_ps(P0[1], P1[1], P2[1], P3[1]);
+		*Z = _mm_setr_ps(P0[2], P1[2], P2[2], P3[2]);
+	}
+}
+
+static void Sse2Extremes(const struct BoundsJob* Job, uint32_t Begin, uint32_t End, struct Extremes* Out)
+{
+	uint32_t i = Begin;
+
+	if (End - Begin >= 4)
+	{
+		__m128 MinValue[3], MaxValue[3];
+		__m128i MinIndex[3], MaxIndex[3];
+
+		__m128i Index = _mm_setr_epi32(i, i + 1, i + 2, i + 3);
+		const __m128i Step = _mm_set1_epi32(4);
+
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			MinValue[Axis] = _mm_set1_ps(Out->Value[Axis * 2 + 0]);
+			MaxValue[Axis] = _mm_set1_ps(Out->Value[Axis * 2 + 1]);
+			MinIndex[Axis] = _mm_set1_epi32(Out->Index[Axis * 2 + 0]);
+			MaxIndex[Axis] = _mm_set1_epi32(Out->Index[Axis * 2 + 1]);
+		}
+
+		for (; i + 4 <= End; i += 4)
+		{
+			__m128 Lanes[3];
+			LoadPositions4(Job, i, &Lanes[0], &Lanes[1], &Lanes[2]);
+
+			for (int Axis = 0; Axis < 3; Axis++)
+			{
+				const __m128 Less = _mm_cmplt_ps(Lanes[Axis], MinValue[Axis]);
+				MinValue[Axis] = SelectPs(Less, Lanes[Axis], MinValue[Axis]);
+				MinIndex[Axis] = SelectEpi32(Less, Index, MinIndex[Axis]);
+
+				const __m128 Greater = _mm_cmpgt_ps(Lanes[Axis], MaxValue[Axis]);
+				MaxValue[Axis] = SelectPs(Greater, Lanes[Axis], MaxValue[Axis]);
+				MaxIndex[Axis] = SelectEpi32(Greater, Index, MaxIndex[Axis]);
+			}
+
+			Index = _mm_add_epi32(Index, Step);
+		}
+
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			alignas(16) float Values[4];
+			alignas(16) uint32_t Indices[4];
+
+			_mm_store_ps(Values, MinValue[Axis]);
+			_mm_store_si128((__m128i*)Indices, MinIndex[Axis]);
+			for (int Lane = 0; Lane < 4; Lane++)
+				KeepMin(Out, Axis * 2 + 0, Values[Lane], Indices[Lane]);
+
+			_mm_store_ps(Values, MaxValue[Axis]);
+			_mm_store_si128((__m128i*)Indices, MaxIndex[Axis]);
+			for (int Lane = 0; Lane < 4; Lane++)
+				KeepMax(Out, Axis * 2 + 1, Values[Lane], Indices[Lane]);
+		}
+	}
+
+	ScalarExtremes(Job, i, End, Out);
+}
+
+//tests four points at a time and only drops to the sequential update for groups with a point outside
+static void Sse2Grow(const struct BoundsJob* Job, uint32_t Begin, uint32_t End, float Center[3], float* Radius)
+{
+	uint32_t i = Begin;
+
+	for (; i + 4 <= End; i += 4)
+	{
+		__m128 X, Y, Z;
+		LoadPositions4(Job, i, &X, &Y, &Z);
+
+		X = _mm_sub_ps(X, _mm_set1_ps(Center[0]));
+		Y = _mm_sub_ps(Y, _mm_set1_ps(Center[1]));
+		Z = _mm_sub_ps(Z, _mm_set1_ps(Center[2]));
+
+		const __m128 DistSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, X), _mm_mul_ps(Y, Y)), _mm_mul_ps(Z, Z));
+		const __m128 RadiusSq = _mm_set1_ps(*Radius * *Radius * BOUNDS_PREFILTER_SLACK);
+
+		if (_mm_movemask_ps(_mm_cmpgt_ps(DistSq, RadiusSq)) != 0)
+			ScalarGrow(Job, i, i + 4, Center, Radius);
+	}
+
+	ScalarGrow(Job, i, End, Center, Radius);
+}
+#endif
+
+#ifdef PLATFORM_AVX2
+static inline __m256i GatherOffsets8(uint32_t Stride)
+{
+	const int FloatStride = (int)(Stride / sizeof(float));
+	return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(FloatStride));
+}
+
+static void Avx2Extremes(const struct BoundsJob* Job, uint32_t Begin, uint32_t End, struct Extremes* Out)
+{
+	uint32_t i = Begin;
+
+	if (End - Begin >= 8)
+	{
+		__m256 MinValue[3], MaxValue[3];
+		__m256i MinIndex[3], MaxIndex[3];
+
+		__m256i Index = _mm256_setr_epi32(i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6, i + 7);
+		const __m256i Step = _mm256_set1_epi32(8);
+		const __m256i Offsets = GatherOffsets8(Job->Stride);
+
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			MinValue[Axis] = _mm256_set1_ps(Out->Value[Axis * 2 + 0]);
+			MaxValue[Axis] = _mm256_set1_ps(Out->Value[Axis * 2 + 1]);
+			MinIndex[Axis] = _mm256_set1_epi32(Out->Index[Axis * 2 + 0]);
+			MaxIndex[Axis] = _mm256_set1_epi32(Out->Index[Axis * 2 + 1]);
+		}
+
+		for (; i + 8 <= End; i += 8)
+		{
+			const float* Base = GetPosition(Job->Positions, Job->Stride, i);
+
+			for (int Axis = 0; Axis < 3; Axis++)
+			{
+				const __m256 Lane = _mm256_i32gather_ps(Base + Axis, Offsets, 4);
+
+				const __m256 Less = _mm256_cmp_ps(Lane, MinValue[Axis], _CMP_LT_OQ);
+				MinValue[Axis] = _mm256_blendv_ps(MinValue[Axis], Lane, Less);
+				MinIndex[Axis] = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(MinIndex[Axis]), _mm256_castsi256_ps(Index), Less));
+
+				const __m256 Greater = _mm256_cmp_ps(Lane, MaxValue[Axis], _CMP_GT_OQ);
+				MaxValue[Axis] = _mm256_blendv_ps(MaxValue[Axis], Lane, Greater);
+				MaxIndex[Axis] = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(MaxIndex[Axis]), _mm256_castsi256_ps(Index), Greater));
+			}
+
+			Index = _mm256_add_epi32(Index, Step);
+		}
+
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			alignas(32) float Values[8];
+			alignas(32) uint32_t Indices[8];
+
+			_mm256_store_ps(Values, MinValue[Axis]);
+			_mm256_store_si256((__m256i*)Indices, MinIndex[Axis]);
+			for (int Lane = 0; Lane < 8; Lane++)
+				KeepMin(Out, Axis * 2 + 0, Values[Lane], Indices[Lane]);
+
+			_mm256_store_ps(Values, MaxValue[Axis]);
+			_mm256_store_si256((__m256i*)Indices, MaxIndex[Axis]);
+			for (int Lane = 0; Lane < 8; Lane++)
+				KeepMax(Out, Axis * 2 + 1, Values[Lane], Indices[Lane]);
+		}
+	}
+
+	ScalarExtremes(Job, i, End, Out);
+}
+
+static void Avx2Grow(const struct BoundsJob* Job, uint32_t Begin, uint32_t End, float Center[3], float* Radius)
+{
+	uint32_t i = Begin;
+	const __m256i Offsets = GatherOffsets8(Job->Stride);
+
+	for (; i + 8 <= End; i += 8)
+	{
+		const float* Base = GetPosition(Job->Positions, Job->Stride, i);
+
+		const __m256 X = _mm256_sub_ps(_mm256_i32gather_ps(Base + 0, Offsets, 4), _mm256_set1_ps(Center[0]));
+		const __m256 Y = _mm256_sub_ps(_mm256_i32gather_ps(Base + 1, Offsets, 4), _mm256_set1_ps(Center[1]));
+		const __m256 Z = _mm256_sub_ps(_mm256_i32gather_ps(Base + 2, Offsets, 4), _mm256_set1_ps(Center[2]));
+
+		const __m256 DistSq = _mm256_fmadd_ps(X, X, _mm256_fmadd_ps(Y, Y, _mm256_mul_ps(Z, Z)));
+		const __m256 RadiusSq = _mm256_set1_ps(*Radius * *Radius * BOUNDS_PREFILTER_SLACK);
+
+		if (_mm256_movemask_ps(_mm256_cmp_ps(DistSq, RadiusSq, _CMP_GT_OQ)) != 0)
+			ScalarGrow(Job, i, i + 8, Center, Radius);
+	}
+
+	ScalarGrow(Job, i, End, Center, Radius);
+}
+#endif
+
+static void ExtremesTask(void* Context, uint32_t TaskIndex)
+{
+	struct BoundsJob* Job = Context;
+
+	const uint32_t Begin = TaskIndex * BOUNDS_CHUNK_SIZE;
+	const uint32_t End = Begin + BOUNDS_CHUNK_SIZE < Job->Count ? Begin + BOUNDS_CHUNK_SIZE : Job->Count;
+
+	struct Extremes* Out = &Job->ChunkExtremes[TaskIndex];
+	InitExtremes(Out, GetPosition(Job->Positions, Job->Stride, Begin), Begin);
+
+	switch (Job->Kernel)
+	{
+#ifdef PLATFORM_AVX2
+	case SIMD_LEVEL_AVX2:
+		Avx2Extremes(Job, Begin + 1, End, Out);
+		break;
+#endif
+#ifdef PLATFORM_SSE2
+	case SIMD_LEVEL_SSE2:
+		Sse2Extremes(Job, Begin + 1, End, Out);
+		break;
+#endif
+	default:
+		ScalarExtremes(Job, Begin + 1, End, Out);
+		break;
+	}
+}
+
+static void GrowTask(void* Context, uint32_t TaskIndex)
+{
+	struct BoundsJob* Job = Context;
+
+	const uint32_t Begin = TaskIndex * BOUNDS_CHUNK_SIZE;
+	const uint32_t End = Begin + BOUNDS_CHUNK_SIZE < Job->Count ? Begin + BOUNDS_CHUNK_SIZE : Job->Count;
+
+	struct BoundingSphere* Out = &Job->ChunkSpheres[TaskIndex];
+	*Out = Job->Initial;
+
+	switch (Job->Kernel)
+	{
+#ifdef PLATFORM_AVX2
+	case SIMD_LEVEL_AVX2:
+		Avx2Grow(Job, Begin, End, Out->Center, &Out->Radius);
+		break;
+#endif
+#ifdef PLATFORM_SSE2
+	case SIMD_LEVEL_SSE2:
+		Sse2Grow(Job, Begin, End, Out->Center, &Out->Radius);
+		break;
+#endif
+	default:
+		ScalarGrow(Job, Begin, End, Out->Center, &Out->Radius);
+		break;
+	}
+}
+
+void ComputeBoundingSphere(const float* Positions, uint32_t Stride, uint32_t Count, enum SimdLevel Kernel, uint32_t ThreadCount, struct BoundingSphere* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	if (Count == 0)
+		return;
+
+	//gathers address whole floats, so odd strides take the scalar path
+	if (!PlatformSimdSupported(Kernel) || Stride % sizeof(float) != 0)
+		Kernel = SIMD_LEVEL_SCALAR;
+
+	struct BoundsJob Job = { 0 };
+	Job.Positions = (const uint8_t*)Positions;
+	Job.Stride = Stride;
+	Job.Count = Count;
+	Job.Kernel = Kernel;
+	Job.ChunkCount = (Count + BOUNDS_CHUNK_SIZE - 1) / BOUNDS_CHUNK_SIZE;
+
+	struct Extremes SingleExtremes;
+	struct BoundingSphere SingleSphere;
+
+	if (Job.ChunkCount == 1)
+	{
+		Job.ChunkExtremes = &SingleExtremes;
+		Job.ChunkSpheres = &SingleSphere;
+	}
+	else
+	{
+		Job.ChunkExtremes = malloc(sizeof(struct Extremes) * Job.ChunkCount);
+		Job.ChunkSpheres = malloc(sizeof(struct BoundingSphere) * Job.ChunkCount);
+
+		if (Job.ChunkExtremes == NULL || Job.ChunkSpheres == NULL)
+		{
+			//out of memory: one chunk covering everything still gives the right answer, just on one thread
+			free(Job.ChunkExtremes);
+			free(Job.ChunkSpheres);
+			Job.ChunkExtremes = &SingleExtremes;
+			Job.ChunkSpheres = &SingleSphere;
+			Job.ChunkCount = 1;
+		}
+	}
+
+	if (Job.ChunkCount == 1)
+	{
+		ExtremesTask(&Job, 0);
+	}
+	else
+	{
+		PlatformParallelFor(Job.ChunkCount, ThreadCount, ExtremesTask, &Job);
+
+		for (uint32_t i = 1; i < Job.ChunkCount; i++)
+			MergeExtremes(&Job.ChunkExtremes[0], &Job.ChunkExtremes[i]);
+	}
+
+	// Use the min/max pair that are farthest apart to form the initial sphere.
+	{
+		const struct Extremes* Extremes = &Job.ChunkExtremes[0];
+
+		float Dist[3];
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			const float* Min = GetPosition(Job.Positions, Stride, Extremes->Index[Axis * 2 + 0]);
+			const float* Max = GetPosition(Job.Positions, Stride, Extremes->Index[Axis * 2 + 1]);
+
+			const float Delta[3] = { Max[0] - Min[0], Max[1] - Min[1], Max[2] - Min[2] };
+			Dist[Axis] = sqrtf(Delta[0] * Delta[0] + Delta[1] * Delta[1] + Delta[2] * Delta[2]);
+		}
+
+		int Axis;
+		if (Dist[0] > Dist[1])
+			Axis = Dist[0] > Dist[2] ? 0 : 2;
+		else // Y >= X
+			Axis = Dist[1] > Dist[2] ? 1 : 2;
+
+		const float* Min = GetPosition(Job.Positions, Stride, Extremes->Index[Axis * 2 + 0]);
+		const float* Max = GetPosition(Job.Positions, Stride, Extremes->Index[Axis * 2 + 1]);
+
+		for (int i = 0; i < 3; i++)
+			Job.Initial.Center[i] = (Min[i] + Max[i]) * 0.5f;
+
+		Job.Initial.Radius = Dist[Axis] * 0.5f;
+	}
+
+	// Add any points not inside the sphere.
+	if (Job.ChunkCount == 1)
+	{
+		GrowTask(&Job, 0);
+		*Out = Job.ChunkSpheres[0];
+	}
+	else
+	{
+		PlatformParallelFor(Job.ChunkCount, ThreadCount, GrowTask, &Job);
+
+		*Out = Job.ChunkSpheres[0];
+		for (uint32_t i = 1; i < Job.ChunkCount; i++)
+			MergeBoundingSpheres(Out, &Job.ChunkSpheres[i], Out);
+
+		free(Job.ChunkExtremes);
+		free(Job.ChunkSpheres);
+	}
+}
+
+void MergeBoundingSpheres(const struct BoundingSphere* A, const struct BoundingSphere* B, struct BoundingSphere* Out)
+{
+	const float V[3] = { B->Center[0] - A->Center[0], B->Center[1] - A->Center[1], B->Center[2] - A->Center[2] };
+	const float d = sqrtf(V[0] * V[0] + V[1] * V[1] + V[2] * V[2]);
+
+	const float r1 = A->Radius;
+	const float r2 = B->Radius;
+
+	if (r1 + r2 >= d)
+	{
+		// One sphere already contains the other.
+		if (r1 - r2 >= d)
+		{
+			*Out = *A;
+			return;
+		}
+
+		if (r2 - r1 >= d)
+		{
+			*Out = *B;
+			return;
+		}
+	}
+
+	const float t1 = fminf(-r1, d - r2);
+	const float t2 = fmaxf(r1, d + r2);
+	const float t_5 = (t2 - t1) * 0.5f;
+	const float Scale = (t_5 + t1) / d;
+
+	const struct BoundingSphere Merged =
+	{
+		.Center = { A->Center[0] + V[0] * Scale, A->Center[1] + V[1] * Scale, A->Center[2] + V[2] * Scale },
+		.Radius = t_5
+	};
+
+	*Out = Merged;
+}
+
+struct MeshBoundsJob
+{
+	struct Mesh* MeshList;
+	enum SimdLevel Kernel;
+	uint32_t ThreadCount;
+};
+
+static void MeshBoundsTask(void* Context, uint32_t TaskIndex)
+{
+	struct MeshBoundsJob* Job = Context;
+	struct Mesh* Mesh = &Job->MeshList[TaskIndex];
+
+	const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+
+	if (Slot == MESHFILE_ATTRIBUTE_NONE)
+	{
+		memset(&Mesh->BoundingSphere, 0, sizeof(Mesh->BoundingSphere));
+		return;
+	}
+
+	const float* Positions = (const float*)(Mesh->VertexBuffers[Slot].Verts + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_POSITION]);
+	const uint32_t Count = Mesh->VertexBuffers[Slot].Size / Mesh->VertexBuffers[Slot].Stride;
+
+	ComputeBoundingSphere(Positions, Mesh->VertexBuffers[Slot].Stride, Count, Job->Kernel, Job->ThreadCount, &Mesh->BoundingSphere);
+}
+
+void ComputeMeshBounds(struct Mesh* MeshList, uint32_t MeshCount, enum SimdLevel Kernel, uint32_t ThreadCount, struct BoundingSphere* SceneSphere)
+{
+	memset(SceneSphere, 0, sizeof(*SceneSphere));
+
+	if (MeshCount == 0)
+		return;
+
+	if (ThreadCount == 0)
+		ThreadCount = PlatformGetProcessorCount();
+
+	uint64_t TotalVertexCount = 0;
+	for (uint32_t i = 0; i < MeshCount; i++)
+		TotalVertexCount += MeshList[i].VertexCount;
+
+	struct MeshBoundsJob Job = { 0 };
+	Job.MeshList = MeshList;
+	Job.Kernel = Kernel;
+
+	//many small meshes: one mesh per thread. few large ones: split each mesh across every thread
+	if (MeshCount >= ThreadCount && TotalVertexCount / MeshCount < BOUNDS_CHUNK_SIZE)
+	{
+		Job.ThreadCount = 1;
+		PlatformParallelFor(MeshCount, ThreadCount, MeshBoundsTask, &Job);
+	}
+	else
+	{
+		Job.ThreadCount = ThreadCount;
+		for (uint32_t i = 0; i < MeshCount; i++)
+			MeshBoundsTask(&Job, i);
+	}
+
+	*SceneSphere = MeshList[0].BoundingSphere;
+
+	for (uint32_t i = 1; i < MeshCount; i++)
+		MergeBoundingSpheres(SceneSphere, &MeshList[i].BoundingSphere, SceneSphere);
+}
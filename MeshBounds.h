@@ -0,0 +1,36 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Platform.h"
+#include "MeshFile.h"
+
+//ritter bounding spheres over strided float3 positions.
+//both passes are split into chunks that run in parallel; the extreme-point pass is an exact reduction,
+//the growth pass grows one sphere per chunk and merges them, so multithreaded results can be slightly
+//looser than the single threaded ones but always enclose every point
+
+//ThreadCount 0 = one per processor
+void ComputeBoundingSphere(const float* Positions, uint32_t Stride, uint32_t Count, enum SimdLevel Kernel, uint32_t ThreadCount, struct BoundingSphere* Out);
+
+//smallest sphere enclosing both A and B; Out may alias either input
+void MergeBoundingSpheres(const struct BoundingSphere* A, const struct BoundingSphere* B, struct BoundingSphere* Out);
+
+//fills in MeshList[i].BoundingSphere for every mesh and returns the sphere around all of them in SceneSphere
+void ComputeMeshBounds(struct Mesh* MeshList, uint32_t MeshCount, enum SimdLevel Kernel, uint32_t ThreadCount, struct BoundingSphere* SceneSphere);
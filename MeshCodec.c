@@ -0,0 +1,729 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <assert.h>
+
+#include "MeshCodec.h"
+
+#ifdef PLATFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef PLATFORM_AVX2
+#include <immintrin.h>
+#endif
+
+//encoded block layout, for each byte plane of the residuals (least significant first):
+//  ceil(groups / 4) header bytes, 2 bits per group selecting 0/2/4/8 bits per value
+//  the packed groups, values stored lsb first
+#define GROUP_SIZE 16
+
+static_assert(MESH_CODEC_BLOCK_SIZE % GROUP_SIZE == 0, "blocks are whole groups");
+static_assert(MESH_CODEC_BLOCK_SIZE % 4 == 0, "blocks hold whole triangles");
+
+static const uint32_t GroupBits[4] = { 0, 2, 4, 8 };
+static const uint32_t GroupBytes[4] = { 0, 4, 8, 16 };
+
+//triangles are coded as four 16 bit fields: three local indices and the two spare bits
+#define TRIANGLE_FIELDS 4
+
+static inline uint32_t ZigZag32(uint32_t Value)
+{
+	return (Value << 1) ^ (uint32_t)((int32_t)Value >> 31);
+}
+
+static inline uint32_t UnZigZag32(uint32_t Value)
+{
+	return (Value >> 1) ^ (0u - (Value & 1));
+}
+
+static inline uint32_t ZigZag16(uint32_t Value)
+{
+	return ((Value << 1) ^ (uint32_t)((int32_t)(int16_t)Value >> 15)) & 0xFFFF;
+}
+
+static inline uint32_t UnZigZag16(uint32_t Value)
+{
+	return ((Value >> 1) ^ (0u - (Value & 1))) & 0xFFFF;
+}
+
+//element size and stride the delta works on; triangles are split into 16 bit fields first
+static inline uint32_t CodedElementSize(const struct MeshCodecFormat* Format)
+{
+	return Format->Filter == MESH_CODEC_FILTER_TRIANGLES ? 2 : Format->ElementSize;
+}
+
+static inline uint32_t CodedStride(const struct MeshCodecFormat* Format)
+{
+	return Format->Filter == MESH_CODEC_FILTER_TRIANGLES ? TRIANGLE_FIELDS : Format->Stride;
+}
+
+static inline size_t CodedElementCount(const struct MeshCodecFormat* Format, size_t Size)
+{
+	return Format->Filter == MESH_CODEC_FILTER_TRIANGLES ? Size / 4 * TRIANGLE_FIELDS : Size / Format->ElementSize;
+}
+
+bool MeshCodecFormatValid(const struct MeshCodecFormat* Format, size_t Size)
+{
+	switch (Format->Filter)
+	{
+	case MESH_CODEC_FILTER_RAW:
+		return true;
+	case MESH_CODEC_FILTER_DELTA:
+		return (Format->ElementSize == 2 || Format->ElementSize == 4) && Format->Stride >= 1 && Size % Format->ElementSize == 0;
+	case MESH_CODEC_FILTER_TRIANGLES:
+		return Size % 4 == 0;
+	default:
+		return false;
+	}
+}
+
+struct MeshCodecFormat MeshCodecStreamFormat(const struct Mesh* Mesh, enum MeshStream Stream)
+{
+	switch (Stream)
+	{
+	case MESH_STREAM_INDICES:
+	case MESH_STREAM_UNIQUE_VERTEX_INDICES:
+		return (struct MeshCodecFormat){ MESH_CODEC_FILTER_DELTA, Mesh->IndexSize, 1 };
+	case MESH_STREAM_INDEX_SUBSETS:
+	case MESH_STREAM_MESHLET_SUBSETS:
+	case MESH_STREAM_CLUSTER_ROOTS:
+		return (struct MeshCodecFormat){ MESH_CODEC_FILTER_DELTA, 4, sizeof(struct Subset) / 4 };
+	case MESH_STREAM_MESHLETS:
+		return (struct MeshCodecFormat){ MESH_CODEC_FILTER_DELTA, 4, sizeof(struct Meshlet) / 4 };
+	case MESH_STREAM_PRIMITIVE_INDICES:
+		return (struct MeshCodecFormat){ MESH_CODEC_FILTER_TRIANGLES, 4, 1 };
+	case MESH_STREAM_CULL_DATA:
+		return (struct MeshCodecFormat){ MESH_CODEC_FILTER_DELTA, 4, sizeof(struct CullData) / 4 };
+	case MESH_STREAM_CLUSTER_LODS:
+		return (struct MeshCodecFormat){ MESH_CODEC_FILTER_DELTA, 4, sizeof(struct ClusterLod) / 4 };
+	default:
+		break;
+	}
+
+	//positions and normals are floats; predicting their bit patterns keeps the round trip exact
+	const uint32_t slot = Stream - MESH_STREAM_VERTICES;
+
+	if (slot < Mesh->VertexBufferCount && Mesh->VertexBuffers[slot].Stride && Mesh->VertexBuffers[slot].Stride % 4 == 0)
+		return (struct MeshCodecFormat){ MESH_CODEC_FILTER_DELTA, 4, Mesh->VertexBuffers[slot].Stride / 4 };
+
+	return (struct MeshCodecFormat){ MESH_CODEC_FILTER_RAW, 1, 1 };
+}
+
+size_t MeshCodecBound(size_t Size)
+{
+	//triangles double in size before packing, plus one header byte per four groups and per block
+	return Size * 2 + Size / 16 + 64;
+}
+
+static uint32_t ReadElement(const struct MeshCodecFormat* Format, const uint8_t* Data, size_t Index)
+{
+	if (Format->Filter == MESH_CODEC_FILTER_TRIANGLES)
+	{
+		uint32_t word;
+		memcpy(&word, Data + Index / TRIANGLE_FIELDS * 4, sizeof(word));
+
+		const uint32_t field = (uint32_t)(Index % TRIANGLE_FIELDS);
+		return field == 3 ? word >> 30 : (word >> (field * 10)) & 0x3FF;
+	}
+
+	if (Format->ElementSize == 2)
+	{
+		uint16_t value;
+		memcpy(&value, Data + Index * 2, sizeof(value));
+		return value;
+	}
+
+	uint32_t value;
+	memcpy(&value, Data + Index * 4, sizeof(value));
+	return value;
+}
+
+static uint8_t* PackPlane(const uint8_t* Plane, uint32_t GroupCount, uint8_t* Out)
+{
+	uint8_t* header = Out;
+	const uint32_t headerSize = (GroupCount + 3) / 4;
+	memset(header, 0, headerSize);
+	Out += headerSize;
+
+	for (uint32_t g = 0; g < GroupCount; g++)
+	{
+		const uint8_t* group = Plane + g * GROUP_SIZE;
+
+		uint32_t bits = 0;
+		for (uint32_t j = 0; j < GROUP_SIZE; j++)
+			bits |= group[j];
+
+		const uint32_t code = bits == 0 ? 0 : bits < 4 ? 1 : bits < 16 ? 2 : 3;
+		header[g / 4] |= (uint8_t)(code << (g % 4 * 2));
+
+		const uint32_t width = GroupBits[code];
+
+		if (width == 8)
+		{
+			memcpy(Out, group, GROUP_SIZE);
+		}
+		else if (width)
+		{
+			memset(Out, 0, GroupBytes[code]);
+
+			for (uint32_t j = 0; j < GROUP_SIZE; j++)
+				Out[j * width / 8] |= (uint8_t)(group[j] << (j * width % 8));
+		}
+
+		Out += GroupBytes[code];
+	}
+
+	return Out;
+}
+
+size_t MeshCodecEncode(const struct MeshCodecFormat* Format, const void* Data, size_t Size, void* Out)
+{
+	assert(MeshCodecFormatValid(Format, Size));
+
+	if (Format->Filter == MESH_CODEC_FILTER_RAW)
+	{
+		if (Size)
+			memcpy(Out, Data, Size);
+
+		return Size;
+	}
+
+	const uint32_t elementSize = CodedElementSize(Format);
+	const size_t stride = CodedStride(Format);
+	const size_t count = CodedElementCount(Format, Size);
+	const uint32_t mask = elementSize == 2 ? 0xFFFF : 0xFFFFFFFF;
+
+	uint8_t planes[4][MESH_CODEC_BLOCK_SIZE];
+	uint8_t* write = Out;
+
+	for (size_t begin = 0; begin < count; begin += MESH_CODEC_BLOCK_SIZE)
+	{
+		const uint32_t blockCount = (uint32_t)(count - begin < MESH_CODEC_BLOCK_SIZE ? count - begin : MESH_CODEC_BLOCK_SIZE);
+		const uint32_t groupCount = (blockCount + GROUP_SIZE - 1) / GROUP_SIZE;
+
+		memset(planes, 0, sizeof(planes));
+
+		for (uint32_t j = 0; j < blockCount; j++)
+		{
+			const size_t i = begin + j;
+			const uint32_t predicted = i >= stride ? ReadElement(Format, Data, i - stride) : 0;
+			const uint32_t delta = (ReadElement(Format, Data, i) - predicted) & mask;
+			const uint32_t residual = elementSize == 2 ? ZigZag16(delta) : ZigZag32(delta);
+
+			for (uint32_t p = 0; p < elementSize; p++)
+				planes[p][j] = (uint8_t)(residual >> (p * 8));
+		}
+
+		for (uint32_t p = 0; p < elementSize; p++)
+			write = PackPlane(planes[p], groupCount, write);
+	}
+
+	return (size_t)(write - (uint8_t*)Out);
+}
+
+//bytes of packed data behind one plane's header; the caller checks it's all there before unpacking
+static size_t PlaneDataSize(const uint8_t* Header, uint32_t GroupCount)
+{
+	size_t size = 0;
+
+	for (uint32_t g = 0; g < GroupCount; g++)
+		size += GroupBytes[(Header[g / 4] >> (g % 4 * 2)) & 3];
+
+	return size;
+}
+
+static void ScalarUnpackPlane(const uint8_t* Header, uint32_t GroupCount, const uint8_t* Data, uint8_t* Plane)
+{
+	for (uint32_t g = 0; g < GroupCount; g++)
+	{
+		const uint32_t code = (Header[g / 4] >> (g % 4 * 2)) & 3;
+		const uint32_t width = GroupBits[code];
+		uint8_t* group = Plane + g * GROUP_SIZE;
+
+		if (width == 8)
+		{
+			memcpy(group, Data, GROUP_SIZE);
+		}
+		else
+		{
+			const uint32_t valueMask = (1u << width) - 1;
+
+			for (uint32_t j = 0; j < GROUP_SIZE; j++)
+				group[j] = width ? (uint8_t)((Data[j * width / 8] >> (j * width % 8)) & valueMask) : 0;
+		}
+
+		Data += GroupBytes[code];
+	}
+}
+
+//scalar reference for the reconstruction: rebuilds elements from the planes, undoes the zigzag and adds the
+//element Stride back. Out points at this block's first element, Before elements ahead of it are already decoded
+static void ScalarReconstruct(uint8_t (*Planes)[MESH_CODEC_BLOCK_SIZE], uint32_t ElementSize, size_t Stride, uint32_t Count, size_t Before, uint8_t* Out)
+{
+	//Out carries no alignment guarantee, so elements go through memcpy
+	if (ElementSize == 2)
+	{
+		for (uint32_t j = 0; j < Count; j++)
+		{
+			const uint32_t residual = Planes[0][j] | (uint32_t)Planes[1][j] << 8;
+			uint16_t predicted = 0;
+			if (Before + j >= Stride)
+				memcpy(&predicted, Out + ((ptrdiff_t)j - (ptrdiff_t)Stride) * 2, sizeof(predicted));
+
+			const uint16_t value = (uint16_t)(UnZigZag16(residual) + predicted);
+			memcpy(Out + (size_t)j * 2, &value, sizeof(value));
+		}
+	}
+	else
+	{
+		for (uint32_t j = 0; j < Count; j++)
+		{
+			const uint32_t residual = Planes[0][j] | (uint32_t)Planes[1][j] << 8 | (uint32_t)Planes[2][j] << 16 | (uint32_t)Planes[3][j] << 24;
+			uint32_t predicted = 0;
+			if (Before + j >= Stride)
+				memcpy(&predicted, Out + ((ptrdiff_t)j - (ptrdiff_t)Stride) * 4, sizeof(predicted));
+
+			const uint32_t value = UnZigZag32(residual) + predicted;
+			memcpy(Out + (size_t)j * 4, &value, sizeof(value));
+		}
+	}
+}
+
+static void ScalarPackTriangles(const uint16_t* Fields, uint32_t TriangleCount, uint8_t* Out)
+{
+	for (uint32_t t = 0; t < TriangleCount; t++)
+	{
+		const uint16_t* f = Fields + t * TRIANGLE_FIELDS;
+		const uint32_t word = (f[0] & 0x3FFu) | (f[1] & 0x3FFu) << 10 | (f[2] & 0x3FFu) << 20 | (uint32_t)(f[3] & 3) << 30;
+		memcpy(Out + t * 4, &word, sizeof(word));
+	}
+}
+
+#ifdef PLATFORM_SSE2
+static void Sse2UnpackPlane(const uint8_t* Header, uint32_t GroupCount, const uint8_t* Data, uint8_t* Plane)
+{
+	const __m128i mask2 = _mm_set1_epi8(0x03);
+	const __m128i mask4 = _mm_set1_epi8(0x0F);
+
+	for (uint32_t g = 0; g < GroupCount; g++)
+	{
+		const uint32_t code = (Header[g / 4] >> (g % 4 * 2)) & 3;
+		__m128i values;
+
+		switch (code)
+		{
+		case 0:
+			values = _mm_setzero_si128();
+			break;
+		case 1:
+		{
+			int32_t packed;
+			memcpy(&packed, Data, sizeof(packed));
+			const __m128i v = _mm_cvtsi32_si128(packed);
+
+			//byte k holds values 4k..4k+3 in bits 0-1, 2-3, 4-5, 6-7
+			const __m128i a = _mm_and_si128(v, mask2);
+			const __m128i b = _mm_and_si128(_mm_srli_epi16(v, 2), mask2);
+			const __m128i c = _mm_and_si128(_mm_srli_epi16(v, 4), mask2);
+			const __m128i d = _mm_and_si128(_mm_srli_epi16(v, 6), mask2);
+			values = _mm_unpacklo_epi16(_mm_unpacklo_epi8(a, b), _mm_unpacklo_epi8(c, d));
+			break;
+		}
+		case 2:
+		{
+			const __m128i v = _mm_loadl_epi64((const __m128i*)Data);
+			values = _mm_unpacklo_epi8(_mm_and_si128(v, mask4), _mm_and_si128(_mm_srli_epi16(v, 4), mask4));
+			break;
+		}
+		default:
+			values = _mm_loadu_si128((const __m128i*)Data);
+			break;
+		}
+
+		_mm_storeu_si128((__m128i*)(Plane + g * GROUP_SIZE), values);
+		Data += GroupBytes[code];
+	}
+}
+
+static inline __m128i Sse2UnZigZag(__m128i Value, uint32_t ElementSize)
+{
+	if (ElementSize == 2)
+		return _mm_xor_si128(_mm_srli_epi16(Value, 1), _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(Value, _mm_set1_epi16(1))));
+
+	return _mm_xor_si128(_mm_srli_epi32(Value, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(Value, _mm_set1_epi32(1))));
+}
+
+static inline __m128i Sse2Add(__m128i A, __m128i B, uint32_t ElementSize)
+{
+	return ElementSize == 2 ? _mm_add_epi16(A, B) : _mm_add_epi32(A, B);
+}
+
+//the record (Stride elements) sizes the sse paths handle: whole vectors behind, or a power of two inside one
+static inline bool Sse2RecordSupported(uint32_t RecordSize)
+{
+	return RecordSize >= 16 || RecordSize == 2 || RecordSize == 4 || RecordSize == 8;
+}
+
+//adds the previous record to 16 bytes of residuals and stores them. records smaller than a vector are
+//summed inside the register first, then the last decoded record is broadcast and added to every copy
+static inline void Sse2StoreDelta(__m128i Value, uint8_t* Out, uint32_t ElementSize, uint32_t RecordSize)
+{
+	if (RecordSize >= 16)
+	{
+		Value = Sse2Add(Value, _mm_loadu_si128((const __m128i*)(Out - RecordSize)), ElementSize);
+	}
+	else
+	{
+		__m128i previous;
+
+		switch (RecordSize)
+		{
+		case 2:
+		{
+			uint16_t last;
+			memcpy(&last, Out - 2, sizeof(last));
+			Value = _mm_add_epi16(Value, _mm_slli_si128(Value, 2));
+			previous = _mm_set1_epi16((short)last);
+			break;
+		}
+		case 4:
+		{
+			int32_t last;
+			memcpy(&last, Out - 4, sizeof(last));
+			previous = _mm_set1_epi32(last);
+			break;
+		}
+		default:
+			previous = _mm_loadl_epi64((const __m128i*)(Out - 8));
+			previous = _mm_unpacklo_epi64(previous, previous);
+			break;
+		}
+
+		if (RecordSize <= 4)
+			Value = Sse2Add(Value, _mm_slli_si128(Value, 4), ElementSize);
+
+		Value = Sse2Add(Value, _mm_slli_si128(Value, 8), ElementSize);
+		Value = Sse2Add(Value, previous, ElementSize);
+	}
+
+	_mm_storeu_si128((__m128i*)Out, Value);
+}
+
+//24 byte records (position + normal vertices, cull data) straddle vectors, and reloading them from memory
+//would stall on store forwarding, so the last two output vectors stay in registers instead
+static inline void Sse2StoreDelta24(__m128i Value, uint8_t* Out, uint32_t ElementSize, __m128i History[2])
+{
+	const __m128i previous = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(History[0]), _mm_castsi128_pd(History[1]), 1));
+	Value = Sse2Add(Value, previous, ElementSize);
+	_mm_storeu_si128((__m128i*)Out, Value);
+
+	History[0] = History[1];
+	History[1] = Value;
+}
+
+static inline void Sse2Store(__m128i Value, uint8_t* Out, uint32_t ElementSize, uint32_t RecordSize, __m128i History[2])
+{
+	if (RecordSize == 24)
+		Sse2StoreDelta24(Value, Out, ElementSize, History);
+	else
+		Sse2StoreDelta(Value, Out, ElementSize, RecordSize);
+}
+
+//elements that have no full record behind them, or that the vector path can't take, go through the scalar loop
+static uint32_t ScalarPrologue(size_t Stride, size_t Before, uint32_t Count)
+{
+	return Before >= Stride ? 0 : (uint32_t)(Stride - Before < Count ? Stride - Before : Count);
+}
+
+static void Sse2Reconstruct(uint8_t (*Planes)[MESH_CODEC_BLOCK_SIZE], uint32_t ElementSize, size_t Stride, uint32_t Count, size_t Before, uint8_t* Out)
+{
+	const size_t recordSize = Stride * ElementSize;
+
+	if (recordSize < 16 && !Sse2RecordSupported((uint32_t)recordSize))
+	{
+		ScalarReconstruct(Planes, ElementSize, Stride, Count, Before, Out);
+		return;
+	}
+
+	const uint32_t record = (uint32_t)recordSize;
+
+	//the register history needs two whole vectors behind the first one
+	const uint32_t prologue = ScalarPrologue(record == 24 ? 32 / ElementSize : Stride, Before, Count);
+	ScalarReconstruct(Planes, ElementSize, Stride, prologue, Before, Out);
+
+	uint32_t j = prologue;
+	__m128i history[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+
+	if (record == 24 && j + 16 <= Count)
+	{
+		history[0] = _mm_loadu_si128((const __m128i*)(Out + (size_t)j * ElementSize - 32));
+		history[1] = _mm_loadu_si128((const __m128i*)(Out + (size_t)j * ElementSize - 16));
+	}
+
+	for (; j + 16 <= Count; j += 16)
+	{
+		uint8_t* out = Out + (size_t)j * ElementSize;
+		const __m128i p0 = _mm_loadu_si128((const __m128i*)(Planes[0] + j));
+		const __m128i p1 = _mm_loadu_si128((const __m128i*)(Planes[1] + j));
+
+		if (ElementSize == 2)
+		{
+			Sse2Store(Sse2UnZigZag(_mm_unpacklo_epi8(p0, p1), 2), out, 2, record, history);
+			Sse2Store(Sse2UnZigZag(_mm_unpackhi_epi8(p0, p1), 2), out + 16, 2, record, history);
+		}
+		else
+		{
+			const __m128i p2 = _mm_loadu_si128((const __m128i*)(Planes[2] + j));
+			const __m128i p3 = _mm_loadu_si128((const __m128i*)(Planes[3] + j));
+
+			const __m128i lo01 = _mm_unpacklo_epi8(p0, p1);
+			const __m128i hi01 = _mm_unpackhi_epi8(p0, p1);
+			const __m128i lo23 = _mm_unpacklo_epi8(p2, p3);
+			const __m128i hi23 = _mm_unpackhi_epi8(p2, p3);
+
+			Sse2Store(Sse2UnZigZag(_mm_unpacklo_epi16(lo01, lo23), 4), out, 4, record, history);
+			Sse2Store(Sse2UnZigZag(_mm_unpackhi_epi16(lo01, lo23), 4), out + 16, 4, record, history);
+			Sse2Store(Sse2UnZigZag(_mm_unpacklo_epi16(hi01, hi23), 4), out + 32, 4, record, history);
+			Sse2Store(Sse2UnZigZag(_mm_unpackhi_epi16(hi01, hi23), 4), out + 48, 4, record, history);
+		}
+	}
+
+	if (j < Count)
+	{
+		uint8_t tail[4][MESH_CODEC_BLOCK_SIZE];
+
+		for (uint32_t p = 0; p < ElementSize; p++)
+			memcpy(tail[p], Planes[p] + j, Count - j);
+
+		ScalarReconstruct(tail, ElementSize, Stride, Count - j, Before + j, Out + (size_t)j * ElementSize);
+	}
+}
+
+//two triangles per 64 bit lane pair: madd folds field pairs into 20 bit halves, the shift joins them
+static void Sse2PackTriangles(const uint16_t* Fields, uint32_t TriangleCount, uint8_t* Out)
+{
+	const __m128i fieldMask = _mm_setr_epi16(0x3FF, 0x3FF, 0x3FF, 3, 0x3FF, 0x3FF, 0x3FF, 3);
+	const __m128i fieldScale = _mm_setr_epi16(1, 1 << 10, 1, 1 << 10, 1, 1 << 10, 1, 1 << 10);
+
+	uint32_t t = 0;
+
+	for (; t + 4 <= TriangleCount; t += 4)
+	{
+		__m128i words[2];
+
+		for (uint32_t h = 0; h < 2; h++)
+		{
+			const __m128i fields = _mm_and_si128(_mm_loadu_si128((const __m128i*)(Fields + (t + h * 2) * TRIANGLE_FIELDS)), fieldMask);
+			const __m128i halves = _mm_madd_epi16(fields, fieldScale);
+			const __m128i joined = _mm_add_epi32(halves, _mm_slli_epi32(_mm_srli_epi64(halves, 32), 20));
+			words[h] = _mm_shuffle_epi32(joined, _MM_SHUFFLE(3, 1, 2, 0));
+		}
+
+		_mm_storeu_si128((__m128i*)(Out + t * 4), _mm_unpacklo_epi64(words[0], words[1]));
+	}
+
+	ScalarPackTriangles(Fields + t * TRIANGLE_FIELDS, TriangleCount - t, Out + t * 4);
+}
+#endif
+
+#ifdef PLATFORM_AVX2
+static inline __m256i Avx2UnZigZag(__m256i Value, uint32_t ElementSize)
+{
+	if (ElementSize == 2)
+		return _mm256_xor_si256(_mm256_srli_epi16(Value, 1), _mm256_sub_epi16(_mm256_setzero_si256(), _mm256_and_si256(Value, _mm256_set1_epi16(1))));
+
+	return _mm256_xor_si256(_mm256_srli_epi32(Value, 1), _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(Value, _mm256_set1_epi32(1))));
+}
+
+//32 byte steps. records of at least 32 bytes are added a whole vector at a time, smaller ones go through the
+//sse delta on each half since the in-register prefix would have to cross the 128 bit lanes
+static inline void Avx2StoreDelta(__m256i Value, uint8_t* Out, uint32_t ElementSize, uint32_t RecordSize, __m128i History[2])
+{
+	if (RecordSize >= 32)
+	{
+		const __m256i previous = _mm256_loadu_si256((const __m256i*)(Out - RecordSize));
+		Value = ElementSize == 2 ? _mm256_add_epi16(Value, previous) : _mm256_add_epi32(Value, previous);
+		_mm256_storeu_si256((__m256i*)Out, Value);
+		return;
+	}
+
+	Sse2Store(_mm256_castsi256_si128(Value), Out, ElementSize, RecordSize, History);
+	Sse2Store(_mm256_extracti128_si256(Value, 1), Out + 16, ElementSize, RecordSize, History);
+}
+
+static void Avx2Reconstruct(uint8_t (*Planes)[MESH_CODEC_BLOCK_SIZE], uint32_t ElementSize, size_t Stride, uint32_t Count, size_t Before, uint8_t* Out)
+{
+	const size_t recordSize = Stride * ElementSize;
+
+	if (recordSize < 16 && !Sse2RecordSupported((uint32_t)recordSize))
+	{
+		ScalarReconstruct(Planes, ElementSize, Stride, Count, Before, Out);
+		return;
+	}
+
+	const uint32_t record = (uint32_t)recordSize;
+
+	const uint32_t prologue = ScalarPrologue(record == 24 ? 32 / ElementSize : Stride, Before, Count);
+	ScalarReconstruct(Planes, ElementSize, Stride, prologue, Before, Out);
+
+	uint32_t j = prologue;
+	__m128i history[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+
+	if (record == 24 && j + 32 <= Count)
+	{
+		history[0] = _mm_loadu_si128((const __m128i*)(Out + (size_t)j * ElementSize - 32));
+		history[1] = _mm_loadu_si128((const __m128i*)(Out + (size_t)j * ElementSize - 16));
+	}
+
+	for (; j + 32 <= Count; j += 32)
+	{
+		uint8_t* out = Out + (size_t)j * ElementSize;
+		const __m256i p0 = _mm256_loadu_si256((const __m256i*)(Planes[0] + j));
+		const __m256i p1 = _mm256_loadu_si256((const __m256i*)(Planes[1] + j));
+
+		//unpacks work per 128 bit lane, so the halves come out as [0-7 | 16-23] and [8-15 | 24-31]
+		const __m256i lo01 = _mm256_unpacklo_epi8(p0, p1);
+		const __m256i hi01 = _mm256_unpackhi_epi8(p0, p1);
+
+		if (ElementSize == 2)
+		{
+			Avx2StoreDelta(Avx2UnZigZag(_mm256_permute2x128_si256(lo01, hi01, 0x20), 2), out, 2, record, history);
+			Avx2StoreDelta(Avx2UnZigZag(_mm256_permute2x128_si256(lo01, hi01, 0x31), 2), out + 32, 2, record, history);
+		}
+		else
+		{
+			const __m256i p2 = _mm256_loadu_si256((const __m256i*)(Planes[2] + j));
+			const __m256i p3 = _mm256_loadu_si256((const __m256i*)(Planes[3] + j));
+
+			const __m256i lo23 = _mm256_unpacklo_epi8(p2, p3);
+			const __m256i hi23 = _mm256_unpackhi_epi8(p2, p3);
+
+			//[0-3 | 16-19], [4-7 | 20-23], [8-11 | 24-27], [12-15 | 28-31]
+			const __m256i a = _mm256_unpacklo_epi16(lo01, lo23);
+			const __m256i b = _mm256_unpackhi_epi16(lo01, lo23);
+			const __m256i c = _mm256_unpacklo_epi16(hi01, hi23);
+			const __m256i d = _mm256_unpackhi_epi16(hi01, hi23);
+
+			Avx2StoreDelta(Avx2UnZigZag(_mm256_permute2x128_si256(a, b, 0x20), 4), out, 4, record, history);
+			Avx2StoreDelta(Avx2UnZigZag(_mm256_permute2x128_si256(c, d, 0x20), 4), out + 32, 4, record, history);
+			Avx2StoreDelta(Avx2UnZigZag(_mm256_permute2x128_si256(a, b, 0x31), 4), out + 64, 4, record, history);
+			Avx2StoreDelta(Avx2UnZigZag(_mm256_permute2x128_si256(c, d, 0x31), 4), out + 96, 4, record, history);
+		}
+	}
+
+	if (j < Count)
+	{
+		uint8_t tail[4][MESH_CODEC_BLOCK_SIZE];
+
+		for (uint32_t p = 0; p < ElementSize; p++)
+			memcpy(tail[p], Planes[p] + j, Count - j);
+
+		Sse2Reconstruct(tail, ElementSize, Stride, Count - j, Before + j, Out + (size_t)j * ElementSize);
+	}
+}
+#endif
+
+bool MeshCodecDecode(const struct MeshCodecFormat* Format, const void* Encoded, size_t EncodedSize, void* Out, size_t Size, enum SimdLevel Kernel)
+{
+	if (!MeshCodecFormatValid(Format, Size))
+		return false;
+
+	if (Format->Filter == MESH_CODEC_FILTER_RAW)
+	{
+		if (EncodedSize != Size)
+			return false;
+
+		if (Size)
+			memcpy(Out, Encoded, Size);
+
+		return true;
+	}
+
+	void (*unpackPlane)(const uint8_t*, uint32_t, const uint8_t*, uint8_t*) = ScalarUnpackPlane;
+	void (*reconstruct)(uint8_t (*)[MESH_CODEC_BLOCK_SIZE], uint32_t, size_t, uint32_t, size_t, uint8_t*) = ScalarReconstruct;
+	void (*packTriangles)(const uint16_t*, uint32_t, uint8_t*) = ScalarPackTriangles;
+
+	switch (Kernel)
+	{
+#ifdef PLATFORM_AVX2
+	case SIMD_LEVEL_AVX2:
+		unpackPlane = Sse2UnpackPlane;
+		reconstruct = Avx2Reconstruct;
+		packTriangles = Sse2PackTriangles;
+		break;
+#endif
+#ifdef PLATFORM_SSE2
+	case SIMD_LEVEL_SSE2:
+		unpackPlane = Sse2UnpackPlane;
+		reconstruct = Sse2Reconstruct;
+		packTriangles = Sse2PackTriangles;
+		break;
+#endif
+	default:
+		break;
+	}
+
+	const uint32_t elementSize = CodedElementSize(Format);
+	const size_t stride = CodedStride(Format);
+	const size_t count = CodedElementCount(Format, Size);
+	const bool bTriangles = Format->Filter == MESH_CODEC_FILTER_TRIANGLES;
+
+	const uint8_t* read = Encoded;
+	const uint8_t* const end = read + EncodedSize;
+
+	uint8_t planes[4][MESH_CODEC_BLOCK_SIZE];
+
+	//triangle fields are decoded here with the previous block's last triangle in front, then packed into Out
+	uint16_t fields[TRIANGLE_FIELDS + MESH_CODEC_BLOCK_SIZE] = { 0 };
+
+	for (size_t begin = 0; begin < count; begin += MESH_CODEC_BLOCK_SIZE)
+	{
+		const uint32_t blockCount = (uint32_t)(count - begin < MESH_CODEC_BLOCK_SIZE ? count - begin : MESH_CODEC_BLOCK_SIZE);
+		const uint32_t groupCount = (blockCount + GROUP_SIZE - 1) / GROUP_SIZE;
+		const uint32_t headerSize = (groupCount + 3) / 4;
+
+		for (uint32_t p = 0; p < elementSize; p++)
+		{
+			if ((size_t)(end - read) < headerSize)
+				return false;
+
+			const uint8_t* header = read;
+			read += headerSize;
+
+			const size_t dataSize = PlaneDataSize(header, groupCount);
+
+			if ((size_t)(end - read) < dataSize)
+				return false;
+
+			unpackPlane(header, groupCount, read, planes[p]);
+			read += dataSize;
+		}
+
+		if (bTriangles)
+		{
+			reconstruct(planes, elementSize, stride, blockCount, TRIANGLE_FIELDS, (uint8_t*)(fields + TRIANGLE_FIELDS));
+			packTriangles(fields + TRIANGLE_FIELDS, blockCount / TRIANGLE_FIELDS, (uint8_t*)Out + begin / TRIANGLE_FIELDS * 4);
+			memcpy(fields, fields + blockCount, sizeof(uint16_t) * TRIANGLE_FIELDS);
+		}
+		else
+		{
+			reconstruct(planes, elementSize, stride, blockCount, begin, (uint8_t*)Out + begin * elementSize);
+		}
+	}
+
+	return read == end;
+}
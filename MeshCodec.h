@@ -0,0 +1,62 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "Platform.h"
+#include "MeshFile.h"
+
+//lossless stream codec for the MSHL buffer streams.
+//a stream is an array of ElementSize (2 or 4) byte elements. each element is predicted from the one Stride
+//elements before it (the same field of the previous record), the residual is zigzagged and split into byte
+//planes, and every plane is bit packed in groups of 16 bytes at the smallest of 0/2/4/8 bits that holds the
+//whole group. the encoding is exact for any bit pattern, floats included
+
+//elements per block; the decoder keeps one block of planes on the stack
+#define MESH_CODEC_BLOCK_SIZE 1024
+
+enum MeshCodecFilter
+{
+	MESH_CODEC_FILTER_RAW,//stored as is
+	MESH_CODEC_FILTER_DELTA,
+	MESH_CODEC_FILTER_TRIANGLES,//PackedTriangle words, split into four 16 bit fields before the delta
+	MESH_CODEC_FILTER_COUNT
+};
+
+struct MeshCodecFormat
+{
+	uint32_t Filter;
+	uint32_t ElementSize;//2 or 4, ignored by MESH_CODEC_FILTER_RAW
+	uint32_t Stride;//in elements, >= 1
+};
+
+//the format an MSHL stream is coded with: every element is predicted from the same field of the previous record
+struct MeshCodecFormat MeshCodecStreamFormat(const struct Mesh* Mesh, enum MeshStream Stream);
+
+//false if Size doesn't fit the format
+bool MeshCodecFormatValid(const struct MeshCodecFormat* Format, size_t Size);
+
+//worst case encoded size of Size bytes
+size_t MeshCodecBound(size_t Size);
+
+//Out must hold MeshCodecBound(Size) bytes. returns the encoded size
+size_t MeshCodecEncode(const struct MeshCodecFormat* Format, const void* Data, size_t Size, void* Out);
+
+//decodes exactly Size bytes. returns false if Encoded is malformed or isn't exactly EncodedSize bytes long
+bool MeshCodecDecode(const struct MeshCodecFormat* Format, const void* Encoded, size_t EncodedSize, void* Out, size_t Size, enum SimdLevel Kernel);
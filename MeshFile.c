@@ -0,0 +1,1240 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 200809L
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "MeshFile.h"
+#include "MeshCodec.h"
+
+#define OffsetPointer(x, offset) ((const void*)((const char*)(x) + (offset)))
+
+struct FileHeader
+{
+	uint32_t Prolog;
+	uint32_t Version;
+	uint32_t MeshCount;
+	uint32_t AccessorCount;
+	uint32_t BufferViewCount;
+	uint32_t BufferSize;
+};
+
+//blob versions only, straight after the FileHeader
+struct BlobHeader
+{
+	uint32_t BufferOffset;//from the start of the file, a multiple of MESHFILE_BUFFER_ALIGNMENT
+	uint32_t StreamAlignment;
+};
+
+struct MeshHeader
+{
+	uint32_t IndexBuffer;
+	uint32_t IndexSubsets;
+	uint32_t Attributes[ATTRIBUTE_TYPE_COUNT];
+	uint32_t Meshlets;
+	uint32_t MeshletSubsets;
+	uint32_t UniqueVertexIndices;
+	uint32_t PrimitiveIndices;
+	uint32_t CullData;
+};
+
+//blob versions only, one table of uint32_t per mesh after the MeshHeaders: where each stream starts inside the
+//buffer, so a loader can bind gpu addresses without walking accessors. FILE_VERSION_BLOB tables stop after the
+//vertex slots, FILE_VERSION_CLUSTERS and later ones hold every MeshStream
+#define BLOB_STREAM_COUNT MESH_STREAM_CLUSTER_LODS
+
+//FILE_VERSION_CLUSTERS and later, one per mesh after the stream tables; MESHFILE_ATTRIBUTE_NONE for meshes without a dag
+struct ClusterHeader
+{
+	uint32_t ClusterLods;
+	uint32_t ClusterRoots;
+};
+
+//FILE_VERSION_MESHLETS only, one per mesh after the cluster headers
+struct MeshletHeader
+{
+	uint32_t MaxVertices;
+	uint32_t MaxPrimitives;
+	uint32_t Flags;//MESHLET_FLAG_
+	uint32_t Reserved;//0
+};
+
+struct BufferView
+{
+	uint32_t Offset;
+	uint32_t Size;
+};
+
+//FILE_VERSION_COMPRESSED only: the blob metadata is kept as is (BlobHeader.BufferOffset and FileHeader.BufferSize
+//describe the decoded image), then one of these per buffer view, then the encoded views back to back. the upper
+//half of FileHeader.Version holds the decoded image's version, 0 for FILE_VERSION_BLOB
+struct CompressedView
+{
+	struct MeshCodecFormat Format;
+	uint32_t Offset;//from the end of the CompressedView table
+	uint32_t Size;
+};
+
+struct Accessor
+{
+	uint32_t BufferView;
+	uint32_t Offset;
+	uint32_t Size;
+	uint32_t Stride;
+	uint32_t Count;
+};
+
+static bool IsBlobVersion(uint32_t Version)
+{
+	return Version == FILE_VERSION_BLOB || Version == FILE_VERSION_CLUSTERS || Version == FILE_VERSION_MESHLETS;
+}
+
+//what a file's metadata is laid out as, which for compressed files is the version of the image they decode to
+static uint32_t ImageVersion(const struct FileHeader* Header)
+{
+	if ((Header->Version & 0xFFFF) != FILE_VERSION_COMPRESSED)
+		return Header->Version;
+
+	return (Header->Version >> 16) ? Header->Version >> 16 : FILE_VERSION_BLOB;
+}
+
+static uint32_t StreamTableCount(uint32_t Version)
+{
+	return Version == FILE_VERSION_CLUSTERS || Version == FILE_VERSION_MESHLETS ? MESH_STREAM_COUNT : BLOB_STREAM_COUNT;
+}
+
+//everything in front of the buffer section; compressed files keep the blob metadata as is
+static uint64_t MetadataSize(const struct FileHeader* Header)
+{
+	const uint32_t version = ImageVersion(Header);
+	const bool bBlob = version != FILE_VERSION_INITIAL;
+
+	return
+		sizeof(struct FileHeader) +
+		(bBlob ? sizeof(struct BlobHeader) + (uint64_t)Header->MeshCount * StreamTableCount(version) * sizeof(uint32_t) : 0) +
+		(StreamTableCount(version) == MESH_STREAM_COUNT ? (uint64_t)Header->MeshCount * sizeof(struct ClusterHeader) : 0) +
+		(version == FILE_VERSION_MESHLETS ? (uint64_t)Header->MeshCount * sizeof(struct MeshletHeader) : 0) +
+		(uint64_t)Header->MeshCount * sizeof(struct MeshHeader) +
+		(uint64_t)Header->AccessorCount * sizeof(struct Accessor) +
+		(uint64_t)Header->BufferViewCount * sizeof(struct BufferView);
+}
+
+//size each attribute occupies inside its vertex, matching the d3d12 input layout the renderer used to build
+static const uint32_t AttributeSizes[ATTRIBUTE_TYPE_COUNT] = { 12, 12, 8, 12, 12 };
+
+struct ParseContext
+{
+	const struct Accessor* Accessors;
+	uint32_t AccessorCount;
+	const struct BufferView* BufferViews;
+	uint32_t BufferViewCount;
+	const uint8_t* Buffer;
+	size_t BufferSize;
+};
+
+//resolves an accessor to the buffer view it reads from, rejecting anything that points outside the file
+static const struct BufferView* ResolveAccessor(const struct ParseContext* Context, uint32_t AccessorIndex, const struct Accessor** OutAccessor)
+{
+	if (AccessorIndex >= Context->AccessorCount)
+		return NULL;
+
+	const struct Accessor* accessor = &Context->Accessors[AccessorIndex];
+
+	if (accessor->BufferView >= Context->BufferViewCount)
+		return NULL;
+
+	const struct BufferView* view = &Context->BufferViews[accessor->BufferView];
+
+	if ((uint64_t)view->Offset + view->Size > Context->BufferSize)
+		return NULL;
+
+	*OutAccessor = accessor;
+	return view;
+}
+
+//records where a stream starts; blob files also have to agree with their stream table and alignment
+static bool RecordStream(struct Mesh* Mesh, const uint32_t* Streams, uint32_t Alignment, enum MeshStream Stream, const struct BufferView* View)
+{
+	Mesh->StreamOffsets[Stream] = View->Offset;
+
+	if (Streams == NULL)
+		return true;
+
+	return Streams[Stream] == View->Offset && View->Offset % Alignment == 0;
+}
+
+bool MeshFileValidateMesh(const struct Mesh* Mesh)
+{
+	//the shader variant is picked by the limits, so no meshlet may go past them
+	if (Mesh->MeshletMaxVertices != 0)
+	{
+		for (uint32_t j = 0; j < Mesh->MeshletCount; j++)
+		{
+			if (Mesh->Meshlets[j].VertCount > Mesh->MeshletMaxVertices || Mesh->Meshlets[j].PrimCount > Mesh->MeshletMaxPrimitives)
+				return false;
+		}
+	}
+
+	//without unique vertex indices the meshlets address the vertex buffers directly
+	if (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS)
+	{
+		for (uint32_t j = 0; j < Mesh->MeshletCount; j++)
+		{
+			if ((uint64_t)Mesh->Meshlets[j].VertOffset + Mesh->Meshlets[j].VertCount > Mesh->VertexCount)
+				return false;
+		}
+	}
+	else
+	{
+		const uint32_t UniqueIndexCount = Mesh->IndexSize == 2 || Mesh->IndexSize == 4 ? Mesh->UniqueVertexIndexCount / Mesh->IndexSize : 0;
+
+		for (uint32_t j = 0; j < Mesh->MeshletCount; j++)
+		{
+			if ((uint64_t)Mesh->Meshlets[j].VertOffset + Mesh->Meshlets[j].VertCount > UniqueIndexCount)
+				return false;
+		}
+
+		//the whole stream, which is no more than what the meshlets can reach
+		uint32_t Largest = 0;
+
+		if (Mesh->IndexSize == 2)
+		{
+			const uint16_t* Indices = (const uint16_t*)Mesh->UniqueVertexIndices;
+			for (uint32_t j = 0; j < UniqueIndexCount; j++)
+				Largest = Largest > Indices[j] ? Largest : Indices[j];
+		}
+		else
+		{
+			const uint32_t* Indices = (const uint32_t*)Mesh->UniqueVertexIndices;
+			for (uint32_t j = 0; j < UniqueIndexCount; j++)
+				Largest = Largest > Indices[j] ? Largest : Indices[j];
+		}
+
+		if (UniqueIndexCount != 0 && Largest >= Mesh->VertexCount)
+			return false;
+	}
+
+	//local indices stay inside their meshlet's vertices, so the ranges above cover every vertex a triangle reads
+	for (uint32_t j = 0; j < Mesh->MeshletCount; j++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[j];
+
+		if ((uint64_t)Meshlet->PrimOffset + Meshlet->PrimCount > Mesh->PrimitiveIndexCount)
+			return false;
+
+		//the largest local index of the meshlet, each triangle read as the word the shader unpacks so the loop vectorizes
+		uint32_t Largest = 0;
+
+		for (uint32_t k = 0; k < Meshlet->PrimCount; k++)
+		{
+			uint32_t Word;
+			memcpy(&Word, &Mesh->PrimitiveIndices[Meshlet->PrimOffset + k], sizeof(Word));
+
+			const uint32_t i0 = Word & 0x3FF;
+			const uint32_t i1 = (Word >> 10) & 0x3FF;
+			const uint32_t i2 = (Word >> 20) & 0x3FF;
+			const uint32_t Max = i0 > i1 ? i0 : i1;
+			Largest = Largest > Max ? Largest : Max;
+			Largest = Largest > i2 ? Largest : i2;
+		}
+
+		if (Meshlet->PrimCount != 0 && Largest >= Meshlet->VertCount)
+			return false;
+	}
+
+	for (uint32_t j = 0; j < Mesh->MeshletSubsetCount; j++)
+	{
+		if ((uint64_t)Mesh->MeshletSubsets[j].Offset + Mesh->MeshletSubsets[j].Count > Mesh->MeshletCount)
+			return false;
+	}
+
+	//a cut walks from the roots through child ranges, so all of them have to stay inside the meshlets
+	for (uint32_t j = 0; j < Mesh->ClusterLodCount; j++)
+	{
+		if ((uint64_t)Mesh->ClusterLods[j].ChildOffset + Mesh->ClusterLods[j].ChildCount > Mesh->MeshletCount)
+			return false;
+	}
+
+	for (uint32_t j = 0; j < Mesh->ClusterRootCount; j++)
+	{
+		if ((uint64_t)Mesh->ClusterRoots[j].Offset + Mesh->ClusterRoots[j].Count > Mesh->MeshletCount)
+			return false;
+	}
+
+	return true;
+}
+
+//bContents = false skips every check that reads inside the buffer section, for images still being streamed in
+static enum MeshFileResult ParseMeshFile(const void* Data, size_t Size, struct MeshFile* File, bool bContents)
+{
+	File->Data = Data;
+	File->Size = Size;
+	File->MeshList = NULL;
+	File->MeshCount = 0;
+
+	if (Size < sizeof(struct FileHeader))
+		return MESHFILE_ERROR_TRUNCATED;
+
+	const void* readPointer = Data;
+	const struct FileHeader* header = readPointer;
+	readPointer = OffsetPointer(readPointer, sizeof(struct FileHeader));
+
+	if (header->Prolog != MESHFILE_PROLOG)
+		return MESHFILE_ERROR_PROLOG; // Incorrect file format.
+
+	if (header->Version != FILE_VERSION_INITIAL && !IsBlobVersion(header->Version))
+		return MESHFILE_ERROR_VERSION; // Version mismatch between export and import serialization code.
+
+	const bool bBlob = IsBlobVersion(header->Version);
+	const uint32_t streamCount = StreamTableCount(header->Version);
+
+	const uint64_t metadataSize = MetadataSize(header);
+
+	if (metadataSize + header->BufferSize > Size)
+		return MESHFILE_ERROR_TRUNCATED;
+
+	const struct BlobHeader* blob = NULL;
+	if (bBlob)
+	{
+		blob = readPointer;
+		readPointer = OffsetPointer(readPointer, sizeof(struct BlobHeader));
+
+		if (blob->BufferOffset < metadataSize || (uint64_t)blob->BufferOffset + header->BufferSize > Size ||
+			blob->StreamAlignment == 0 || blob->StreamAlignment % MESHFILE_STREAM_ALIGNMENT != 0 || blob->BufferOffset % blob->StreamAlignment != 0)
+			return MESHFILE_ERROR_TRUNCATED;
+	}
+
+	// Read mesh metdata
+	const struct MeshHeader* meshes = readPointer;
+	readPointer = OffsetPointer(readPointer, header->MeshCount * sizeof(meshes[0]));
+
+	const uint32_t* streams = NULL;
+	if (bBlob)
+	{
+		streams = readPointer;
+		readPointer = OffsetPointer(readPointer, (size_t)header->MeshCount * streamCount * sizeof(streams[0]));
+	}
+
+	const struct ClusterHeader* clusters = NULL;
+	if (streamCount == MESH_STREAM_COUNT)
+	{
+		clusters = readPointer;
+		readPointer = OffsetPointer(readPointer, header->MeshCount * sizeof(clusters[0]));
+	}
+
+	const struct MeshletHeader* meshletHeaders = NULL;
+	if (header->Version == FILE_VERSION_MESHLETS)
+	{
+		meshletHeaders = readPointer;
+		readPointer = OffsetPointer(readPointer, header->MeshCount * sizeof(meshletHeaders[0]));
+	}
+
+	struct ParseContext context = { 0 };
+
+	context.Accessors = readPointer;
+	context.AccessorCount = header->AccessorCount;
+	readPointer = OffsetPointer(readPointer, header->AccessorCount * sizeof(context.Accessors[0]));
+
+	context.BufferViews = readPointer;
+	context.BufferViewCount = header->BufferViewCount;
+	readPointer = OffsetPointer(readPointer, header->BufferViewCount * sizeof(context.BufferViews[0]));
+
+	context.Buffer = bBlob ? OffsetPointer(Data, blob->BufferOffset) : readPointer;
+	context.BufferSize = header->BufferSize;
+
+	File->Version = header->Version;
+	File->Buffer = context.Buffer;
+	File->BufferSize = header->BufferSize;
+
+	File->MeshList = calloc(header->MeshCount ? header->MeshCount : 1, sizeof(struct Mesh));
+
+	if (File->MeshList == NULL)
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+
+	File->MeshCount = header->MeshCount;
+
+	const uint32_t alignment = bBlob ? blob->StreamAlignment : 1;
+
+	// Populate mesh data from binary data and metadata.
+	for (uint32_t i = 0; i < header->MeshCount; i++)
+	{
+		struct Mesh* mesh = &File->MeshList[i];
+		const uint32_t* meshStreams = bBlob ? &streams[(size_t)i * streamCount] : NULL;
+		const struct Accessor* accessor;
+		const struct BufferView* view;
+
+		for (uint32_t j = 0; j < MESH_STREAM_COUNT; j++)
+			mesh->StreamOffsets[j] = MESHFILE_ATTRIBUTE_NONE;
+
+		// Index data
+		if ((view = ResolveAccessor(&context, meshes[i].IndexBuffer, &accessor)) == NULL || (accessor->Size != 2 && accessor->Size != 4) ||
+			(uint64_t)accessor->Count * accessor->Size > view->Size || !RecordStream(mesh, meshStreams, alignment, MESH_STREAM_INDICES, view))
+			goto truncated;
+
+		mesh->IndexSize = accessor->Size;
+		mesh->IndexCount = accessor->Count;
+		mesh->IndexBuffer = OffsetPointer(context.Buffer, view->Offset);
+		mesh->IndexBufferSize = view->Size;
+
+		// Index Subset data
+		if ((view = ResolveAccessor(&context, meshes[i].IndexSubsets, &accessor)) == NULL || (uint64_t)accessor->Count * sizeof(struct Subset) > view->Size ||
+			!RecordStream(mesh, meshStreams, alignment, MESH_STREAM_INDEX_SUBSETS, view))
+			goto truncated;
+
+		mesh->IndexSubsets = OffsetPointer(context.Buffer, view->Offset);
+		mesh->IndexSubsetCount = accessor->Count;
+
+		// Vertex data & layout metadata
+
+		// Determine the number of unique Buffer Views associated with the vertex attributes.
+		uint32_t vbMap[ATTRIBUTE_TYPE_COUNT];
+		uint32_t vbOffsets[ATTRIBUTE_TYPE_COUNT] = { 0 };
+
+		for (uint32_t j = 0; j < ATTRIBUTE_TYPE_COUNT; j++)
+		{
+			mesh->AttributeSlots[j] = MESHFILE_ATTRIBUTE_NONE;
+			mesh->AttributeOffsets[j] = MESHFILE_ATTRIBUTE_NONE;
+
+			if (meshes[i].Attributes[j] == MESHFILE_ATTRIBUTE_NONE)
+				continue;
+
+			if ((view = ResolveAccessor(&context, meshes[i].Attributes[j], &accessor)) == NULL || accessor->Stride == 0)
+				goto truncated;
+
+			uint32_t slot = 0;
+			while (slot < mesh->VertexBufferCount && vbMap[slot] != accessor->BufferView)
+				slot++;
+
+			if (slot == mesh->VertexBufferCount)
+			{
+				// New buffer view encountered; add to list
+				vbMap[slot] = accessor->BufferView;
+
+				struct VertexBuffer* verts = &mesh->VertexBuffers[slot];
+				verts->Verts = OffsetPointer(context.Buffer, view->Offset);
+				verts->Size = view->Size;
+				verts->Stride = accessor->Stride;
+
+				mesh->VertexBufferCount++;
+				mesh->VertexCount = verts->Size / verts->Stride;
+
+				if (!RecordStream(mesh, meshStreams, alignment, MESH_STREAM_VERTICES + slot, view))
+					goto truncated;
+			}
+
+			mesh->AttributeSlots[j] = slot;
+
+			if (bBlob)
+			{
+				// Blob files store each attribute's offset explicitly.
+				if ((uint64_t)accessor->Offset + AttributeSizes[j] > accessor->Stride)
+					goto truncated;
+
+				mesh->AttributeOffsets[j] = accessor->Offset;
+			}
+			else
+			{
+				// Attributes sharing a buffer view are laid out back to back, like D3D12_APPEND_ALIGNED_ELEMENT.
+				mesh->AttributeOffsets[j] = vbOffsets[slot];
+				vbOffsets[slot] += AttributeSizes[j];
+			}
+		}
+
+		// Meshlet data
+		if ((view = ResolveAccessor(&context, meshes[i].Meshlets, &accessor)) == NULL || (uint64_t)accessor->Count * sizeof(struct Meshlet) > view->Size ||
+			!RecordStream(mesh, meshStreams, alignment, MESH_STREAM_MESHLETS, view))
+			goto truncated;
+
+		mesh->Meshlets = OffsetPointer(context.Buffer, view->Offset);
+		mesh->MeshletCount = accessor->Count;
+
+		// Meshlet Subset data
+		if ((view = ResolveAccessor(&context, meshes[i].MeshletSubsets, &accessor)) == NULL || (uint64_t)accessor->Count * sizeof(struct Subset) > view->Size ||
+			!RecordStream(mesh, meshStreams, alignment, MESH_STREAM_MESHLET_SUBSETS, view))
+			goto truncated;
+
+		mesh->MeshletSubsets = OffsetPointer(context.Buffer, view->Offset);
+		mesh->MeshletSubsetCount = accessor->Count;
+
+		// Unique Vertex Index data
+		if ((view = ResolveAccessor(&context, meshes[i].UniqueVertexIndices, &accessor)) == NULL || !RecordStream(mesh, meshStreams, alignment, MESH_STREAM_UNIQUE_VERTEX_INDICES, view))
+			goto truncated;
+
+		mesh->UniqueVertexIndices = OffsetPointer(context.Buffer, view->Offset);
+		mesh->UniqueVertexIndexCount = view->Size;
+
+		// Primitive Index data
+		if ((view = ResolveAccessor(&context, meshes[i].PrimitiveIndices, &accessor)) == NULL || (uint64_t)accessor->Count * sizeof(struct PackedTriangle) > view->Size ||
+			!RecordStream(mesh, meshStreams, alignment, MESH_STREAM_PRIMITIVE_INDICES, view))
+			goto truncated;
+
+		mesh->PrimitiveIndices = OffsetPointer(context.Buffer, view->Offset);
+		mesh->PrimitiveIndexCount = accessor->Count;
+
+		// Cull data
+		if ((view = ResolveAccessor(&context, meshes[i].CullData, &accessor)) == NULL || (uint64_t)accessor->Count * sizeof(struct CullData) > view->Size ||
+			!RecordStream(mesh, meshStreams, alignment, MESH_STREAM_CULL_DATA, view))
+			goto truncated;
+
+		mesh->CullingData = OffsetPointer(context.Buffer, view->Offset);
+		mesh->CullingDataCount = accessor->Count;
+
+		// Cluster lod dag
+		if (clusters != NULL && clusters[i].ClusterLods != MESHFILE_ATTRIBUTE_NONE)
+		{
+			if ((view = ResolveAccessor(&context, clusters[i].ClusterLods, &accessor)) == NULL || (uint64_t)accessor->Count * sizeof(struct ClusterLod) > view->Size ||
+				!RecordStream(mesh, meshStreams, alignment, MESH_STREAM_CLUSTER_LODS, view))
+				goto truncated;
+
+			mesh->ClusterLods = OffsetPointer(context.Buffer, view->Offset);
+			mesh->ClusterLodCount = accessor->Count;
+
+			if ((view = ResolveAccessor(&context, clusters[i].ClusterRoots, &accessor)) == NULL || (uint64_t)accessor->Count * sizeof(struct Subset) > view->Size ||
+				!RecordStream(mesh, meshStreams, alignment, MESH_STREAM_CLUSTER_ROOTS, view))
+				goto truncated;
+
+			mesh->ClusterRoots = OffsetPointer(context.Buffer, view->Offset);
+			mesh->ClusterRootCount = accessor->Count;
+
+			if (mesh->ClusterLodCount != mesh->MeshletCount)
+				goto truncated;
+		}
+
+		// Meshlet limits
+		if (meshletHeaders != NULL)
+		{
+			const struct MeshletHeader* limits = &meshletHeaders[i];
+
+			if (limits->MaxVertices < 3 || limits->MaxVertices > MESHLET_MAX_VERTICES_LIMIT || limits->MaxPrimitives < 1 || limits->MaxPrimitives > MESHLET_MAX_PRIMITIVES_LIMIT ||
+				(limits->Flags & ~MESHLET_FLAG_INDEXLESS) != 0)
+				goto truncated;
+
+			mesh->MeshletMaxVertices = limits->MaxVertices;
+			mesh->MeshletMaxPrimitives = limits->MaxPrimitives;
+			mesh->MeshletFlags = limits->Flags;
+
+			if ((mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS) && mesh->UniqueVertexIndexCount != 0)
+				goto truncated;
+		}
+
+		// The culler indexes CullingData by meshlet index, so every subset has to stay inside both arrays.
+		if (mesh->CullingDataCount != mesh->MeshletCount || (bContents && !MeshFileValidateMesh(mesh)))
+			goto truncated;
+	}
+
+	return MESHFILE_OK;
+
+truncated:
+	free(File->MeshList);
+	File->MeshList = NULL;
+	File->MeshCount = 0;
+	return MESHFILE_ERROR_TRUNCATED;
+}
+
+//replaces whatever File holds with Image, which File then owns. Image is freed on failure
+static enum MeshFileResult AdoptImage(void* Image, size_t ImageSize, struct MeshFile* File)
+{
+	MeshFileClose(File);
+
+	enum MeshFileResult Result = ParseMeshFile(Image, ImageSize, File, true);
+
+	if (Result != MESHFILE_OK)
+	{
+		free(Image);
+		memset(File, 0, sizeof(*File));
+		return Result;
+	}
+
+	File->bOwned = true;
+	return MESHFILE_OK;
+}
+
+static bool IsCompressed(const void* Data, size_t Size)
+{
+	const struct FileHeader* header = Data;
+	return Size >= sizeof(struct FileHeader) && header->Prolog == MESHFILE_PROLOG && (header->Version & 0xFFFF) == FILE_VERSION_COMPRESSED;
+}
+
+static enum MeshFileResult OpenCompressed(const void* Data, size_t Size, struct MeshFile* File)
+{
+	void* image;
+	size_t imageSize;
+
+	enum MeshFileResult Result = MeshFileDecompress(Data, Size, PlatformSimdBest(), &image, &imageSize);
+
+	if (Result != MESHFILE_OK)
+		return Result;
+
+	Result = AdoptImage(image, imageSize, File);
+
+	if (Result == MESHFILE_OK)
+		File->bCompressed = true;
+
+	return Result;
+}
+
+enum MeshFileResult MeshFileParse(const void* Data, size_t Size, struct MeshFile* File)
+{
+	memset(File, 0, sizeof(*File));
+
+	if (IsCompressed(Data, Size))
+		return OpenCompressed(Data, Size, File);
+
+	return ParseMeshFile(Data, Size, File, true);
+}
+
+uint64_t MeshFileLayoutSize(const void* Data, size_t Size)
+{
+	const struct FileHeader* header = Data;
+
+	if (Size < sizeof(struct FileHeader))
+		return sizeof(struct FileHeader);
+
+	if (header->Prolog != MESHFILE_PROLOG || (header->Version != FILE_VERSION_INITIAL && !IsBlobVersion(header->Version)))
+		return 0;
+
+	return MetadataSize(header);
+}
+
+enum MeshFileResult MeshFileParseLayout(const void* Data, size_t Size, struct MeshFile* File)
+{
+	memset(File, 0, sizeof(*File));
+
+	if (IsCompressed(Data, Size))
+		return MESHFILE_ERROR_VERSION;
+
+	return ParseMeshFile(Data, Size, File, false);
+}
+
+enum MeshFileResult MeshFileOpen(const char* Path, struct MeshFile* File)
+{
+	memset(File, 0, sizeof(*File));
+
+#ifdef _WIN32
+	wchar_t WidePath[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, Path, -1, WidePath, MAX_PATH) == 0)
+		return MESHFILE_ERROR_OPEN;
+
+	HANDLE AssetDataFile = CreateFileW(WidePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (AssetDataFile == INVALID_HANDLE_VALUE)
+		return MESHFILE_ERROR_OPEN;
+
+	LARGE_INTEGER AssetDataSize;
+	if (!GetFileSizeEx(AssetDataFile, &AssetDataSize) || AssetDataSize.QuadPart == 0)
+	{
+		CloseHandle(AssetDataFile);
+		return MESHFILE_ERROR_OPEN;
+	}
+
+	HANDLE AssetDataFileMap = CreateFileMappingW(AssetDataFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (AssetDataFileMap == NULL)
+	{
+		CloseHandle(AssetDataFile);
+		return MESHFILE_ERROR_OPEN;
+	}
+
+	const void* AssetData = MapViewOfFile(AssetDataFileMap, FILE_MAP_READ, 0, 0, 0);
+	if (AssetData == NULL)
+	{
+		CloseHandle(AssetDataFileMap);
+		CloseHandle(AssetDataFile);
+		return MESHFILE_ERROR_OPEN;
+	}
+
+	File->FileHandle = AssetDataFile;
+	File->FileMapping = AssetDataFileMap;
+	size_t AssetSize = (size_t)AssetDataSize.QuadPart;
+#else
+	int AssetDataFile = open(Path, O_RDONLY);
+	if (AssetDataFile < 0)
+		return MESHFILE_ERROR_OPEN;
+
+	struct stat AssetDataStat;
+	if (fstat(AssetDataFile, &AssetDataStat) != 0 || AssetDataStat.st_size == 0)
+	{
+		close(AssetDataFile);
+		return MESHFILE_ERROR_OPEN;
+	}
+
+	const void* AssetData = mmap(NULL, (size_t)AssetDataStat.st_size, PROT_READ, MAP_PRIVATE, AssetDataFile, 0);
+	if (AssetData == MAP_FAILED)
+	{
+		close(AssetDataFile);
+		return MESHFILE_ERROR_OPEN;
+	}
+
+	File->FileDescriptor = AssetDataFile;
+	size_t AssetSize = (size_t)AssetDataStat.st_size;
+#endif
+
+	File->Data = AssetData;
+	File->Size = AssetSize;
+	File->bMapped = true;
+
+	enum MeshFileResult Result = IsCompressed(AssetData, AssetSize) ?
+		OpenCompressed(AssetData, AssetSize, File) :
+		ParseMeshFile(AssetData, AssetSize, File, true);
+
+	if (Result != MESHFILE_OK)
+		MeshFileClose(File);
+
+	return Result;
+}
+
+uint64_t MeshStreamSize(const struct Mesh* Mesh, enum MeshStream Stream)
+{
+	switch (Stream)
+	{
+	case MESH_STREAM_INDICES: return (uint64_t)Mesh->IndexCount * Mesh->IndexSize;
+	case MESH_STREAM_INDEX_SUBSETS: return (uint64_t)Mesh->IndexSubsetCount * sizeof(struct Subset);
+	case MESH_STREAM_MESHLETS: return (uint64_t)Mesh->MeshletCount * sizeof(struct Meshlet);
+	case MESH_STREAM_MESHLET_SUBSETS: return (uint64_t)Mesh->MeshletSubsetCount * sizeof(struct Subset);
+	case MESH_STREAM_UNIQUE_VERTEX_INDICES: return Mesh->UniqueVertexIndexCount;
+	case MESH_STREAM_PRIMITIVE_INDICES: return (uint64_t)Mesh->PrimitiveIndexCount * sizeof(struct PackedTriangle);
+	case MESH_STREAM_CULL_DATA: return (uint64_t)Mesh->CullingDataCount * sizeof(struct CullData);
+	case MESH_STREAM_CLUSTER_LODS: return (uint64_t)Mesh->ClusterLodCount * sizeof(struct ClusterLod);
+	case MESH_STREAM_CLUSTER_ROOTS: return (uint64_t)Mesh->ClusterRootCount * sizeof(struct Subset);
+	default:
+		break;
+	}
+
+	const uint32_t slot = Stream - MESH_STREAM_VERTICES;
+	return slot < Mesh->VertexBufferCount ? Mesh->VertexBuffers[slot].Size : 0;
+}
+
+const uint8_t* MeshStreamData(const struct Mesh* Mesh, enum MeshStream Stream)
+{
+	switch (Stream)
+	{
+	case MESH_STREAM_INDICES: return Mesh->IndexBuffer;
+	case MESH_STREAM_INDEX_SUBSETS: return (const uint8_t*)Mesh->IndexSubsets;
+	case MESH_STREAM_MESHLETS: return (const uint8_t*)Mesh->Meshlets;
+	case MESH_STREAM_MESHLET_SUBSETS: return (const uint8_t*)Mesh->MeshletSubsets;
+	case MESH_STREAM_UNIQUE_VERTEX_INDICES: return Mesh->UniqueVertexIndices;
+	case MESH_STREAM_PRIMITIVE_INDICES: return (const uint8_t*)Mesh->PrimitiveIndices;
+	case MESH_STREAM_CULL_DATA: return (const uint8_t*)Mesh->CullingData;
+	case MESH_STREAM_CLUSTER_LODS: return (const uint8_t*)Mesh->ClusterLods;
+	case MESH_STREAM_CLUSTER_ROOTS: return (const uint8_t*)Mesh->ClusterRoots;
+	default:
+		break;
+	}
+
+	const uint32_t slot = Stream - MESH_STREAM_VERTICES;
+	return slot < Mesh->VertexBufferCount ? Mesh->VertexBuffers[slot].Verts : NULL;
+}
+
+uint32_t MeshletVertexIndex(const struct Mesh* Mesh, uint32_t Index)
+{
+	if (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS)
+		return Index;
+
+	if (Mesh->IndexSize == 2)
+		return ((const uint16_t*)Mesh->UniqueVertexIndices)[Index];
+
+	return ((const uint32_t*)Mesh->UniqueVertexIndices)[Index];
+}
+
+void MeshMeshletLimits(const struct Mesh* Mesh, uint32_t* OutMaxVertices, uint32_t* OutMaxPrimitives)
+{
+	if (Mesh->MeshletMaxVertices != 0)
+	{
+		*OutMaxVertices = Mesh->MeshletMaxVertices;
+		*OutMaxPrimitives = Mesh->MeshletMaxPrimitives;
+		return;
+	}
+
+	uint32_t maxVertices = MESHLET_DEFAULT_MAX_VERTICES;
+	uint32_t maxPrimitives = MESHLET_DEFAULT_MAX_PRIMITIVES;
+
+	for (uint32_t i = 0; i < Mesh->MeshletCount; i++)
+	{
+		if (Mesh->Meshlets[i].VertCount > maxVertices)
+			maxVertices = Mesh->Meshlets[i].VertCount;
+
+		if (Mesh->Meshlets[i].PrimCount > maxPrimitives)
+			maxPrimitives = Mesh->Meshlets[i].PrimCount;
+	}
+
+	*OutMaxVertices = maxVertices;
+	*OutMaxPrimitives = maxPrimitives;
+}
+
+void MeshFileClose(struct MeshFile* File)
+{
+	free(File->MeshList);
+
+	if (File->bOwned)
+		free((void*)File->Data);
+
+	if (File->bMapped)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(File->Data);
+		CloseHandle(File->FileMapping);
+		CloseHandle(File->FileHandle);
+#else
+		munmap((void*)File->Data, File->Size);
+		close(File->FileDescriptor);
+#endif
+	}
+
+	memset(File, 0, sizeof(*File));
+}
+
+static inline uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+{
+	return (Value + Alignment - 1) / Alignment * Alignment;
+}
+
+struct WriteContext
+{
+	uint8_t* Buffer;
+	uint64_t BufferSize;
+	struct Accessor* Accessors;
+	uint32_t AccessorCount;
+	struct BufferView* BufferViews;
+	uint32_t BufferViewCount;
+};
+
+//appends one aligned stream to the buffer and returns its buffer view index. a NULL Buffer only measures
+static uint32_t WriteStream(struct WriteContext* Context, const void* Data, uint64_t Size)
+{
+	Context->BufferSize = AlignUp(Context->BufferSize, MESHFILE_STREAM_ALIGNMENT);
+
+	if (Context->Buffer)
+	{
+		struct BufferView* view = &Context->BufferViews[Context->BufferViewCount];
+		view->Offset = (uint32_t)Context->BufferSize;
+		view->Size = (uint32_t)Size;
+
+		if (Size)
+			memcpy(Context->Buffer + Context->BufferSize, Data, Size);
+	}
+
+	Context->BufferSize += Size;
+	return Context->BufferViewCount++;
+}
+
+static uint32_t WriteAccessor(struct WriteContext* Context, uint32_t BufferView, uint32_t Offset, uint32_t Size, uint32_t Stride, uint32_t Count)
+{
+	if (Context->Buffer)
+		Context->Accessors[Context->AccessorCount] = (struct Accessor){ BufferView, Offset, Size, Stride, Count };
+
+	return Context->AccessorCount++;
+}
+
+//lays out every mesh; the first pass (Buffer == NULL) only counts, the second one fills in everything.
+//StreamCount is the image's stream table size, and only FILE_VERSION_CLUSTERS and later ones have room for dags and
+//Clusters. MeshletHeaders is NULL unless the image is FILE_VERSION_MESHLETS
+static void WriteMeshes(struct WriteContext* Context, const struct Mesh* MeshList, uint32_t MeshCount, struct MeshHeader* Meshes, uint32_t* Streams, uint32_t StreamCount,
+	struct ClusterHeader* Clusters, struct MeshletHeader* MeshletHeaders)
+{
+	for (uint32_t i = 0; i < MeshCount; i++)
+	{
+		const struct Mesh* mesh = &MeshList[i];
+		struct MeshHeader header;
+		struct ClusterHeader cluster = { MESHFILE_ATTRIBUTE_NONE, MESHFILE_ATTRIBUTE_NONE };
+		uint32_t streams[MESH_STREAM_COUNT];
+
+		for (uint32_t j = 0; j < MESH_STREAM_COUNT; j++)
+			streams[j] = MESHFILE_ATTRIBUTE_NONE;
+
+#define WRITE_STREAM(Stream, Data, Size) (streams[Stream] = (uint32_t)AlignUp(Context->BufferSize, MESHFILE_STREAM_ALIGNMENT), WriteStream(Context, Data, Size))
+
+		uint32_t view = WRITE_STREAM(MESH_STREAM_INDICES, mesh->IndexBuffer, (uint64_t)mesh->IndexCount * mesh->IndexSize);
+		header.IndexBuffer = WriteAccessor(Context, view, 0, mesh->IndexSize, mesh->IndexSize, mesh->IndexCount);
+
+		view = WRITE_STREAM(MESH_STREAM_INDEX_SUBSETS, mesh->IndexSubsets, (uint64_t)mesh->IndexSubsetCount * sizeof(struct Subset));
+		header.IndexSubsets = WriteAccessor(Context, view, 0, sizeof(struct Subset), sizeof(struct Subset), mesh->IndexSubsetCount);
+
+		uint32_t vertexViews[ATTRIBUTE_TYPE_COUNT];
+		for (uint32_t j = 0; j < mesh->VertexBufferCount; j++)
+			vertexViews[j] = WRITE_STREAM(MESH_STREAM_VERTICES + j, mesh->VertexBuffers[j].Verts, mesh->VertexBuffers[j].Size);
+
+		for (uint32_t j = 0; j < ATTRIBUTE_TYPE_COUNT; j++)
+		{
+			const uint32_t slot = mesh->AttributeSlots[j];
+
+			if (slot == MESHFILE_ATTRIBUTE_NONE)
+			{
+				header.Attributes[j] = MESHFILE_ATTRIBUTE_NONE;
+				continue;
+			}
+
+			header.Attributes[j] = WriteAccessor(Context, vertexViews[slot], mesh->AttributeOffsets[j], AttributeSizes[j], mesh->VertexBuffers[slot].Stride, mesh->VertexCount);
+		}
+
+		view = WRITE_STREAM(MESH_STREAM_MESHLETS, mesh->Meshlets, (uint64_t)mesh->MeshletCount * sizeof(struct Meshlet));
+		header.Meshlets = WriteAccessor(Context, view, 0, sizeof(struct Meshlet), sizeof(struct Meshlet), mesh->MeshletCount);
+
+		view = WRITE_STREAM(MESH_STREAM_MESHLET_SUBSETS, mesh->MeshletSubsets, (uint64_t)mesh->MeshletSubsetCount * sizeof(struct Subset));
+		header.MeshletSubsets = WriteAccessor(Context, view, 0, sizeof(struct Subset), sizeof(struct Subset), mesh->MeshletSubsetCount);
+
+		view = WRITE_STREAM(MESH_STREAM_UNIQUE_VERTEX_INDICES, mesh->UniqueVertexIndices, mesh->UniqueVertexIndexCount);
+		header.UniqueVertexIndices = WriteAccessor(Context, view, 0, mesh->IndexSize, mesh->IndexSize, mesh->IndexSize ? mesh->UniqueVertexIndexCount / mesh->IndexSize : 0);
+
+		view = WRITE_STREAM(MESH_STREAM_PRIMITIVE_INDICES, mesh->PrimitiveIndices, (uint64_t)mesh->PrimitiveIndexCount * sizeof(struct PackedTriangle));
+		header.PrimitiveIndices = WriteAccessor(Context, view, 0, sizeof(struct PackedTriangle), sizeof(struct PackedTriangle), mesh->PrimitiveIndexCount);
+
+		view = WRITE_STREAM(MESH_STREAM_CULL_DATA, mesh->CullingData, (uint64_t)mesh->CullingDataCount * sizeof(struct CullData));
+		header.CullData = WriteAccessor(Context, view, 0, sizeof(struct CullData), sizeof(struct CullData), mesh->CullingDataCount);
+
+		if (StreamCount == MESH_STREAM_COUNT && mesh->ClusterLodCount != 0)
+		{
+			view = WRITE_STREAM(MESH_STREAM_CLUSTER_LODS, mesh->ClusterLods, (uint64_t)mesh->ClusterLodCount * sizeof(struct ClusterLod));
+			cluster.ClusterLods = WriteAccessor(Context, view, 0, sizeof(struct ClusterLod), sizeof(struct ClusterLod), mesh->ClusterLodCount);
+
+			view = WRITE_STREAM(MESH_STREAM_CLUSTER_ROOTS, mesh->ClusterRoots, (uint64_t)mesh->ClusterRootCount * sizeof(struct Subset));
+			cluster.ClusterRoots = WriteAccessor(Context, view, 0, sizeof(struct Subset), sizeof(struct Subset), mesh->ClusterRootCount);
+		}
+
+#undef WRITE_STREAM
+
+		if (Context->Buffer)
+		{
+			Meshes[i] = header;
+			memcpy(&Streams[(size_t)i * StreamCount], streams, StreamCount * sizeof(streams[0]));
+
+			if (StreamCount == MESH_STREAM_COUNT)
+				Clusters[i] = cluster;
+
+			if (MeshletHeaders != NULL)
+			{
+				struct MeshletHeader* limits = &MeshletHeaders[i];
+				memset(limits, 0, sizeof(*limits));
+				MeshMeshletLimits(mesh, &limits->MaxVertices, &limits->MaxPrimitives);
+				limits->Flags = mesh->MeshletFlags;
+			}
+		}
+	}
+}
+
+enum MeshFileResult MeshFileWrite(const struct Mesh* MeshList, uint32_t MeshCount, void** OutData, size_t* OutSize)
+{
+	*OutData = NULL;
+	*OutSize = 0;
+
+	//files without a dag, custom meshlet limits or meshlet flags stay readable by FILE_VERSION_BLOB loaders
+	uint32_t version = FILE_VERSION_BLOB;
+	for (uint32_t i = 0; i < MeshCount; i++)
+	{
+		if (MeshList[i].ClusterLodCount != 0 && version < FILE_VERSION_CLUSTERS)
+			version = FILE_VERSION_CLUSTERS;
+
+		if ((MeshList[i].MeshletMaxVertices != 0 &&
+			(MeshList[i].MeshletMaxVertices != MESHLET_DEFAULT_MAX_VERTICES || MeshList[i].MeshletMaxPrimitives != MESHLET_DEFAULT_MAX_PRIMITIVES)) ||
+			MeshList[i].MeshletFlags != 0)
+			version = FILE_VERSION_MESHLETS;
+	}
+
+	const uint32_t streamCount = StreamTableCount(version);
+	const bool bClusters = streamCount == MESH_STREAM_COUNT;
+	const bool bMeshlets = version == FILE_VERSION_MESHLETS;
+
+	struct WriteContext context = { 0 };
+	WriteMeshes(&context, MeshList, MeshCount, NULL, NULL, streamCount, NULL, NULL);
+
+	struct FileHeader sizing = { MESHFILE_PROLOG, version, MeshCount, context.AccessorCount, context.BufferViewCount, 0 };
+	const uint64_t metadataSize = MetadataSize(&sizing);
+
+	const uint64_t bufferOffset = AlignUp(metadataSize, MESHFILE_BUFFER_ALIGNMENT);
+	const uint64_t bufferSize = AlignUp(context.BufferSize, MESHFILE_STREAM_ALIGNMENT);
+
+	if (bufferSize > UINT32_MAX || bufferOffset > UINT32_MAX || bufferOffset + bufferSize > SIZE_MAX)
+		return MESHFILE_ERROR_TOO_LARGE;
+
+	uint8_t* image = calloc(1, (size_t)(bufferOffset + bufferSize));
+
+	if (image == NULL)
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+
+	struct FileHeader* header = (struct FileHeader*)image;
+	header->Prolog = MESHFILE_PROLOG;
+	header->Version = version;
+	header->MeshCount = MeshCount;
+	header->AccessorCount = context.AccessorCount;
+	header->BufferViewCount = context.BufferViewCount;
+	header->BufferSize = (uint32_t)bufferSize;
+
+	struct BlobHeader* blob = (struct BlobHeader*)(header + 1);
+	blob->BufferOffset = (uint32_t)bufferOffset;
+	blob->StreamAlignment = MESHFILE_STREAM_ALIGNMENT;
+
+	struct MeshHeader* meshes = (struct MeshHeader*)(blob + 1);
+	uint32_t* streams = (uint32_t*)(meshes + MeshCount);
+	struct ClusterHeader* clusters = (struct ClusterHeader*)(streams + (size_t)MeshCount * streamCount);
+	struct MeshletHeader* meshletHeaders = (struct MeshletHeader*)(bClusters ? clusters + MeshCount : clusters);
+
+	context.Accessors = bMeshlets ? (struct Accessor*)(meshletHeaders + MeshCount) : (struct Accessor*)meshletHeaders;
+	context.BufferViews = (struct BufferView*)(context.Accessors + context.AccessorCount);
+	context.Buffer = image + bufferOffset;
+	context.BufferSize = 0;
+	context.AccessorCount = 0;
+	context.BufferViewCount = 0;
+
+	WriteMeshes(&context, MeshList, MeshCount, meshes, streams, streamCount, clusters, bMeshlets ? meshletHeaders : NULL);
+
+	*OutData = image;
+	*OutSize = (size_t)(bufferOffset + bufferSize);
+	return MESHFILE_OK;
+}
+
+enum MeshFileResult MeshFileSave(const char* Path, const struct Mesh* MeshList, uint32_t MeshCount, bool bCompressed)
+{
+	void* image;
+	size_t imageSize;
+
+	enum MeshFileResult Result = MeshFileWrite(MeshList, MeshCount, &image, &imageSize);
+
+	if (Result != MESHFILE_OK)
+		return Result;
+
+	if (bCompressed)
+	{
+		void* compressed;
+		size_t compressedSize;
+
+		Result = MeshFileCompress(image, imageSize, &compressed, &compressedSize);
+		free(image);
+
+		if (Result != MESHFILE_OK)
+			return Result;
+
+		image = compressed;
+		imageSize = compressedSize;
+	}
+
+	FILE* output = fopen(Path, "wb");
+
+	if (output == NULL)
+	{
+		free(image);
+		return MESHFILE_ERROR_OPEN;
+	}
+
+	const bool bWritten = fwrite(image, 1, imageSize, output) == imageSize;
+
+	free(image);
+
+	if (fclose(output) != 0 || !bWritten)
+		return MESHFILE_ERROR_WRITE;
+
+	return MESHFILE_OK;
+}
+
+enum MeshFileResult MeshFileRepack(struct MeshFile* File)
+{
+	if (IsBlobVersion(File->Version))
+		return MESHFILE_OK;
+
+	void* image;
+	size_t imageSize;
+
+	enum MeshFileResult Result = MeshFileWrite(File->MeshList, File->MeshCount, &image, &imageSize);
+
+	if (Result != MESHFILE_OK)
+		return Result;
+
+	return AdoptImage(image, imageSize, File);
+}
+
+//picks the codec format for each buffer view from the streams that live in it; anything unknown stays raw
+static void ChooseViewFormats(const struct MeshFile* File, const struct BufferView* Views, uint32_t ViewCount, struct CompressedView* Out)
+{
+	for (uint32_t i = 0; i < ViewCount; i++)
+		Out[i].Format = (struct MeshCodecFormat){ MESH_CODEC_FILTER_RAW, 1, 1 };
+
+	for (uint32_t m = 0; m < File->MeshCount; m++)
+	{
+		const struct Mesh* mesh = &File->MeshList[m];
+
+		for (uint32_t s = 0; s < MESH_STREAM_COUNT; s++)
+		{
+			const uint64_t size = MeshStreamSize(mesh, s);
+
+			if (mesh->StreamOffsets[s] == MESHFILE_ATTRIBUTE_NONE || size == 0)
+				continue;
+
+			const struct MeshCodecFormat format = MeshCodecStreamFormat(mesh, s);
+
+			//empty streams can share their offset with the next view, so views are matched on size too
+			for (uint32_t i = 0; i < ViewCount; i++)
+			{
+				if (Views[i].Offset == mesh->StreamOffsets[s] && Views[i].Size == size && MeshCodecFormatValid(&format, size))
+					Out[i].Format = format;
+			}
+		}
+	}
+}
+
+enum MeshFileResult MeshFileCompress(const void* Data, size_t Size, void** OutData, size_t* OutSize)
+{
+	*OutData = NULL;
+	*OutSize = 0;
+
+	struct MeshFile file;
+	enum MeshFileResult Result = MeshFileParse(Data, Size, &file);
+
+	if (Result != MESHFILE_OK)
+		return Result;
+
+	if (!IsBlobVersion(file.Version) || file.bCompressed)
+	{
+		MeshFileClose(&file);
+		return MESHFILE_ERROR_VERSION;
+	}
+
+	const struct FileHeader* header = Data;
+	const uint64_t metadataSize = MetadataSize(header);
+	const struct BufferView* views = OffsetPointer(Data, metadataSize - (uint64_t)header->BufferViewCount * sizeof(struct BufferView));
+	const uint32_t viewCount = header->BufferViewCount;
+
+	const uint64_t tableSize = (uint64_t)viewCount * sizeof(struct CompressedView);
+	uint64_t capacity = metadataSize + tableSize;
+
+	for (uint32_t i = 0; i < viewCount; i++)
+		capacity += MeshCodecBound(views[i].Size);
+
+	uint8_t* image = capacity <= SIZE_MAX ? malloc((size_t)capacity) : NULL;
+
+	if (image == NULL)
+	{
+		MeshFileClose(&file);
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+	}
+
+	memcpy(image, Data, (size_t)metadataSize);
+	((struct FileHeader*)image)->Version = FILE_VERSION_COMPRESSED | (file.Version == FILE_VERSION_BLOB ? 0 : file.Version << 16);
+
+	struct CompressedView* table = (struct CompressedView*)(image + metadataSize);
+	uint8_t* const encoded = image + metadataSize + tableSize;
+	uint64_t encodedSize = 0;
+
+	ChooseViewFormats(&file, views, viewCount, table);
+
+	for (uint32_t i = 0; i < viewCount; i++)
+	{
+		const uint8_t* viewData = file.Buffer + views[i].Offset;
+		size_t size = MeshCodecEncode(&table[i].Format, viewData, views[i].Size, encoded + encodedSize);
+
+		//streams that don't shrink aren't worth decoding
+		if (size >= views[i].Size && table[i].Format.Filter != MESH_CODEC_FILTER_RAW)
+		{
+			table[i].Format = (struct MeshCodecFormat){ MESH_CODEC_FILTER_RAW, 1, 1 };
+			size = MeshCodecEncode(&table[i].Format, viewData, views[i].Size, encoded + encodedSize);
+		}
+
+		table[i].Offset = (uint32_t)encodedSize;
+		table[i].Size = (uint32_t)size;
+		encodedSize += size;
+	}
+
+	MeshFileClose(&file);
+
+	if (encodedSize > UINT32_MAX)
+	{
+		free(image);
+		return MESHFILE_ERROR_TOO_LARGE;
+	}
+
+	*OutData = image;
+	*OutSize = (size_t)(metadataSize + tableSize + encodedSize);
+	return MESHFILE_OK;
+}
+
+enum MeshFileResult MeshFileDecompress(const void* Data, size_t Size, enum SimdLevel Kernel, void** OutData, size_t* OutSize)
+{
+	*OutData = NULL;
+	*OutSize = 0;
+
+	if (Size < sizeof(struct FileHeader) + sizeof(struct BlobHeader))
+		return MESHFILE_ERROR_TRUNCATED;
+
+	const struct FileHeader* header = Data;
+	const struct BlobHeader* blob = OffsetPointer(Data, sizeof(struct FileHeader));
+
+	if (header->Prolog != MESHFILE_PROLOG)
+		return MESHFILE_ERROR_PROLOG;
+
+	if ((header->Version & 0xFFFF) != FILE_VERSION_COMPRESSED || !IsBlobVersion(ImageVersion(header)))
+		return MESHFILE_ERROR_VERSION;
+
+	const uint64_t metadataSize = MetadataSize(header);
+	const uint64_t tableSize = (uint64_t)header->BufferViewCount * sizeof(struct CompressedView);
+
+	if (metadataSize + tableSize > Size || blob->BufferOffset < metadataSize || blob->BufferOffset % MESHFILE_BUFFER_ALIGNMENT != 0)
+		return MESHFILE_ERROR_TRUNCATED;
+
+	const uint64_t imageSize = (uint64_t)blob->BufferOffset + header->BufferSize;
+	uint8_t* image = imageSize <= SIZE_MAX ? calloc(1, (size_t)imageSize) : NULL;
+
+	if (image == NULL)
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+
+	memcpy(image, Data, (size_t)metadataSize);
+	((struct FileHeader*)image)->Version = ImageVersion(header);
+
+	const struct BufferView* views = OffsetPointer(Data, metadataSize - (uint64_t)header->BufferViewCount * sizeof(struct BufferView));
+	const struct CompressedView* table = OffsetPointer(Data, metadataSize);
+	const uint8_t* encoded = OffsetPointer(Data, metadataSize + tableSize);
+	const uint64_t encodedSize = Size - metadataSize - tableSize;
+
+	for (uint32_t i = 0; i < header->BufferViewCount; i++)
+	{
+		if ((uint64_t)views[i].Offset + views[i].Size > header->BufferSize ||
+			(uint64_t)table[i].Offset + table[i].Size > encodedSize ||
+			!MeshCodecDecode(&table[i].Format, encoded + table[i].Offset, table[i].Size, image + blob->BufferOffset + views[i].Offset, views[i].Size, Kernel))
+		{
+			free(image);
+			return MESHFILE_ERROR_CORRUPT;
+		}
+	}
+
+	*OutData = image;
+	*OutSize = (size_t)imageSize;
+	return MESHFILE_OK;
+}
+
+const char* MeshFileResultString(enum MeshFileResult Result)
+{
+	switch (Result)
+	{
+	case MESHFILE_OK: return "ok";
+	case MESHFILE_ERROR_OPEN: return "unable to open file";
+	case MESHFILE_ERROR_PROLOG: return "file malformed: bad prolog";
+	case MESHFILE_ERROR_VERSION: return "file malformed: unsupported version";
+	case MESHFILE_ERROR_TRUNCATED: return "file malformed: truncated or out of range";
+	case MESHFILE_ERROR_OUT_OF_MEMORY: return "out of memory";
+	case MESHFILE_ERROR_WRITE: return "unable to write file";
+	case MESHFILE_ERROR_TOO_LARGE: return "meshes too large for a 4GB buffer";
+	case MESHFILE_ERROR_CORRUPT: return "file malformed: compressed stream doesn't decode";
+	case MESHFILE_ERROR_READ: return "read failed";
+	case MESHFILE_ERROR_LOD_MISMATCH: return "mesh count differs from the _LOD0 file";
+	}
+
+	return "unknown error";
+}
@@ -0,0 +1,279 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "Platform.h"
+
+//MSHL asset loader. no d3d12 types in here, so it builds headless on windows and linux
+
+#define MESHFILE_PROLOG 0x4D53484C // 'MSHL'
+
+#define MESHFILE_ATTRIBUTE_NONE UINT32_MAX
+
+//FILE_VERSION_BLOB (and every later blob version) guarantees: the buffer section starts on a MESHFILE_BUFFER_ALIGNMENT file offset and every
+//stream starts on a MESHFILE_STREAM_ALIGNMENT offset inside it, so the whole buffer can go to the gpu as one resource
+#define MESHFILE_BUFFER_ALIGNMENT 4096
+#define MESHFILE_STREAM_ALIGNMENT 16
+
+enum EType
+{
+	ATTRIBUTE_TYPE_POSITION,
+	ATTRIBUTE_TYPE_NORMAL,
+	ATTRIBUTE_TYPE_TEXCOORD,
+	ATTRIBUTE_TYPE_TANGENT,
+	ATTRIBUTE_TYPE_BITANGENT,
+	ATTRIBUTE_TYPE_COUNT
+};
+
+enum FileVersion
+{
+	FILE_VERSION_INITIAL = 0,
+	FILE_VERSION_BLOB = 1,
+	FILE_VERSION_COMPRESSED = 2,//a blob file with its buffer views run through MeshCodec; decoded at load
+	FILE_VERSION_CLUSTERS = 3,//FILE_VERSION_BLOB plus each mesh's cluster lod dag, written only for meshes that have one
+	FILE_VERSION_MESHLETS = 4,//FILE_VERSION_CLUSTERS plus the meshlet limits and layout flags of each mesh
+	CURRENT_FILE_VERSION = FILE_VERSION_MESHLETS
+};
+
+//meshlet limits the mesh shader is compiled for when a file doesn't say otherwise
+#define MESHLET_DEFAULT_MAX_VERTICES 64
+#define MESHLET_DEFAULT_MAX_PRIMITIVES 126
+
+//mesh shader output limits. PackedTriangle holds 10 bit local indices, so the vertex limit could go up to 1024
+#define MESHLET_MAX_VERTICES_LIMIT 256
+#define MESHLET_MAX_PRIMITIVES_LIMIT 256
+
+//Mesh.MeshletFlags
+//every meshlet's vertices are its own contiguous range of the vertex buffers, VertOffset .. VertOffset + VertCount - 1,
+//and UniqueVertexIndices is empty. vertices shared by meshlets are stored once per meshlet
+#define MESHLET_FLAG_INDEXLESS 0x1
+
+enum MeshFileResult
+{
+	MESHFILE_OK,
+	MESHFILE_ERROR_OPEN,
+	MESHFILE_ERROR_PROLOG,
+	MESHFILE_ERROR_VERSION,
+	MESHFILE_ERROR_TRUNCATED,
+	MESHFILE_ERROR_OUT_OF_MEMORY,
+	MESHFILE_ERROR_WRITE,
+	MESHFILE_ERROR_TOO_LARGE,
+	MESHFILE_ERROR_CORRUPT,
+	MESHFILE_ERROR_READ,
+	MESHFILE_ERROR_LOD_MISMATCH//a scene's coarser level doesn't have the same meshes as its _LOD0
+};
+
+//every range of the buffer a mesh references; vertex buffers take one entry per slot
+enum MeshStream
+{
+	MESH_STREAM_INDICES,
+	MESH_STREAM_INDEX_SUBSETS,
+	MESH_STREAM_MESHLETS,
+	MESH_STREAM_MESHLET_SUBSETS,
+	MESH_STREAM_UNIQUE_VERTEX_INDICES,
+	MESH_STREAM_PRIMITIVE_INDICES,
+	MESH_STREAM_CULL_DATA,
+	MESH_STREAM_VERTICES,
+	MESH_STREAM_CLUSTER_LODS = MESH_STREAM_VERTICES + ATTRIBUTE_TYPE_COUNT,
+	MESH_STREAM_CLUSTER_ROOTS,
+	MESH_STREAM_COUNT
+};
+
+struct Subset
+{
+	uint32_t Offset;
+	uint32_t Count;
+};
+
+struct Meshlet
+{
+	uint32_t VertCount;
+	uint32_t VertOffset;
+	uint32_t PrimCount;
+	uint32_t PrimOffset;
+};
+
+struct PackedTriangle
+{
+	uint32_t i0 : 10;
+	uint32_t i1 : 10;
+	uint32_t i2 : 10;
+};
+
+struct BoundingSphere
+{
+	float Center[3];
+	float Radius;
+};
+
+struct CullData
+{
+	float BoundingSphere[4]; // xyz = center, w = radius
+	uint8_t NormalCone[4];  // xyz = axis, w = -cos(a + 90)
+	float ApexOffset;     // apex = center - axis * offset
+};
+
+//one per meshlet of a mesh with a cluster dag. meshlets are grouped, each group is simplified as a whole with its
+//border locked and cut into new, coarser meshlets, and those are grouped again. a group's error and sphere are shared
+//by every meshlet made from it and stored twice: as their Error/Bounds, and as the ParentError/ParentBounds of the
+//group's members. both only grow towards the roots, so a view cuts the dag by drawing every meshlet whose own error
+//is acceptable and whose parent's isn't; level 0 meshlets have no children and count as acceptable
+struct ClusterLod
+{
+	float Bounds[4];//xyz = center, w = radius; holds Bounds of every child
+	float ParentBounds[4];
+	float Error;//object space, 0 at level 0
+	float ParentError;//FLT_MAX for roots
+	uint32_t ChildOffset;//the group this meshlet was made from, a contiguous meshlet range
+	uint32_t ChildCount : 31;//0 at level 0
+	uint32_t bFirstSibling : 1;//set on one meshlet made from each group, the one a traversal descends from
+};
+
+struct VertexBuffer
+{
+	const uint8_t* Verts;
+	uint32_t Size;
+	uint32_t Stride;
+};
+
+struct Mesh
+{
+	struct VertexBuffer VertexBuffers[ATTRIBUTE_TYPE_COUNT];
+	uint32_t VertexBufferCount;
+
+	//which vertex buffer each attribute lives in and its byte offset within a vertex, MESHFILE_ATTRIBUTE_NONE if absent
+	uint32_t AttributeSlots[ATTRIBUTE_TYPE_COUNT];
+	uint32_t AttributeOffsets[ATTRIBUTE_TYPE_COUNT];
+
+	uint32_t VertexCount;
+	struct BoundingSphere BoundingSphere;
+
+	const struct Subset* IndexSubsets;
+	uint32_t IndexSubsetCount;
+
+	const uint8_t* IndexBuffer;
+	uint32_t IndexBufferSize;
+
+	uint32_t IndexSize;
+	uint32_t IndexCount;
+
+	const struct Subset* MeshletSubsets;
+	uint32_t MeshletSubsetCount;
+
+	const struct Meshlet* Meshlets;
+	uint32_t MeshletCount;
+
+	const uint8_t* UniqueVertexIndices;
+	uint32_t UniqueVertexIndexCount;//in bytes
+
+	const struct PackedTriangle* PrimitiveIndices;
+	uint32_t PrimitiveIndexCount;
+
+	const struct CullData* CullingData;
+	uint32_t CullingDataCount;
+
+	//cluster lod dag, empty unless the file is FILE_VERSION_CLUSTERS. level 0 is what MeshletSubsets cover; the
+	//coarser meshlets follow it in the meshlet streams. one root range per index subset, each cut from there
+	const struct ClusterLod* ClusterLods;
+	uint32_t ClusterLodCount;//0 or MeshletCount
+
+	const struct Subset* ClusterRoots;
+	uint32_t ClusterRootCount;
+
+	//the most vertices and primitives any meshlet may have, which the mesh shader variant drawing it must cover.
+	//0 when the file predates FILE_VERSION_MESHLETS; MeshMeshletLimits works it out from the meshlets then
+	uint32_t MeshletMaxVertices;
+	uint32_t MeshletMaxPrimitives;
+	uint32_t MeshletFlags;//MESHLET_FLAG_, 0 before FILE_VERSION_MESHLETS
+
+	//byte offset of each stream from MeshFile.Buffer, MESHFILE_ATTRIBUTE_NONE for unused vertex slots
+	uint32_t StreamOffsets[MESH_STREAM_COUNT];
+};
+
+struct MeshFile
+{
+	const void* Data;
+	size_t Size;
+
+	uint32_t Version;
+
+	//the buffer section every mesh stream points into
+	const uint8_t* Buffer;
+	uint32_t BufferSize;
+
+	struct Mesh* MeshList;
+	uint32_t MeshCount;
+
+	//os handles backing Data when opened from disk
+#ifdef _WIN32
+	void* FileHandle;
+	void* FileMapping;
+#else
+	int FileDescriptor;
+#endif
+	bool bMapped;
+	bool bOwned;//Data was allocated by MeshFileRepack or decoded from a compressed file
+	bool bCompressed;//stored as FILE_VERSION_COMPRESSED; Data is the decoded blob image
+};
+
+//maps the file read-only (MapViewOfFile on windows, mmap elsewhere) and parses it. compressed files are decoded
+//into memory and the mapping is released
+enum MeshFileResult MeshFileOpen(const char* Path, struct MeshFile* File);
+
+//parses an image already in memory; Data must outlive File
+enum MeshFileResult MeshFileParse(const void* Data, size_t Size, struct MeshFile* File);
+
+//how much of the start of an image MeshFileParseLayout needs: sizeof the file header until the header is in,
+//then the whole metadata block. 0 if the image can't be parsed before it's complete (compressed, or not MSHL)
+uint64_t MeshFileLayoutSize(const void* Data, size_t Size);
+
+//parses an uncompressed image whose buffer section may still be arriving: stream pointers are set up but nothing
+//inside the buffer is read. MeshFileValidateMesh does the remaining checks once a mesh's streams are in
+enum MeshFileResult MeshFileParseLayout(const void* Data, size_t Size, struct MeshFile* File);
+bool MeshFileValidateMesh(const struct Mesh* Mesh);
+
+void MeshFileClose(struct MeshFile* File);
+
+//size in bytes and first byte of one of a mesh's streams, 0 / NULL for unused vertex slots
+uint64_t MeshStreamSize(const struct Mesh* Mesh, enum MeshStream Stream);
+const uint8_t* MeshStreamData(const struct Mesh* Mesh, enum MeshStream Stream);
+
+//the mesh vertex at Index in the meshlet vertex list, which meshlets address as VertOffset + local index:
+//UniqueVertexIndices[Index], or Index itself for MESHLET_FLAG_INDEXLESS meshes
+uint32_t MeshletVertexIndex(const struct Mesh* Mesh, uint32_t Index);
+
+//the limits a mesh's meshlets were built with. meshes that don't record them get the defaults, raised to their
+//largest meshlet
+void MeshMeshletLimits(const struct Mesh* Mesh, uint32_t* OutMaxVertices, uint32_t* OutMaxPrimitives);
+
+//serializes meshes into a FILE_VERSION_BLOB image, FILE_VERSION_CLUSTERS if any of them has a cluster dag and
+//FILE_VERSION_MESHLETS if any was built with other than the default meshlet limits or has MeshletFlags. *OutData is malloc'd; release it with free
+enum MeshFileResult MeshFileWrite(const struct Mesh* MeshList, uint32_t MeshCount, void** OutData, size_t* OutSize);
+
+enum MeshFileResult MeshFileSave(const char* Path, const struct Mesh* MeshList, uint32_t MeshCount, bool bCompressed);
+
+//encodes a FILE_VERSION_BLOB, FILE_VERSION_CLUSTERS or FILE_VERSION_MESHLETS image into a FILE_VERSION_COMPRESSED one, and back. *OutData is malloc'd
+enum MeshFileResult MeshFileCompress(const void* Data, size_t Size, void** OutData, size_t* OutSize);
+enum MeshFileResult MeshFileDecompress(const void* Data, size_t Size, enum SimdLevel Kernel, void** OutData, size_t* OutSize);
+
+//turns a FILE_VERSION_INITIAL file into an in-memory FILE_VERSION_BLOB image in place; does nothing to blob images
+enum MeshFileResult MeshFileRepack(struct MeshFile* File);
+
+const char* MeshFileResultString(enum MeshFileResult Result);
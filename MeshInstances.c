@@ -0,0 +1,270 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "MeshInstances.h"
+
+#ifdef PLATFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef PLATFORM_AVX2
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(struct BoundingSphere) == 16, "simd loads assume a 16 byte BoundingSphere");
+static_assert(sizeof(struct InstanceTransform) == 48, "MeshletMS.hlsl reads three float4 rows an instance");
+
+void TransformBoundingSphere(const struct InstanceTransform* Transform, const struct BoundingSphere* Local, struct BoundingSphere* Out)
+{
+	const float (*M)[4] = Transform->Rows;
+
+	float Center[3];
+	for (int r = 0; r < 3; r++)
+		Center[r] = M[r][0] * Local->Center[0] + M[r][1] * Local->Center[1] + M[r][2] * Local->Center[2] + M[r][3];
+
+	//the largest stretch squared is the largest eigenvalue of L^T L, L the linear part, and no eigenvalue is above
+	//the largest absolute row sum. for a rotation times a scale L^T L is diagonal and the bound is exact
+	float Stretch = 0.0f;
+	for (int i = 0; i < 3; i++)
+	{
+		float RowSum = 0.0f;
+		for (int j = 0; j < 3; j++)
+			RowSum += fabsf(M[0][i] * M[0][j] + M[1][i] * M[1][j] + M[2][i] * M[2][j]);
+
+		Stretch = RowSum > Stretch ? RowSum : Stretch;
+	}
+
+	Out->Center[0] = Center[0];
+	Out->Center[1] = Center[1];
+	Out->Center[2] = Center[2];
+	Out->Radius = Local->Radius * sqrtf(Stretch);
+}
+
+bool SceneInstancesGrid(const struct MeshScene* Scene, uint32_t CountPerChain, float Spacing, uint32_t Seed, struct SceneInstances* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	const uint64_t Total = (uint64_t)CountPerChain * Scene->LodChainCount;
+
+	if (Total > UINT32_MAX)
+		return false;
+
+	Out->ChainCount = Scene->LodChainCount;
+	Out->Count = (uint32_t)Total;
+	Out->Transforms = malloc(sizeof(struct InstanceTransform) * (Total ? Total : 1));
+	Out->Bounds = malloc(sizeof(struct BoundingSphere) * (Total ? Total : 1));
+	Out->ChainOffsets = malloc(sizeof(uint32_t) * (Scene->LodChainCount + 1));
+
+	if (Out->Transforms == NULL || Out->Bounds == NULL || Out->ChainOffsets == NULL)
+	{
+		SceneInstancesFree(Out);
+		return false;
+	}
+
+	const uint32_t Side = (uint32_t)ceil(sqrt((double)CountPerChain));
+
+	for (uint32_t c = 0; c < Scene->LodChainCount; c++)
+	{
+		const struct BoundingSphere* Local = &Scene->LodChains[c].Bounds;
+		const float Step = Spacing > 0.0f ? Spacing : 2.0f * Local->Radius;
+		const uint32_t First = c * CountPerChain;
+
+		Out->ChainOffsets[c] = First;
+
+		for (uint32_t k = 0; k < CountPerChain; k++)
+		{
+			Seed = Seed * 1664525u + 1013904223u;
+			const float Yaw = (float)(Seed >> 8) * (6.28318531f / 16777216.0f);
+			const float Cos = cosf(Yaw);
+			const float Sin = sinf(Yaw);
+
+			const float Target[3] =
+			{
+				Local->Center[0] + ((float)(k % Side) - (Side - 1) * 0.5f) * Step,
+				Local->Center[1],
+				Local->Center[2] + ((float)(k / Side) - (Side - 1) * 0.5f) * Step
+			};
+
+			//turned about y, then moved so the chain's centre lands on its grid point
+			struct InstanceTransform* Transform = &Out->Transforms[First + k];
+			const float Rotation[3][3] = { { Cos, 0.0f, Sin }, { 0.0f, 1.0f, 0.0f }, { -Sin, 0.0f, Cos } };
+
+			for (int r = 0; r < 3; r++)
+			{
+				Transform->Rows[r][0] = Rotation[r][0];
+				Transform->Rows[r][1] = Rotation[r][1];
+				Transform->Rows[r][2] = Rotation[r][2];
+				Transform->Rows[r][3] = Target[r] - (Rotation[r][0] * Local->Center[0] + Rotation[r][1] * Local->Center[1] + Rotation[r][2] * Local->Center[2]);
+			}
+
+			TransformBoundingSphere(Transform, Local, &Out->Bounds[First + k]);
+		}
+	}
+
+	Out->ChainOffsets[Scene->LodChainCount] = Out->Count;
+
+	return true;
+}
+
+void SceneInstancesFree(struct SceneInstances* Instances)
+{
+	free(Instances->Transforms);
+	free(Instances->Bounds);
+	free(Instances->ChainOffsets);
+	memset(Instances, 0, sizeof(*Instances));
+}
+
+bool CullInstanceVisible(const struct CullFrustum* Frustum, const struct BoundingSphere* Bounds)
+{
+	for (int i = 0; i < 6; i++)
+	{
+		const float* Plane = Frustum->Planes[i];
+
+		//grouped the same way as CullMeshletVisible and the simd kernels
+		if ((Bounds->Center[0] * Plane[0] + Bounds->Center[1] * Plane[1]) + (Bounds->Center[2] * Plane[2] + Plane[3]) < -Bounds->Radius)
+			return false;
+	}
+
+	return true;
+}
+
+static uint32_t ScalarCull(const struct CullFrustum* Frustum, const struct BoundingSphere* Bounds, uint32_t Begin, uint32_t End, uint32_t* Visible)
+{
+	uint32_t VisibleCount = 0;
+
+	for (uint32_t i = Begin; i < End; i++)
+	{
+		if (CullInstanceVisible(Frustum, &Bounds[i]))
+			Visible[VisibleCount++] = i;
+	}
+
+	return VisibleCount;
+}
+
+#ifdef PLATFORM_SSE2
+static uint32_t Sse2Cull(const struct CullFrustum* Frustum, const struct BoundingSphere* Bounds, uint32_t Begin, uint32_t End, uint32_t* Visible)
+{
+	uint32_t VisibleCount = 0;
+	uint32_t i = Begin;
+
+	for (; i + 4 <= End; i += 4)
+	{
+		__m128 X = _mm_loadu_ps(Bounds[i + 0].Center);
+		__m128 Y = _mm_loadu_ps(Bounds[i + 1].Center);
+		__m128 Z = _mm_loadu_ps(Bounds[i + 2].Center);
+		__m128 R = _mm_loadu_ps(Bounds[i + 3].Center);
+		_MM_TRANSPOSE4_PS(X, Y, Z, R);
+
+		const __m128 NegR = _mm_sub_ps(_mm_setzero_ps(), R);
+		__m128 Outside = _mm_setzero_ps();
+
+		for (int p = 0; p < 6; p++)
+		{
+			const float* Plane = Frustum->Planes[p];
+
+			const __m128 Dist = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(X, _mm_set1_ps(Plane[0])), _mm_mul_ps(Y, _mm_set1_ps(Plane[1]))),
+				_mm_add_ps(_mm_mul_ps(Z, _mm_set1_ps(Plane[2])), _mm_set1_ps(Plane[3])));
+
+			Outside = _mm_or_ps(Outside, _mm_cmplt_ps(Dist, NegR));
+		}
+
+		const int CulledMask = _mm_movemask_ps(Outside);
+
+		for (int Lane = 0; Lane < 4; Lane++)
+		{
+			Visible[VisibleCount] = i + Lane;
+			VisibleCount += ((CulledMask >> Lane) & 1) ^ 1;
+		}
+	}
+
+	return VisibleCount + ScalarCull(Frustum, Bounds, i, End, Visible + VisibleCount);
+}
+#endif
+
+#ifdef PLATFORM_AVX2
+static uint32_t Avx2Cull(const struct CullFrustum* Frustum, const struct BoundingSphere* Bounds, uint32_t Begin, uint32_t End, uint32_t* Visible)
+{
+	uint32_t VisibleCount = 0;
+	uint32_t i = Begin;
+
+	for (; i + 8 <= End; i += 8)
+	{
+		//spheres i and i + 4 side by side in each register, then a 4x4 transpose within each half: lanes 0..3 are
+		//instances i..i + 3 and lanes 4..7 are i + 4..i + 7, in order
+		const __m256 S0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(Bounds[i + 0].Center)), _mm_loadu_ps(Bounds[i + 4].Center), 1);
+		const __m256 S1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(Bounds[i + 1].Center)), _mm_loadu_ps(Bounds[i + 5].Center), 1);
+		const __m256 S2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(Bounds[i + 2].Center)), _mm_loadu_ps(Bounds[i + 6].Center), 1);
+		const __m256 S3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(Bounds[i + 3].Center)), _mm_loadu_ps(Bounds[i + 7].Center), 1);
+
+		const __m256 T0 = _mm256_unpacklo_ps(S0, S1);
+		const __m256 T1 = _mm256_unpacklo_ps(S2, S3);
+		const __m256 T2 = _mm256_unpackhi_ps(S0, S1);
+		const __m256 T3 = _mm256_unpackhi_ps(S2, S3);
+
+		const __m256 X = _mm256_shuffle_ps(T0, T1, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 Y = _mm256_shuffle_ps(T0, T1, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 Z = _mm256_shuffle_ps(T2, T3, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 R = _mm256_shuffle_ps(T2, T3, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 NegR = _mm256_sub_ps(_mm256_setzero_ps(), R);
+
+		__m256 Outside = _mm256_setzero_ps();
+
+		for (int p = 0; p < 6; p++)
+		{
+			const float* Plane = Frustum->Planes[p];
+
+			const __m256 Dist = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(X, _mm256_set1_ps(Plane[0])), _mm256_mul_ps(Y, _mm256_set1_ps(Plane[1]))),
+				_mm256_add_ps(_mm256_mul_ps(Z, _mm256_set1_ps(Plane[2])), _mm256_set1_ps(Plane[3])));
+
+			Outside = _mm256_or_ps(Outside, _mm256_cmp_ps(Dist, NegR, _CMP_LT_OQ));
+		}
+
+		const int CulledMask = _mm256_movemask_ps(Outside);
+
+		for (int Lane = 0; Lane < 8; Lane++)
+		{
+			Visible[VisibleCount] = i + Lane;
+			VisibleCount += ((CulledMask >> Lane) & 1) ^ 1;
+		}
+	}
+
+	return VisibleCount + ScalarCull(Frustum, Bounds, i, End, Visible + VisibleCount);
+}
+#endif
+
+uint32_t CullInstances(const struct CullFrustum* Frustum, const struct BoundingSphere* Bounds, uint32_t First, uint32_t Count, enum SimdLevel Kernel, uint32_t* Visible)
+{
+	switch (Kernel)
+	{
+#ifdef PLATFORM_AVX2
+	case SIMD_LEVEL_AVX2:
+		return Avx2Cull(Frustum, Bounds, First, First + Count, Visible);
+#endif
+#ifdef PLATFORM_SSE2
+	case SIMD_LEVEL_SSE2:
+		return Sse2Cull(Frustum, Bounds, First, First + Count, Visible);
+#endif
+	default:
+		return ScalarCull(Frustum, Bounds, First, First + Count, Visible);
+	}
+}
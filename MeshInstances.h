@@ -0,0 +1,64 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Platform.h"
+#include "MeshFile.h"
+#include "MeshScene.h"
+#include "MeshletCull.h"
+
+//many copies of a scene's lod chains, each placed by its own transform. every instance gets a world space bounding
+//sphere once, from its chain's, so a frame only tests spheres against the frustum; the simd kernels take four or
+//eight at a time and make the same decisions as the scalar reference.
+//
+//culling and shading hold for any affine transform: the radius grows by a bound on how far the transform stretches,
+//and MeshletMS.hlsl moves normals by the transform's cofactor matrix. lod errors are measured in object space though,
+//so a scaled instance picks its levels as if it had its chain's size
+
+struct InstanceTransform
+{
+	float Rows[3][4];//world = Rows * (x, y, z, 1), the layout MeshletMS.hlsl reads
+};
+
+struct SceneInstances
+{
+	struct InstanceTransform* Transforms;//grouped by chain
+	struct BoundingSphere* Bounds;//world space, one per transform
+	uint32_t* ChainOffsets;//ChainCount + 1 entries, chain c owns [ChainOffsets[c], ChainOffsets[c + 1])
+	uint32_t ChainCount;
+	uint32_t Count;
+};
+
+//Local moved by Transform, with its radius scaled by a bound on the transform's largest stretch that is exact for a
+//rotation with any per axis scale
+void TransformBoundingSphere(const struct InstanceTransform* Transform, const struct BoundingSphere* Local, struct BoundingSphere* Out);
+
+//CountPerChain copies of every lod chain of Scene on a square grid in the xz plane, centred where the chain is and
+//Spacing apart (0 = twice the chain's radius), each turned about y by an angle drawn from Seed. false if memory runs out
+bool SceneInstancesGrid(const struct MeshScene* Scene, uint32_t CountPerChain, float Spacing, uint32_t Seed, struct SceneInstances* Out);
+
+void SceneInstancesFree(struct SceneInstances* Instances);
+
+//scalar reference: false when the sphere is entirely outside a plane of the frustum
+bool CullInstanceVisible(const struct CullFrustum* Frustum, const struct BoundingSphere* Bounds);
+
+//tests Bounds[First .. First + Count) and writes the indices of the visible ones to Visible in ascending order.
+//returns how many were written
+uint32_t CullInstances(const struct CullFrustum* Frustum, const struct BoundingSphere* Bounds, uint32_t First, uint32_t Count, enum SimdLevel Kernel, uint32_t* Visible);
@@ -0,0 +1,880 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#define _GNU_SOURCE
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+//io_uring is driven through the raw syscalls so there's no liburing dependency
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define MESH_LOADER_IO_URING 1
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "MeshLoader.h"
+
+struct StagingSlot
+{
+	uint64_t Offset;//file offset of the chunk the slot is reading
+	uint32_t Size;//bytes the chunk has; only the last one is short
+	uint32_t Filled;
+};
+
+#ifdef MESH_LOADER_IO_URING
+struct Uring
+{
+	int Fd;
+
+	void* SqRing;
+	size_t SqRingSize;
+	void* CqRing;
+	size_t CqRingSize;
+	struct io_uring_sqe* Sqes;
+	size_t SqesSize;
+
+	uint32_t* SqTail;
+	uint32_t* SqMask;
+	uint32_t* SqArray;
+	uint32_t* CqHead;
+	uint32_t* CqTail;
+	uint32_t* CqMask;
+	struct io_uring_cqe* Cqes;
+
+	uint32_t Unsubmitted;
+	bool bFixed;//the staging ring is registered and reads use IORING_OP_READ_FIXED
+};
+#endif
+
+struct Reader
+{
+	enum MeshLoaderBackend Backend;
+
+#ifdef _WIN32
+	HANDLE File;
+	OVERLAPPED Overlapped[MESH_LOADER_MAX_QUEUE_DEPTH];
+#else
+	int File;
+#endif
+#ifdef MESH_LOADER_IO_URING
+	struct Uring Ring;
+#endif
+
+	uint8_t* Staging;//QueueDepth slots of ChunkSize bytes, MESH_LOADER_CHUNK_ALIGNMENT aligned
+	void* StagingAllocation;
+	uint32_t ChunkSize;
+	uint32_t QueueDepth;
+	struct StagingSlot Slots[MESH_LOADER_MAX_QUEUE_DEPTH];
+
+	//overlapped and pread reads are waited on in the order they were issued
+	uint32_t Fifo[MESH_LOADER_MAX_QUEUE_DEPTH];
+	uint32_t FifoHead;
+	uint32_t FifoCount;
+
+	uint32_t ReadCount;
+};
+
+#ifdef MESH_LOADER_IO_URING
+static void UringDestroy(struct Uring* Ring)
+{
+	if (Ring->Sqes != NULL)
+		munmap(Ring->Sqes, Ring->SqesSize);
+
+	if (Ring->CqRing != NULL && Ring->CqRing != Ring->SqRing)
+		munmap(Ring->CqRing, Ring->CqRingSize);
+
+	if (Ring->SqRing != NULL)
+		munmap(Ring->SqRing, Ring->SqRingSize);
+
+	if (Ring->Fd >= 0)
+		close(Ring->Fd);
+
+	memset(Ring, 0, sizeof(*Ring));
+	Ring->Fd = -1;
+}
+
+static bool UringCreate(struct Uring* Ring, uint32_t Entries)
+{
+	memset(Ring, 0, sizeof(*Ring));
+
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	Ring->Fd = (int)syscall(__NR_io_uring_setup, Entries, &params);
+	if (Ring->Fd < 0)
+	{
+		Ring->Fd = -1;
+		return false;
+	}
+
+	Ring->SqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	Ring->CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	Ring->SqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	const bool bSingleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (bSingleMap)
+		Ring->SqRingSize = Ring->CqRingSize = Ring->SqRingSize > Ring->CqRingSize ? Ring->SqRingSize : Ring->CqRingSize;
+
+	Ring->SqRing = mmap(NULL, Ring->SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Ring->Fd, IORING_OFF_SQ_RING);
+	if (Ring->SqRing == MAP_FAILED)
+	{
+		Ring->SqRing = NULL;
+		UringDestroy(Ring);
+		return false;
+	}
+
+	Ring->CqRing = bSingleMap ? Ring->SqRing : mmap(NULL, Ring->CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Ring->Fd, IORING_OFF_CQ_RING);
+	if (Ring->CqRing == MAP_FAILED)
+	{
+		Ring->CqRing = NULL;
+		UringDestroy(Ring);
+		return false;
+	}
+
+	Ring->Sqes = mmap(NULL, Ring->SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Ring->Fd, IORING_OFF_SQES);
+	if (Ring->Sqes == MAP_FAILED)
+	{
+		Ring->Sqes = NULL;
+		UringDestroy(Ring);
+		return false;
+	}
+
+	uint8_t* sq = Ring->SqRing;
+	uint8_t* cq = Ring->CqRing;
+	Ring->SqTail = (uint32_t*)(sq + params.sq_off.tail);
+	Ring->SqMask = (uint32_t*)(sq + params.sq_off.ring_mask);
+	Ring->SqArray = (uint32_t*)(sq + params.sq_off.array);
+	Ring->CqHead = (uint32_t*)(cq + params.cq_off.head);
+	Ring->CqTail = (uint32_t*)(cq + params.cq_off.tail);
+	Ring->CqMask = (uint32_t*)(cq + params.cq_off.ring_mask);
+	Ring->Cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+	return true;
+}
+
+//the whole staging ring is one registered buffer; READ_FIXED may target any range inside it
+static void UringRegisterBuffer(struct Uring* Ring, void* Buffer, size_t Size)
+{
+	struct iovec buffer = { Buffer, Size };
+	Ring->bFixed = syscall(__NR_io_uring_register, Ring->Fd, IORING_REGISTER_BUFFERS, &buffer, 1) == 0;
+}
+
+static void UringQueueRead(struct Uring* Ring, int File, void* Buffer, uint32_t Size, uint64_t Offset, uint64_t UserData)
+{
+	//only this thread produces, so the tail can be read plainly
+	const uint32_t tail = *Ring->SqTail;
+	const uint32_t index = tail & *Ring->SqMask;
+
+	struct io_uring_sqe* sqe = &Ring->Sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = Ring->bFixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+	sqe->fd = File;
+	sqe->addr = (uint64_t)(uintptr_t)Buffer;
+	sqe->len = Size;
+	sqe->off = Offset;
+	sqe->buf_index = 0;
+	sqe->user_data = UserData;
+
+	Ring->SqArray[index] = index;
+	__atomic_store_n(Ring->SqTail, tail + 1, __ATOMIC_RELEASE);
+	Ring->Unsubmitted++;
+}
+
+//submits whatever is queued and returns the next completion, blocking if there is none yet
+static bool UringWait(struct Uring* Ring, uint64_t* OutUserData, int32_t* OutResult)
+{
+	for (;;)
+	{
+		const uint32_t head = *Ring->CqHead;
+		const bool bEmpty = head == __atomic_load_n(Ring->CqTail, __ATOMIC_ACQUIRE);
+
+		if (Ring->Unsubmitted != 0 || bEmpty)
+		{
+			const long submitted = syscall(__NR_io_uring_enter, Ring->Fd, Ring->Unsubmitted, bEmpty ? 1 : 0, IORING_ENTER_GETEVENTS, NULL, 0);
+			if (submitted < 0)
+			{
+				if (errno == EINTR || errno == EAGAIN)
+					continue;
+
+				return false;
+			}
+
+			Ring->Unsubmitted -= (uint32_t)submitted;
+		}
+
+		if (bEmpty)
+			continue;
+
+		const struct io_uring_cqe* cqe = &Ring->Cqes[head & *Ring->CqMask];
+		*OutUserData = cqe->user_data;
+		*OutResult = cqe->res;
+		__atomic_store_n(Ring->CqHead, head + 1, __ATOMIC_RELEASE);
+		return true;
+	}
+}
+#endif
+
+static void ReaderClose(struct Reader* Reader)
+{
+#ifdef MESH_LOADER_IO_URING
+	if (Reader->Backend == MESH_LOADER_BACKEND_IO_URING)
+		UringDestroy(&Reader->Ring);
+#endif
+
+#ifdef _WIN32
+	for (uint32_t i = 0; i < MESH_LOADER_MAX_QUEUE_DEPTH; i++)
+	{
+		if (Reader->Overlapped[i].hEvent != NULL)
+			CloseHandle(Reader->Overlapped[i].hEvent);
+	}
+
+	if (Reader->File != INVALID_HANDLE_VALUE)
+		CloseHandle(Reader->File);
+#else
+	if (Reader->File >= 0)
+		close(Reader->File);
+#endif
+
+	free(Reader->StagingAllocation);
+	memset(Reader, 0, sizeof(*Reader));
+}
+
+static bool ReaderOpen(struct Reader* Reader, const char* Path, enum MeshLoaderBackend Backend, bool bUnbuffered, uint32_t ChunkSize, uint32_t QueueDepth, bool* bOutUnbuffered, uint64_t* OutSize)
+{
+	memset(Reader, 0, sizeof(*Reader));
+	Reader->ChunkSize = ChunkSize;
+	Reader->QueueDepth = QueueDepth;
+
+	if (Backend == MESH_LOADER_BACKEND_AUTO)
+	{
+#if defined(_WIN32)
+		Backend = MESH_LOADER_BACKEND_OVERLAPPED;
+#elif defined(MESH_LOADER_IO_URING)
+		Backend = MESH_LOADER_BACKEND_IO_URING;
+#else
+		Backend = MESH_LOADER_BACKEND_PREAD;
+#endif
+	}
+
+#ifdef _WIN32
+	if (Backend != MESH_LOADER_BACKEND_OVERLAPPED)
+		Backend = MESH_LOADER_BACKEND_PREAD;
+
+	Reader->File = INVALID_HANDLE_VALUE;
+
+	wchar_t WidePath[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, Path, -1, WidePath, MAX_PATH) == 0)
+		return false;
+
+	const DWORD flags = FILE_FLAG_SEQUENTIAL_SCAN | (Backend == MESH_LOADER_BACKEND_OVERLAPPED ? FILE_FLAG_OVERLAPPED : 0);
+
+	if (bUnbuffered)
+		Reader->File = CreateFileW(WidePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags | FILE_FLAG_NO_BUFFERING, NULL);
+
+	*bOutUnbuffered = Reader->File != INVALID_HANDLE_VALUE;
+
+	if (Reader->File == INVALID_HANDLE_VALUE)
+		Reader->File = CreateFileW(WidePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+
+	if (Reader->File == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(Reader->File, &fileSize))
+	{
+		ReaderClose(Reader);
+		return false;
+	}
+
+	*OutSize = (uint64_t)fileSize.QuadPart;
+#else
+	Reader->File = -1;
+
+	//some file systems (tmpfs) refuse O_DIRECT, which just means the read goes through the cache
+#ifdef O_DIRECT
+	if (bUnbuffered)
+		Reader->File = open(Path, O_RDONLY | O_DIRECT);
+#endif
+
+	*bOutUnbuffered = Reader->File >= 0;
+
+	if (Reader->File < 0)
+		Reader->File = open(Path, O_RDONLY);
+
+	struct stat fileStat;
+	if (Reader->File < 0 || fstat(Reader->File, &fileStat) != 0)
+	{
+		ReaderClose(Reader);
+		return false;
+	}
+
+	*OutSize = (uint64_t)fileStat.st_size;
+#endif
+
+	//no more slots than chunks, small files don't pay for a big staging ring
+	const uint64_t chunkCount = (*OutSize + ChunkSize - 1) / ChunkSize;
+	if (Reader->QueueDepth > chunkCount)
+		Reader->QueueDepth = chunkCount ? (uint32_t)chunkCount : 1;
+
+	QueueDepth = Reader->QueueDepth;
+
+#ifndef _WIN32
+#ifdef MESH_LOADER_IO_URING
+	if (Backend == MESH_LOADER_BACKEND_IO_URING && !UringCreate(&Reader->Ring, QueueDepth))
+		Backend = MESH_LOADER_BACKEND_PREAD;
+#endif
+	if (Backend != MESH_LOADER_BACKEND_IO_URING)
+		Backend = MESH_LOADER_BACKEND_PREAD;
+
+	if (Backend == MESH_LOADER_BACKEND_PREAD)
+		posix_fadvise(Reader->File, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+	Reader->Backend = Backend;
+
+#ifdef _WIN32
+	if (Backend == MESH_LOADER_BACKEND_OVERLAPPED)
+	{
+		for (uint32_t i = 0; i < QueueDepth; i++)
+		{
+			Reader->Overlapped[i].hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+			if (Reader->Overlapped[i].hEvent == NULL)
+			{
+				ReaderClose(Reader);
+				return false;
+			}
+		}
+	}
+#endif
+
+	const size_t stagingSize = (size_t)ChunkSize * QueueDepth;
+	Reader->StagingAllocation = malloc(stagingSize + MESH_LOADER_CHUNK_ALIGNMENT);
+	if (Reader->StagingAllocation == NULL)
+	{
+		ReaderClose(Reader);
+		return false;
+	}
+
+	Reader->Staging = (uint8_t*)(((uintptr_t)Reader->StagingAllocation + MESH_LOADER_CHUNK_ALIGNMENT - 1) & ~(uintptr_t)(MESH_LOADER_CHUNK_ALIGNMENT - 1));
+
+#ifdef MESH_LOADER_IO_URING
+	if (Backend == MESH_LOADER_BACKEND_IO_URING)
+		UringRegisterBuffer(&Reader->Ring, Reader->Staging, stagingSize);
+#endif
+
+	return true;
+}
+
+//issues a read for the unfilled part of a slot. the length always runs to the end of the slot, which keeps unbuffered
+//reads sector sized; the last chunk just comes back short at the end of the file
+static bool ReaderSubmit(struct Reader* Reader, uint32_t Slot)
+{
+	struct StagingSlot* slot = &Reader->Slots[Slot];
+	uint8_t* buffer = Reader->Staging + (size_t)Slot * Reader->ChunkSize + slot->Filled;
+	const uint32_t size = Reader->ChunkSize - slot->Filled;
+	const uint64_t offset = slot->Offset + slot->Filled;
+
+	Reader->ReadCount++;
+
+	switch (Reader->Backend)
+	{
+#ifdef MESH_LOADER_IO_URING
+	case MESH_LOADER_BACKEND_IO_URING:
+		UringQueueRead(&Reader->Ring, Reader->File, buffer, size, offset, Slot);
+		return true;
+#endif
+#ifdef _WIN32
+	case MESH_LOADER_BACKEND_OVERLAPPED:
+	{
+		OVERLAPPED* overlapped = &Reader->Overlapped[Slot];
+		HANDLE event = overlapped->hEvent;
+		memset(overlapped, 0, sizeof(*overlapped));
+		overlapped->hEvent = event;
+		overlapped->Offset = (DWORD)offset;
+		overlapped->OffsetHigh = (DWORD)(offset >> 32);
+
+		if (!ReadFile(Reader->File, buffer, size, NULL, overlapped) && GetLastError() != ERROR_IO_PENDING && GetLastError() != ERROR_HANDLE_EOF)
+			return false;
+		break;
+	}
+#endif
+	default:
+#ifndef _WIN32
+		//the read itself happens in ReaderWait; start the kernel's readahead so queued chunks arrive in the background
+		posix_fadvise(Reader->File, (off_t)offset, size, POSIX_FADV_WILLNEED);
+#endif
+		break;
+	}
+
+	Reader->Fifo[(Reader->FifoHead + Reader->FifoCount) % MESH_LOADER_MAX_QUEUE_DEPTH] = Slot;
+	Reader->FifoCount++;
+	return true;
+}
+
+//waits for the next read to finish. OutBytes is -1 if it failed
+static bool ReaderWait(struct Reader* Reader, uint32_t* OutSlot, int64_t* OutBytes)
+{
+#ifdef MESH_LOADER_IO_URING
+	if (Reader->Backend == MESH_LOADER_BACKEND_IO_URING)
+	{
+		uint64_t userData;
+		int32_t result;
+
+		if (!UringWait(&Reader->Ring, &userData, &result))
+			return false;
+
+		*OutSlot = (uint32_t)userData;
+		*OutBytes = result < 0 ? -1 : result;
+		return true;
+	}
+#endif
+
+	if (Reader->FifoCount == 0)
+		return false;
+
+	const uint32_t slotIndex = Reader->Fifo[Reader->FifoHead];
+	Reader->FifoHead = (Reader->FifoHead + 1) % MESH_LOADER_MAX_QUEUE_DEPTH;
+	Reader->FifoCount--;
+
+	struct StagingSlot* slot = &Reader->Slots[slotIndex];
+	uint8_t* buffer = Reader->Staging + (size_t)slotIndex * Reader->ChunkSize + slot->Filled;
+	const uint32_t size = Reader->ChunkSize - slot->Filled;
+	const uint64_t offset = slot->Offset + slot->Filled;
+
+	*OutSlot = slotIndex;
+
+#ifdef _WIN32
+	DWORD bytes = 0;
+	BOOL bResult;
+
+	if (Reader->Backend == MESH_LOADER_BACKEND_OVERLAPPED)
+	{
+		bResult = GetOverlappedResult(Reader->File, &Reader->Overlapped[slotIndex], &bytes, TRUE);
+	}
+	else
+	{
+		OVERLAPPED position = { 0 };
+		position.Offset = (DWORD)offset;
+		position.OffsetHigh = (DWORD)(offset >> 32);
+		bResult = ReadFile(Reader->File, buffer, size, &bytes, &position);
+	}
+
+	*OutBytes = bResult || GetLastError() == ERROR_HANDLE_EOF ? (int64_t)bytes : -1;
+#else
+	ssize_t bytes;
+	do
+	{
+		bytes = pread(Reader->File, buffer, size, (off_t)offset);
+	} while (bytes < 0 && errno == EINTR);
+
+	*OutBytes = bytes;
+#endif
+
+	return true;
+}
+
+struct MeshEnd
+{
+	uint64_t End;//offset of the mesh's last stream byte inside the image
+	uint32_t Mesh;
+};
+
+static int CompareMeshEnds(const void* A, const void* B)
+{
+	const struct MeshEnd* a = A;
+	const struct MeshEnd* b = B;
+
+	if (a->End != b->End)
+		return a->End < b->End ? -1 : 1;
+
+	return a->Mesh < b->Mesh ? -1 : a->Mesh > b->Mesh;
+}
+
+struct LoadProgress
+{
+	const struct MeshLoaderDesc* Desc;
+	const uint8_t* Image;
+	size_t Size;
+	struct MeshFile* File;
+
+	bool bLayout;//File holds the layout parse of Image
+	bool bWhole;//Image can't be parsed until it's complete
+
+	struct MeshEnd* Ends;//meshes in the order their streams complete
+	uint32_t NextMesh;
+
+	double StartTime;
+	double FirstMeshTime;
+};
+
+static enum MeshFileResult ParseLayout(struct LoadProgress* Progress)
+{
+	enum MeshFileResult Result = MeshFileParseLayout(Progress->Image, Progress->Size, Progress->File);
+	if (Result != MESHFILE_OK)
+		return Result;
+
+	struct MeshFile* file = Progress->File;
+
+	Progress->Ends = malloc((file->MeshCount ? file->MeshCount : 1) * sizeof(struct MeshEnd));
+	if (Progress->Ends == NULL)
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+
+	const uint64_t bufferOffset = (uint64_t)(file->Buffer - Progress->Image);
+
+	for (uint32_t i = 0; i < file->MeshCount; i++)
+	{
+		const struct Mesh* mesh = &file->MeshList[i];
+		uint64_t end = 0;
+
+		for (uint32_t j = 0; j < MESH_STREAM_COUNT; j++)
+		{
+			if (mesh->StreamOffsets[j] == MESHFILE_ATTRIBUTE_NONE)
+				continue;
+
+			const uint64_t streamEnd = mesh->StreamOffsets[j] + MeshStreamSize(mesh, (enum MeshStream)j);
+			if (streamEnd > end)
+				end = streamEnd;
+		}
+
+		Progress->Ends[i].End = bufferOffset + end;
+		Progress->Ends[i].Mesh = i;
+	}
+
+	qsort(Progress->Ends, file->MeshCount, sizeof(struct MeshEnd), CompareMeshEnds);
+	Progress->bLayout = true;
+	return MESHFILE_OK;
+}
+
+//hands out every mesh whose streams lie inside the first Received bytes of the image
+static enum MeshFileResult PublishMeshes(struct LoadProgress* Progress, uint64_t Received)
+{
+	if (!Progress->bLayout && !Progress->bWhole)
+	{
+		const uint64_t layoutSize = MeshFileLayoutSize(Progress->Image, Received < Progress->Size ? (size_t)Received : Progress->Size);
+
+		if (layoutSize == 0)
+			Progress->bWhole = true;
+		else if (layoutSize <= Received)
+		{
+			enum MeshFileResult Result = ParseLayout(Progress);
+			if (Result != MESHFILE_OK)
+				return Result;
+		}
+	}
+
+	if (!Progress->bLayout)
+		return MESHFILE_OK;
+
+	while (Progress->NextMesh < Progress->File->MeshCount && Progress->Ends[Progress->NextMesh].End <= Received)
+	{
+		const uint32_t meshIndex = Progress->Ends[Progress->NextMesh].Mesh;
+
+		if (!MeshFileValidateMesh(&Progress->File->MeshList[meshIndex]))
+			return MESHFILE_ERROR_TRUNCATED;
+
+		if (Progress->NextMesh == 0)
+			Progress->FirstMeshTime = PlatformGetTime() - Progress->StartTime;
+
+		if (Progress->Desc->OnMeshReady != NULL)
+			Progress->Desc->OnMeshReady(Progress->Desc->Context, Progress->File, meshIndex);
+
+		Progress->NextMesh++;
+	}
+
+	return MESHFILE_OK;
+}
+
+//parses an image that couldn't be streamed (compressed or v0 with odd metadata) once it's all in.
+//File owns the image, or the decoded copy of it, afterwards
+static enum MeshFileResult ParseWhole(struct LoadProgress* Progress, uint8_t* Image)
+{
+	enum MeshFileResult Result = MeshFileParse(Image, Progress->Size, Progress->File);
+
+	if (Result != MESHFILE_OK)
+	{
+		free(Image);
+		return Result;
+	}
+
+	if (Progress->File->bOwned)
+		free(Image);//decoded into a new image
+	else
+		Progress->File->bOwned = true;
+
+	Progress->FirstMeshTime = PlatformGetTime() - Progress->StartTime;
+
+	for (uint32_t i = 0; i < Progress->File->MeshCount; i++)
+	{
+		if (Progress->Desc->OnMeshReady != NULL)
+			Progress->Desc->OnMeshReady(Progress->Desc->Context, Progress->File, i);
+	}
+
+	return MESHFILE_OK;
+}
+
+enum MeshFileResult MeshFileLoad(const char* Path, const struct MeshLoaderDesc* Desc, struct MeshFile* File, struct MeshLoaderStats* Stats)
+{
+	const double startTime = PlatformGetTime();
+
+	memset(File, 0, sizeof(*File));
+
+	struct MeshLoaderDesc desc = { 0 };
+	if (Desc != NULL)
+		desc = *Desc;
+
+	if (desc.ChunkSize == 0)
+		desc.ChunkSize = MESH_LOADER_DEFAULT_CHUNK_SIZE;
+
+	if (desc.ChunkSize > UINT32_MAX - MESH_LOADER_CHUNK_ALIGNMENT)
+		desc.ChunkSize = UINT32_MAX - MESH_LOADER_CHUNK_ALIGNMENT;
+
+	desc.ChunkSize = (desc.ChunkSize + MESH_LOADER_CHUNK_ALIGNMENT - 1) & ~(uint32_t)(MESH_LOADER_CHUNK_ALIGNMENT - 1);
+
+	if (desc.QueueDepth == 0)
+		desc.QueueDepth = MESH_LOADER_DEFAULT_QUEUE_DEPTH;
+
+	if (desc.QueueDepth > MESH_LOADER_MAX_QUEUE_DEPTH)
+		desc.QueueDepth = MESH_LOADER_MAX_QUEUE_DEPTH;
+
+	struct MeshLoaderStats stats = { 0 };
+
+	struct Reader reader;
+	uint64_t fileSize;
+
+	if (!ReaderOpen(&reader, Path, desc.Backend, desc.bUnbuffered, desc.ChunkSize, desc.QueueDepth, &stats.bUnbuffered, &fileSize))
+		return MESHFILE_ERROR_OPEN;
+
+	stats.Backend = reader.Backend;
+
+	if (fileSize == 0)
+	{
+		ReaderClose(&reader);
+		return MESHFILE_ERROR_OPEN;
+	}
+
+	if (fileSize > SIZE_MAX)
+	{
+		ReaderClose(&reader);
+		return MESHFILE_ERROR_TOO_LARGE;
+	}
+
+	const uint64_t chunkCount = (fileSize + desc.ChunkSize - 1) / desc.ChunkSize;
+
+	uint8_t* image = malloc((size_t)fileSize);
+	uint8_t* chunkDone = calloc((size_t)chunkCount, 1);
+
+	if (image == NULL || chunkDone == NULL)
+	{
+		free(image);
+		free(chunkDone);
+		ReaderClose(&reader);
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+	}
+
+	struct LoadProgress progress = { 0 };
+	progress.Desc = &desc;
+	progress.Image = image;
+	progress.Size = (size_t)fileSize;
+	progress.File = File;
+	progress.StartTime = startTime;
+
+	enum MeshFileResult Result = MESHFILE_OK;
+	uint64_t nextChunk = 0;
+	uint64_t receivedChunks = 0;//chunks 0 .. receivedChunks-1 are all in
+	uint32_t inFlight = 0;
+
+	for (uint32_t i = 0; i < reader.QueueDepth && nextChunk < chunkCount; i++)
+	{
+		reader.Slots[i].Offset = nextChunk * desc.ChunkSize;
+		reader.Slots[i].Size = (uint32_t)(fileSize - reader.Slots[i].Offset < desc.ChunkSize ? fileSize - reader.Slots[i].Offset : desc.ChunkSize);
+		reader.Slots[i].Filled = 0;
+		nextChunk++;
+
+		if (!ReaderSubmit(&reader, i))
+		{
+			Result = MESHFILE_ERROR_READ;
+			break;
+		}
+
+		inFlight++;
+	}
+
+	while (inFlight != 0)
+	{
+		uint32_t slotIndex;
+		int64_t bytes;
+
+		if (!ReaderWait(&reader, &slotIndex, &bytes) || slotIndex >= reader.QueueDepth)
+		{
+			//reads may still be landing in the staging ring, so it can't be freed
+			reader.StagingAllocation = NULL;
+			Result = MESHFILE_ERROR_READ;
+			break;
+		}
+
+		struct StagingSlot* slot = &reader.Slots[slotIndex];
+
+		//once something failed the remaining reads are only drained
+		if (Result != MESHFILE_OK)
+		{
+			inFlight--;
+			continue;
+		}
+
+		//a read that ends early before the end of its chunk means the file shrank under us
+		if (bytes < 0 || (bytes == 0 && slot->Filled < slot->Size))
+		{
+			Result = MESHFILE_ERROR_READ;
+			inFlight--;
+			continue;
+		}
+
+		slot->Filled += (uint32_t)bytes;
+		stats.BytesRead += (uint64_t)bytes;
+
+		if (slot->Filled < slot->Size)
+		{
+			if (!ReaderSubmit(&reader, slotIndex))
+			{
+				Result = MESHFILE_ERROR_READ;
+				inFlight--;
+			}
+			continue;
+		}
+
+		memcpy(image + slot->Offset, reader.Staging + (size_t)slotIndex * desc.ChunkSize, slot->Size);
+		chunkDone[slot->Offset / desc.ChunkSize] = 1;
+		inFlight--;
+
+		while (receivedChunks < chunkCount && chunkDone[receivedChunks])
+			receivedChunks++;
+
+		if (nextChunk < chunkCount)
+		{
+			slot->Offset = nextChunk * desc.ChunkSize;
+			slot->Size = (uint32_t)(fileSize - slot->Offset < desc.ChunkSize ? fileSize - slot->Offset : desc.ChunkSize);
+			slot->Filled = 0;
+			nextChunk++;
+
+			if (!ReaderSubmit(&reader, slotIndex))
+			{
+				Result = MESHFILE_ERROR_READ;
+				continue;
+			}
+
+			inFlight++;
+		}
+
+		const uint64_t received = receivedChunks * desc.ChunkSize < fileSize ? receivedChunks * desc.ChunkSize : fileSize;
+		Result = PublishMeshes(&progress, received);
+	}
+
+	stats.ReadCount = reader.ReadCount;
+	stats.ReadTime = PlatformGetTime() - startTime;
+	ReaderClose(&reader);
+	free(chunkDone);
+
+	if (Result == MESHFILE_OK && receivedChunks != chunkCount)
+		Result = MESHFILE_ERROR_READ;
+
+	if (Result == MESHFILE_OK)
+	{
+		if (progress.bLayout)
+		{
+			File->bOwned = true;
+			Result = PublishMeshes(&progress, fileSize);
+		}
+		else
+		{
+			//ParseWhole owns the image from here on
+			Result = ParseWhole(&progress, image);
+			image = NULL;
+		}
+	}
+
+	free(progress.Ends);
+
+	if (Result != MESHFILE_OK)
+	{
+		if (File->bOwned)
+			MeshFileClose(File);
+		else
+		{
+			free(File->MeshList);
+			free(image);
+		}
+
+		memset(File, 0, sizeof(*File));
+		return Result;
+	}
+
+	stats.FirstMeshTime = progress.FirstMeshTime;
+	stats.TotalTime = PlatformGetTime() - startTime;
+
+	if (Stats != NULL)
+		*Stats = stats;
+
+	return MESHFILE_OK;
+}
+
+bool MeshLoaderBackendSupported(enum MeshLoaderBackend Backend)
+{
+	switch (Backend)
+	{
+	case MESH_LOADER_BACKEND_AUTO:
+	case MESH_LOADER_BACKEND_PREAD:
+		return true;
+#ifdef MESH_LOADER_IO_URING
+	case MESH_LOADER_BACKEND_IO_URING:
+	{
+		struct Uring ring;
+		if (!UringCreate(&ring, 1))
+			return false;
+
+		UringDestroy(&ring);
+		return true;
+	}
+#endif
+#ifdef _WIN32
+	case MESH_LOADER_BACKEND_OVERLAPPED:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+const char* MeshLoaderBackendName(enum MeshLoaderBackend Backend)
+{
+	switch (Backend)
+	{
+	case MESH_LOADER_BACKEND_AUTO: return "auto";
+	case MESH_LOADER_BACKEND_IO_URING: return "io_uring";
+	case MESH_LOADER_BACKEND_OVERLAPPED: return "overlapped";
+	case MESH_LOADER_BACKEND_PREAD: return "pread";
+	default: return "unknown";
+	}
+}
@@ -0,0 +1,76 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "MeshFile.h"
+
+//streaming MSHL loader: the file is read in ChunkSize pieces with up to QueueDepth reads in flight through a ring
+//of staging buffers (io_uring on linux, overlapped ReadFile on windows, pread everywhere else), and each piece is
+//copied into the image as it lands. uncompressed files are parsed as soon as their metadata is in, and every mesh
+//is handed to OnMeshReady the moment the last byte of its streams arrives, while the rest of the file is still
+//being read. compressed files have to be complete before they decode, so their meshes all come at the end
+
+#define MESH_LOADER_DEFAULT_CHUNK_SIZE (1u << 20)
+#define MESH_LOADER_DEFAULT_QUEUE_DEPTH 8
+#define MESH_LOADER_MAX_QUEUE_DEPTH 64
+
+//ChunkSize is rounded up to this, so unbuffered reads stay sector aligned
+#define MESH_LOADER_CHUNK_ALIGNMENT 4096
+
+enum MeshLoaderBackend
+{
+	MESH_LOADER_BACKEND_AUTO,//io_uring on linux, overlapped on windows, pread if neither is available
+	MESH_LOADER_BACKEND_IO_URING,
+	MESH_LOADER_BACKEND_OVERLAPPED,
+	MESH_LOADER_BACKEND_PREAD,//blocking positioned reads, with readahead hints for the queued chunks
+	MESH_LOADER_BACKEND_COUNT
+};
+
+struct MeshLoaderDesc
+{
+	uint32_t ChunkSize;//0 = MESH_LOADER_DEFAULT_CHUNK_SIZE
+	uint32_t QueueDepth;//0 = MESH_LOADER_DEFAULT_QUEUE_DEPTH, clamped to MESH_LOADER_MAX_QUEUE_DEPTH
+	enum MeshLoaderBackend Backend;//an unsupported backend falls back to MESH_LOADER_BACKEND_PREAD
+	bool bUnbuffered;//bypass the page cache (O_DIRECT / FILE_FLAG_NO_BUFFERING) where the file system allows it
+
+	//called on the loading thread, in the order meshes complete. the mesh's streams are in and validated
+	void* Context;
+	void (*OnMeshReady)(void* Context, const struct MeshFile* File, uint32_t MeshIndex);
+};
+
+struct MeshLoaderStats
+{
+	enum MeshLoaderBackend Backend;
+	bool bUnbuffered;//the file was really opened unbuffered
+
+	double FirstMeshTime;//seconds from the call to the first OnMeshReady
+	double ReadTime;//seconds until the last byte was in
+	double TotalTime;//seconds until the call returned
+
+	uint64_t BytesRead;
+	uint32_t ReadCount;//reads issued, short reads resubmitted included
+};
+
+//Desc may be NULL for the defaults. on success File owns its image (bOwned) and is released with MeshFileClose
+enum MeshFileResult MeshFileLoad(const char* Path, const struct MeshLoaderDesc* Desc, struct MeshFile* File, struct MeshLoaderStats* Stats);
+
+//false if the backend isn't built in or the kernel doesn't have it
+bool MeshLoaderBackendSupported(enum MeshLoaderBackend Backend);
+
+const char* MeshLoaderBackendName(enum MeshLoaderBackend Backend);
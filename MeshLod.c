@@ -0,0 +1,230 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <assert.h>
+
+#include "MeshLod.h"
+
+#ifdef PLATFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef PLATFORM_AVX2
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(struct BoundingSphere) == 16, "simd loads assume a 16 byte BoundingSphere");
+
+void LodViewInit(const float Position[3], float FovY, float ViewportHeight, float PixelError, struct LodView* Out)
+{
+	Out->Position[0] = Position[0];
+	Out->Position[1] = Position[1];
+	Out->Position[2] = Position[2];
+
+	//an error e at distance d covers e * ViewportHeight / (2 * d * tan(FovY / 2)) pixels
+	Out->ErrorPerDistance = PixelError * 2.0f * tanf(FovY * 0.5f) / ViewportHeight;
+}
+
+float MeshLodGeometricError(const struct Mesh* Mesh)
+{
+	const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+	const uint8_t* PositionBase = Mesh->VertexBuffers[Slot].Verts + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_POSITION];
+	const uint32_t Stride = Mesh->VertexBuffers[Slot].Stride;
+
+	double Area = 0.0;
+	uint32_t TriangleCount = 0;
+
+	for (uint32_t i = 0; i + 3 <= Mesh->IndexCount; i += 3)
+	{
+		float p[3][3];
+		for (int k = 0; k < 3; k++)
+		{
+			const uint32_t Index = Mesh->IndexSize == 2 ? ((const uint16_t*)Mesh->IndexBuffer)[i + k] : ((const uint32_t*)Mesh->IndexBuffer)[i + k];
+			memcpy(p[k], PositionBase + (size_t)Index * Stride, sizeof(p[k]));
+		}
+
+		const double e0[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+		const double e1[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+		const double Cross[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+
+		Area += 0.5 * sqrt(Cross[0] * Cross[0] + Cross[1] * Cross[1] + Cross[2] * Cross[2]);
+		TriangleCount++;
+	}
+
+	if (TriangleCount == 0)
+		return 0.0f;
+
+	//an equilateral triangle of side s has area s^2 * sqrt(3) / 4
+	return (float)sqrt(4.0 * Area / (sqrt(3.0) * TriangleCount));
+}
+
+void MeshLodChainInit(const struct Mesh* MeshList, const uint32_t* Levels, uint32_t LevelCount, struct MeshLodChain* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	Out->LevelCount = LevelCount < MESH_LOD_MAX_LEVELS ? LevelCount : MESH_LOD_MAX_LEVELS;
+
+	if (Out->LevelCount == 0)
+		return;
+
+	Out->Bounds = MeshList[Levels[0]].BoundingSphere;
+
+	for (uint32_t i = 0; i < Out->LevelCount; i++)
+	{
+		Out->Meshes[i] = Levels[i];
+
+		if (i == 0)
+			continue;
+
+		//level 0 is exact, the rest are measured against it and kept ordered
+		const float Error = MeshLodGeometricError(&MeshList[Levels[i]]);
+		Out->Errors[i] = Error > Out->Errors[i - 1] ? Error : Out->Errors[i - 1];
+	}
+}
+
+uint32_t SelectLod(const struct LodView* View, const struct MeshLodChain* Chain, const struct BoundingSphere* Bounds)
+{
+	const float Dx = Bounds->Center[0] - View->Position[0];
+	const float Dy = Bounds->Center[1] - View->Position[1];
+	const float Dz = Bounds->Center[2] - View->Position[2];
+
+	//grouped the same way as the simd kernels; the strict compare keeps anything the view is inside at level 0
+	const float Allowed = (sqrtf((Dx * Dx + Dy * Dy) + Dz * Dz) - Bounds->Radius) * View->ErrorPerDistance;
+
+	uint32_t Level = 0;
+	for (uint32_t i = 1; i < Chain->LevelCount; i++)
+		Level += Chain->Errors[i] < Allowed;
+
+	return Level;
+}
+
+static void ScalarSelect(const struct LodView* View, const struct MeshLodChain* Chain, const struct BoundingSphere* Bounds, uint32_t Begin, uint32_t End, uint8_t* OutLevels)
+{
+	for (uint32_t i = Begin; i < End; i++)
+		OutLevels[i] = (uint8_t)SelectLod(View, Chain, &Bounds[i]);
+}
+
+#ifdef PLATFORM_SSE2
+static void Sse2Select(const struct LodView* View, const struct MeshLodChain* Chain, const struct BoundingSphere* Bounds, uint32_t Begin, uint32_t End, uint8_t* OutLevels)
+{
+	uint32_t i = Begin;
+
+	const __m128 Vx = _mm_set1_ps(View->Position[0]);
+	const __m128 Vy = _mm_set1_ps(View->Position[1]);
+	const __m128 Vz = _mm_set1_ps(View->Position[2]);
+	const __m128 ErrorPerDistance = _mm_set1_ps(View->ErrorPerDistance);
+
+	for (; i + 4 <= End; i += 4)
+	{
+		__m128 X = _mm_loadu_ps(Bounds[i + 0].Center);
+		__m128 Y = _mm_loadu_ps(Bounds[i + 1].Center);
+		__m128 Z = _mm_loadu_ps(Bounds[i + 2].Center);
+		__m128 R = _mm_loadu_ps(Bounds[i + 3].Center);
+		_MM_TRANSPOSE4_PS(X, Y, Z, R);
+
+		const __m128 Dx = _mm_sub_ps(X, Vx);
+		const __m128 Dy = _mm_sub_ps(Y, Vy);
+		const __m128 Dz = _mm_sub_ps(Z, Vz);
+
+		const __m128 Distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(Dx, Dx), _mm_mul_ps(Dy, Dy)), _mm_mul_ps(Dz, Dz)));
+		const __m128 Allowed = _mm_mul_ps(_mm_sub_ps(Distance, R), ErrorPerDistance);
+
+		//true lanes are all ones, so subtracting the mask counts the levels that pass
+		__m128i Level = _mm_setzero_si128();
+		for (uint32_t k = 1; k < Chain->LevelCount; k++)
+			Level = _mm_sub_epi32(Level, _mm_castps_si128(_mm_cmplt_ps(_mm_set1_ps(Chain->Errors[k]), Allowed)));
+
+		uint32_t Levels[4];
+		_mm_storeu_si128((__m128i*)Levels, Level);
+
+		for (int Lane = 0; Lane < 4; Lane++)
+			OutLevels[i + Lane] = (uint8_t)Levels[Lane];
+	}
+
+	ScalarSelect(View, Chain, Bounds, i, End, OutLevels);
+}
+#endif
+
+#ifdef PLATFORM_AVX2
+static void Avx2Select(const struct LodView* View, const struct MeshLodChain* Chain, const struct BoundingSphere* Bounds, uint32_t Begin, uint32_t End, uint8_t* OutLevels)
+{
+	uint32_t i = Begin;
+
+	//one BoundingSphere is four floats; gather each field across eight instances
+	const __m256i Offsets = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+
+	const __m256 Vx = _mm256_set1_ps(View->Position[0]);
+	const __m256 Vy = _mm256_set1_ps(View->Position[1]);
+	const __m256 Vz = _mm256_set1_ps(View->Position[2]);
+	const __m256 ErrorPerDistance = _mm256_set1_ps(View->ErrorPerDistance);
+
+	//bytes 0, 4, 8 and 12 of each 128 bit half hold the levels
+	const __m256i PackBytes = _mm256_setr_epi8(
+		0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+	for (; i + 8 <= End; i += 8)
+	{
+		const float* Base = Bounds[i].Center;
+
+		const __m256 X = _mm256_i32gather_ps(Base + 0, Offsets, 4);
+		const __m256 Y = _mm256_i32gather_ps(Base + 1, Offsets, 4);
+		const __m256 Z = _mm256_i32gather_ps(Base + 2, Offsets, 4);
+		const __m256 R = _mm256_i32gather_ps(Base + 3, Offsets, 4);
+
+		const __m256 Dx = _mm256_sub_ps(X, Vx);
+		const __m256 Dy = _mm256_sub_ps(Y, Vy);
+		const __m256 Dz = _mm256_sub_ps(Z, Vz);
+
+		const __m256 Distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(Dx, Dx), _mm256_mul_ps(Dy, Dy)), _mm256_mul_ps(Dz, Dz)));
+		const __m256 Allowed = _mm256_mul_ps(_mm256_sub_ps(Distance, R), ErrorPerDistance);
+
+		__m256i Level = _mm256_setzero_si256();
+		for (uint32_t k = 1; k < Chain->LevelCount; k++)
+			Level = _mm256_sub_epi32(Level, _mm256_castps_si256(_mm256_cmp_ps(_mm256_set1_ps(Chain->Errors[k]), Allowed, _CMP_LT_OQ)));
+
+		const __m256i Packed = _mm256_shuffle_epi8(Level, PackBytes);
+		const uint32_t Low = (uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(Packed));
+		const uint32_t High = (uint32_t)_mm_cvtsi128_si32(_mm256_extracti128_si256(Packed, 1));
+
+		memcpy(&OutLevels[i], &Low, sizeof(Low));
+		memcpy(&OutLevels[i + 4], &High, sizeof(High));
+	}
+
+	ScalarSelect(View, Chain, Bounds, i, End, OutLevels);
+}
+#endif
+
+void SelectLods(const struct LodView* View, const struct MeshLodChain* Chain, const struct BoundingSphere* Bounds, uint32_t Count, enum SimdLevel Kernel, uint8_t* OutLevels)
+{
+	switch (Kernel)
+	{
+#ifdef PLATFORM_AVX2
+	case SIMD_LEVEL_AVX2:
+		Avx2Select(View, Chain, Bounds, 0, Count, OutLevels);
+		break;
+#endif
+#ifdef PLATFORM_SSE2
+	case SIMD_LEVEL_SSE2:
+		Sse2Select(View, Chain, Bounds, 0, Count, OutLevels);
+		break;
+#endif
+	default:
+		ScalarSelect(View, Chain, Bounds, 0, Count, OutLevels);
+		break;
+	}
+}
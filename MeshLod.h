@@ -0,0 +1,61 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "Platform.h"
+#include "MeshFile.h"
+
+//discrete level of detail: a chain of meshes of the same object, most detailed first, each with the geometric error
+//it makes against level 0. a level is good enough once its error, projected to the screen, is under the pixel
+//budget, and the coarsest such level is drawn.
+//
+//MSHL carries no error, so chains loaded from files estimate it from triangle density (MeshLodGeometricError): a
+//level whose average triangle edge is under the budget looks the same as one with finer triangles
+
+#define MESH_LOD_MAX_LEVELS 8
+
+struct MeshLodChain
+{
+	uint32_t LevelCount;
+	uint32_t Meshes[MESH_LOD_MAX_LEVELS];//index of each level in the caller's mesh list
+	float Errors[MESH_LOD_MAX_LEVELS];//object space, Errors[0] = 0 and never decreasing
+	struct BoundingSphere Bounds;//level 0's, which holds every level since simplification doesn't add vertices
+};
+
+struct LodView
+{
+	float Position[3];
+	float ErrorPerDistance;//largest error that may be seen from one unit away
+};
+
+//FovY in radians, ViewportHeight and PixelError in pixels
+void LodViewInit(const float Position[3], float FovY, float ViewportHeight, float PixelError, struct LodView* Out);
+
+//average edge length of the mesh's triangles taken as equilateral
+float MeshLodGeometricError(const struct Mesh* Mesh);
+
+//Levels index MeshList, most detailed first; at most MESH_LOD_MAX_LEVELS are used. errors are estimated
+void MeshLodChainInit(const struct Mesh* MeshList, const uint32_t* Levels, uint32_t LevelCount, struct MeshLodChain* Out);
+
+//scalar reference: the coarsest level whose error is acceptable for an instance with these bounds. inside the
+//sphere that is always level 0
+uint32_t SelectLod(const struct LodView* View, const struct MeshLodChain* Chain, const struct BoundingSphere* Bounds);
+
+//selects a level for each of Count instances of the chain, Bounds are the instances' spheres in the same space as
+//the view. every kernel gives the same levels as SelectLod
+void SelectLods(const struct LodView* View, const struct MeshLodChain* Chain, const struct BoundingSphere* Bounds, uint32_t Count, enum SimdLevel Kernel, uint8_t* OutLevels);
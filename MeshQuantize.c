@@ -0,0 +1,383 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "MeshQuantize.h"
+
+static_assert(sizeof(struct QuantizedVertex) == 12, "the mesh shader loads quantized vertices as three uints");
+
+static const uint8_t* AttributeBase(const struct Mesh* Mesh, enum EType Type, uint32_t* OutStride)
+{
+	const uint32_t Slot = Mesh->AttributeSlots[Type];
+
+	if (Slot == MESHFILE_ATTRIBUTE_NONE)
+		return NULL;
+
+	*OutStride = Mesh->VertexBuffers[Slot].Stride;
+	return Mesh->VertexBuffers[Slot].Verts + Mesh->AttributeOffsets[Type];
+}
+
+void VertexQuantizationInit(const struct Mesh* Mesh, struct VertexQuantization* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	uint32_t Stride;
+	const uint8_t* Positions = AttributeBase(Mesh, ATTRIBUTE_TYPE_POSITION, &Stride);
+
+	if (Positions == NULL || Mesh->VertexCount == 0)
+		return;
+
+	float Min[3], Max[3];
+	memcpy(Min, Positions, sizeof(Min));
+	memcpy(Max, Positions, sizeof(Max));
+
+	for (uint32_t i = 1; i < Mesh->VertexCount; i++)
+	{
+		float p[3];
+		memcpy(p, Positions + (size_t)i * Stride, sizeof(p));
+
+		for (int k = 0; k < 3; k++)
+		{
+			Min[k] = p[k] < Min[k] ? p[k] : Min[k];
+			Max[k] = p[k] > Max[k] ? p[k] : Max[k];
+		}
+	}
+
+	for (int k = 0; k < 3; k++)
+	{
+		Out->Offset[k] = Min[k];
+		Out->Scale[k] = (Max[k] - Min[k]) / QUANTIZED_POSITION_STEPS;
+	}
+}
+
+void DecodeOctahedral(const int16_t Encoded[2], float Out[3])
+{
+	//-32768 is a second -1
+	float x = fmaxf(Encoded[0] / QUANTIZED_NORMAL_STEPS, -1.0f);
+	float y = fmaxf(Encoded[1] / QUANTIZED_NORMAL_STEPS, -1.0f);
+	const float z = 1.0f - fabsf(x) - fabsf(y);
+
+	//the lower hemisphere is folded over the diagonals of the square; unfold it
+	const float t = fmaxf(-z, 0.0f);
+	x += x >= 0.0f ? -t : t;
+	y += y >= 0.0f ? -t : t;
+
+	const float Length = sqrtf(x * x + y * y + z * z);
+
+	Out[0] = x / Length;
+	Out[1] = y / Length;
+	Out[2] = z / Length;
+}
+
+static int16_t QuantizeSnorm(float Value, float (*Round)(float))
+{
+	const float Steps = Round(Value * QUANTIZED_NORMAL_STEPS);
+	return (int16_t)(Steps < -QUANTIZED_NORMAL_STEPS ? -QUANTIZED_NORMAL_STEPS : Steps > QUANTIZED_NORMAL_STEPS ? QUANTIZED_NORMAL_STEPS : Steps);
+}
+
+void EncodeOctahedral(const float Normal[3], int16_t Out[2])
+{
+	Out[0] = 0;
+	Out[1] = 0;
+
+	const float Sum = fabsf(Normal[0]) + fabsf(Normal[1]) + fabsf(Normal[2]);
+
+	if (!(Sum > 0.0f) || !isfinite(Sum))
+		return;
+
+	//project onto the octahedron |x| + |y| + |z| = 1, then fold the lower half out to the corners
+	float x = Normal[0] / Sum;
+	float y = Normal[1] / Sum;
+
+	if (Normal[2] < 0.0f)
+	{
+		const float FoldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		const float FoldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = FoldedX;
+		y = FoldedY;
+	}
+
+	//nearest rounding isn't always the nearest direction, so try all four neighbours of the exact point. they're
+	//compared by distance rather than by dot product, which float can't resolve this close to 1
+	const float Length = sqrtf(Normal[0] * Normal[0] + Normal[1] * Normal[1] + Normal[2] * Normal[2]);
+	const float Unit[3] = { Normal[0] / Length, Normal[1] / Length, Normal[2] / Length };
+	float BestDistance = FLT_MAX;
+
+	for (int k = 0; k < 4; k++)
+	{
+		const int16_t Candidate[2] = { QuantizeSnorm(x, k & 1 ? ceilf : floorf), QuantizeSnorm(y, k & 2 ? ceilf : floorf) };
+
+		float Decoded[3];
+		DecodeOctahedral(Candidate, Decoded);
+
+		const float Dx = Decoded[0] - Unit[0];
+		const float Dy = Decoded[1] - Unit[1];
+		const float Dz = Decoded[2] - Unit[2];
+		const float Distance = Dx * Dx + Dy * Dy + Dz * Dz;
+
+		if (Distance < BestDistance)
+		{
+			BestDistance = Distance;
+			Out[0] = Candidate[0];
+			Out[1] = Candidate[1];
+		}
+	}
+}
+
+void QuantizeVertices(const struct Mesh* Mesh, const struct VertexQuantization* Quantization, uint32_t First, uint32_t Count, struct QuantizedVertex* Out)
+{
+	uint32_t PositionStride = 0, NormalStride = 0;
+	const uint8_t* Positions = AttributeBase(Mesh, ATTRIBUTE_TYPE_POSITION, &PositionStride);
+	const uint8_t* Normals = AttributeBase(Mesh, ATTRIBUTE_TYPE_NORMAL, &NormalStride);
+
+	float InverseScale[3];
+	for (int k = 0; k < 3; k++)
+		InverseScale[k] = Quantization->Scale[k] > 0.0f ? 1.0f / Quantization->Scale[k] : 0.0f;
+
+	for (uint32_t i = First; i < First + Count; i++)
+	{
+		struct QuantizedVertex Vertex = { 0 };
+
+		if (Positions != NULL)
+		{
+			float p[3];
+			memcpy(p, Positions + (size_t)i * PositionStride, sizeof(p));
+
+			for (int k = 0; k < 3; k++)
+			{
+				const float Steps = roundf((p[k] - Quantization->Offset[k]) * InverseScale[k]);
+				Vertex.Position[k] = (uint16_t)(Steps > 0.0f ? (Steps < QUANTIZED_POSITION_STEPS ? Steps : QUANTIZED_POSITION_STEPS) : 0.0f);
+			}
+		}
+
+		if (Normals != NULL)
+		{
+			float n[3];
+			memcpy(n, Normals + (size_t)i * NormalStride, sizeof(n));
+			EncodeOctahedral(n, Vertex.Normal);
+		}
+
+		Out[i] = Vertex;
+	}
+}
+
+void QuantizeNormals(const struct Mesh* Mesh, uint32_t First, uint32_t Count, int16_t (*Out)[2])
+{
+	uint32_t NormalStride = 0;
+	const uint8_t* Normals = AttributeBase(Mesh, ATTRIBUTE_TYPE_NORMAL, &NormalStride);
+
+	for (uint32_t i = First; i < First + Count; i++)
+	{
+		float n[3] = { 0.0f, 0.0f, 1.0f };
+
+		if (Normals != NULL)
+			memcpy(n, Normals + (size_t)i * NormalStride, sizeof(n));
+
+		EncodeOctahedral(n, Out[i]);
+	}
+}
+
+void DequantizeVertices(const struct QuantizedVertex* Vertices, uint32_t Count, const struct VertexQuantization* Quantization, float* OutPositions, float* OutNormals)
+{
+	for (uint32_t i = 0; i < Count; i++)
+	{
+		if (OutPositions != NULL)
+		{
+			for (int k = 0; k < 3; k++)
+				OutPositions[i * 3 + k] = Quantization->Offset[k] + Vertices[i].Position[k] * Quantization->Scale[k];
+		}
+
+		if (OutNormals != NULL)
+			DecodeOctahedral(Vertices[i].Normal, &OutNormals[i * 3]);
+	}
+}
+
+static_assert(sizeof(struct MeshletPositionHeader) == 20, "the mesh shader loads meshlet position headers as five uints");
+
+static uint32_t BitWidth(uint32_t Value)
+{
+	uint32_t Bits = 0;
+	while (Value >> Bits)
+		Bits++;
+	return Bits;
+}
+
+static void WriteBits(uint32_t* Data, uint64_t Bit, uint32_t Value, uint32_t Bits)
+{
+	if (Bits == 0)
+		return;
+
+	const uint32_t Word = (uint32_t)(Bit >> 5);
+	const uint32_t Shift = (uint32_t)(Bit & 31);
+
+	Data[Word] |= Value << Shift;
+
+	if (Shift + Bits > 32)
+		Data[Word + 1] |= Value >> (32 - Shift);
+}
+
+static uint32_t ReadBits(const uint32_t* Data, uint64_t Bit, uint32_t Bits)
+{
+	if (Bits == 0)
+		return 0;
+
+	const uint32_t Word = (uint32_t)(Bit >> 5);
+	const uint32_t Shift = (uint32_t)(Bit & 31);
+
+	uint32_t Value = Data[Word] >> Shift;
+
+	if (Shift + Bits > 32)
+		Value |= Data[Word + 1] << (32 - Shift);
+
+	return Bits == 32 ? Value : Value & ((1u << Bits) - 1);
+}
+
+bool BuildMeshletPositions(const struct Mesh* Mesh, uint32_t Bits, struct MeshletPositions* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	uint32_t Stride;
+	const uint8_t* Positions = AttributeBase(Mesh, ATTRIBUTE_TYPE_POSITION, &Stride);
+
+	if (Bits == 0 || Bits > MESHLET_POSITION_MAX_BITS || Positions == NULL)
+		return false;
+
+	//a cubic grid over the mesh's box
+	VertexQuantizationInit(Mesh, &Out->Grid);
+
+	const float MaxCell = (float)((1u << Bits) - 1);
+	const float Extent = fmaxf(Out->Grid.Scale[0], fmaxf(Out->Grid.Scale[1], Out->Grid.Scale[2])) * QUANTIZED_POSITION_STEPS;
+	const float Step = Extent / MaxCell;
+	const float InverseStep = Step > 0.0f ? 1.0f / Step : 0.0f;
+
+	for (int k = 0; k < 3; k++)
+		Out->Grid.Scale[k] = Step;
+
+	Out->Bits = Bits;
+	Out->HeaderCount = Mesh->MeshletCount;
+	Out->Headers = calloc(Mesh->MeshletCount ? Mesh->MeshletCount : 1, sizeof(struct MeshletPositionHeader));
+	uint32_t (*Cells)[3] = malloc(sizeof(uint32_t[3]) * (Mesh->VertexCount ? Mesh->VertexCount : 1));
+
+	if (Out->Headers == NULL || Cells == NULL)
+	{
+		free(Cells);
+		MeshletPositionsFree(Out);
+		return false;
+	}
+
+	for (uint32_t v = 0; v < Mesh->VertexCount; v++)
+	{
+		float p[3];
+		memcpy(p, Positions + (size_t)v * Stride, sizeof(p));
+
+		for (int k = 0; k < 3; k++)
+		{
+			const float Cell = roundf((p[k] - Out->Grid.Offset[k]) * InverseStep);
+			Cells[v][k] = (uint32_t)(Cell > 0.0f ? (Cell < MaxCell ? Cell : MaxCell) : 0.0f);
+		}
+	}
+
+	//boxes and bit widths first, which sizes the data
+	uint64_t WordCount = 1;
+
+	for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+		struct MeshletPositionHeader* Header = &Out->Headers[m];
+		uint32_t Min[3] = { UINT32_MAX, UINT32_MAX, UINT32_MAX }, Max[3] = { 0, 0, 0 };
+
+		for (uint32_t i = 0; i < Meshlet->VertCount; i++)
+		{
+			const uint32_t* Cell = Cells[MeshletVertexIndex(Mesh, Meshlet->VertOffset + i)];
+
+			for (int k = 0; k < 3; k++)
+			{
+				Min[k] = Cell[k] < Min[k] ? Cell[k] : Min[k];
+				Max[k] = Cell[k] > Max[k] ? Cell[k] : Max[k];
+			}
+		}
+
+		for (int k = 0; k < 3; k++)
+		{
+			Header->Base[k] = Meshlet->VertCount ? Min[k] : 0;
+			Header->Bits[k] = (uint8_t)(Meshlet->VertCount ? BitWidth(Max[k] - Min[k]) : 0);
+		}
+
+		Header->DataOffset = (uint32_t)(WordCount - 1);
+		WordCount += ((uint64_t)Meshlet->VertCount * (Header->Bits[0] + Header->Bits[1] + Header->Bits[2]) + 31) / 32;
+	}
+
+	Out->DataCount = WordCount > UINT32_MAX ? 0 : (uint32_t)WordCount;
+	Out->Data = Out->DataCount ? calloc(Out->DataCount, sizeof(uint32_t)) : NULL;
+
+	if (Out->Data == NULL)
+	{
+		free(Cells);
+		MeshletPositionsFree(Out);
+		return false;
+	}
+
+	for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+		const struct MeshletPositionHeader* Header = &Out->Headers[m];
+		uint64_t Plane = (uint64_t)Header->DataOffset * 32;
+
+		for (int k = 0; k < 3; k++)
+		{
+			for (uint32_t i = 0; i < Meshlet->VertCount; i++)
+			{
+				const uint32_t* Cell = Cells[MeshletVertexIndex(Mesh, Meshlet->VertOffset + i)];
+				WriteBits(Out->Data, Plane + (uint64_t)i * Header->Bits[k], Cell[k] - Header->Base[k], Header->Bits[k]);
+			}
+
+			Plane += (uint64_t)Meshlet->VertCount * Header->Bits[k];
+		}
+	}
+
+	free(Cells);
+	return true;
+}
+
+void DecodeMeshletPositions(const struct MeshletPositions* Positions, const struct Mesh* Mesh, uint32_t MeshletIndex, float* Out)
+{
+	const struct Meshlet* Meshlet = &Mesh->Meshlets[MeshletIndex];
+	const struct MeshletPositionHeader* Header = &Positions->Headers[MeshletIndex];
+	uint64_t Plane = (uint64_t)Header->DataOffset * 32;
+
+	for (int k = 0; k < 3; k++)
+	{
+		//the cell is summed as an integer and converted once, like the shader does, so every meshlet gets the same float
+		for (uint32_t i = 0; i < Meshlet->VertCount; i++)
+		{
+			const uint32_t Cell = Header->Base[k] + ReadBits(Positions->Data, Plane + (uint64_t)i * Header->Bits[k], Header->Bits[k]);
+			Out[i * 3 + k] = Positions->Grid.Offset[k] + (float)Cell * Positions->Grid.Scale[k];
+		}
+
+		Plane += (uint64_t)Meshlet->VertCount * Header->Bits[k];
+	}
+}
+
+void MeshletPositionsFree(struct MeshletPositions* Positions)
+{
+	free(Positions->Headers);
+	free(Positions->Data);
+	memset(Positions, 0, sizeof(*Positions));
+}
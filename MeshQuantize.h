@@ -0,0 +1,98 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "MeshFile.h"
+
+//quantized vertices for the mesh shader: 12 bytes instead of a float3 position and a float3 normal.
+//positions become 16 bit unorm steps across the mesh's bounding box, so the error is at most half a step per axis.
+//normals are octahedral encoded, the unit sphere folded onto a square, at 16 bit snorm per axis; the encoder tries
+//both roundings of each axis and keeps the one that decodes closest. decoding is the same arithmetic as
+//MeshletMS.hlsl's
+
+#define QUANTIZED_POSITION_STEPS 65535.0f
+#define QUANTIZED_NORMAL_STEPS 32767.0f
+
+struct QuantizedVertex
+{
+	uint16_t Position[3];
+	uint16_t Reserved;//0, keeps Normal 4 byte aligned for the shader's loads
+	int16_t Normal[2];
+};
+
+//what a mesh's positions decode with: Offset + Position * Scale
+struct VertexQuantization
+{
+	float Offset[3];//the box's minimum
+	float Scale[3];//its extent / QUANTIZED_POSITION_STEPS, 0 on flat axes
+};
+
+//the box of every vertex in the mesh's vertex buffer, not only the indexed ones, so meshes sharing a buffer agree
+void VertexQuantizationInit(const struct Mesh* Mesh, struct VertexQuantization* Out);
+
+//writes the mesh's vertices First .. First + Count - 1 to the same places in Out. meshes without normals get +z
+void QuantizeVertices(const struct Mesh* Mesh, const struct VertexQuantization* Quantization, uint32_t First, uint32_t Count, struct QuantizedVertex* Out);
+
+//the normals alone, 4 bytes a vertex as QuantizedVertex stores them, for meshes whose positions come from
+//MeshletPositions instead. writes vertices First .. First + Count - 1 to the same places in Out
+void QuantizeNormals(const struct Mesh* Mesh, uint32_t First, uint32_t Count, int16_t (*Out)[2]);
+
+//decodes Count vertices to float3 positions and unit normals; either output may be NULL
+void DequantizeVertices(const struct QuantizedVertex* Vertices, uint32_t Count, const struct VertexQuantization* Quantization, float* OutPositions, float* OutNormals);
+
+//Normal needn't be unit length; a zero or non finite one encodes as +z
+void EncodeOctahedral(const float Normal[3], int16_t Out[2]);
+void DecodeOctahedral(const int16_t Encoded[2], float Out[3]);
+
+//per meshlet positions: every vertex is snapped to one grid across the mesh, 2^Bits - 1 steps along its longest
+//axis, and each meshlet stores its vertices as offsets from its own box minimum on that grid, with only as many
+//bits per axis as its box needs. a vertex shared by meshlets decodes from the same grid cell in each, through the
+//same arithmetic, so borders are bit exact and can't crack.
+//a meshlet's data is three bit planes, x then y then z, of VertCount values each in meshlet vertex order, padded to
+//a whole uint32
+
+#define MESHLET_POSITION_MAX_BITS 24//grid coordinates stay exact in a float
+
+struct MeshletPositionHeader
+{
+	uint32_t Base[3];//grid cell of the meshlet's box minimum
+	uint32_t DataOffset;//first uint32 of the meshlet's planes
+	uint8_t Bits[3];//per axis, 0 when every vertex has the same coordinate
+	uint8_t Reserved;
+};
+
+struct MeshletPositions
+{
+	struct VertexQuantization Grid;//the same step on every axis
+	uint32_t Bits;
+
+	struct MeshletPositionHeader* Headers;//one per meshlet of the mesh
+	uint32_t HeaderCount;
+
+	uint32_t* Data;
+	uint32_t DataCount;//in uint32s, with one spare at the end so a reader may always load two
+};
+
+//Bits 1 .. MESHLET_POSITION_MAX_BITS. false if memory runs out or Bits is out of range
+bool BuildMeshletPositions(const struct Mesh* Mesh, uint32_t Bits, struct MeshletPositions* Out);
+
+//decodes meshlet MeshletIndex's VertCount positions to float3s in meshlet vertex order
+void DecodeMeshletPositions(const struct MeshletPositions* Positions, const struct Mesh* Mesh, uint32_t MeshletIndex, float* Out);
+
+void MeshletPositionsFree(struct MeshletPositions* Positions);
@@ -0,0 +1,656 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "MeshScene.h"
+#include "MeshBounds.h"
+#include "MeshletCull.h"
+
+static inline uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+{
+	return (Value + Alignment - 1) / Alignment * Alignment;
+}
+
+static char* CopyString(const char* String, size_t Length)
+{
+	char* copy = malloc(Length + 1);
+
+	if (copy != NULL)
+	{
+		memcpy(copy, String, Length);
+		copy[Length] = '\0';
+	}
+
+	return copy;
+}
+
+static bool IsAbsolutePath(const char* Path)
+{
+	return Path[0] == '/' || Path[0] == '\\' || (Path[0] != '\0' && Path[1] == ':');
+}
+
+//splits the manifest into resolved paths. returns false if it can't be read or a line is too long
+static bool ReadManifest(const char* ManifestPath, char*** OutPaths, uint32_t* OutCount)
+{
+	*OutPaths = NULL;
+	*OutCount = 0;
+
+	FILE* manifest = fopen(ManifestPath, "rb");
+	if (manifest == NULL)
+		return false;
+
+	char* text = NULL;
+	size_t textSize = 0;
+	bool bRead = fseek(manifest, 0, SEEK_END) == 0;
+	const long length = bRead ? ftell(manifest) : -1;
+
+	if (length >= 0 && fseek(manifest, 0, SEEK_SET) == 0 && (text = malloc((size_t)length + 1)) != NULL)
+		textSize = fread(text, 1, (size_t)length, manifest);
+
+	fclose(manifest);
+
+	if (text == NULL || textSize != (size_t)length)
+	{
+		free(text);
+		return false;
+	}
+
+	text[textSize] = '\0';
+
+	//paths are relative to the directory the manifest is in
+	size_t directoryLength = strlen(ManifestPath);
+	while (directoryLength > 0 && ManifestPath[directoryLength - 1] != '/' && ManifestPath[directoryLength - 1] != '\\')
+		directoryLength--;
+
+	uint32_t lineCount = 1;
+	for (size_t i = 0; i < textSize; i++)
+		lineCount += text[i] == '\n';
+
+	char** paths = calloc(lineCount, sizeof(char*));
+	uint32_t count = 0;
+	bool bValid = paths != NULL;
+
+	for (char* line = text; bValid && line < text + textSize + 1;)
+	{
+		char* end = line;
+		while (*end != '\0' && *end != '\n')
+			end++;
+
+		char* next = end + 1;
+
+		while (line < end && (*line == ' ' || *line == '\t'))
+			line++;
+
+		while (end > line && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+			end--;
+
+		const size_t lineLength = (size_t)(end - line);
+
+		if (lineLength != 0 && line[0] != '#')
+		{
+			*end = '\0';
+			const size_t prefix = IsAbsolutePath(line) ? 0 : directoryLength;
+
+			if (prefix + lineLength >= MESH_SCENE_MAX_PATH || (paths[count] = malloc(prefix + lineLength + 1)) == NULL)
+			{
+				bValid = false;
+				break;
+			}
+
+			memcpy(paths[count], ManifestPath, prefix);
+			memcpy(paths[count] + prefix, line, lineLength + 1);
+			count++;
+		}
+
+		line = next;
+	}
+
+	free(text);
+
+	if (!bValid)
+	{
+		for (uint32_t i = 0; paths != NULL && i < count; i++)
+			free(paths[i]);
+
+		free(paths);
+		return false;
+	}
+
+	*OutPaths = paths;
+	*OutCount = count;
+	return true;
+}
+
+//index of the 0 in a _LOD0 that ends the file name (extension aside), 0 if there isn't one
+static size_t FindLodDigit(const char* Path)
+{
+	const size_t length = strlen(Path);
+
+	size_t nameStart = length;
+	while (nameStart > 0 && Path[nameStart - 1] != '/' && Path[nameStart - 1] != '\\')
+		nameStart--;
+
+	const char* extension = strrchr(Path + nameStart, '.');
+	const size_t nameEnd = extension != NULL ? (size_t)(extension - Path) : length;
+
+	if (nameEnd - nameStart < 5 || memcmp(Path + nameEnd - 5, "_LOD0", 5) != 0)
+		return 0;
+
+	return nameEnd - 1;
+}
+
+static bool FileExists(const char* Path)
+{
+	FILE* file = fopen(Path, "rb");
+
+	if (file != NULL)
+		fclose(file);
+
+	return file != NULL;
+}
+
+//inserts the coarser levels that exist after every _LOD0 path. on success the old path array is released and
+//OutLevels gets the level of each file, 0 for everything that isn't a coarser level; on failure nothing changes
+static bool ExpandLodPaths(char*** Paths, uint32_t* FileCount, uint8_t** OutLevels)
+{
+	char** paths = calloc((size_t)*FileCount * MESH_LOD_MAX_LEVELS + 1, sizeof(char*));
+	uint8_t* levels = calloc((size_t)*FileCount * MESH_LOD_MAX_LEVELS + 1, 1);
+	uint32_t count = 0;
+	bool bValid = paths != NULL && levels != NULL;
+
+	for (uint32_t i = 0; bValid && i < *FileCount; i++)
+	{
+		const char* path = (*Paths)[i];
+		const size_t digit = FindLodDigit(path);
+
+		paths[count++] = (char*)path;
+
+		for (uint32_t level = 1; digit != 0 && level < MESH_LOD_MAX_LEVELS; level++)
+		{
+			char* sibling = CopyString(path, strlen(path));
+
+			if (sibling == NULL)
+			{
+				bValid = false;
+				break;
+			}
+
+			sibling[digit] = (char)('0' + level);
+
+			if (!FileExists(sibling))
+			{
+				free(sibling);
+				break;
+			}
+
+			levels[count] = (uint8_t)level;
+			paths[count++] = sibling;
+		}
+	}
+
+	if (!bValid)
+	{
+		for (uint32_t i = 0; paths != NULL && i < count; i++)
+		{
+			if (levels[i] != 0)
+				free(paths[i]);
+		}
+
+		free(paths);
+		free(levels);
+		return false;
+	}
+
+	free(*Paths);
+	*Paths = paths;
+	*FileCount = count;
+	*OutLevels = levels;
+	return true;
+}
+
+struct SceneLoadTask
+{
+	char** Paths;
+	const struct MeshLoaderDesc* Desc;
+	struct MeshFile* Files;
+	enum MeshFileResult* Results;
+	double* ReadTimes;
+	double* ParseTimes;
+	uint64_t* BytesRead;
+};
+
+static void LoadSceneFile(void* Context, uint32_t FileIndex)
+{
+	struct SceneLoadTask* task = Context;
+	struct MeshLoaderStats stats;
+
+	const double start = PlatformGetTime();
+	enum MeshFileResult Result = MeshFileLoad(task->Paths[FileIndex], task->Desc, &task->Files[FileIndex], &stats);
+
+	// Older files keep their streams unaligned; every file has to be a blob to share the scene buffer
+	if (Result == MESHFILE_OK)
+		Result = MeshFileRepack(&task->Files[FileIndex]);
+
+	if (Result == MESHFILE_OK)
+	{
+		task->ReadTimes[FileIndex] = stats.ReadTime;
+		task->ParseTimes[FileIndex] = PlatformGetTime() - start - stats.ReadTime;
+		task->BytesRead[FileIndex] = stats.BytesRead;
+	}
+
+	task->Results[FileIndex] = Result;
+}
+
+//one chain per mesh of each file that isn't a coarser level, taking in the levels that follow it
+static enum MeshFileResult BuildLodChains(struct MeshScene* Scene, const uint8_t* FileLevels, const uint32_t* FileMeshOffsets, uint32_t* FailedFile)
+{
+	uint32_t chainCount = 0;
+
+	for (uint32_t i = 0; i < Scene->FileCount; i++)
+	{
+		if (FileLevels[i] == 0)
+			chainCount += Scene->Files[i].MeshCount;
+	}
+
+	Scene->LodChains = malloc((chainCount ? chainCount : 1) * sizeof(struct MeshLodChain));
+
+	if (Scene->LodChains == NULL)
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+
+	for (uint32_t i = 0; i < Scene->FileCount; i++)
+	{
+		if (FileLevels[i] != 0)
+			continue;
+
+		uint32_t levelCount = 1;
+		while (i + levelCount < Scene->FileCount && FileLevels[i + levelCount] == levelCount)
+		{
+			// Mesh j of every level is the same object
+			if (Scene->Files[i + levelCount].MeshCount != Scene->Files[i].MeshCount)
+			{
+				*FailedFile = i + levelCount;
+				return MESHFILE_ERROR_LOD_MISMATCH;
+			}
+
+			levelCount++;
+		}
+
+		for (uint32_t j = 0; j < Scene->Files[i].MeshCount; j++)
+		{
+			uint32_t levels[MESH_LOD_MAX_LEVELS];
+
+			for (uint32_t k = 0; k < levelCount; k++)
+				levels[k] = FileMeshOffsets[i + k] + j;
+
+			MeshLodChainInit(Scene->MeshList, levels, levelCount, &Scene->LodChains[Scene->LodChainCount++]);
+		}
+	}
+
+	return MESHFILE_OK;
+}
+
+static enum MeshFileResult MergeScene(struct MeshScene* Scene, const uint8_t* FileLevels, uint32_t* FailedFile)
+{
+	uint64_t bufferSize = 0;
+	uint64_t meshCount = 0;
+
+	for (uint32_t i = 0; i < Scene->FileCount; i++)
+	{
+		bufferSize = AlignUp(bufferSize, MESHFILE_BUFFER_ALIGNMENT);
+		Scene->FileBufferOffsets[i] = bufferSize;
+		bufferSize += Scene->Files[i].BufferSize;
+		meshCount += Scene->Files[i].MeshCount;
+	}
+
+	// StreamOffsets are 32 bit, so that's as far as the scene buffer can go
+	if (bufferSize > UINT32_MAX || meshCount > UINT32_MAX)
+		return MESHFILE_ERROR_TOO_LARGE;
+
+	Scene->BufferSize = (uint32_t)bufferSize;
+
+	Scene->MeshList = malloc((meshCount ? meshCount : 1) * sizeof(struct Mesh));
+	Scene->MeshFileIndices = malloc((meshCount ? meshCount : 1) * sizeof(uint32_t));
+	Scene->MeshletOffsets = malloc((meshCount ? meshCount : 1) * sizeof(uint32_t));
+	uint32_t* fileMeshOffsets = malloc((Scene->FileCount ? Scene->FileCount : 1) * sizeof(uint32_t));
+
+	if (Scene->MeshList == NULL || Scene->MeshFileIndices == NULL || Scene->MeshletOffsets == NULL || fileMeshOffsets == NULL)
+	{
+		free(fileMeshOffsets);
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+	}
+
+	uint64_t meshletCount = 0;
+
+	for (uint32_t i = 0; i < Scene->FileCount; i++)
+	{
+		fileMeshOffsets[i] = Scene->MeshCount;
+
+		for (uint32_t j = 0; j < Scene->Files[i].MeshCount; j++)
+		{
+			struct Mesh* mesh = &Scene->MeshList[Scene->MeshCount];
+			*mesh = Scene->Files[i].MeshList[j];
+
+			for (uint32_t s = 0; s < MESH_STREAM_COUNT; s++)
+			{
+				if (mesh->StreamOffsets[s] != MESHFILE_ATTRIBUTE_NONE)
+					mesh->StreamOffsets[s] += (uint32_t)Scene->FileBufferOffsets[i];
+			}
+
+			Scene->MeshFileIndices[Scene->MeshCount] = i;
+			Scene->MeshletOffsets[Scene->MeshCount] = (uint32_t)meshletCount;
+			Scene->MeshCount++;
+
+			meshletCount += mesh->MeshletCount;
+		}
+	}
+
+	Scene->MeshletCount = (uint32_t)meshletCount;
+
+	// Level selection needs the spheres, which the files don't store
+	struct BoundingSphere sceneSphere;
+	ComputeMeshBounds(Scene->MeshList, Scene->MeshCount, PlatformSimdBest(), 0, &sceneSphere);
+
+	enum MeshFileResult Result = meshletCount > UINT32_MAX ? MESHFILE_ERROR_TOO_LARGE : BuildLodChains(Scene, FileLevels, fileMeshOffsets, FailedFile);
+
+	free(fileMeshOffsets);
+	return Result;
+}
+
+//takes ownership of Paths
+static enum MeshFileResult LoadScene(char** Paths, uint32_t FileCount, uint32_t ThreadCount, const struct MeshLoaderDesc* Desc, struct MeshScene* Scene, struct MeshSceneStats* Stats)
+{
+	uint8_t* fileLevels = NULL;
+	const bool bExpanded = ExpandLodPaths(&Paths, &FileCount, &fileLevels);
+
+	Scene->Paths = Paths;
+	Scene->FileCount = FileCount;
+	Scene->Files = calloc(FileCount ? FileCount : 1, sizeof(struct MeshFile));
+	Scene->FileBufferOffsets = calloc(FileCount ? FileCount : 1, sizeof(uint64_t));
+
+	enum MeshFileResult* results = calloc(FileCount ? FileCount : 1, sizeof(enum MeshFileResult));
+	double* times = calloc(FileCount ? FileCount * 2 : 1, sizeof(double));
+	uint64_t* bytes = calloc(FileCount ? FileCount : 1, sizeof(uint64_t));
+
+	if (!bExpanded || Scene->Files == NULL || Scene->FileBufferOffsets == NULL || results == NULL || times == NULL || bytes == NULL)
+	{
+		free(fileLevels);
+		free(results);
+		free(times);
+		free(bytes);
+		MeshSceneFree(Scene);
+		return MESHFILE_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (ThreadCount == 0)
+		ThreadCount = PlatformGetProcessorCount();
+
+	if (ThreadCount > FileCount)
+		ThreadCount = FileCount ? FileCount : 1;
+
+	Stats->ThreadCount = ThreadCount;
+
+	struct SceneLoadTask task = { Paths, Desc, Scene->Files, results, times, times + FileCount, bytes };
+
+	const double loadStart = PlatformGetTime();
+	PlatformParallelFor(FileCount, ThreadCount, LoadSceneFile, &task);
+	Stats->LoadTime = PlatformGetTime() - loadStart;
+
+	enum MeshFileResult Result = MESHFILE_OK;
+
+	for (uint32_t i = 0; i < FileCount; i++)
+	{
+		if (results[i] != MESHFILE_OK && Result == MESHFILE_OK)
+		{
+			Result = results[i];
+			Stats->FailedFile = i;
+			snprintf(Stats->FailedPath, sizeof(Stats->FailedPath), "%s", Paths[i]);
+		}
+
+		Stats->FileReadTime += times[i];
+		Stats->FileParseTime += times[FileCount + i];
+		Stats->BytesRead += bytes[i];
+	}
+
+	free(results);
+	free(times);
+	free(bytes);
+
+	if (Result == MESHFILE_OK)
+	{
+		const double mergeStart = PlatformGetTime();
+		Result = MergeScene(Scene, fileLevels, &Stats->FailedFile);
+		Stats->MergeTime = PlatformGetTime() - mergeStart;
+
+		if (Result == MESHFILE_ERROR_LOD_MISMATCH)
+			snprintf(Stats->FailedPath, sizeof(Stats->FailedPath), "%s", Paths[Stats->FailedFile]);
+	}
+
+	free(fileLevels);
+
+	if (Result != MESHFILE_OK)
+		MeshSceneFree(Scene);
+
+	return Result;
+}
+
+enum MeshFileResult MeshSceneLoad(const char* ManifestPath, uint32_t ThreadCount, const struct MeshLoaderDesc* Desc, struct MeshScene* Scene, struct MeshSceneStats* Stats)
+{
+	struct MeshSceneStats stats = { 0 };
+	stats.FailedFile = UINT32_MAX;
+
+	memset(Scene, 0, sizeof(*Scene));
+
+	const double start = PlatformGetTime();
+
+	char** paths;
+	uint32_t count;
+	enum MeshFileResult Result;
+
+	snprintf(stats.FailedPath, sizeof(stats.FailedPath), "%s", ManifestPath);
+
+	if (!ReadManifest(ManifestPath, &paths, &count))
+		Result = MESHFILE_ERROR_OPEN;
+	else if (count == 0)
+	{
+		free(paths);
+		Result = MESHFILE_ERROR_OPEN;
+	}
+	else
+	{
+		stats.ManifestTime = PlatformGetTime() - start;
+		Result = LoadScene(paths, count, ThreadCount, Desc, Scene, &stats);
+	}
+
+	if (Stats != NULL)
+		*Stats = stats;
+
+	return Result;
+}
+
+enum MeshFileResult MeshSceneLoadFiles(const char* const* Paths, uint32_t FileCount, uint32_t ThreadCount, const struct MeshLoaderDesc* Desc, struct MeshScene* Scene, struct MeshSceneStats* Stats)
+{
+	struct MeshSceneStats stats = { 0 };
+	stats.FailedFile = UINT32_MAX;
+
+	memset(Scene, 0, sizeof(*Scene));
+
+	char** paths = calloc(FileCount ? FileCount : 1, sizeof(char*));
+	enum MeshFileResult Result = paths ? MESHFILE_OK : MESHFILE_ERROR_OUT_OF_MEMORY;
+
+	for (uint32_t i = 0; i < FileCount && Result == MESHFILE_OK; i++)
+	{
+		if ((paths[i] = CopyString(Paths[i], strlen(Paths[i]))) == NULL)
+			Result = MESHFILE_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (Result == MESHFILE_OK)
+		Result = LoadScene(paths, FileCount, ThreadCount, Desc, Scene, &stats);
+	else
+	{
+		for (uint32_t i = 0; paths != NULL && i < FileCount; i++)
+			free(paths[i]);
+
+		free(paths);
+	}
+
+	if (Stats != NULL)
+		*Stats = stats;
+
+	return Result;
+}
+
+void MeshSceneCopyBuffer(const struct MeshScene* Scene, void* Out)
+{
+	uint8_t* out = Out;
+	uint64_t written = 0;
+
+	for (uint32_t i = 0; i < Scene->FileCount; i++)
+	{
+		memset(out + written, 0, (size_t)(Scene->FileBufferOffsets[i] - written));
+		memcpy(out + Scene->FileBufferOffsets[i], Scene->Files[i].Buffer, Scene->Files[i].BufferSize);
+		written = Scene->FileBufferOffsets[i] + Scene->Files[i].BufferSize;
+	}
+}
+
+//vertices quantized per task; big meshes are split so one of them doesn't leave the other workers idle
+#define QUANTIZE_CHUNK_SIZE 16384
+
+struct SceneQuantizeTask
+{
+	const struct MeshScene* Scene;
+	uint8_t* Buffer;
+	const struct VertexQuantization* Quantizations;
+	const uint32_t* FirstChunks;//each mesh's first chunk, MeshCount + 1 entries
+	bool bNormalsOnly;
+};
+
+static void QuantizeSceneChunk(void* Context, uint32_t TaskIndex)
+{
+	const struct SceneQuantizeTask* task = Context;
+
+	//the last mesh whose first chunk is at or before this one
+	uint32_t low = 0, high = task->Scene->MeshCount;
+	while (high - low > 1)
+	{
+		const uint32_t middle = (low + high) / 2;
+
+		if (task->FirstChunks[middle] <= TaskIndex)
+			low = middle;
+		else
+			high = middle;
+	}
+
+	const struct Mesh* mesh = &task->Scene->MeshList[low];
+	const uint32_t first = (TaskIndex - task->FirstChunks[low]) * QUANTIZE_CHUNK_SIZE;
+	const uint32_t count = mesh->VertexCount - first < QUANTIZE_CHUNK_SIZE ? mesh->VertexCount - first : QUANTIZE_CHUNK_SIZE;
+
+	//reads go to the files, so meshes sharing a vertex stream just write the same vertices twice
+	uint8_t* stream = task->Buffer + mesh->StreamOffsets[MESH_STREAM_VERTICES];
+
+	if (task->bNormalsOnly)
+		QuantizeNormals(mesh, first, count, (int16_t (*)[2])stream);
+	else
+		QuantizeVertices(mesh, &task->Quantizations[low], first, count, (struct QuantizedVertex*)stream);
+}
+
+void MeshSceneQuantizeVertices(const struct MeshScene* Scene, void* Buffer, uint32_t ThreadCount, bool bNormalsOnly, struct VertexQuantization* Out)
+{
+	uint32_t* firstChunks = malloc(sizeof(uint32_t) * ((size_t)Scene->MeshCount + 1));
+	uint32_t chunkCount = 0;
+
+	for (uint32_t i = 0; i < Scene->MeshCount; i++)
+	{
+		const struct Mesh* mesh = &Scene->MeshList[i];
+
+		VertexQuantizationInit(mesh, &Out[i]);
+
+		if (firstChunks == NULL)
+		{
+			if (mesh->StreamOffsets[MESH_STREAM_VERTICES] == MESHFILE_ATTRIBUTE_NONE)
+				continue;
+
+			uint8_t* stream = (uint8_t*)Buffer + mesh->StreamOffsets[MESH_STREAM_VERTICES];
+
+			if (bNormalsOnly)
+				QuantizeNormals(mesh, 0, mesh->VertexCount, (int16_t (*)[2])stream);
+			else
+				QuantizeVertices(mesh, &Out[i], 0, mesh->VertexCount, (struct QuantizedVertex*)stream);
+
+			continue;
+		}
+
+		firstChunks[i] = chunkCount;
+
+		if (mesh->StreamOffsets[MESH_STREAM_VERTICES] != MESHFILE_ATTRIBUTE_NONE)
+			chunkCount += (mesh->VertexCount + QUANTIZE_CHUNK_SIZE - 1) / QUANTIZE_CHUNK_SIZE;
+	}
+
+	//out of memory: done one mesh at a time above
+	if (firstChunks == NULL)
+		return;
+
+	firstChunks[Scene->MeshCount] = chunkCount;
+
+	struct SceneQuantizeTask task = { Scene, Buffer, Out, firstChunks, bNormalsOnly };
+	PlatformParallelFor(chunkCount, ThreadCount, QuantizeSceneChunk, &task);
+
+	free(firstChunks);
+}
+
+void MeshSceneEncodeTriangles(const struct MeshScene* Scene, void* Buffer, enum TriangleFormat Format, enum TriangleFormat* OutFormats)
+{
+	for (uint32_t i = 0; i < Scene->MeshCount; i++)
+	{
+		const struct Mesh* mesh = &Scene->MeshList[i];
+
+		//encoded from the file's copy, so the buffer is only written once the whole stream is known to fit
+		void* stream = (uint8_t*)Buffer + mesh->StreamOffsets[MESH_STREAM_PRIMITIVE_INDICES];
+		OutFormats[i] = EncodeTriangles(mesh->PrimitiveIndices, mesh->PrimitiveIndexCount, Format, stream) ? Format : TRIANGLE_FORMAT_PACKED10;
+	}
+}
+
+void MeshSceneEncodeCullData(const struct MeshScene* Scene, void* Buffer)
+{
+	for (uint32_t i = 0; i < Scene->MeshCount; i++)
+	{
+		const struct Mesh* mesh = &Scene->MeshList[i];
+		CullDataToGpu(mesh->CullingData, mesh->CullingDataCount, (struct CullData*)((uint8_t*)Buffer + mesh->StreamOffsets[MESH_STREAM_CULL_DATA]));
+	}
+}
+
+void MeshSceneFree(struct MeshScene* Scene)
+{
+	for (uint32_t i = 0; i < Scene->FileCount; i++)
+	{
+		if (Scene->Files != NULL)
+			MeshFileClose(&Scene->Files[i]);
+
+		if (Scene->Paths != NULL)
+			free(Scene->Paths[i]);
+	}
+
+	free(Scene->Files);
+	free(Scene->Paths);
+	free(Scene->FileBufferOffsets);
+	free(Scene->MeshList);
+	free(Scene->MeshFileIndices);
+	free(Scene->MeshletOffsets);
+	free(Scene->LodChains);
+
+	memset(Scene, 0, sizeof(*Scene));
+}
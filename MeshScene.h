@@ -0,0 +1,105 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "MeshFile.h"
+#include "MeshLoader.h"
+#include "MeshLod.h"
+#include "MeshQuantize.h"
+#include "MeshletTriangles.h"
+
+//a scene is many MSHL files loaded side by side. every file is streamed in and repacked to FILE_VERSION_BLOB by a
+//pool of workers, then the meshes are merged into one list whose StreamOffsets point into a single scene buffer:
+//each file's buffer is placed at the next MESHFILE_BUFFER_ALIGNMENT boundary and its streams are rebased by that
+//much, so the whole scene goes to the gpu as one buffer.
+//
+//the manifest is a text file with one MSHL path per line, relative to the manifest's directory unless absolute.
+//blank lines and lines starting with # are skipped.
+//
+//a file whose name ends in _LOD0 (before the extension) brings in its _LOD1, _LOD2 .. siblings, as many as exist in
+//a row, as coarser levels of the same meshes; list only the _LOD0 file. every level needs the same mesh count
+
+//longest path a manifest line may hold
+#define MESH_SCENE_MAX_PATH 1024
+
+struct MeshScene
+{
+	struct MeshFile* Files;
+	char** Paths;
+	uint64_t* FileBufferOffsets;//where each file's buffer starts in the scene buffer
+	uint32_t FileCount;
+
+	//copies of every file's meshes in manifest order, with their bounding spheres filled in. the cpu pointers still
+	//point into the files, StreamOffsets are relative to the scene buffer
+	struct Mesh* MeshList;
+	uint32_t* MeshFileIndices;//which file each mesh came from
+	uint32_t* MeshletOffsets;//first meshlet of each mesh when all the scene's meshlets are numbered one after another
+	uint32_t MeshCount;
+	uint32_t MeshletCount;
+
+	//what gets drawn: one chain per mesh of every file that isn't a coarser level of another, indexing MeshList.
+	//meshes without levels are one level chains
+	struct MeshLodChain* LodChains;
+	uint32_t LodChainCount;
+
+	uint32_t BufferSize;
+};
+
+struct MeshSceneStats
+{
+	uint32_t ThreadCount;
+	uint32_t FailedFile;//index of the file that made the load fail, UINT32_MAX if the manifest itself did
+	char FailedPath[MESH_SCENE_MAX_PATH];
+
+	double ManifestTime;
+	double LoadTime;//wall time of the worker pool
+	double MergeTime;
+
+	//summed over files, so LoadTime against these shows how well the pool scales
+	double FileReadTime;
+	double FileParseTime;//everything after the last byte was in: layout parse, validation and repack
+	uint64_t BytesRead;
+};
+
+//ThreadCount 0 = one per processor. Desc is passed to every file's MeshFileLoad and may be NULL; its OnMeshReady
+//runs on the worker threads, with the file's own mesh index
+enum MeshFileResult MeshSceneLoad(const char* ManifestPath, uint32_t ThreadCount, const struct MeshLoaderDesc* Desc, struct MeshScene* Scene, struct MeshSceneStats* Stats);
+
+//the same without a manifest
+enum MeshFileResult MeshSceneLoadFiles(const char* const* Paths, uint32_t FileCount, uint32_t ThreadCount, const struct MeshLoaderDesc* Desc, struct MeshScene* Scene, struct MeshSceneStats* Stats);
+
+//writes the scene buffer, BufferSize bytes, to Out; the gaps between files are zeroed
+void MeshSceneCopyBuffer(const struct MeshScene* Scene, void* Out);
+
+//rewrites each mesh's vertex stream in a buffer MeshSceneCopyBuffer filled as QuantizedVertex, from the start of the
+//stream (12 bytes a vertex always fit in a slot that holds a float3). Out gets MeshCount quantizations.
+//bNormalsOnly writes only QuantizedVertex's 4 byte normals, for positions that come from MeshletPositions.
+//ThreadCount 0 = one per processor
+void MeshSceneQuantizeVertices(const struct MeshScene* Scene, void* Buffer, uint32_t ThreadCount, bool bNormalsOnly, struct VertexQuantization* Out);
+
+//rewrites each mesh's primitive stream in a buffer MeshSceneCopyBuffer filled in Format, from the start of the
+//stream (no format is bigger than PackedTriangle). a mesh whose indices don't fit keeps TRIANGLE_FORMAT_PACKED10;
+//OutFormats gets what each of the MeshCount meshes ended up with
+void MeshSceneEncodeTriangles(const struct MeshScene* Scene, void* Buffer, enum TriangleFormat Format, enum TriangleFormat* OutFormats);
+
+//rewrites each mesh's cull data stream in a buffer MeshSceneCopyBuffer filled with CullDataToGpu, for MeshletAS.hlsl
+void MeshSceneEncodeCullData(const struct MeshScene* Scene, void* Buffer);
+
+void MeshSceneFree(struct MeshScene* Scene);
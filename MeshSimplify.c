@@ -0,0 +1,557 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "MeshSimplify.h"
+
+static const uint32_t EMPTY_SLOT = UINT32_MAX;
+
+//symmetric 4x4 plane quadric, upper triangle: a2 ab ac ad b2 bc bd c2 cd d2
+struct Quadric
+{
+	double m[10];
+};
+
+struct Collapse
+{
+	float cost;
+	uint32_t from;
+	uint32_t to;
+	uint32_t fromVersion;
+	uint32_t toVersion;
+};
+
+struct Simplifier
+{
+	const float* positions;
+	uint32_t positionStride;
+
+	uint32_t* triangles;//3 welded vertex ids per triangle, rewritten as vertices collapse
+	uint8_t* triangleAlive;
+	uint32_t aliveCount;
+
+	//vertex -> corners (triangle * 3 + k) that use it, as linked lists so a collapse can splice one into another.
+	//corners of dead triangles stay in the lists and are skipped
+	uint32_t* cornerHead;
+	uint32_t* cornerNext;
+
+	struct Quadric* quadrics;
+	uint32_t* versions;
+	uint8_t* bLocked;
+	uint8_t* bRemoved;
+	uint32_t* pushStamps;//collapse number that last requeued the edge to each vertex, so each edge goes in once
+
+	struct Collapse* heap;
+	uint32_t heapCount;
+	uint32_t heapCapacity;
+};
+
+static inline const float* GetPosition(const struct Simplifier* s, uint32_t vertex)
+{
+	return (const float*)((const uint8_t*)s->positions + (size_t)vertex * s->positionStride);
+}
+
+static inline uint32_t HashKey(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdull;
+	key ^= key >> 33;
+	return (uint32_t)key;
+}
+
+static uint32_t TableSize(uint32_t count)
+{
+	uint32_t size = 1;
+	while (size < count * 2)
+		size <<= 1;
+
+	return size;
+}
+
+bool WeldPositions(const float* Positions, uint32_t PositionStride, uint32_t VertexCount, uint32_t* Remap)
+{
+	const struct Simplifier s = { .positions = Positions, .positionStride = PositionStride };
+	const uint32_t size = TableSize(VertexCount);
+	uint32_t* table = malloc(sizeof(uint32_t) * size);
+
+	if (table == NULL)
+		return false;
+
+	memset(table, 0xff, sizeof(uint32_t) * size);
+
+	for (uint32_t v = 0; v < VertexCount; v++)
+	{
+		uint32_t bits[3];
+		memcpy(bits, GetPosition(&s, v), sizeof(bits));
+
+		const uint64_t key = ((uint64_t)bits[0] * 73856093u) ^ ((uint64_t)bits[1] * 19349663u << 11) ^ ((uint64_t)bits[2] * 83492791u << 22);
+		uint32_t slot = HashKey(key) & (size - 1);
+
+		for (;; slot = (slot + 1) & (size - 1))
+		{
+			if (table[slot] == EMPTY_SLOT)
+			{
+				table[slot] = v;
+				Remap[v] = v;
+				break;
+			}
+
+			if (memcmp(GetPosition(&s, table[slot]), bits, sizeof(bits)) == 0)
+			{
+				Remap[v] = table[slot];
+				break;
+			}
+		}
+	}
+
+	free(table);
+	return true;
+}
+
+//locks the ends of every edge that doesn't have exactly two triangles: open borders and non-manifold fans
+static bool LockBorders(struct Simplifier* s, uint32_t triangleCount)
+{
+	const uint32_t size = TableSize(triangleCount * 3);
+	uint64_t* keys = malloc(sizeof(uint64_t) * size);
+	uint32_t* counts = calloc(size, sizeof(uint32_t));
+
+	if (keys == NULL || counts == NULL)
+	{
+		free(keys);
+		free(counts);
+		return false;
+	}
+
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		if (!s->triangleAlive[t])
+			continue;
+
+		for (int k = 0; k < 3; k++)
+		{
+			uint32_t a = s->triangles[t * 3 + k];
+			uint32_t b = s->triangles[t * 3 + (k + 1) % 3];
+
+			if (a > b)
+			{
+				const uint32_t swap = a;
+				a = b;
+				b = swap;
+			}
+
+			const uint64_t key = ((uint64_t)a << 32) | b;
+			uint32_t slot = HashKey(key) & (size - 1);
+
+			while (counts[slot] != 0 && keys[slot] != key)
+				slot = (slot + 1) & (size - 1);
+
+			keys[slot] = key;
+			counts[slot]++;
+		}
+	}
+
+	for (uint32_t slot = 0; slot < size; slot++)
+	{
+		if (counts[slot] != 0 && counts[slot] != 2)
+		{
+			s->bLocked[keys[slot] >> 32] = 1;
+			s->bLocked[keys[slot] & UINT32_MAX] = 1;
+		}
+	}
+
+	free(keys);
+	free(counts);
+	return true;
+}
+
+static void TriangleNormal(const float* a, const float* b, const float* c, double* out)
+{
+	const double e0[3] = { (double)b[0] - a[0], (double)b[1] - a[1], (double)b[2] - a[2] };
+	const double e1[3] = { (double)c[0] - a[0], (double)c[1] - a[1], (double)c[2] - a[2] };
+
+	out[0] = e0[1] * e1[2] - e0[2] * e1[1];
+	out[1] = e0[2] * e1[0] - e0[0] * e1[2];
+	out[2] = e0[0] * e1[1] - e0[1] * e1[0];
+}
+
+static void AddTriangleQuadric(struct Simplifier* s, const uint32_t* triangle)
+{
+	const float* p0 = GetPosition(s, triangle[0]);
+
+	double n[3];
+	TriangleNormal(p0, GetPosition(s, triangle[1]), GetPosition(s, triangle[2]), n);
+
+	const double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+	if (length == 0.0)
+		return;
+
+	//unit plane, so the error is a distance and doesn't depend on how finely the surface is tessellated
+	const double a = n[0] / length, b = n[1] / length, c = n[2] / length;
+	const double d = -(a * p0[0] + b * p0[1] + c * p0[2]);
+	const double plane[10] = { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d };
+
+	for (int k = 0; k < 3; k++)
+	{
+		for (int i = 0; i < 10; i++)
+			s->quadrics[triangle[k]].m[i] += plane[i];
+	}
+}
+
+static double QuadricError(const struct Quadric* q, const float* p)
+{
+	const double x = p[0], y = p[1], z = p[2];
+	const double* m = q->m;
+
+	const double error =
+		m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x +
+		m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y +
+		m[7] * z * z + 2.0 * m[8] * z +
+		m[9];
+
+	return error > 0.0 ? error : 0.0;
+}
+
+//false if moving from onto to would flip or collapse one of from's triangles that survive
+static bool CollapseKeepsOrientation(const struct Simplifier* s, uint32_t from, uint32_t to)
+{
+	const float* target = GetPosition(s, to);
+
+	for (uint32_t corner = s->cornerHead[from]; corner != EMPTY_SLOT; corner = s->cornerNext[corner])
+	{
+		const uint32_t t = corner / 3;
+
+		if (!s->triangleAlive[t])
+			continue;
+
+		const uint32_t* triangle = &s->triangles[t * 3];
+
+		if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+			continue;
+
+		const uint32_t k = corner % 3;
+		const float* p1 = GetPosition(s, triangle[(k + 1) % 3]);
+		const float* p2 = GetPosition(s, triangle[(k + 2) % 3]);
+
+		double before[3], after[3];
+		TriangleNormal(GetPosition(s, from), p1, p2, before);
+		TriangleNormal(target, p1, p2, after);
+
+		const double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+		const double beforeLength = sqrt(before[0] * before[0] + before[1] * before[1] + before[2] * before[2]);
+		const double afterLength = sqrt(after[0] * after[0] + after[1] * after[1] + after[2] * after[2]);
+
+		//the new triangle has to face within ~75 degrees of the old one
+		if (dot <= 0.25 * beforeLength * afterLength)
+			return false;
+	}
+
+	return true;
+}
+
+static bool HeapPush(struct Simplifier* s, struct Collapse collapse)
+{
+	if (s->heapCount == s->heapCapacity)
+	{
+		const uint32_t capacity = s->heapCapacity * 2;
+		struct Collapse* heap = realloc(s->heap, sizeof(struct Collapse) * capacity);
+
+		if (heap == NULL)
+			return false;
+
+		s->heap = heap;
+		s->heapCapacity = capacity;
+	}
+
+	uint32_t i = s->heapCount++;
+
+	while (i > 0 && s->heap[(i - 1) / 2].cost > collapse.cost)
+	{
+		s->heap[i] = s->heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+
+	s->heap[i] = collapse;
+	return true;
+}
+
+static struct Collapse HeapPop(struct Simplifier* s)
+{
+	const struct Collapse top = s->heap[0];
+	const struct Collapse last = s->heap[--s->heapCount];
+
+	uint32_t i = 0;
+
+	for (;;)
+	{
+		uint32_t child = i * 2 + 1;
+
+		if (child >= s->heapCount)
+			break;
+
+		if (child + 1 < s->heapCount && s->heap[child + 1].cost < s->heap[child].cost)
+			child++;
+
+		if (s->heap[child].cost >= last.cost)
+			break;
+
+		s->heap[i] = s->heap[child];
+		i = child;
+	}
+
+	if (s->heapCount != 0)
+		s->heap[i] = last;
+
+	return top;
+}
+
+static double CollapseCost(const struct Simplifier* s, uint32_t from, uint32_t to)
+{
+	struct Quadric sum;
+
+	for (int i = 0; i < 10; i++)
+		sum.m[i] = s->quadrics[from].m[i] + s->quadrics[to].m[i];
+
+	return QuadricError(&sum, GetPosition(s, to));
+}
+
+//queues whichever direction of the edge is cheaper among the ones allowed to move
+static bool PushEdge(struct Simplifier* s, uint32_t a, uint32_t b)
+{
+	const double costA = s->bLocked[a] ? INFINITY : CollapseCost(s, a, b);
+	const double costB = s->bLocked[b] ? INFINITY : CollapseCost(s, b, a);
+
+	if (costA == INFINITY && costB == INFINITY)
+		return true;
+
+	const uint32_t from = costA <= costB ? a : b;
+	const uint32_t to = from == a ? b : a;
+
+	const struct Collapse collapse = {
+		.cost = (float)(costA <= costB ? costA : costB),
+		.from = from,
+		.to = to,
+		.fromVersion = s->versions[from],
+		.toVersion = s->versions[to]
+	};
+
+	return HeapPush(s, collapse);
+}
+
+static void ApplyCollapse(struct Simplifier* s, uint32_t from, uint32_t to)
+{
+	uint32_t last = EMPTY_SLOT;
+
+	for (uint32_t corner = s->cornerHead[from]; corner != EMPTY_SLOT; corner = s->cornerNext[corner])
+	{
+		last = corner;
+		const uint32_t t = corner / 3;
+
+		if (!s->triangleAlive[t])
+			continue;
+
+		uint32_t* triangle = &s->triangles[t * 3];
+
+		if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+		{
+			s->triangleAlive[t] = 0;
+			s->aliveCount--;
+		}
+		else
+		{
+			triangle[corner % 3] = to;
+		}
+	}
+
+	//splice from's corners onto the front of to's list
+	if (last != EMPTY_SLOT)
+	{
+		s->cornerNext[last] = s->cornerHead[to];
+		s->cornerHead[to] = s->cornerHead[from];
+		s->cornerHead[from] = EMPTY_SLOT;
+	}
+
+	for (int i = 0; i < 10; i++)
+		s->quadrics[to].m[i] += s->quadrics[from].m[i];
+
+	s->bRemoved[from] = 1;
+	s->versions[from]++;
+	s->versions[to]++;
+}
+
+static void FreeSimplifier(struct Simplifier* s)
+{
+	free(s->triangles);
+	free(s->triangleAlive);
+	free(s->cornerHead);
+	free(s->cornerNext);
+	free(s->quadrics);
+	free(s->versions);
+	free(s->bLocked);
+	free(s->bRemoved);
+	free(s->pushStamps);
+	free(s->heap);
+}
+
+uint32_t SimplifyMesh(const float* Positions, uint32_t PositionStride, uint32_t VertexCount, const uint32_t* Indices, uint32_t IndexCount,
+	const bool* Locked, uint32_t TargetIndexCount, float TargetError, uint32_t* Out, float* OutError)
+{
+	*OutError = 0.0f;
+
+	const uint32_t triangleCount = IndexCount / 3;
+
+	struct Simplifier s = { 0 };
+	s.positions = Positions;
+	s.positionStride = PositionStride;
+	s.heapCapacity = triangleCount + 16;
+
+	uint32_t* remap = malloc(sizeof(uint32_t) * (VertexCount ? VertexCount : 1));
+	s.triangles = malloc(sizeof(uint32_t) * (triangleCount * 3 + 1));
+	s.triangleAlive = malloc(triangleCount + 1);
+	s.cornerHead = malloc(sizeof(uint32_t) * (VertexCount + 1));
+	s.cornerNext = malloc(sizeof(uint32_t) * (triangleCount * 3 + 1));
+	s.quadrics = calloc(VertexCount + 1, sizeof(struct Quadric));
+	s.versions = calloc(VertexCount + 1, sizeof(uint32_t));
+	s.bLocked = calloc(VertexCount + 1, 1);
+	s.bRemoved = calloc(VertexCount + 1, 1);
+	s.pushStamps = calloc(VertexCount + 1, sizeof(uint32_t));
+	s.heap = malloc(sizeof(struct Collapse) * s.heapCapacity);
+
+	if (remap == NULL || s.triangles == NULL || s.triangleAlive == NULL || s.cornerHead == NULL || s.cornerNext == NULL ||
+		s.quadrics == NULL || s.versions == NULL || s.bLocked == NULL || s.bRemoved == NULL || s.pushStamps == NULL || s.heap == NULL ||
+		!WeldPositions(Positions, PositionStride, VertexCount, remap))
+	{
+		free(remap);
+		FreeSimplifier(&s);
+		*OutError = -1.0f;
+		return 0;
+	}
+
+	memset(s.cornerHead, 0xff, sizeof(uint32_t) * VertexCount);
+
+	for (uint32_t v = 0; v < VertexCount; v++)
+	{
+		if (Locked != NULL && Locked[v])
+			s.bLocked[remap[v]] = 1;
+	}
+
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		uint32_t* triangle = &s.triangles[t * 3];
+
+		for (int k = 0; k < 3; k++)
+			triangle[k] = remap[Indices[t * 3 + k]];
+
+		s.triangleAlive[t] = triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[0] != triangle[2];
+
+		if (!s.triangleAlive[t])
+			continue;
+
+		s.aliveCount++;
+		AddTriangleQuadric(&s, triangle);
+
+		for (int k = 0; k < 3; k++)
+		{
+			s.cornerNext[t * 3 + k] = s.cornerHead[triangle[k]];
+			s.cornerHead[triangle[k]] = t * 3 + k;
+		}
+	}
+
+	free(remap);
+
+	bool bValid = LockBorders(&s, triangleCount);
+
+	//each interior edge is seen once from each side, queue it from the side where it runs low to high
+	for (uint32_t t = 0; bValid && t < triangleCount; t++)
+	{
+		if (!s.triangleAlive[t])
+			continue;
+
+		for (int k = 0; k < 3 && bValid; k++)
+		{
+			const uint32_t a = s.triangles[t * 3 + k];
+			const uint32_t b = s.triangles[t * 3 + (k + 1) % 3];
+
+			if (a < b)
+				bValid = PushEdge(&s, a, b);
+		}
+	}
+
+	const double maxCost = (double)TargetError * TargetError;
+	double largestCost = 0.0;
+	uint32_t collapseCount = 0;
+
+	while (bValid && s.heapCount != 0 && s.aliveCount * 3 > TargetIndexCount)
+	{
+		if (s.heap[0].cost > maxCost)
+			break;
+
+		const struct Collapse collapse = HeapPop(&s);
+
+		if (s.bRemoved[collapse.from] || s.bRemoved[collapse.to] ||
+			s.versions[collapse.from] != collapse.fromVersion || s.versions[collapse.to] != collapse.toVersion)
+			continue;
+
+		//the neighbourhood may have changed since the edge was queued
+		if (!CollapseKeepsOrientation(&s, collapse.from, collapse.to))
+			continue;
+
+		ApplyCollapse(&s, collapse.from, collapse.to);
+
+		if (collapse.cost > largestCost)
+			largestCost = collapse.cost;
+
+		//every edge around the merged vertex has a new cost
+		collapseCount++;
+
+		for (uint32_t corner = s.cornerHead[collapse.to]; bValid && corner != EMPTY_SLOT; corner = s.cornerNext[corner])
+		{
+			const uint32_t t = corner / 3;
+
+			if (!s.triangleAlive[t])
+				continue;
+
+			for (uint32_t k = 1; bValid && k < 3; k++)
+			{
+				const uint32_t neighbour = s.triangles[t * 3 + (corner % 3 + k) % 3];
+
+				if (s.pushStamps[neighbour] != collapseCount)
+				{
+					s.pushStamps[neighbour] = collapseCount;
+					bValid = PushEdge(&s, collapse.to, neighbour);
+				}
+			}
+		}
+	}
+
+	uint32_t outCount = 0;
+
+	for (uint32_t t = 0; bValid && t < triangleCount; t++)
+	{
+		if (!s.triangleAlive[t])
+			continue;
+
+		memcpy(&Out[outCount], &s.triangles[t * 3], sizeof(uint32_t) * 3);
+		outCount += 3;
+	}
+
+	FreeSimplifier(&s);
+
+	*OutError = bValid ? (float)sqrt(largestCost) : -1.0f;
+	return outCount;
+}
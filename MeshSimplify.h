@@ -0,0 +1,35 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//quadric error edge collapse simplifier over an indexed triangle list.
+//vertices with the same position are welded first, so attribute seams don't stop collapses. every collapse moves
+//one vertex onto a neighbour and no vertex is ever created, so the result indexes the caller's vertex buffer (the
+//first vertex of each welded group). vertices on open or non-manifold edges never move, nor do any the caller locks,
+//which keeps borders between separately simplified pieces crack free. collapses that would flip a triangle are skipped
+
+//writes the simplified list to Out (IndexCount entries are enough) and returns its length. collapses stop once the
+//list is down to TargetIndexCount or the cheapest one left would exceed TargetError; OutError gets the largest error of
+//the collapses made. errors are object space distances, the square root of the plane quadric error.
+//Locked may be NULL. returns 0 with *OutError < 0 if memory runs out
+uint32_t SimplifyMesh(const float* Positions, uint32_t PositionStride, uint32_t VertexCount, const uint32_t* Indices, uint32_t IndexCount,
+	const bool* Locked, uint32_t TargetIndexCount, float TargetError, uint32_t* Out, float* OutError);
+
+//welds vertices with bitwise equal positions: Remap[v] = the first vertex with v's position. false if memory runs out
+bool WeldPositions(const float* Positions, uint32_t PositionStride, uint32_t VertexCount, uint32_t* Remap);
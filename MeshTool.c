@@ -0,0 +1,5734 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+//headless command line front end for the MSHL asset library, no window or gpu required
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "Platform.h"
+#include "MeshFile.h"
+#include "MeshCodec.h"
+#include "MeshBounds.h"
+#include "MeshletCull.h"
+#include "MeshletCullMath.h"
+#include "MeshletBuilder.h"
+#include "MeshLoader.h"
+#include "MeshScene.h"
+#include "MeshSimplify.h"
+#include "MeshLod.h"
+#include "MeshletDag.h"
+#include "MeshQuantize.h"
+#include "MeshletTriangles.h"
+#include "MeshletIndexless.h"
+#include "MeshletLocality.h"
+#include "StagingRing.h"
+#include "HeapAllocator.h"
+#include "UploadScheduler.h"
+#include "FramePacer.h"
+#include "FrameTelemetry.h"
+#include "CameraPath.h"
+#include "MeshInstances.h"
+#include "FrameDraws.h"
+
+//sums every 64th byte so each page of the mapping is faulted in, and the compiler can't drop the loop
+static uint64_t TouchPages(const void* Data, size_t Size)
+{
+	const uint8_t* Bytes = Data;
+	uint64_t Sum = 0;
+
+	for (size_t i = 0; i < Size; i += 64)
+		Sum += Bytes[i];
+
+	return Sum;
+}
+
+static int CommandInfo(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool info <file.bin>...\n");
+		return EXIT_FAILURE;
+	}
+
+	int ExitCode = EXIT_SUCCESS;
+
+	for (int f = 0; f < ArgCount; f++)
+	{
+		struct MeshFile File;
+
+		const double OpenStart = PlatformGetTime();
+		enum MeshFileResult Result = MeshFileOpen(Args[f], &File);
+		const double OpenEnd = PlatformGetTime();
+
+		if (Result != MESHFILE_OK)
+		{
+			fprintf(stderr, "%s: %s\n", Args[f], MeshFileResultString(Result));
+			ExitCode = EXIT_FAILURE;
+			continue;
+		}
+
+		const uint64_t Checksum = TouchPages(File.Data, File.Size);
+		const double TouchEnd = PlatformGetTime();
+
+		printf("%s: %zu bytes, version %u%s, %u meshes\n", Args[f], File.Size, File.Version, File.bCompressed ? " (decoded from compressed)" : "", File.MeshCount);
+
+		for (uint32_t i = 0; i < File.MeshCount; i++)
+		{
+			const struct Mesh* Mesh = &File.MeshList[i];
+
+			printf("  mesh %u\n", i);
+			printf("    vertices         %u (%u buffers, stride %u)\n", Mesh->VertexCount, Mesh->VertexBufferCount, Mesh->VertexBufferCount ? Mesh->VertexBuffers[0].Stride : 0);
+			printf("    indices          %u x %u bytes, %u subsets\n", Mesh->IndexCount, Mesh->IndexSize, Mesh->IndexSubsetCount);
+			printf("    triangles        %u\n", Mesh->IndexCount / 3);
+			printf("    meshlets         %u, %u subsets\n", Mesh->MeshletCount, Mesh->MeshletSubsetCount);
+			printf("    unique indices   %u bytes\n", Mesh->UniqueVertexIndexCount);
+			printf("    primitives       %u\n", Mesh->PrimitiveIndexCount);
+			printf("    cull data        %u\n", Mesh->CullingDataCount);
+
+			if (Mesh->MeshletCount)
+			{
+				uint64_t MeshletVertices = 0;
+				for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+					MeshletVertices += Mesh->Meshlets[m].VertCount;
+
+				printf("    avg verts/prims  %.1f / %.1f per meshlet\n",
+					(double)MeshletVertices / Mesh->MeshletCount,
+					(double)Mesh->PrimitiveIndexCount / Mesh->MeshletCount);
+
+				uint32_t MaxVertices, MaxPrimitives;
+				MeshMeshletLimits(Mesh, &MaxVertices, &MaxPrimitives);
+				printf("    meshlet limits   %u / %u%s\n", MaxVertices, MaxPrimitives, Mesh->MeshletMaxVertices ? "" : " (not recorded)");
+				printf("    meshlet layout   %s\n", (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS) ? "indexless" : "indexed");
+			}
+		}
+
+		const double MegaBytes = (double)File.Size / (1024.0 * 1024.0);
+		printf("  open+parse %.3f ms, page-in %.3f ms, %.1f MB/s (checksum %llu)\n",
+			(OpenEnd - OpenStart) * 1000.0,
+			(TouchEnd - OpenEnd) * 1000.0,
+			MegaBytes / (TouchEnd - OpenStart),
+			(unsigned long long)Checksum);
+
+		MeshFileClose(&File);
+	}
+
+	return ExitCode;
+}
+
+//largest distance any position sits outside Sphere; <= 0 means the sphere encloses the mesh
+static float SphereOvershoot(const struct Mesh* Mesh, const struct BoundingSphere* Sphere)
+{
+	const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+	if (Slot == MESHFILE_ATTRIBUTE_NONE)
+		return 0.0f;
+
+	const struct VertexBuffer* Buffer = &Mesh->VertexBuffers[Slot];
+	float Overshoot = -Sphere->Radius;
+
+	for (uint32_t i = 0; i < Buffer->Size / Buffer->Stride; i++)
+	{
+		const float* Point = (const float*)(Buffer->Verts + (size_t)i * Buffer->Stride + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_POSITION]);
+		const float Delta[3] = { Point[0] - Sphere->Center[0], Point[1] - Sphere->Center[1], Point[2] - Sphere->Center[2] };
+		const float Dist = sqrtf(Delta[0] * Delta[0] + Delta[1] * Delta[1] + Delta[2] * Delta[2]) - Sphere->Radius;
+
+		if (Dist > Overshoot)
+			Overshoot = Dist;
+	}
+
+	return Overshoot;
+}
+
+static int CommandBounds(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool bounds <file.bin> [iterations]\n");
+		return EXIT_FAILURE;
+	}
+
+	const int Iterations = ArgCount >= 2 ? atoi(Args[1]) : 10;
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	uint64_t VertexCount = 0;
+	for (uint32_t i = 0; i < File.MeshCount; i++)
+		VertexCount += File.MeshList[i].VertexCount;
+
+	const uint32_t ProcessorCount = PlatformGetProcessorCount();
+	const uint32_t ThreadCounts[] = { 1, ProcessorCount };
+
+	printf("%s: %u meshes, %llu vertices, %d iterations, %u processors\n", Args[0], File.MeshCount, (unsigned long long)VertexCount, Iterations, ProcessorCount);
+
+	//scalar on one thread is the loop the renderer used to run, everything else is measured against it
+	double ReferenceTime = 0.0;
+	int ExitCode = EXIT_SUCCESS;
+
+	for (int Kernel = 0; Kernel < SIMD_LEVEL_COUNT; Kernel++)
+	{
+		if (!PlatformSimdSupported(Kernel))
+			continue;
+
+		for (size_t t = 0; t < sizeof(ThreadCounts) / sizeof(ThreadCounts[0]); t++)
+		{
+			if (t > 0 && ThreadCounts[t] == ThreadCounts[t - 1])
+				continue;
+
+			struct BoundingSphere Scene;
+			ComputeMeshBounds(File.MeshList, File.MeshCount, Kernel, ThreadCounts[t], &Scene);
+
+			const double Start = PlatformGetTime();
+			for (int i = 0; i < Iterations; i++)
+				ComputeMeshBounds(File.MeshList, File.MeshCount, Kernel, ThreadCounts[t], &Scene);
+			const double Elapsed = (PlatformGetTime() - Start) / (Iterations > 0 ? Iterations : 1);
+
+			if (ReferenceTime == 0.0)
+				ReferenceTime = Elapsed;
+
+			float Overshoot = -INFINITY;
+			for (uint32_t i = 0; i < File.MeshCount; i++)
+			{
+				const float MeshOvershoot = SphereOvershoot(&File.MeshList[i], &File.MeshList[i].BoundingSphere);
+				const float SceneOvershoot = SphereOvershoot(&File.MeshList[i], &Scene);
+
+				Overshoot = fmaxf(Overshoot, fmaxf(MeshOvershoot, SceneOvershoot));
+			}
+
+			//allow for float rounding relative to the sphere size
+			const bool bEncloses = Overshoot <= Scene.Radius * 1e-5f;
+			if (!bEncloses)
+				ExitCode = EXIT_FAILURE;
+
+			printf("  %-6s x%-3u %9.3f ms  %8.1f Mverts/s  %5.2fx  scene (%.3f, %.3f, %.3f) r=%.3f %s\n",
+				PlatformSimdName(Kernel),
+				ThreadCounts[t],
+				Elapsed * 1000.0,
+				VertexCount / Elapsed * 1e-6,
+				ReferenceTime / Elapsed,
+				Scene.Center[0], Scene.Center[1], Scene.Center[2], Scene.Radius,
+				bEncloses ? "ok" : "POINTS OUTSIDE");
+		}
+	}
+
+	MeshFileClose(&File);
+
+	return ExitCode;
+}
+
+//right handed look-at * perspective, column-major like cglm, so the tool needs no math library
+static void BuildViewProjection(const float Eye[3], const float Target[3], float FovY, float Aspect, float NearZ, float FarZ, float Out[16])
+{
+	float Forward[3] = { Target[0] - Eye[0], Target[1] - Eye[1], Target[2] - Eye[2] };
+	float Length = sqrtf(Forward[0] * Forward[0] + Forward[1] * Forward[1] + Forward[2] * Forward[2]);
+	for (int i = 0; i < 3; i++)
+		Forward[i] /= Length;
+
+	const float Up[3] = { 0.0f, 1.0f, 0.0f };
+	float Side[3] = { Forward[1] * Up[2] - Forward[2] * Up[1], Forward[2] * Up[0] - Forward[0] * Up[2], Forward[0] * Up[1] - Forward[1] * Up[0] };
+	Length = sqrtf(Side[0] * Side[0] + Side[1] * Side[1] + Side[2] * Side[2]);
+	for (int i = 0; i < 3; i++)
+		Side[i] /= Length;
+
+	const float NewUp[3] = { Side[1] * Forward[2] - Side[2] * Forward[1], Side[2] * Forward[0] - Side[0] * Forward[2], Side[0] * Forward[1] - Side[1] * Forward[0] };
+
+	float View[16] = { 0 };
+	for (int i = 0; i < 3; i++)
+	{
+		View[i * 4 + 0] = Side[i];
+		View[i * 4 + 1] = NewUp[i];
+		View[i * 4 + 2] = -Forward[i];
+	}
+	View[12] = -(Side[0] * Eye[0] + Side[1] * Eye[1] + Side[2] * Eye[2]);
+	View[13] = -(NewUp[0] * Eye[0] + NewUp[1] * Eye[1] + NewUp[2] * Eye[2]);
+	View[14] = Forward[0] * Eye[0] + Forward[1] * Eye[1] + Forward[2] * Eye[2];
+	View[15] = 1.0f;
+
+	const float f = 1.0f / tanf(FovY * 0.5f);
+	float Proj[16] = { 0 };
+	Proj[0] = f / Aspect;
+	Proj[5] = f;
+	Proj[10] = FarZ / (NearZ - FarZ);
+	Proj[11] = -1.0f;
+	Proj[14] = NearZ * FarZ / (NearZ - FarZ);
+
+	for (int c = 0; c < 4; c++)
+	{
+		for (int r = 0; r < 4; r++)
+		{
+			float Sum = 0.0f;
+			for (int k = 0; k < 4; k++)
+				Sum += Proj[k * 4 + r] * View[c * 4 + k];
+			Out[c * 4 + r] = Sum;
+		}
+	}
+}
+
+static int CommandCull(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool cull <file.bin> [views]\n");
+		return EXIT_FAILURE;
+	}
+
+	const int ViewCount = ArgCount >= 2 ? atoi(Args[1]) : 256;
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	struct BoundingSphere Scene;
+	ComputeMeshBounds(File.MeshList, File.MeshCount, PlatformSimdBest(), 0, &Scene);
+
+	uint32_t MaxMeshletCount = 0;
+	uint64_t TotalMeshletCount = 0;
+	for (uint32_t i = 0; i < File.MeshCount; i++)
+	{
+		if (File.MeshList[i].CullingDataCount > MaxMeshletCount)
+			MaxMeshletCount = File.MeshList[i].CullingDataCount;
+		TotalMeshletCount += File.MeshList[i].CullingDataCount;
+	}
+
+	uint32_t* Visible = malloc(sizeof(uint32_t) * (MaxMeshletCount ? MaxMeshletCount : 1));
+	uint32_t* Reference = malloc(sizeof(uint32_t) * (MaxMeshletCount ? MaxMeshletCount : 1));
+
+	//orbit the scene at a few distances and heights; the near ones put part of the scene behind the camera
+	struct CullFrustum* Frustums = malloc(sizeof(struct CullFrustum) * (ViewCount > 0 ? ViewCount : 1));
+	for (int v = 0; v < ViewCount; v++)
+	{
+		const float Angle = 6.2831853f * v / ViewCount;
+		const float Distance = Scene.Radius * (0.5f + 2.5f * ((v * 7) % 11) / 10.0f);
+		const float Eye[3] =
+		{
+			Scene.Center[0] + cosf(Angle) * Distance,
+			Scene.Center[1] + Scene.Radius * 0.5f * sinf(Angle * 3.0f),
+			Scene.Center[2] + sinf(Angle) * Distance
+		};
+
+		float ViewProj[16];
+		BuildViewProjection(Eye, Scene.Center, 3.14159265f / 3.0f, 16.0f / 9.0f, 1.0f, 1000.0f, ViewProj);
+		CullFrustumFromMatrix(ViewProj, Eye, &Frustums[v]);
+	}
+
+	printf("%s: %u meshes, %llu meshlets, %d views\n", Args[0], File.MeshCount, (unsigned long long)TotalMeshletCount, ViewCount);
+
+	int ExitCode = EXIT_SUCCESS;
+	double ReferenceTime = 0.0;
+
+	for (int Kernel = 0; Kernel < SIMD_LEVEL_COUNT; Kernel++)
+	{
+		if (!PlatformSimdSupported(Kernel))
+			continue;
+
+		uint64_t VisibleTotal = 0;
+		uint64_t Mismatches = 0;
+
+		const double Start = PlatformGetTime();
+
+		for (int v = 0; v < ViewCount; v++)
+		{
+			for (uint32_t i = 0; i < File.MeshCount; i++)
+			{
+				const struct Mesh* Mesh = &File.MeshList[i];
+
+				for (uint32_t j = 0; j < Mesh->MeshletSubsetCount; j++)
+					VisibleTotal += CullMeshlets(&Frustums[v], Mesh->CullingData, Mesh->MeshletSubsets[j].Offset, Mesh->MeshletSubsets[j].Count, Kernel, Visible);
+			}
+		}
+
+		const double Elapsed = PlatformGetTime() - Start;
+
+		if (ReferenceTime == 0.0)
+			ReferenceTime = Elapsed;
+
+		//check every decision against the scalar reference, outside the timed loop
+		for (int v = 0; v < ViewCount; v++)
+		{
+			for (uint32_t i = 0; i < File.MeshCount; i++)
+			{
+				const struct Mesh* Mesh = &File.MeshList[i];
+
+				for (uint32_t j = 0; j < Mesh->MeshletSubsetCount; j++)
+				{
+					const uint32_t Offset = Mesh->MeshletSubsets[j].Offset;
+					const uint32_t Count = Mesh->MeshletSubsets[j].Count;
+
+					const uint32_t VisibleCount = CullMeshlets(&Frustums[v], Mesh->CullingData, Offset, Count, Kernel, Visible);
+					const uint32_t ReferenceCount = CullMeshlets(&Frustums[v], Mesh->CullingData, Offset, Count, SIMD_LEVEL_SCALAR, Reference);
+
+					if (VisibleCount != ReferenceCount || memcmp(Visible, Reference, sizeof(uint32_t) * VisibleCount) != 0)
+						Mismatches++;
+				}
+			}
+		}
+
+		if (Mismatches)
+			ExitCode = EXIT_FAILURE;
+
+		const double Tested = (double)TotalMeshletCount * ViewCount;
+
+		printf("  %-6s %9.3f ms  %8.1f Mmeshlets/s  %5.2fx  %5.1f%% visible  %llu mismatched subsets\n",
+			PlatformSimdName(Kernel),
+			Elapsed * 1000.0,
+			Tested / Elapsed * 1e-6,
+			ReferenceTime / Elapsed,
+			Tested > 0 ? 100.0 * VisibleTotal / Tested : 0.0,
+			(unsigned long long)Mismatches);
+	}
+
+	free(Frustums);
+	free(Reference);
+	free(Visible);
+	MeshFileClose(&File);
+
+	return ExitCode;
+}
+
+static inline uint32_t ReadMeshIndex(const struct Mesh* Mesh, const uint8_t* Indices, uint32_t i)
+{
+	return Mesh->IndexSize == 2 ? ((const uint16_t*)Indices)[i] : ((const uint32_t*)Indices)[i];
+}
+
+//rotates a triangle so its smallest index comes first; winding is kept
+static void CanonicalTriangle(uint32_t a, uint32_t b, uint32_t c, uint32_t Out[3])
+{
+	if (a <= b && a <= c)
+	{
+		Out[0] = a; Out[1] = b; Out[2] = c;
+	}
+	else if (b <= a && b <= c)
+	{
+		Out[0] = b; Out[1] = c; Out[2] = a;
+	}
+	else
+	{
+		Out[0] = c; Out[1] = a; Out[2] = b;
+	}
+}
+
+static int CompareTriangles(const void* A, const void* B)
+{
+	const uint32_t* a = A;
+	const uint32_t* b = B;
+
+	for (int k = 0; k < 3; k++)
+	{
+		if (a[k] != b[k])
+			return a[k] < b[k] ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static const float* MeshPosition(const struct Mesh* Mesh, uint32_t Vertex)
+{
+	const struct VertexBuffer* Buffer = &Mesh->VertexBuffers[Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION]];
+	return (const float*)(Buffer->Verts + (size_t)Vertex * Buffer->Stride + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_POSITION]);
+}
+
+//checks limits, that every subset's triangles come out exactly once with their winding, that the spheres
+//enclose their meshlets and that a cone cull never rejects a meshlet with a front facing triangle.
+//returns the number of problems found
+static uint32_t ValidateMeshlets(const struct Mesh* Mesh, uint32_t MaxVertices, uint32_t MaxPrimitives)
+{
+	uint32_t Errors = 0;
+	const uint32_t UniqueIndexCount = (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS) ? Mesh->VertexCount : Mesh->UniqueVertexIndexCount / Mesh->IndexSize;
+
+	for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+
+		if (Meshlet->VertCount > MaxVertices || Meshlet->PrimCount > MaxPrimitives ||
+			(uint64_t)Meshlet->VertOffset + Meshlet->VertCount > UniqueIndexCount ||
+			(uint64_t)Meshlet->PrimOffset + Meshlet->PrimCount > Mesh->PrimitiveIndexCount)
+		{
+			if (Errors++ == 0)
+				fprintf(stderr, "    meshlet %u: %u verts / %u prims out of range\n", m, Meshlet->VertCount, Meshlet->PrimCount);
+			continue;
+		}
+
+		for (uint32_t p = 0; p < Meshlet->PrimCount; p++)
+		{
+			const struct PackedTriangle Triangle = Mesh->PrimitiveIndices[Meshlet->PrimOffset + p];
+
+			if (Triangle.i0 >= Meshlet->VertCount || Triangle.i1 >= Meshlet->VertCount || Triangle.i2 >= Meshlet->VertCount)
+			{
+				if (Errors++ == 0)
+					fprintf(stderr, "    meshlet %u: primitive %u indexes past the meshlet's vertices\n", m, p);
+			}
+		}
+	}
+
+	if (Errors)
+		return Errors;
+
+	for (uint32_t s = 0; s < Mesh->IndexSubsetCount && s < Mesh->MeshletSubsetCount; s++)
+	{
+		const struct Subset* IndexSubset = &Mesh->IndexSubsets[s];
+		const struct Subset* MeshletSubset = &Mesh->MeshletSubsets[s];
+
+		uint64_t BuiltCount = 0;
+		for (uint32_t m = MeshletSubset->Offset; m < MeshletSubset->Offset + MeshletSubset->Count; m++)
+			BuiltCount += Mesh->Meshlets[m].PrimCount;
+
+		if (BuiltCount != IndexSubset->Count / 3)
+		{
+			if (Errors++ == 0)
+				fprintf(stderr, "    subset %u: %llu triangles in meshlets, %u in the index buffer\n", s, (unsigned long long)BuiltCount, IndexSubset->Count / 3);
+			continue;
+		}
+
+		uint32_t* Expected = malloc(sizeof(uint32_t) * 3 * BuiltCount + 1);
+		uint32_t* Built = malloc(sizeof(uint32_t) * 3 * BuiltCount + 1);
+
+		for (uint32_t t = 0; t < IndexSubset->Count / 3; t++)
+		{
+			const uint32_t i = IndexSubset->Offset + t * 3;
+			CanonicalTriangle(ReadMeshIndex(Mesh, Mesh->IndexBuffer, i), ReadMeshIndex(Mesh, Mesh->IndexBuffer, i + 1), ReadMeshIndex(Mesh, Mesh->IndexBuffer, i + 2), &Expected[t * 3]);
+		}
+
+		uint32_t t = 0;
+		for (uint32_t m = MeshletSubset->Offset; m < MeshletSubset->Offset + MeshletSubset->Count; m++)
+		{
+			const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+
+			for (uint32_t p = 0; p < Meshlet->PrimCount; p++, t++)
+			{
+				const struct PackedTriangle Triangle = Mesh->PrimitiveIndices[Meshlet->PrimOffset + p];
+				CanonicalTriangle(
+					MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i0),
+					MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i1),
+					MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i2),
+					&Built[t * 3]);
+			}
+		}
+
+		qsort(Expected, BuiltCount, sizeof(uint32_t) * 3, CompareTriangles);
+		qsort(Built, BuiltCount, sizeof(uint32_t) * 3, CompareTriangles);
+
+		if (memcmp(Expected, Built, sizeof(uint32_t) * 3 * BuiltCount) != 0)
+		{
+			if (Errors++ == 0)
+				fprintf(stderr, "    subset %u: meshlet triangles don't match the index buffer\n", s);
+		}
+
+		free(Expected);
+		free(Built);
+	}
+
+	// Cone conservativeness: eyes scattered around each meshlet, with a frustum that accepts everything.
+	struct CullFrustum Frustum = { 0 };
+	for (int i = 0; i < 6; i++)
+		Frustum.Planes[i][3] = FLT_MAX;
+
+	uint32_t Seed = 12345;
+
+	for (uint32_t m = 0; m < Mesh->CullingDataCount && m < Mesh->MeshletCount; m++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+		const struct CullData* CullData = &Mesh->CullingData[m];
+		const float* Sphere = CullData->BoundingSphere;
+
+		for (uint32_t v = 0; v < Meshlet->VertCount; v++)
+		{
+			const float* Point = MeshPosition(Mesh, MeshletVertexIndex(Mesh, Meshlet->VertOffset + v));
+			const float Delta[3] = { Point[0] - Sphere[0], Point[1] - Sphere[1], Point[2] - Sphere[2] };
+
+			if (sqrtf(Delta[0] * Delta[0] + Delta[1] * Delta[1] + Delta[2] * Delta[2]) > Sphere[3] * (1.0f + 1e-5f) + 1e-6f)
+			{
+				if (Errors++ == 0)
+					fprintf(stderr, "    meshlet %u: vertex %u outside the bounding sphere\n", m, v);
+				break;
+			}
+		}
+
+		if (CullData->NormalCone[3] == 0xFF)
+			continue;
+
+		for (int e = 0; e < 16; e++)
+		{
+			float Eye[3];
+			for (int a = 0; a < 3; a++)
+			{
+				Seed = Seed * 1664525u + 1013904223u;
+				Eye[a] = Sphere[a] + ((Seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * Sphere[3] * 8.0f;
+			}
+
+			memcpy(Frustum.ViewPosition, Eye, sizeof(Eye));
+
+			if (CullMeshletVisible(&Frustum, CullData))
+				continue;
+
+			for (uint32_t p = 0; p < Meshlet->PrimCount; p++)
+			{
+				const struct PackedTriangle Triangle = Mesh->PrimitiveIndices[Meshlet->PrimOffset + p];
+				const float* p0 = MeshPosition(Mesh, MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i0));
+				const float* p1 = MeshPosition(Mesh, MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i1));
+				const float* p2 = MeshPosition(Mesh, MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i2));
+
+				const float e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				const float e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				const float n[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+				const float ToEye[3] = { Eye[0] - p0[0], Eye[1] - p0[1], Eye[2] - p0[2] };
+
+				const float Facing = n[0] * ToEye[0] + n[1] * ToEye[1] + n[2] * ToEye[2];
+				const float Scale = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * sqrtf(ToEye[0] * ToEye[0] + ToEye[1] * ToEye[1] + ToEye[2] * ToEye[2]);
+
+				if (Facing > Scale * 1e-3f)
+				{
+					if (Errors++ == 0)
+						fprintf(stderr, "    meshlet %u: cone culled with triangle %u facing the eye\n", m, p);
+					break;
+				}
+			}
+		}
+	}
+
+	return Errors;
+}
+
+static void PrintMeshletStats(const char* Label, const struct Mesh* Mesh, uint32_t MaxVertices, uint32_t MaxPrimitives)
+{
+	uint64_t Verts = 0;
+	uint64_t Prims = 0;
+	uint32_t Degenerate = 0;
+
+	for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+	{
+		Verts += Mesh->Meshlets[m].VertCount;
+		Prims += Mesh->Meshlets[m].PrimCount;
+	}
+
+	for (uint32_t m = 0; m < Mesh->CullingDataCount; m++)
+		Degenerate += Mesh->CullingData[m].NormalCone[3] == 0xFF;
+
+	const double Count = Mesh->MeshletCount ? Mesh->MeshletCount : 1;
+
+	printf("    %-8s %7u meshlets  %5.1f verts (%5.1f%%)  %6.1f prims (%5.1f%%)  %.3f verts/tri  %4.1f%% no cone\n",
+		Label,
+		Mesh->MeshletCount,
+		Verts / Count, 100.0 * Verts / Count / MaxVertices,
+		Prims / Count, 100.0 * Prims / Count / MaxPrimitives,
+		Prims ? (double)Verts / Prims : 0.0,
+		100.0 * Degenerate / Count);
+}
+
+static int CommandMeshlets(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool meshlets <file.bin> [max verts] [max prims] [threads]\n");
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t MaxVertices = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : MESHLET_DEFAULT_MAX_VERTICES;
+	const uint32_t MaxPrimitives = ArgCount >= 3 ? (uint32_t)atoi(Args[2]) : MESHLET_DEFAULT_MAX_PRIMITIVES;
+	const uint32_t ThreadCount = ArgCount >= 4 ? (uint32_t)atoi(Args[3]) : PlatformGetProcessorCount();
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	printf("%s: %u meshes, limits %u verts / %u prims, %u threads\n", Args[0], File.MeshCount, MaxVertices, MaxPrimitives, ThreadCount);
+
+	int ExitCode = EXIT_SUCCESS;
+
+	for (uint32_t i = 0; i < File.MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &File.MeshList[i];
+		printf("  mesh %u: %u triangles\n", i, Mesh->IndexCount / 3);
+
+		struct MeshletData Single;
+		struct MeshletData Multi;
+
+		const double SingleStart = PlatformGetTime();
+		enum MeshletBuildResult BuildResult = BuildMeshlets(Mesh, MaxVertices, MaxPrimitives, 1, &Single);
+		const double SingleEnd = PlatformGetTime();
+
+		if (BuildResult != MESHLET_BUILD_OK)
+		{
+			fprintf(stderr, "    %s\n", MeshletBuildResultString(BuildResult));
+			ExitCode = EXIT_FAILURE;
+			continue;
+		}
+
+		BuildResult = BuildMeshlets(Mesh, MaxVertices, MaxPrimitives, ThreadCount, &Multi);
+		const double MultiEnd = PlatformGetTime();
+
+		if (BuildResult != MESHLET_BUILD_OK)
+		{
+			fprintf(stderr, "    %s\n", MeshletBuildResultString(BuildResult));
+			MeshletDataFree(&Single);
+			ExitCode = EXIT_FAILURE;
+			continue;
+		}
+
+		//chunking doesn't depend on the thread count, so both builds have to agree byte for byte
+		const bool bIdentical =
+			Single.MeshletCount == Multi.MeshletCount &&
+			Single.UniqueVertexIndexCount == Multi.UniqueVertexIndexCount &&
+			Single.PrimitiveIndexCount == Multi.PrimitiveIndexCount &&
+			memcmp(Single.Meshlets, Multi.Meshlets, sizeof(struct Meshlet) * Single.MeshletCount) == 0 &&
+			memcmp(Single.UniqueVertexIndices, Multi.UniqueVertexIndices, Single.UniqueVertexIndexCount) == 0 &&
+			memcmp(Single.PrimitiveIndices, Multi.PrimitiveIndices, sizeof(struct PackedTriangle) * Single.PrimitiveIndexCount) == 0 &&
+			memcmp(Single.CullingData, Multi.CullingData, sizeof(struct CullData) * Single.CullingDataCount) == 0;
+
+		if (Mesh->MeshletCount)
+			PrintMeshletStats("file", Mesh, MaxVertices, MaxPrimitives);
+
+		struct Mesh Rebuilt = *Mesh;
+		MeshletDataApply(&Multi, &Rebuilt);
+		PrintMeshletStats("built", &Rebuilt, MaxVertices, MaxPrimitives);
+
+		const uint32_t Errors = ValidateMeshlets(&Rebuilt, MaxVertices, MaxPrimitives);
+		const double Triangles = Mesh->IndexCount / 3.0;
+
+		printf("    x1 %8.3f ms %7.2f Mtris/s   x%u %8.3f ms %7.2f Mtris/s   %s   %u validation errors\n",
+			(SingleEnd - SingleStart) * 1000.0, Triangles / (SingleEnd - SingleStart) * 1e-6,
+			ThreadCount, (MultiEnd - SingleEnd) * 1000.0, Triangles / (MultiEnd - SingleEnd) * 1e-6,
+			bIdentical ? "deterministic" : "THREAD COUNT CHANGED OUTPUT",
+			Errors);
+
+		if (Errors || !bIdentical)
+			ExitCode = EXIT_FAILURE;
+
+		MeshletDataFree(&Single);
+		MeshletDataFree(&Multi);
+	}
+
+	MeshFileClose(&File);
+
+	return ExitCode;
+}
+
+//counts the streams of Converted that differ from Source or don't sit at their aligned StreamOffsets
+static uint32_t CompareMeshStreams(const struct Mesh* Source, const struct Mesh* Converted, const uint8_t* Buffer)
+{
+	uint32_t Errors = 0;
+
+#define CHECK_STREAM(Name, Stream, SourcePointer, ConvertedPointer, Bytes) \
+	if ((const uint8_t*)(ConvertedPointer) != Buffer + Converted->StreamOffsets[Stream] || Converted->StreamOffsets[Stream] % MESHFILE_STREAM_ALIGNMENT != 0) \
+	{ \
+		printf("    %s: not at its aligned stream offset\n", Name); \
+		Errors++; \
+	} \
+	else if ((size_t)(Bytes) != 0 && memcmp(SourcePointer, ConvertedPointer, Bytes) != 0) \
+	{ \
+		printf("    %s: contents differ\n", Name); \
+		Errors++; \
+	}
+
+	if (Source->IndexCount != Converted->IndexCount || Source->IndexSize != Converted->IndexSize ||
+		Source->IndexSubsetCount != Converted->IndexSubsetCount ||
+		Source->MeshletCount != Converted->MeshletCount || Source->MeshletSubsetCount != Converted->MeshletSubsetCount ||
+		Source->UniqueVertexIndexCount != Converted->UniqueVertexIndexCount ||
+		Source->PrimitiveIndexCount != Converted->PrimitiveIndexCount || Source->CullingDataCount != Converted->CullingDataCount ||
+		Source->VertexCount != Converted->VertexCount || Source->VertexBufferCount != Converted->VertexBufferCount ||
+		Source->ClusterLodCount != Converted->ClusterLodCount || Source->ClusterRootCount != Converted->ClusterRootCount)
+	{
+		printf("    stream counts differ\n");
+		return 1;
+	}
+
+	CHECK_STREAM("indices", MESH_STREAM_INDICES, Source->IndexBuffer, Converted->IndexBuffer, (size_t)Source->IndexCount * Source->IndexSize);
+	CHECK_STREAM("index subsets", MESH_STREAM_INDEX_SUBSETS, Source->IndexSubsets, Converted->IndexSubsets, sizeof(struct Subset) * Source->IndexSubsetCount);
+	CHECK_STREAM("meshlets", MESH_STREAM_MESHLETS, Source->Meshlets, Converted->Meshlets, sizeof(struct Meshlet) * Source->MeshletCount);
+	CHECK_STREAM("meshlet subsets", MESH_STREAM_MESHLET_SUBSETS, Source->MeshletSubsets, Converted->MeshletSubsets, sizeof(struct Subset) * Source->MeshletSubsetCount);
+	CHECK_STREAM("unique vertex indices", MESH_STREAM_UNIQUE_VERTEX_INDICES, Source->UniqueVertexIndices, Converted->UniqueVertexIndices, Source->UniqueVertexIndexCount);
+	CHECK_STREAM("primitive indices", MESH_STREAM_PRIMITIVE_INDICES, Source->PrimitiveIndices, Converted->PrimitiveIndices, sizeof(struct PackedTriangle) * Source->PrimitiveIndexCount);
+	CHECK_STREAM("cull data", MESH_STREAM_CULL_DATA, Source->CullingData, Converted->CullingData, sizeof(struct CullData) * Source->CullingDataCount);
+
+	if (Source->ClusterLodCount != 0)
+	{
+		CHECK_STREAM("cluster lods", MESH_STREAM_CLUSTER_LODS, Source->ClusterLods, Converted->ClusterLods, sizeof(struct ClusterLod) * Source->ClusterLodCount);
+		CHECK_STREAM("cluster roots", MESH_STREAM_CLUSTER_ROOTS, Source->ClusterRoots, Converted->ClusterRoots, sizeof(struct Subset) * Source->ClusterRootCount);
+	}
+
+	uint32_t SourceLimits[2];
+	uint32_t ConvertedLimits[2];
+	MeshMeshletLimits(Source, &SourceLimits[0], &SourceLimits[1]);
+	MeshMeshletLimits(Converted, &ConvertedLimits[0], &ConvertedLimits[1]);
+
+	if (SourceLimits[0] != ConvertedLimits[0] || SourceLimits[1] != ConvertedLimits[1])
+	{
+		printf("    meshlet limits differ: %u/%u -> %u/%u\n", SourceLimits[0], SourceLimits[1], ConvertedLimits[0], ConvertedLimits[1]);
+		Errors++;
+	}
+
+	if (Source->MeshletFlags != Converted->MeshletFlags)
+	{
+		printf("    meshlet flags differ: %#x -> %#x\n", Source->MeshletFlags, Converted->MeshletFlags);
+		Errors++;
+	}
+
+	for (uint32_t j = 0; j < Source->VertexBufferCount; j++)
+	{
+		if (Source->VertexBuffers[j].Size != Converted->VertexBuffers[j].Size || Source->VertexBuffers[j].Stride != Converted->VertexBuffers[j].Stride)
+		{
+			printf("    vertex buffer %u: size or stride differs\n", j);
+			Errors++;
+			continue;
+		}
+
+		CHECK_STREAM("vertices", MESH_STREAM_VERTICES + j, Source->VertexBuffers[j].Verts, Converted->VertexBuffers[j].Verts, Source->VertexBuffers[j].Size);
+	}
+
+	for (uint32_t j = 0; j < ATTRIBUTE_TYPE_COUNT; j++)
+	{
+		if (Source->AttributeSlots[j] != Converted->AttributeSlots[j] ||
+			(Source->AttributeSlots[j] != MESHFILE_ATTRIBUTE_NONE && Source->AttributeOffsets[j] != Converted->AttributeOffsets[j]))
+		{
+			printf("    attribute %u: layout differs\n", j);
+			Errors++;
+		}
+	}
+
+#undef CHECK_STREAM
+
+	return Errors;
+}
+
+static int CommandConvert(int ArgCount, char** Args)
+{
+	if (ArgCount < 2)
+	{
+		fprintf(stderr, "usage: MeshTool convert <in.bin> <out.bin> [max verts] [max prims]\n");
+		return EXIT_FAILURE;
+	}
+
+	//meshlets are only rebuilt when limits are given, otherwise the file's own streams are carried over
+	const bool bRebuild = ArgCount >= 3;
+	const uint32_t MaxVertices = ArgCount >= 3 ? (uint32_t)atoi(Args[2]) : MESHLET_DEFAULT_MAX_VERTICES;
+	const uint32_t MaxPrimitives = ArgCount >= 4 ? (uint32_t)atoi(Args[3]) : MESHLET_DEFAULT_MAX_PRIMITIVES;
+
+	struct MeshFile Source;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &Source);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	struct Mesh* Meshes = calloc(Source.MeshCount ? Source.MeshCount : 1, sizeof(struct Mesh));
+	struct MeshletData* Built = calloc(Source.MeshCount ? Source.MeshCount : 1, sizeof(struct MeshletData));
+
+	if (Meshes == NULL || Built == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Meshes);
+		free(Built);
+		MeshFileClose(&Source);
+		return EXIT_FAILURE;
+	}
+
+	int ExitCode = EXIT_SUCCESS;
+
+	const double BuildStart = PlatformGetTime();
+
+	for (uint32_t i = 0; i < Source.MeshCount && ExitCode == EXIT_SUCCESS; i++)
+	{
+		Meshes[i] = Source.MeshList[i];
+
+		if (!bRebuild)
+			continue;
+
+		enum MeshletBuildResult BuildResult = BuildMeshlets(&Meshes[i], MaxVertices, MaxPrimitives, 0, &Built[i]);
+
+		if (BuildResult != MESHLET_BUILD_OK)
+		{
+			fprintf(stderr, "mesh %u: %s\n", i, MeshletBuildResultString(BuildResult));
+			ExitCode = EXIT_FAILURE;
+			break;
+		}
+
+		MeshletDataApply(&Built[i], &Meshes[i]);
+	}
+
+	const double SaveStart = PlatformGetTime();
+
+	if (ExitCode == EXIT_SUCCESS)
+	{
+		Result = MeshFileSave(Args[1], Meshes, Source.MeshCount, false);
+
+		if (Result != MESHFILE_OK)
+		{
+			fprintf(stderr, "%s: %s\n", Args[1], MeshFileResultString(Result));
+			ExitCode = EXIT_FAILURE;
+		}
+	}
+
+	const double SaveEnd = PlatformGetTime();
+
+	if (ExitCode == EXIT_SUCCESS)
+	{
+		struct MeshFile Converted;
+		Result = MeshFileOpen(Args[1], &Converted);
+		const double OpenEnd = PlatformGetTime();
+
+		if (Result != MESHFILE_OK)
+		{
+			fprintf(stderr, "%s: %s\n", Args[1], MeshFileResultString(Result));
+			ExitCode = EXIT_FAILURE;
+		}
+		else
+		{
+			const size_t BufferOffset = (size_t)(Converted.Buffer - (const uint8_t*)Converted.Data);
+
+			printf("%s: version %u, %zu bytes -> %s: version %u, %zu bytes (buffer %u bytes at offset %zu)\n",
+				Args[0], Source.Version, Source.Size, Args[1], Converted.Version, Converted.Size, Converted.BufferSize, BufferOffset);
+
+			uint32_t Errors = 0;
+
+			//custom meshlet limits need FILE_VERSION_MESHLETS to be recorded
+			if ((Converted.Version != FILE_VERSION_BLOB && Converted.Version != FILE_VERSION_MESHLETS) || BufferOffset % MESHFILE_BUFFER_ALIGNMENT != 0 || Converted.MeshCount != Source.MeshCount)
+			{
+				printf("  bad header\n");
+				Errors++;
+			}
+
+			for (uint32_t i = 0; i < Source.MeshCount && i < Converted.MeshCount; i++)
+			{
+				printf("  mesh %u\n", i);
+				Errors += CompareMeshStreams(&Meshes[i], &Converted.MeshList[i], Converted.Buffer);
+			}
+
+			printf("  build %.3f ms, write %.3f ms, reopen %.3f ms, %u mismatches\n",
+				(SaveStart - BuildStart) * 1000.0, (SaveEnd - SaveStart) * 1000.0, (OpenEnd - SaveEnd) * 1000.0, Errors);
+
+			if (Errors)
+				ExitCode = EXIT_FAILURE;
+
+			MeshFileClose(&Converted);
+		}
+	}
+
+	for (uint32_t i = 0; i < Source.MeshCount; i++)
+		MeshletDataFree(&Built[i]);
+
+	free(Built);
+	free(Meshes);
+	MeshFileClose(&Source);
+
+	return ExitCode;
+}
+
+static const char* const StreamNames[] = { "indices", "index subsets", "meshlets", "meshlet subsets", "unique indices", "primitives", "cull data", "vertices", "cluster lods", "cluster roots" };
+
+//StreamNames entry of a stream, all vertex slots sharing one
+static uint32_t StreamKind(uint32_t Stream)
+{
+	if (Stream < MESH_STREAM_VERTICES)
+		return Stream;
+
+	return Stream < MESH_STREAM_CLUSTER_LODS ? MESH_STREAM_VERTICES : MESH_STREAM_VERTICES + 1 + (Stream - MESH_STREAM_CLUSTER_LODS);
+}
+
+static int CommandCompress(int ArgCount, char** Args)
+{
+	if (ArgCount < 2)
+	{
+		fprintf(stderr, "usage: MeshTool compress <in.bin> <out.bin> [iters]\n");
+		return EXIT_FAILURE;
+	}
+
+	const int Iterations = ArgCount >= 3 ? atoi(Args[2]) : 10;
+
+	struct MeshFile Source;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &Source);
+
+	if (Result == MESHFILE_OK)
+		Result = MeshFileRepack(&Source);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	//per stream kind ratios and decode speed, all vertex slots counted together
+	enum { KIND_COUNT = sizeof(StreamNames) / sizeof(StreamNames[0]) };
+	uint64_t RawBytes[KIND_COUNT] = { 0 };
+	uint64_t EncodedBytes[KIND_COUNT] = { 0 };
+	double DecodeTime[KIND_COUNT][SIMD_LEVEL_COUNT] = { { 0 } };
+	uint32_t Mismatches = 0;
+
+	for (uint32_t i = 0; i < Source.MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &Source.MeshList[i];
+
+		for (uint32_t s = 0; s < MESH_STREAM_COUNT; s++)
+		{
+			const uint64_t Size = MeshStreamSize(Mesh, s);
+			const uint32_t Kind = StreamKind(s);
+
+			if (Size == 0)
+				continue;
+
+			struct MeshCodecFormat Format = MeshCodecStreamFormat(Mesh, s);
+
+			if (!MeshCodecFormatValid(&Format, Size))
+				Format = (struct MeshCodecFormat){ MESH_CODEC_FILTER_RAW, 1, 1 };
+
+			uint8_t* Encoded = malloc(MeshCodecBound(Size));
+			uint8_t* Decoded = malloc(Size);
+
+			if (Encoded == NULL || Decoded == NULL)
+			{
+				fprintf(stderr, "out of memory\n");
+				free(Encoded);
+				free(Decoded);
+				MeshFileClose(&Source);
+				return EXIT_FAILURE;
+			}
+
+			size_t EncodedSize = MeshCodecEncode(&Format, MeshStreamData(Mesh, s), Size, Encoded);
+
+			//same rule as MeshFileCompress: streams that don't shrink are stored raw
+			if (EncodedSize >= Size && Format.Filter != MESH_CODEC_FILTER_RAW)
+			{
+				Format = (struct MeshCodecFormat){ MESH_CODEC_FILTER_RAW, 1, 1 };
+				EncodedSize = MeshCodecEncode(&Format, MeshStreamData(Mesh, s), Size, Encoded);
+			}
+			RawBytes[Kind] += Size;
+			EncodedBytes[Kind] += EncodedSize;
+
+			for (uint32_t Level = 0; Level < SIMD_LEVEL_COUNT; Level++)
+			{
+				if (!PlatformSimdSupported(Level))
+					continue;
+
+				const double Start = PlatformGetTime();
+
+				for (int n = 0; n < Iterations; n++)
+				{
+					if (!MeshCodecDecode(&Format, Encoded, EncodedSize, Decoded, Size, Level))
+						Mismatches++;
+				}
+
+				DecodeTime[Kind][Level] += PlatformGetTime() - Start;
+
+				if (memcmp(Decoded, MeshStreamData(Mesh, s), Size) != 0)
+				{
+					printf("  mesh %u %s: %s decode differs\n", i, StreamNames[Kind], PlatformSimdName(Level));
+					Mismatches++;
+				}
+			}
+
+			free(Encoded);
+			free(Decoded);
+		}
+	}
+
+	printf("%s: %zu bytes as version %u\n", Args[0], Source.Size, Source.Version);
+	printf("  %-16s %12s %12s %7s", "stream", "raw", "encoded", "ratio");
+
+	for (uint32_t Level = 0; Level < SIMD_LEVEL_COUNT; Level++)
+	{
+		if (PlatformSimdSupported(Level))
+			printf(" %8s GB/s", PlatformSimdName(Level));
+	}
+
+	printf("\n");
+
+	uint64_t TotalRaw = 0;
+	uint64_t TotalEncoded = 0;
+	double TotalTime[SIMD_LEVEL_COUNT] = { 0 };
+
+	for (uint32_t Kind = 0; Kind < KIND_COUNT; Kind++)
+	{
+		if (RawBytes[Kind] == 0)
+			continue;
+
+		printf("  %-16s %12llu %12llu %6.1f%%", StreamNames[Kind], (unsigned long long)RawBytes[Kind], (unsigned long long)EncodedBytes[Kind], 100.0 * EncodedBytes[Kind] / RawBytes[Kind]);
+
+		for (uint32_t Level = 0; Level < SIMD_LEVEL_COUNT; Level++)
+		{
+			if (PlatformSimdSupported(Level))
+				printf(" %13.2f", (double)RawBytes[Kind] * Iterations / DecodeTime[Kind][Level] * 1e-9);
+
+			TotalTime[Level] += DecodeTime[Kind][Level];
+		}
+
+		printf("\n");
+
+		TotalRaw += RawBytes[Kind];
+		TotalEncoded += EncodedBytes[Kind];
+	}
+
+	printf("  %-16s %12llu %12llu %6.1f%%", "total", (unsigned long long)TotalRaw, (unsigned long long)TotalEncoded, 100.0 * TotalEncoded / (TotalRaw ? TotalRaw : 1));
+
+	for (uint32_t Level = 0; Level < SIMD_LEVEL_COUNT; Level++)
+	{
+		if (PlatformSimdSupported(Level))
+			printf(" %13.2f", (double)TotalRaw * Iterations / TotalTime[Level] * 1e-9);
+	}
+
+	printf("\n");
+
+	//whole file: compress, write, then load it back through the normal loader and compare with the source
+	void* Compressed;
+	size_t CompressedSize;
+
+	const double CompressStart = PlatformGetTime();
+	Result = MeshFileCompress(Source.Data, Source.Size, &Compressed, &CompressedSize);
+	const double CompressEnd = PlatformGetTime();
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		MeshFileClose(&Source);
+		return EXIT_FAILURE;
+	}
+
+	for (uint32_t Level = 0; Level < SIMD_LEVEL_COUNT; Level++)
+	{
+		if (!PlatformSimdSupported(Level))
+			continue;
+
+		void* Decompressed;
+		size_t DecompressedSize;
+
+		const double Start = PlatformGetTime();
+		Result = MeshFileDecompress(Compressed, CompressedSize, Level, &Decompressed, &DecompressedSize);
+		const double End = PlatformGetTime();
+
+		if (Result != MESHFILE_OK || DecompressedSize != Source.Size || memcmp(Decompressed, Source.Data, Source.Size) != 0)
+		{
+			printf("  %s: decompressed image differs (%s)\n", PlatformSimdName(Level), MeshFileResultString(Result));
+			Mismatches++;
+		}
+		else
+		{
+			printf("  %-6s decompress %8.3f ms, %6.2f GB/s\n", PlatformSimdName(Level), (End - Start) * 1000.0, Source.Size / (End - Start) * 1e-9);
+		}
+
+		free(Decompressed);
+	}
+
+	FILE* Output = fopen(Args[1], "wb");
+	const bool bWritten = Output && fwrite(Compressed, 1, CompressedSize, Output) == CompressedSize;
+
+	if (Output == NULL || fclose(Output) != 0 || !bWritten)
+	{
+		fprintf(stderr, "%s: %s\n", Args[1], MeshFileResultString(MESHFILE_ERROR_WRITE));
+		free(Compressed);
+		MeshFileClose(&Source);
+		return EXIT_FAILURE;
+	}
+
+	free(Compressed);
+
+	struct MeshFile Reloaded;
+	const double LoadStart = PlatformGetTime();
+	Result = MeshFileOpen(Args[1], &Reloaded);
+	const double LoadEnd = PlatformGetTime();
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[1], MeshFileResultString(Result));
+		MeshFileClose(&Source);
+		return EXIT_FAILURE;
+	}
+
+	for (uint32_t i = 0; i < Source.MeshCount && i < Reloaded.MeshCount; i++)
+		Mismatches += CompareMeshStreams(&Source.MeshList[i], &Reloaded.MeshList[i], Reloaded.Buffer);
+
+	if (Reloaded.MeshCount != Source.MeshCount || !Reloaded.bCompressed)
+		Mismatches++;
+
+	printf("%s: %zu bytes (%.1f%%), compress %.3f ms, open+decode %.3f ms, %u mismatches\n",
+		Args[1], CompressedSize, 100.0 * CompressedSize / Source.Size,
+		(CompressEnd - CompressStart) * 1000.0, (LoadEnd - LoadStart) * 1000.0, Mismatches);
+
+	MeshFileClose(&Reloaded);
+	MeshFileClose(&Source);
+
+	return Mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+struct StreamCheck
+{
+	const struct MeshFile* Reference;
+	uint32_t Ready;
+	uint32_t Mismatches;
+};
+
+//every stream of a mesh has to be in place the moment the loader hands it out
+static void CheckStreamedMesh(void* Context, const struct MeshFile* File, uint32_t MeshIndex)
+{
+	struct StreamCheck* Check = Context;
+	const struct Mesh* Mesh = &File->MeshList[MeshIndex];
+	const struct Mesh* Reference = &Check->Reference->MeshList[MeshIndex];
+
+	for (uint32_t s = 0; s < MESH_STREAM_COUNT; s++)
+	{
+		const uint64_t Size = MeshStreamSize(Mesh, s);
+
+		if (Size != MeshStreamSize(Reference, s) || (Size != 0 && memcmp(MeshStreamData(Mesh, s), MeshStreamData(Reference, s), Size) != 0))
+			Check->Mismatches++;
+	}
+
+	Check->Ready++;
+}
+
+static int CommandStream(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool stream <file.bin> [chunkKB] [depth] [unbuffered]\n");
+		return EXIT_FAILURE;
+	}
+
+	struct MeshLoaderDesc Desc = { 0 };
+	Desc.ChunkSize = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) * 1024 : 0;
+	Desc.QueueDepth = ArgCount >= 3 ? (uint32_t)atoi(Args[2]) : 0;
+	Desc.bUnbuffered = ArgCount >= 4 && atoi(Args[3]) != 0;
+	Desc.OnMeshReady = CheckStreamedMesh;
+
+	struct MeshFile Reference;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &Reference);
+
+	//the reference has to live in memory: dropping the file from the cache would evict a mapping too
+	void* ReferenceCopy = NULL;
+	if (Result == MESHFILE_OK && Reference.bMapped)
+	{
+		ReferenceCopy = malloc(Reference.Size);
+		if (ReferenceCopy != NULL)
+			memcpy(ReferenceCopy, Reference.Data, Reference.Size);
+
+		const size_t ReferenceSize = Reference.Size;
+		MeshFileClose(&Reference);
+		Result = ReferenceCopy ? MeshFileParse(ReferenceCopy, ReferenceSize, &Reference) : MESHFILE_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		free(ReferenceCopy);
+		return EXIT_FAILURE;
+	}
+
+	printf("%s: %zu bytes as version %u%s, %u meshes\n", Args[0], Reference.Size, Reference.Version,
+		Reference.bCompressed ? " (compressed)" : "", Reference.MeshCount);
+	printf("  %-12s %-5s %12s %12s %10s %8s\n", "backend", "cache", "first mesh", "total", "MB/s", "reads");
+
+	uint32_t Mismatches = 0;
+	bool bDropped = true;
+
+	for (uint32_t Backend = MESH_LOADER_BACKEND_IO_URING; Backend < MESH_LOADER_BACKEND_COUNT; Backend++)
+	{
+		if (!MeshLoaderBackendSupported(Backend))
+			continue;
+
+		for (int Warm = 0; Warm < 2; Warm++)
+		{
+			if (!Warm)
+				bDropped &= PlatformDropFileCache(Args[0]);
+
+			struct StreamCheck Check = { &Reference, 0, 0 };
+			Desc.Backend = Backend;
+			Desc.Context = &Check;
+
+			struct MeshFile File;
+			struct MeshLoaderStats Stats;
+			Result = MeshFileLoad(Args[0], &Desc, &File, &Stats);
+
+			if (Result != MESHFILE_OK)
+			{
+				fprintf(stderr, "%s: %s: %s\n", Args[0], MeshLoaderBackendName(Backend), MeshFileResultString(Result));
+				MeshFileClose(&Reference);
+				free(ReferenceCopy);
+				return EXIT_FAILURE;
+			}
+
+			if (Stats.Backend != Backend || File.Size != Reference.Size || memcmp(File.Data, Reference.Data, File.Size) != 0 ||
+				Check.Ready != Reference.MeshCount || Check.Mismatches != 0)
+				Mismatches++;
+
+			printf("  %-12s %-5s %9.3f ms %9.3f ms %10.1f %8u%s\n", MeshLoaderBackendName(Stats.Backend), Warm ? "warm" : "cold",
+				Stats.FirstMeshTime * 1000.0, Stats.TotalTime * 1000.0, Stats.BytesRead / Stats.ReadTime / (1024.0 * 1024.0), Stats.ReadCount,
+				Stats.bUnbuffered ? " unbuffered" : "");
+
+			MeshFileClose(&File);
+		}
+	}
+
+	//the mapped path for comparison: nothing is read until the pages are touched
+	MeshFileClose(&Reference);
+	free(ReferenceCopy);
+
+	for (int Warm = 0; Warm < 2; Warm++)
+	{
+		if (!Warm)
+			bDropped &= PlatformDropFileCache(Args[0]);
+
+		const double Start = PlatformGetTime();
+		Result = MeshFileOpen(Args[0], &Reference);
+		const double OpenEnd = PlatformGetTime();
+
+		if (Result != MESHFILE_OK)
+		{
+			fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+			return EXIT_FAILURE;
+		}
+
+		volatile uint64_t Checksum = TouchPages(Reference.Data, Reference.Size);
+		(void)Checksum;
+		const double End = PlatformGetTime();
+
+		printf("  %-12s %-5s %9.3f ms %9.3f ms %10.1f\n", "mmap", Warm ? "warm" : "cold",
+			(OpenEnd - Start) * 1000.0, (End - Start) * 1000.0, Reference.Size / (End - Start) / (1024.0 * 1024.0));
+
+		MeshFileClose(&Reference);
+	}
+
+	if (!bDropped)
+		printf("  couldn't drop the file from the page cache, cold runs are warm\n");
+
+	printf("  %u mismatches\n", Mismatches);
+
+	return Mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int CommandScene(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool scene <manifest.txt> [maxthreads]\n");
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t MaxThreads = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : PlatformGetProcessorCount();
+	uint32_t Mismatches = 0;
+
+	printf("%s: %u processors\n", Args[0], PlatformGetProcessorCount());
+	printf("  %-7s %-5s %10s %10s %10s %10s %8s %10s\n", "threads", "cache", "wall", "read", "parse", "merge", "speedup", "MB/s");
+
+	double SingleThreadTime[2] = { 0.0, 0.0 };
+
+	for (uint32_t Threads = 1; Threads <= MaxThreads; Threads = Threads * 2 > MaxThreads && Threads != MaxThreads ? MaxThreads : Threads * 2)
+	{
+		for (int Warm = 0; Warm < 2; Warm++)
+		{
+			struct MeshScene Scene;
+			struct MeshSceneStats Stats;
+
+			if (!Warm)
+			{
+				//the paths are only known once the manifest is read, so drop them from a first load
+				if (MeshSceneLoad(Args[0], Threads, NULL, &Scene, &Stats) == MESHFILE_OK)
+				{
+					for (uint32_t i = 0; i < Scene.FileCount; i++)
+						PlatformDropFileCache(Scene.Paths[i]);
+
+					MeshSceneFree(&Scene);
+				}
+			}
+
+			const double Start = PlatformGetTime();
+			enum MeshFileResult Result = MeshSceneLoad(Args[0], Threads, NULL, &Scene, &Stats);
+			const double Wall = PlatformGetTime() - Start;
+
+			if (Result != MESHFILE_OK)
+			{
+				fprintf(stderr, "%s: %s\n", Stats.FailedPath, MeshFileResultString(Result));
+				return EXIT_FAILURE;
+			}
+
+			if (Threads == 1)
+				SingleThreadTime[Warm] = Wall;
+
+			printf("  %-7u %-5s %7.2f ms %7.2f ms %7.2f ms %7.2f ms %7.2fx %10.1f\n", Stats.ThreadCount, Warm ? "warm" : "cold",
+				Wall * 1000.0, Stats.FileReadTime * 1000.0, Stats.FileParseTime * 1000.0, Stats.MergeTime * 1000.0,
+				SingleThreadTime[Warm] / Wall, Stats.BytesRead / Wall / (1024.0 * 1024.0));
+
+			//the merged streams have to match every file loaded on its own, at their rebased offsets
+			if (Threads == MaxThreads && Warm)
+			{
+				uint8_t* Buffer = malloc(Scene.BufferSize ? Scene.BufferSize : 1);
+				uint32_t MeshletOffset = 0;
+
+				if (Buffer == NULL)
+				{
+					fprintf(stderr, "out of memory\n");
+					MeshSceneFree(&Scene);
+					return EXIT_FAILURE;
+				}
+
+				MeshSceneCopyBuffer(&Scene, Buffer);
+
+				for (uint32_t i = 0, Mesh = 0; i < Scene.FileCount; i++)
+				{
+					struct MeshFile Reference;
+					Result = MeshFileOpen(Scene.Paths[i], &Reference);
+
+					if (Result == MESHFILE_OK)
+						Result = MeshFileRepack(&Reference);
+
+					if (Result != MESHFILE_OK)
+					{
+						fprintf(stderr, "%s: %s\n", Scene.Paths[i], MeshFileResultString(Result));
+						Mismatches++;
+						continue;
+					}
+
+					for (uint32_t j = 0; j < Reference.MeshCount; j++, Mesh++)
+					{
+						if (Mesh >= Scene.MeshCount || Scene.MeshFileIndices[Mesh] != i || Scene.MeshletOffsets[Mesh] != MeshletOffset)
+						{
+							Mismatches++;
+							continue;
+						}
+
+						const struct Mesh* Merged = &Scene.MeshList[Mesh];
+
+						for (uint32_t s = 0; s < MESH_STREAM_COUNT; s++)
+						{
+							const uint64_t Size = MeshStreamSize(&Reference.MeshList[j], s);
+
+							if (Size != MeshStreamSize(Merged, s))
+								Mismatches++;
+							else if (Size != 0 && (Merged->StreamOffsets[s] % MESHFILE_STREAM_ALIGNMENT != 0 ||
+								memcmp(Buffer + Merged->StreamOffsets[s], MeshStreamData(&Reference.MeshList[j], s), Size) != 0))
+							{
+								printf("    mesh %u %s: not at its rebased offset\n", Mesh, StreamNames[StreamKind(s)]);
+								Mismatches++;
+							}
+						}
+
+						MeshletOffset += Reference.MeshList[j].MeshletCount;
+					}
+
+					MeshFileClose(&Reference);
+				}
+
+				if (MeshletOffset != Scene.MeshletCount)
+					Mismatches++;
+
+				printf("  %u files, %u meshes, %u meshlets, %u byte buffer, %u mismatches\n",
+					Scene.FileCount, Scene.MeshCount, Scene.MeshletCount, Scene.BufferSize, Mismatches);
+
+				free(Buffer);
+			}
+
+			MeshSceneFree(&Scene);
+		}
+
+		if (Threads == MaxThreads)
+			break;
+	}
+
+	return Mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//owned streams of a mesh that lodgen built
+struct LodLevel
+{
+	struct Mesh Mesh;
+	uint8_t* Vertices[ATTRIBUTE_TYPE_COUNT];
+	uint8_t* Indices;
+	struct Subset* Subsets;
+	struct MeshletData Meshlets;
+};
+
+static void FreeLodLevel(struct LodLevel* Level)
+{
+	for (uint32_t i = 0; i < ATTRIBUTE_TYPE_COUNT; i++)
+		free(Level->Vertices[i]);
+
+	free(Level->Indices);
+	free(Level->Subsets);
+	MeshletDataFree(&Level->Meshlets);
+	memset(Level, 0, sizeof(*Level));
+}
+
+//a copy of Source holding only the vertices Indices use, renumbered in first use order, with fresh meshlets
+static bool MakeLodLevel(const struct Mesh* Source, const uint32_t* Indices, const struct Subset* Subsets, uint32_t IndexCount, struct LodLevel* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	uint32_t* Remap = malloc(sizeof(uint32_t) * (Source->VertexCount ? Source->VertexCount : 1));
+
+	if (Remap == NULL)
+		return false;
+
+	memset(Remap, 0xff, sizeof(uint32_t) * Source->VertexCount);
+
+	uint32_t VertexCount = 0;
+	for (uint32_t i = 0; i < IndexCount; i++)
+	{
+		if (Remap[Indices[i]] == UINT32_MAX)
+			Remap[Indices[i]] = VertexCount++;
+	}
+
+	const uint32_t IndexSize = VertexCount <= 0x10000 ? 2 : 4;
+
+	Out->Mesh = *Source;
+	Out->Indices = malloc((size_t)IndexCount * IndexSize + 1);
+	Out->Subsets = malloc(sizeof(struct Subset) * (Source->IndexSubsetCount ? Source->IndexSubsetCount : 1));
+	bool bValid = Out->Indices != NULL && Out->Subsets != NULL;
+
+	for (uint32_t b = 0; bValid && b < Source->VertexBufferCount; b++)
+	{
+		const uint32_t Stride = Source->VertexBuffers[b].Stride;
+
+		if ((Out->Vertices[b] = malloc((size_t)VertexCount * Stride + 1)) == NULL)
+		{
+			bValid = false;
+			break;
+		}
+
+		for (uint32_t v = 0; v < Source->VertexCount; v++)
+		{
+			if (Remap[v] != UINT32_MAX)
+				memcpy(Out->Vertices[b] + (size_t)Remap[v] * Stride, Source->VertexBuffers[b].Verts + (size_t)v * Stride, Stride);
+		}
+
+		Out->Mesh.VertexBuffers[b].Verts = Out->Vertices[b];
+		Out->Mesh.VertexBuffers[b].Size = VertexCount * Stride;
+	}
+
+	if (bValid)
+	{
+		for (uint32_t i = 0; i < IndexCount; i++)
+		{
+			if (IndexSize == 2)
+				((uint16_t*)Out->Indices)[i] = (uint16_t)Remap[Indices[i]];
+			else
+				((uint32_t*)Out->Indices)[i] = Remap[Indices[i]];
+		}
+
+		memcpy(Out->Subsets, Subsets, sizeof(struct Subset) * Source->IndexSubsetCount);
+
+		Out->Mesh.VertexCount = VertexCount;
+		Out->Mesh.IndexBuffer = Out->Indices;
+		Out->Mesh.IndexBufferSize = IndexCount * IndexSize;
+		Out->Mesh.IndexSize = IndexSize;
+		Out->Mesh.IndexCount = IndexCount;
+		Out->Mesh.IndexSubsets = Out->Subsets;
+
+		struct BoundingSphere Sphere;
+		ComputeMeshBounds(&Out->Mesh, 1, PlatformSimdBest(), 1, &Sphere);
+
+		//coarser levels keep the meshlet limits of the level they come from
+		uint32_t MaxVertices, MaxPrimitives;
+		MeshMeshletLimits(Source, &MaxVertices, &MaxPrimitives);
+
+		bValid = BuildMeshlets(&Out->Mesh, MaxVertices, MaxPrimitives, 0, &Out->Meshlets) == MESHLET_BUILD_OK;
+	}
+
+	free(Remap);
+
+	if (!bValid)
+	{
+		FreeLodLevel(Out);
+		return false;
+	}
+
+	MeshletDataApply(&Out->Meshlets, &Out->Mesh);
+	return true;
+}
+
+static int CommandLodGen(int ArgCount, char** Args)
+{
+	if (ArgCount < 2)
+	{
+		fprintf(stderr, "usage: MeshTool lodgen <in.bin> <out prefix> [levels]\n");
+		return EXIT_FAILURE;
+	}
+
+	uint32_t LevelCount = ArgCount >= 3 ? (uint32_t)atoi(Args[2]) : 4;
+	LevelCount = LevelCount < 2 ? 2 : LevelCount > MESH_LOD_MAX_LEVELS ? MESH_LOD_MAX_LEVELS : LevelCount;
+
+	struct MeshFile Source;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &Source);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t MeshCount = Source.MeshCount;
+
+	//each level is simplified from the one before, per index subset, so subset borders stay where they are
+	uint32_t** Current = calloc(MeshCount ? MeshCount : 1, sizeof(uint32_t*));
+	uint32_t** Next = calloc(MeshCount ? MeshCount : 1, sizeof(uint32_t*));
+	struct Subset** Subsets = calloc(MeshCount ? MeshCount : 1, sizeof(struct Subset*));
+	float* ErrorBounds = calloc(MeshCount ? MeshCount : 1, sizeof(float));
+	struct LodLevel* Levels = calloc(MeshCount ? MeshCount : 1, sizeof(struct LodLevel));
+	struct Mesh* Meshes = calloc(MeshCount ? MeshCount : 1, sizeof(struct Mesh));
+
+	int ExitCode = Current && Next && Subsets && ErrorBounds && Levels && Meshes ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	for (uint32_t i = 0; i < MeshCount && ExitCode == EXIT_SUCCESS; i++)
+	{
+		const struct Mesh* Mesh = &Source.MeshList[i];
+
+		if (Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION] == MESHFILE_ATTRIBUTE_NONE)
+		{
+			fprintf(stderr, "mesh %u: no positions\n", i);
+			ExitCode = EXIT_FAILURE;
+			break;
+		}
+
+		Current[i] = malloc(sizeof(uint32_t) * (Mesh->IndexCount + 1));
+		Next[i] = malloc(sizeof(uint32_t) * (Mesh->IndexCount + 1));
+		Subsets[i] = malloc(sizeof(struct Subset) * (Mesh->IndexSubsetCount + 1));
+
+		if (Current[i] == NULL || Next[i] == NULL || Subsets[i] == NULL)
+		{
+			ExitCode = EXIT_FAILURE;
+			break;
+		}
+
+		for (uint32_t j = 0; j < Mesh->IndexCount; j++)
+			Current[i][j] = ReadMeshIndex(Mesh, Mesh->IndexBuffer, j);
+
+		memcpy(Subsets[i], Mesh->IndexSubsets, sizeof(struct Subset) * Mesh->IndexSubsetCount);
+	}
+
+	char Path[MESH_SCENE_MAX_PATH];
+	uint32_t Problems = 0;
+
+	if (ExitCode == EXIT_SUCCESS)
+	{
+		snprintf(Path, sizeof(Path), "%s_LOD0.bin", Args[1]);
+		Result = MeshFileSave(Path, Source.MeshList, MeshCount, false);
+
+		if (Result != MESHFILE_OK)
+		{
+			fprintf(stderr, "%s: %s\n", Path, MeshFileResultString(Result));
+			ExitCode = EXIT_FAILURE;
+		}
+	}
+
+	printf("%s: %u meshes, %u levels\n", Args[0], MeshCount, LevelCount);
+	printf("  %-5s %-4s %10s %10s %9s %10s %12s %12s %8s\n", "level", "mesh", "triangles", "vertices", "meshlets", "simplify", "error bound", "density err", "problems");
+
+	for (uint32_t i = 0; i < MeshCount && ExitCode == EXIT_SUCCESS; i++)
+	{
+		const struct Mesh* Mesh = &Source.MeshList[i];
+		printf("  %-5u %-4u %10u %10u %9u %10s %12g %12g %8u\n", 0, i, Mesh->IndexCount / 3, Mesh->VertexCount, Mesh->MeshletCount, "-", 0.0, MeshLodGeometricError(Mesh), 0);
+	}
+
+	for (uint32_t Level = 1; Level < LevelCount && ExitCode == EXIT_SUCCESS; Level++)
+	{
+		for (uint32_t i = 0; i < MeshCount && ExitCode == EXIT_SUCCESS; i++)
+		{
+			const struct Mesh* Mesh = &Source.MeshList[i];
+			const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+
+			const double Start = PlatformGetTime();
+			uint32_t IndexCount = 0;
+			float LevelError = 0.0f;
+
+			for (uint32_t s = 0; s < Mesh->IndexSubsetCount; s++)
+			{
+				const struct Subset Subset = Subsets[i][s];
+				const uint32_t Target = Subset.Count / 6 * 3;
+
+				float Error;
+				const uint32_t Count = SimplifyMesh(MeshPosition(Mesh, 0), Mesh->VertexBuffers[Slot].Stride, Mesh->VertexCount,
+					Current[i] + Subset.Offset, Subset.Count, NULL, Target, FLT_MAX, Next[i] + IndexCount, &Error);
+
+				if (Error < 0.0f)
+				{
+					fprintf(stderr, "out of memory\n");
+					ExitCode = EXIT_FAILURE;
+					break;
+				}
+
+				Subsets[i][s].Offset = IndexCount;
+				Subsets[i][s].Count = Count;
+				IndexCount += Count;
+				LevelError = Error > LevelError ? Error : LevelError;
+			}
+
+			const double SimplifyTime = PlatformGetTime() - Start;
+
+			uint32_t* Swap = Current[i];
+			Current[i] = Next[i];
+			Next[i] = Swap;
+
+			//each step moves the surface by at most its own error, so they add up to a bound against level 0
+			ErrorBounds[i] += LevelError;
+
+			if (ExitCode != EXIT_SUCCESS || !MakeLodLevel(Mesh, Current[i], Subsets[i], IndexCount, &Levels[i]))
+			{
+				fprintf(stderr, "mesh %u: could not build level %u\n", i, Level);
+				ExitCode = EXIT_FAILURE;
+				break;
+			}
+
+			Meshes[i] = Levels[i].Mesh;
+
+			uint32_t MaxVertices, MaxPrimitives;
+			MeshMeshletLimits(&Meshes[i], &MaxVertices, &MaxPrimitives);
+
+			const uint32_t LevelProblems = ValidateMeshlets(&Meshes[i], MaxVertices, MaxPrimitives);
+			Problems += LevelProblems;
+
+			printf("  %-5u %-4u %10u %10u %9u %7.2f ms %12g %12g %8u\n", Level, i, IndexCount / 3, Meshes[i].VertexCount, Meshes[i].MeshletCount,
+				SimplifyTime * 1000.0, ErrorBounds[i], MeshLodGeometricError(&Meshes[i]), LevelProblems);
+		}
+
+		if (ExitCode == EXIT_SUCCESS)
+		{
+			snprintf(Path, sizeof(Path), "%s_LOD%u.bin", Args[1], Level);
+			Result = MeshFileSave(Path, Meshes, MeshCount, false);
+
+			if (Result != MESHFILE_OK)
+			{
+				fprintf(stderr, "%s: %s\n", Path, MeshFileResultString(Result));
+				ExitCode = EXIT_FAILURE;
+			}
+		}
+
+		for (uint32_t i = 0; Levels != NULL && i < MeshCount; i++)
+			FreeLodLevel(&Levels[i]);
+	}
+
+	if (ExitCode == EXIT_SUCCESS)
+		printf("  wrote %s_LOD0.bin .. %s_LOD%u.bin, %u problems\n", Args[1], Args[1], LevelCount - 1, Problems);
+
+	for (uint32_t i = 0; i < MeshCount; i++)
+	{
+		free(Current ? Current[i] : NULL);
+		free(Next ? Next[i] : NULL);
+		free(Subsets ? Subsets[i] : NULL);
+	}
+
+	free(Current);
+	free(Next);
+	free(Subsets);
+	free(ErrorBounds);
+	free(Levels);
+	free(Meshes);
+	MeshFileClose(&Source);
+
+	return ExitCode == EXIT_SUCCESS && Problems == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int CommandLod(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool lod <file_LOD0.bin> [instances]\n");
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t InstanceCount = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : 100000;
+
+	struct MeshScene Scene;
+	struct MeshSceneStats Stats;
+	enum MeshFileResult Result = MeshSceneLoadFiles((const char* const*)&Args[0], 1, 1, NULL, &Scene, &Stats);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Stats.FailedPath, MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	printf("%s: %u files, %u chains\n", Args[0], Scene.FileCount, Scene.LodChainCount);
+
+	for (uint32_t c = 0; c < Scene.LodChainCount; c++)
+	{
+		const struct MeshLodChain* Chain = &Scene.LodChains[c];
+
+		for (uint32_t k = 0; k < Chain->LevelCount; k++)
+		{
+			const struct Mesh* Mesh = &Scene.MeshList[Chain->Meshes[k]];
+			printf("  chain %u level %u: %10u triangles %8u meshlets  error %g\n", c, k, Mesh->IndexCount / 3, Mesh->MeshletCount, Chain->Errors[k]);
+		}
+	}
+
+	struct BoundingSphere* Bounds = malloc(sizeof(struct BoundingSphere) * (InstanceCount ? InstanceCount : 1));
+	uint8_t* Reference = malloc(InstanceCount + 1);
+	uint8_t* Levels = malloc(InstanceCount + 1);
+
+	if (Bounds == NULL || Reference == NULL || Levels == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Bounds);
+		free(Reference);
+		free(Levels);
+		MeshSceneFree(&Scene);
+		return EXIT_FAILURE;
+	}
+
+	uint32_t Mismatches = 0;
+	const float Eye[3] = { 0.0f, 0.0f, 0.0f };
+	const float FovY = 1.04719755f;//60 degrees, like the renderer
+	const float ViewportHeight = 1080.0f;
+	const float PixelBudgets[] = { 0.5f, 1.0f, 2.0f, 4.0f };
+
+	for (uint32_t c = 0; c < Scene.LodChainCount; c++)
+	{
+		const struct MeshLodChain* Chain = &Scene.LodChains[c];
+		const float Radius = Chain->Bounds.Radius > 0.0f ? Chain->Bounds.Radius : 1.0f;
+
+		//a field of copies from touching the eye out to 1000 radii away
+		uint32_t Seed = 12345;
+		for (uint32_t i = 0; i < InstanceCount; i++)
+		{
+			float Direction[3], Length = 0.0f;
+			do
+			{
+				Length = 0.0f;
+				for (int k = 0; k < 3; k++)
+				{
+					Seed = Seed * 1664525u + 1013904223u;
+					Direction[k] = (float)(Seed >> 8) / (float)(1u << 24) * 2.0f - 1.0f;
+					Length += Direction[k] * Direction[k];
+				}
+			} while (Length > 1.0f || Length < 1e-6f);
+
+			Seed = Seed * 1664525u + 1013904223u;
+			const float Distance = Radius * 1000.0f * (float)(Seed >> 8) / (float)(1u << 24);
+
+			for (int k = 0; k < 3; k++)
+				Bounds[i].Center[k] = Direction[k] / sqrtf(Length) * Distance;
+			Bounds[i].Radius = Radius;
+		}
+
+		//the edges: the eye inside the bounds always gets level 0, an instance out of sight of any error the last
+		struct LodView View;
+		LodViewInit(Eye, FovY, ViewportHeight, 1.0f, &View);
+
+		const struct BoundingSphere Inside = { { 0.0f, 0.0f, 0.0f }, Radius };
+		const struct BoundingSphere Far = { { 0.0f, 0.0f, 1e30f }, Radius };
+
+		if (SelectLod(&View, Chain, &Inside) != 0)
+			Mismatches++;
+
+		if (Chain->Errors[Chain->LevelCount - 1] < FLT_MAX && SelectLod(&View, Chain, &Far) != Chain->LevelCount - 1)
+			Mismatches++;
+
+		const uint64_t Level0Meshlets = (uint64_t)Scene.MeshList[Chain->Meshes[0]].MeshletCount * InstanceCount;
+
+		printf("  chain %u, %u instances, %llu meshlets at level 0\n", c, InstanceCount, (unsigned long long)Level0Meshlets);
+		printf("    %-7s %12s %8s %-30s", "budget", "meshlets", "of lod0", "instances per level");
+
+		for (int Kernel = SIMD_LEVEL_SCALAR; Kernel < SIMD_LEVEL_COUNT; Kernel++)
+		{
+			if (PlatformSimdSupported((enum SimdLevel)Kernel))
+				printf(" %12s", PlatformSimdName((enum SimdLevel)Kernel));
+		}
+		printf("\n");
+
+		for (size_t b = 0; b < sizeof(PixelBudgets) / sizeof(PixelBudgets[0]); b++)
+		{
+			LodViewInit(Eye, FovY, ViewportHeight, PixelBudgets[b], &View);
+
+			for (uint32_t i = 0; i < InstanceCount; i++)
+				Reference[i] = (uint8_t)SelectLod(&View, Chain, &Bounds[i]);
+
+			uint64_t Meshlets = 0;
+			uint32_t PerLevel[MESH_LOD_MAX_LEVELS] = { 0 };
+
+			for (uint32_t i = 0; i < InstanceCount; i++)
+			{
+				Meshlets += Scene.MeshList[Chain->Meshes[Reference[i]]].MeshletCount;
+				PerLevel[Reference[i]]++;
+			}
+
+			char Histogram[64] = "";
+			for (uint32_t k = 0, Length = 0; k < Chain->LevelCount && Length < sizeof(Histogram); k++)
+				Length += snprintf(Histogram + Length, sizeof(Histogram) - Length, k ? " %u" : "%u", PerLevel[k]);
+
+			printf("    %4.1f px %12llu %7.1f%% %-30s", PixelBudgets[b], (unsigned long long)Meshlets, Level0Meshlets ? 100.0 * Meshlets / Level0Meshlets : 0.0, Histogram);
+
+			for (int Kernel = SIMD_LEVEL_SCALAR; Kernel < SIMD_LEVEL_COUNT; Kernel++)
+			{
+				if (!PlatformSimdSupported((enum SimdLevel)Kernel))
+					continue;
+
+				const int Iterations = 20;
+				const double Start = PlatformGetTime();
+
+				for (int Iteration = 0; Iteration < Iterations; Iteration++)
+					SelectLods(&View, Chain, Bounds, InstanceCount, (enum SimdLevel)Kernel, Levels);
+
+				const double Time = (PlatformGetTime() - Start) / Iterations;
+
+				if (memcmp(Levels, Reference, InstanceCount) != 0)
+					Mismatches++;
+
+				printf(" %7.1f Mi/s", Time > 0.0 ? InstanceCount / Time / 1e6 : 0.0);
+			}
+
+			printf("\n");
+		}
+	}
+
+	printf("  %u mismatches\n", Mismatches);
+
+	free(Bounds);
+	free(Reference);
+	free(Levels);
+	MeshSceneFree(&Scene);
+
+	return Mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//checks what a cut relies on: child ranges inside the mesh, every child carrying its group's error and sphere as its
+//parent's, errors and spheres that only grow towards the roots, one first sibling per group and roots without parents.
+//returns the number of problems found
+static uint32_t ValidateDag(const struct Mesh* Mesh)
+{
+	uint32_t Errors = 0;
+
+	if (Mesh->ClusterLodCount != Mesh->MeshletCount || Mesh->ClusterRootCount != Mesh->MeshletSubsetCount)
+	{
+		fprintf(stderr, "    %u cluster lods for %u meshlets, %u roots for %u subsets\n", Mesh->ClusterLodCount, Mesh->MeshletCount, Mesh->ClusterRootCount, Mesh->MeshletSubsetCount);
+		return 1;
+	}
+
+	uint8_t* Parents = calloc(Mesh->MeshletCount + 1, 1);
+	uint32_t* FirstSiblings = calloc(Mesh->MeshletCount + 1, sizeof(uint32_t));
+
+	if (Parents == NULL || FirstSiblings == NULL)
+	{
+		free(Parents);
+		free(FirstSiblings);
+		fprintf(stderr, "    out of memory\n");
+		return 1;
+	}
+
+	for (uint32_t c = 0; c < Mesh->ClusterLodCount; c++)
+	{
+		const struct ClusterLod* Lod = &Mesh->ClusterLods[c];
+
+		if (Lod->ChildCount == 0)
+		{
+			if (Lod->Error != 0.0f && Errors++ == 0)
+				fprintf(stderr, "    cluster %u: level 0 with error %g\n", c, Lod->Error);
+			continue;
+		}
+
+		if ((uint64_t)Lod->ChildOffset + Lod->ChildCount > Mesh->MeshletCount)
+		{
+			if (Errors++ == 0)
+				fprintf(stderr, "    cluster %u: children out of range\n", c);
+			continue;
+		}
+
+		FirstSiblings[Lod->ChildOffset] += Lod->bFirstSibling;
+
+		for (uint32_t k = Lod->ChildOffset; k < Lod->ChildOffset + Lod->ChildCount; k++)
+		{
+			const struct ClusterLod* Child = &Mesh->ClusterLods[k];
+			const float* a = Lod->Bounds;
+			const float* b = Child->Bounds;
+			const float Distance = sqrtf((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+
+			Parents[k] = 1;
+
+			if (Child->ParentError != Lod->Error || memcmp(Child->ParentBounds, Lod->Bounds, sizeof(Lod->Bounds)) != 0)
+			{
+				if (Errors++ == 0)
+					fprintf(stderr, "    cluster %u: child %u doesn't carry its error and bounds\n", c, k);
+			}
+			else if (Child->Error > Lod->Error || (Child->Error != 0.0f && Child->Error >= Lod->Error) || Distance + b[3] > a[3])
+			{
+				if (Errors++ == 0)
+					fprintf(stderr, "    cluster %u: child %u error %g / %g or bounds not nested\n", c, k, Child->Error, Lod->Error);
+			}
+		}
+	}
+
+	for (uint32_t c = 0; c < Mesh->ClusterLodCount; c++)
+	{
+		const struct ClusterLod* Lod = &Mesh->ClusterLods[c];
+
+		if (Lod->ChildCount != 0 && FirstSiblings[Lod->ChildOffset] != 1)
+		{
+			if (Errors++ == 0)
+				fprintf(stderr, "    cluster %u: group at %u has %u first siblings\n", c, Lod->ChildOffset, FirstSiblings[Lod->ChildOffset]);
+		}
+
+		if (!Parents[c] && Lod->ParentError != FLT_MAX)
+		{
+			if (Errors++ == 0)
+				fprintf(stderr, "    cluster %u: not in any group but has a parent error\n", c);
+		}
+	}
+
+	//the roots are the clusters nothing was made from
+	for (uint32_t s = 0; s < Mesh->ClusterRootCount; s++)
+	{
+		const struct Subset* Roots = &Mesh->ClusterRoots[s];
+
+		for (uint32_t c = Roots->Offset; c < Roots->Offset + Roots->Count && c < Mesh->MeshletCount; c++)
+		{
+			if (Mesh->ClusterLods[c].ParentError != FLT_MAX)
+			{
+				if (Errors++ == 0)
+					fprintf(stderr, "    subset %u: root %u has a parent\n", s, c);
+			}
+		}
+	}
+
+	free(Parents);
+	free(FirstSiblings);
+	return Errors;
+}
+
+static int CommandDag(int ArgCount, char** Args)
+{
+	if (ArgCount < 2)
+	{
+		fprintf(stderr, "usage: MeshTool dag <in.bin> <out.bin> [max verts] [max prims]\n");
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t MaxVertices = ArgCount >= 3 ? (uint32_t)atoi(Args[2]) : MESHLET_DEFAULT_MAX_VERTICES;
+	const uint32_t MaxPrimitives = ArgCount >= 4 ? (uint32_t)atoi(Args[3]) : MESHLET_DEFAULT_MAX_PRIMITIVES;
+
+	struct MeshFile Source;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &Source);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t MeshCount = Source.MeshCount;
+	struct MeshletDag* Dags = calloc(MeshCount ? MeshCount : 1, sizeof(struct MeshletDag));
+	struct Mesh* Meshes = calloc(MeshCount ? MeshCount : 1, sizeof(struct Mesh));
+
+	if (Dags == NULL || Meshes == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Dags);
+		free(Meshes);
+		MeshFileClose(&Source);
+		return EXIT_FAILURE;
+	}
+
+	printf("%s: %u meshes, %u / %u meshlet limits\n", Args[0], MeshCount, MaxVertices, MaxPrimitives);
+	printf("  %-4s %10s %9s %9s %7s %6s %10s %12s %10s %8s\n", "mesh", "triangles", "level 0", "clusters", "levels", "roots", "root tris", "root error", "build", "problems");
+
+	uint32_t Problems = 0;
+	int ExitCode = EXIT_SUCCESS;
+
+	for (uint32_t i = 0; i < MeshCount; i++)
+	{
+		const double Start = PlatformGetTime();
+		const enum MeshletBuildResult BuildResult = BuildMeshletDag(&Source.MeshList[i], MaxVertices, MaxPrimitives, 0, &Dags[i]);
+		const double BuildTime = PlatformGetTime() - Start;
+
+		if (BuildResult != MESHLET_BUILD_OK)
+		{
+			fprintf(stderr, "mesh %u: %s\n", i, MeshletBuildResultString(BuildResult));
+			ExitCode = EXIT_FAILURE;
+			break;
+		}
+
+		Meshes[i] = Source.MeshList[i];
+		MeshletDagApply(&Dags[i], &Meshes[i]);
+
+		const uint32_t MeshProblems = ValidateMeshlets(&Meshes[i], MaxVertices, MaxPrimitives) + ValidateDag(&Meshes[i]);
+		Problems += MeshProblems;
+
+		uint32_t Level0 = 0;
+		uint32_t RootTriangles = 0;
+		float RootError = 0.0f;
+
+		for (uint32_t s = 0; s < Meshes[i].MeshletSubsetCount; s++)
+		{
+			const struct Subset* Roots = &Meshes[i].ClusterRoots[s];
+			Level0 += Meshes[i].MeshletSubsets[s].Count;
+
+			for (uint32_t c = Roots->Offset; c < Roots->Offset + Roots->Count; c++)
+			{
+				RootTriangles += Meshes[i].Meshlets[c].PrimCount;
+				RootError = fmaxf(RootError, Meshes[i].ClusterLods[c].Error);
+			}
+		}
+
+		printf("  %-4u %10u %9u %9u %7u %6u %10u %12g %7.1f ms %8u\n", i, Meshes[i].IndexCount / 3, Level0, Meshes[i].MeshletCount,
+			Dags[i].LevelCount, Dags[i].ClusterRootCount, RootTriangles, RootError, BuildTime * 1000.0, MeshProblems);
+	}
+
+	if (ExitCode == EXIT_SUCCESS)
+	{
+		Result = MeshFileSave(Args[1], Meshes, MeshCount, false);
+
+		struct MeshFile Converted;
+
+		if (Result == MESHFILE_OK && (Result = MeshFileOpen(Args[1], &Converted)) == MESHFILE_OK)
+		{
+			uint32_t Mismatches = Converted.Version < FILE_VERSION_CLUSTERS || Converted.MeshCount != MeshCount;
+
+			for (uint32_t i = 0; i < MeshCount && Mismatches == 0; i++)
+				Mismatches += CompareMeshStreams(&Meshes[i], &Converted.MeshList[i], Converted.Buffer);
+
+			printf("  wrote %s: %zu bytes, version %u, %u mismatches, %u problems\n", Args[1], Converted.Size, Converted.Version, Mismatches, Problems);
+
+			Problems += Mismatches;
+			MeshFileClose(&Converted);
+		}
+
+		if (Result != MESHFILE_OK)
+		{
+			fprintf(stderr, "%s: %s\n", Args[1], MeshFileResultString(Result));
+			ExitCode = EXIT_FAILURE;
+		}
+	}
+
+	for (uint32_t i = 0; i < MeshCount; i++)
+		MeshletDagFree(&Dags[i]);
+
+	free(Dags);
+	free(Meshes);
+	MeshFileClose(&Source);
+
+	return ExitCode == EXIT_SUCCESS && Problems == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int CompareEdges(const void* A, const void* B)
+{
+	const int64_t a = *(const int64_t*)A >> 1;
+	const int64_t b = *(const int64_t*)B >> 1;
+	return (a > b) - (a < b);
+}
+
+//what a set of meshlets looks like from outside: the welded edges left open, each with how many more times it's used
+//one way than the other, and the total area. a cut that drops or doubles a piece of the surface, or leaves a crack
+//where coarse meets fine, opens edges that level 0 doesn't have. Edges is malloc'd, returns its length
+static uint32_t SurfaceSignature(const struct Mesh* Mesh, const uint32_t* Weld, const uint32_t* Meshlets, uint32_t MeshletCount, int64_t** Edges, double* Area)
+{
+	uint64_t TriangleCount = 0;
+	for (uint32_t m = 0; m < MeshletCount; m++)
+		TriangleCount += Mesh->Meshlets[Meshlets[m]].PrimCount;
+
+	//undirected edge key in the upper bits, direction in bit 0
+	int64_t* Keys = malloc(sizeof(int64_t) * 3 * (size_t)TriangleCount + 1);
+	uint32_t KeyCount = 0;
+	*Area = 0.0;
+	*Edges = NULL;
+
+	if (Keys == NULL)
+		return 0;
+
+	for (uint32_t m = 0; m < MeshletCount; m++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[Meshlets[m]];
+
+		for (uint32_t p = 0; p < Meshlet->PrimCount; p++)
+		{
+			const struct PackedTriangle Triangle = Mesh->PrimitiveIndices[Meshlet->PrimOffset + p];
+			const uint32_t v[3] =
+			{
+				Weld[MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i0)],
+				Weld[MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i1)],
+				Weld[MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i2)],
+			};
+
+			const float* p0 = MeshPosition(Mesh, v[0]);
+			const float* p1 = MeshPosition(Mesh, v[1]);
+			const float* p2 = MeshPosition(Mesh, v[2]);
+			const double e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const double e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			const double n[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+			*Area += 0.5 * sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (int k = 0; k < 3; k++)
+			{
+				const uint32_t a = v[k];
+				const uint32_t b = v[(k + 1) % 3];
+
+				if (a != b)
+					Keys[KeyCount++] = (int64_t)(((uint64_t)(a < b ? a : b) << 32 | (a < b ? b : a)) << 1 | (a < b));
+			}
+		}
+	}
+
+	qsort(Keys, KeyCount, sizeof(int64_t), CompareEdges);
+
+	//compacted in place: each open edge once, its balance in the low bits
+	uint32_t OpenCount = 0;
+
+	for (uint32_t Begin = 0, End; Begin < KeyCount; Begin = End)
+	{
+		int64_t Balance = 0;
+
+		for (End = Begin; End < KeyCount && Keys[End] >> 1 == Keys[Begin] >> 1; End++)
+			Balance += (Keys[End] & 1) ? 1 : -1;
+
+		if (Balance != 0)
+			Keys[OpenCount++] = (Keys[Begin] >> 1) * 256 + Balance;
+	}
+
+	*Edges = Keys;
+	return OpenCount;
+}
+
+static int CompareU32(const void* A, const void* B)
+{
+	const uint32_t a = *(const uint32_t*)A;
+	const uint32_t b = *(const uint32_t*)B;
+	return (a > b) - (a < b);
+}
+
+static int CommandDagCut(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool dagcut <file.bin> [views per distance]\n");
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t ViewsPerDistance = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : 8;
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	struct BoundingSphere SceneSphere;
+	ComputeMeshBounds(File.MeshList, File.MeshCount, PlatformSimdBest(), 0, &SceneSphere);
+
+	printf("%s: version %u, %u meshes\n", Args[0], File.Version, File.MeshCount);
+
+	const float FovY = 1.04719755f;//60 degrees, like the renderer
+	const float ViewportHeight = 1080.0f;
+	const float Distances[] = { 0.0f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f, 128.0f, 256.0f, 1000.0f };
+
+	uint32_t Mismatches = 0;
+	uint32_t Cracks = 0;
+	uint32_t DagMeshes = 0;
+
+	for (uint32_t i = 0; i < File.MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &File.MeshList[i];
+
+		if (Mesh->ClusterLodCount == 0)
+			continue;
+
+		DagMeshes++;
+
+		uint32_t* Weld = malloc(sizeof(uint32_t) * (Mesh->VertexCount + 1));
+		uint32_t* Cut = malloc(sizeof(uint32_t) * (Mesh->MeshletCount + 1));
+		uint32_t* Reference = malloc(sizeof(uint32_t) * (Mesh->MeshletCount + 1));
+		uint32_t* Level0 = malloc(sizeof(uint32_t) * (Mesh->MeshletCount + 1));
+
+		const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+
+		if (Weld == NULL || Cut == NULL || Reference == NULL || Level0 == NULL ||
+			!WeldPositions(MeshPosition(Mesh, 0), Mesh->VertexBuffers[Slot].Stride, Mesh->VertexCount, Weld))
+		{
+			fprintf(stderr, "out of memory\n");
+			free(Weld);
+			free(Cut);
+			free(Reference);
+			free(Level0);
+			Mismatches++;
+			break;
+		}
+
+		uint32_t Level0Count = 0;
+		uint32_t Level0Triangles = 0;
+
+		for (uint32_t s = 0; s < Mesh->MeshletSubsetCount; s++)
+		{
+			for (uint32_t m = 0; m < Mesh->MeshletSubsets[s].Count; m++)
+			{
+				Level0[Level0Count++] = Mesh->MeshletSubsets[s].Offset + m;
+				Level0Triangles += Mesh->Meshlets[Mesh->MeshletSubsets[s].Offset + m].PrimCount;
+			}
+		}
+
+		int64_t* Level0Edges;
+		double Level0Area;
+		const uint32_t Level0EdgeCount = SurfaceSignature(Mesh, Weld, Level0, Level0Count, &Level0Edges, &Level0Area);
+
+		printf("  mesh %u: %u meshlets at level 0, %u in the dag, %u open edges, radius %g\n", i, Level0Count, Mesh->MeshletCount, Level0EdgeCount, Mesh->BoundingSphere.Radius);
+		printf("    %-9s %9s %11s %8s %10s %10s %12s %12s %9s\n", "distance", "clusters", "triangles", "of lod0", "area", "cracks", "traverse", "brute force", "mismatch");
+
+		uint32_t Seed = 12345;
+
+		for (size_t d = 0; d < sizeof(Distances) / sizeof(Distances[0]); d++)
+		{
+			uint64_t Clusters = 0;
+			uint64_t Triangles = 0;
+			double AreaError = 0.0;
+			double TraverseTime = 0.0;
+			double BruteTime = 0.0;
+			uint32_t DistanceCracks = 0;
+			uint32_t DistanceMismatches = 0;
+
+			for (uint32_t v = 0; v < ViewsPerDistance; v++)
+			{
+				float Direction[3], Length;
+				do
+				{
+					Length = 0.0f;
+					for (int k = 0; k < 3; k++)
+					{
+						Seed = Seed * 1664525u + 1013904223u;
+						Direction[k] = (float)(Seed >> 8) / (float)(1u << 24) * 2.0f - 1.0f;
+						Length += Direction[k] * Direction[k];
+					}
+				} while (Length > 1.0f || Length < 1e-6f);
+
+				float Eye[3];
+				for (int k = 0; k < 3; k++)
+					Eye[k] = Mesh->BoundingSphere.Center[k] + Direction[k] / sqrtf(Length) * Mesh->BoundingSphere.Radius * Distances[d];
+
+				struct LodView View;
+				LodViewInit(Eye, FovY, ViewportHeight, 1.0f, &View);
+
+				double Start = PlatformGetTime();
+				uint32_t CutCount = 0;
+				for (uint32_t s = 0; s < Mesh->MeshletSubsetCount; s++)
+					CutCount += CutMeshletDag(&View, Mesh, s, Cut + CutCount);
+				TraverseTime += PlatformGetTime() - Start;
+
+				Start = PlatformGetTime();
+				const uint32_t ReferenceCount = CutMeshletDagReference(&View, Mesh, Reference);
+				BruteTime += PlatformGetTime() - Start;
+
+				qsort(Cut, CutCount, sizeof(uint32_t), CompareU32);
+
+				if (CutCount != ReferenceCount || memcmp(Cut, Reference, sizeof(uint32_t) * CutCount) != 0 || CutCount > Level0Count)
+					DistanceMismatches++;
+
+				int64_t* Edges;
+				double Area;
+				const uint32_t EdgeCount = SurfaceSignature(Mesh, Weld, Cut, CutCount, &Edges, &Area);
+
+				if (EdgeCount != Level0EdgeCount || (EdgeCount != 0 && memcmp(Edges, Level0Edges, sizeof(int64_t) * EdgeCount) != 0))
+					DistanceCracks++;
+
+				free(Edges);
+
+				for (uint32_t c = 0; c < CutCount; c++)
+					Triangles += Mesh->Meshlets[Cut[c]].PrimCount;
+
+				Clusters += CutCount;
+				AreaError = fmax(AreaError, fabs(Area - Level0Area) / Level0Area);
+			}
+
+			const double Views = ViewsPerDistance ? ViewsPerDistance : 1;
+
+			printf("    %6g r %9.0f %11.0f %7.1f%% %9.2f%% %10u %9.2f us %9.2f us %9u\n", Distances[d], Clusters / Views, Triangles / Views,
+				Level0Triangles ? 100.0 * Triangles / Views / Level0Triangles : 0.0, 100.0 * AreaError, DistanceCracks,
+				TraverseTime / Views * 1e6, BruteTime / Views * 1e6, DistanceMismatches);
+
+			Cracks += DistanceCracks;
+			Mismatches += DistanceMismatches;
+		}
+
+		free(Level0Edges);
+		free(Weld);
+		free(Cut);
+		free(Reference);
+		free(Level0);
+	}
+
+	printf("  %u meshes with a dag, %u cracked cuts, %u mismatches\n", DagMeshes, Cracks, Mismatches);
+
+	MeshFileClose(&File);
+
+	return DagMeshes && Mismatches == 0 && Cracks == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static const double QUANTIZE_NORMAL_TOLERANCE = 0.005;//degrees, about twice what 16 bit octahedral normals lose
+
+//position error allowed by quantizing onto Steps steps of Scale from Offset: half a step, plus the float rounding of
+//offset + step * scale
+static double PositionTolerance(float Offset, float Scale, double Steps)
+{
+	return 0.5 * Scale + 4.0 * FLT_EPSILON * (fabs(Offset) + Scale * Steps);
+}
+
+static int CommandQuantize(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool quantize <file.bin> [iters]\n");
+		return EXIT_FAILURE;
+	}
+
+	const int Iterations = ArgCount >= 2 ? atoi(Args[1]) : 5;
+
+	struct MeshScene Scene;
+	struct MeshSceneStats Stats;
+	enum MeshFileResult Result = MeshSceneLoadFiles((const char* const*)&Args[0], 1, 1, NULL, &Scene, &Stats);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Stats.FailedPath, MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	uint32_t MaxVertexCount = 0;
+	uint64_t VertexCount = 0;
+	uint64_t FloatBytes = 0;
+
+	for (uint32_t i = 0; i < Scene.MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &Scene.MeshList[i];
+
+		MaxVertexCount = Mesh->VertexCount > MaxVertexCount ? Mesh->VertexCount : MaxVertexCount;
+		VertexCount += Mesh->VertexCount;
+
+		for (uint32_t j = 0; j < Mesh->VertexBufferCount; j++)
+			FloatBytes += Mesh->VertexBuffers[j].Size;
+	}
+
+	uint8_t* Buffer = malloc(Scene.BufferSize ? Scene.BufferSize : 1);
+	struct VertexQuantization* Quantizations = malloc(sizeof(struct VertexQuantization) * (Scene.MeshCount ? Scene.MeshCount : 1));
+	float* Positions = malloc(sizeof(float) * 3 * ((size_t)MaxVertexCount + 1));
+	float* Normals = malloc(sizeof(float) * 3 * ((size_t)MaxVertexCount + 1));
+
+	if (Buffer == NULL || Quantizations == NULL || Positions == NULL || Normals == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Buffer);
+		free(Quantizations);
+		free(Positions);
+		free(Normals);
+		MeshSceneFree(&Scene);
+		return EXIT_FAILURE;
+	}
+
+	MeshSceneCopyBuffer(&Scene, Buffer);
+
+	//every iteration rewrites the same streams from the files, so the last one leaves what the renderer uploads
+	double EncodeTime = 0.0;
+	for (int Iteration = 0; Iteration < (Iterations > 0 ? Iterations : 1); Iteration++)
+	{
+		const double Start = PlatformGetTime();
+		MeshSceneQuantizeVertices(&Scene, Buffer, 0, false, Quantizations);
+		EncodeTime += PlatformGetTime() - Start;
+	}
+	EncodeTime /= Iterations > 0 ? Iterations : 1;
+
+	printf("%s: %u meshes, %llu vertices, %llu bytes of float vertices -> %llu quantized (%.1f%%)\n", Args[0], Scene.MeshCount,
+		(unsigned long long)VertexCount, (unsigned long long)FloatBytes, (unsigned long long)VertexCount * sizeof(struct QuantizedVertex),
+		FloatBytes ? 100.0 * VertexCount * sizeof(struct QuantizedVertex) / FloatBytes : 0.0);
+	printf("  %-5s %9s %12s %12s %10s %10s %12s %12s\n", "mesh", "vertices", "step", "max error", "of step", "of radius", "normal max", "normal mean");
+
+	uint32_t Problems = 0;
+	double DecodeTime = 0.0;
+
+	for (uint32_t i = 0; i < Scene.MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &Scene.MeshList[i];
+		const struct VertexQuantization* Quantization = &Quantizations[i];
+
+		if (Mesh->StreamOffsets[MESH_STREAM_VERTICES] == MESHFILE_ATTRIBUTE_NONE)
+			continue;
+
+		const struct QuantizedVertex* Vertices = (const struct QuantizedVertex*)(Buffer + Mesh->StreamOffsets[MESH_STREAM_VERTICES]);
+
+		const double Start = PlatformGetTime();
+		DequantizeVertices(Vertices, Mesh->VertexCount, Quantization, Positions, Normals);
+		DecodeTime += PlatformGetTime() - Start;
+
+		const uint32_t NormalSlot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_NORMAL];
+
+		double MaxError = 0.0;
+		double MaxStepError = 0.0;
+		double MaxAngle = 0.0;
+		double AngleSum = 0.0;
+		uint32_t NormalCount = 0;
+
+		for (uint32_t v = 0; v < Mesh->VertexCount; v++)
+		{
+			const float* Position = MeshPosition(Mesh, v);
+
+			for (int k = 0; k < 3; k++)
+			{
+				const double Error = fabs((double)Positions[v * 3 + k] - Position[k]);
+
+				MaxError = fmax(MaxError, Error);
+				MaxStepError = fmax(MaxStepError, Quantization->Scale[k] > 0.0f ? Error / Quantization->Scale[k] : 0.0);
+
+				if (Error > PositionTolerance(Quantization->Offset[k], Quantization->Scale[k], QUANTIZED_POSITION_STEPS))
+					Problems++;
+			}
+
+			if (NormalSlot == MESHFILE_ATTRIBUTE_NONE)
+				continue;
+
+			float Normal[3];
+			memcpy(Normal, Mesh->VertexBuffers[NormalSlot].Verts + (size_t)v * Mesh->VertexBuffers[NormalSlot].Stride + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_NORMAL], sizeof(Normal));
+
+			const double Length = sqrt((double)Normal[0] * Normal[0] + (double)Normal[1] * Normal[1] + (double)Normal[2] * Normal[2]);
+
+			if (!(Length > 0.0) || !isfinite(Length))
+				continue;
+
+			//atan2 of the cross and dot products stays accurate for the tiny angles acos can't resolve
+			const double n[3] = { Normal[0] / Length, Normal[1] / Length, Normal[2] / Length };
+			const float* d = &Normals[v * 3];
+			const double Cross[3] = { n[1] * d[2] - n[2] * d[1], n[2] * d[0] - n[0] * d[2], n[0] * d[1] - n[1] * d[0] };
+			const double Dot = n[0] * d[0] + n[1] * d[1] + n[2] * d[2];
+			const double Angle = atan2(sqrt(Cross[0] * Cross[0] + Cross[1] * Cross[1] + Cross[2] * Cross[2]), Dot) * 180.0 / 3.14159265358979323846;
+
+			MaxAngle = fmax(MaxAngle, Angle);
+			AngleSum += Angle;
+			NormalCount++;
+
+			if (Angle > QUANTIZE_NORMAL_TOLERANCE)
+				Problems++;
+		}
+
+		const float Step = fmaxf(Quantization->Scale[0], fmaxf(Quantization->Scale[1], Quantization->Scale[2]));
+
+		printf("  %-5u %9u %12g %12g %10.3f %9.5f%% %10.5f d %10.5f d\n", i, Mesh->VertexCount, Step, MaxError, MaxStepError,
+			Mesh->BoundingSphere.Radius > 0.0f ? 100.0 * MaxError / Mesh->BoundingSphere.Radius : 0.0, MaxAngle, NormalCount ? AngleSum / NormalCount : 0.0);
+	}
+
+	printf("  encode %.2f ms (%.1f Mvertices/s), decode %.2f ms, %u values out of tolerance\n", EncodeTime * 1000.0, EncodeTime > 0.0 ? VertexCount / EncodeTime / 1e6 : 0.0,
+		DecodeTime * 1000.0, Problems);
+
+	free(Buffer);
+	free(Quantizations);
+	free(Positions);
+	free(Normals);
+	MeshSceneFree(&Scene);
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int CommandMeshletPositions(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool meshletpos <file.bin> [bits]...\n");
+		return EXIT_FAILURE;
+	}
+
+	static const uint32_t DefaultBits[] = { 10, 12, 14, 16, 18, 20 };
+
+	uint32_t BitCounts[16];
+	uint32_t BitCountCount = 0;
+
+	for (int i = 1; i < ArgCount && BitCountCount < sizeof(BitCounts) / sizeof(BitCounts[0]); i++)
+		BitCounts[BitCountCount++] = (uint32_t)atoi(Args[i]);
+
+	if (BitCountCount == 0)
+	{
+		memcpy(BitCounts, DefaultBits, sizeof(DefaultBits));
+		BitCountCount = sizeof(DefaultBits) / sizeof(DefaultBits[0]);
+	}
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	struct BoundingSphere SceneSphere;
+	ComputeMeshBounds(File.MeshList, File.MeshCount, PlatformSimdBest(), 0, &SceneSphere);
+
+	printf("%s: version %u, %u meshes\n", Args[0], File.Version, File.MeshCount);
+
+	uint32_t Problems = 0;
+
+	for (uint32_t i = 0; i < File.MeshCount && Problems == 0; i++)
+	{
+		const struct Mesh* Mesh = &File.MeshList[i];
+
+		uint32_t MeshletVertices = 0;
+		for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+			MeshletVertices += Mesh->Meshlets[m].VertCount;
+
+		//the first decode of every vertex, which each later meshlet sharing it has to match bit for bit
+		float* Decoded = malloc(sizeof(float) * 3 * ((size_t)MeshletVertices + 1));
+		float* First = malloc(sizeof(float) * 3 * ((size_t)Mesh->VertexCount + 1));
+		uint8_t* bSeen = malloc((size_t)Mesh->VertexCount + 1);
+
+		if (Decoded == NULL || First == NULL || bSeen == NULL)
+		{
+			fprintf(stderr, "out of memory\n");
+			free(Decoded);
+			free(First);
+			free(bSeen);
+			Problems++;
+			break;
+		}
+
+		printf("  mesh %u: %u vertices, %u in meshlets (%.2fx), %u meshlets, radius %g\n", i, Mesh->VertexCount, MeshletVertices,
+			Mesh->VertexCount ? (double)MeshletVertices / Mesh->VertexCount : 0.0, Mesh->MeshletCount, Mesh->BoundingSphere.Radius);
+		printf("    %-5s %12s %12s %9s %10s %14s %14s %10s %10s %9s\n", "bits", "step", "max error", "of step", "of radius", "bits/meshlet v", "bytes/vertex", "encode", "decode", "cracks");
+
+		for (uint32_t b = 0; b < BitCountCount; b++)
+		{
+			struct MeshletPositions Positions;
+
+			double Start = PlatformGetTime();
+			const bool bBuilt = BuildMeshletPositions(Mesh, BitCounts[b], &Positions);
+			const double EncodeTime = PlatformGetTime() - Start;
+
+			if (!bBuilt)
+			{
+				printf("    %-5u could not be built\n", BitCounts[b]);
+				Problems++;
+				continue;
+			}
+
+			Start = PlatformGetTime();
+			for (uint32_t m = 0, Vertex = 0; m < Mesh->MeshletCount; Vertex += Mesh->Meshlets[m].VertCount, m++)
+				DecodeMeshletPositions(&Positions, Mesh, m, &Decoded[(size_t)Vertex * 3]);
+			const double DecodeTime = PlatformGetTime() - Start;
+
+			memset(bSeen, 0, Mesh->VertexCount);
+
+			double MaxError = 0.0;
+			uint32_t Cracks = 0;
+			uint32_t OutOfTolerance = 0;
+
+			for (uint32_t m = 0, Vertex = 0; m < Mesh->MeshletCount; m++)
+			{
+				const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+
+				for (uint32_t k = 0; k < Meshlet->VertCount; k++, Vertex++)
+				{
+					const uint32_t Index = MeshletVertexIndex(Mesh, Meshlet->VertOffset + k);
+					const float* Position = MeshPosition(Mesh, Index);
+					const float* d = &Decoded[(size_t)Vertex * 3];
+
+					for (int Axis = 0; Axis < 3; Axis++)
+					{
+						const double Error = fabs((double)d[Axis] - Position[Axis]);
+						MaxError = fmax(MaxError, Error);
+
+						if (Error > PositionTolerance(Positions.Grid.Offset[Axis], Positions.Grid.Scale[Axis], (double)((1u << Positions.Bits) - 1)))
+							OutOfTolerance++;
+					}
+
+					if (!bSeen[Index])
+					{
+						bSeen[Index] = 1;
+						memcpy(&First[(size_t)Index * 3], d, sizeof(float) * 3);
+					}
+					else if (memcmp(&First[(size_t)Index * 3], d, sizeof(float) * 3) != 0)
+						Cracks++;
+				}
+			}
+
+			const double Bytes = sizeof(struct MeshletPositionHeader) * (double)Positions.HeaderCount + sizeof(uint32_t) * (double)Positions.DataCount;
+			const double DataBits = 32.0 * Positions.DataCount;
+
+			printf("    %-5u %12g %12g %9.3f %9.5f%% %14.2f %14.2f %7.2f ms %7.2f ms %9u\n", BitCounts[b], Positions.Grid.Scale[0], MaxError,
+				Positions.Grid.Scale[0] > 0.0f ? MaxError / Positions.Grid.Scale[0] : 0.0, Mesh->BoundingSphere.Radius > 0.0f ? 100.0 * MaxError / Mesh->BoundingSphere.Radius : 0.0,
+				MeshletVertices ? DataBits / MeshletVertices : 0.0, Mesh->VertexCount ? Bytes / Mesh->VertexCount : 0.0, EncodeTime * 1000.0, DecodeTime * 1000.0, Cracks);
+
+			Problems += Cracks + OutOfTolerance;
+			MeshletPositionsFree(&Positions);
+		}
+
+		free(Decoded);
+		free(First);
+		free(bSeen);
+	}
+
+	printf("  bytes/vertex counts headers and every meshlet's copy of shared vertices, against the mesh's own vertices\n");
+	printf("  %u problems\n", Problems);
+
+	MeshFileClose(&File);
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//threads per mesh shader group for a meshlet limit, like MESHLET_GROUP_SIZE in MeshletMS.hlsl: the larger limit
+//rounded up to a 32 lane wave, at most 128, with bigger meshlets looping over their outputs
+static uint32_t MeshletGroupSize(uint32_t MaxVertices, uint32_t MaxPrimitives)
+{
+	const uint32_t Largest = MaxVertices > MaxPrimitives ? MaxVertices : MaxPrimitives;
+	const uint32_t Size = (Largest + 31) / 32 * 32;
+
+	return Size < 128 ? Size : 128;
+}
+
+static int CommandLimits(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool limits <file.bin> [verts/prims]...\n");
+		return EXIT_FAILURE;
+	}
+
+	//the shader variants the renderer ships
+	static const uint32_t DefaultLimits[][2] = { { 64, 84 }, { 64, 126 }, { 128, 256 } };
+
+	uint32_t Limits[16][2];
+	uint32_t LimitCount = 0;
+
+	for (int i = 1; i < ArgCount && LimitCount < sizeof(Limits) / sizeof(Limits[0]); i++)
+	{
+		if (sscanf(Args[i], "%u/%u", &Limits[LimitCount][0], &Limits[LimitCount][1]) != 2)
+		{
+			fprintf(stderr, "%s: expected verts/prims\n", Args[i]);
+			return EXIT_FAILURE;
+		}
+
+		LimitCount++;
+	}
+
+	if (LimitCount == 0)
+	{
+		memcpy(Limits, DefaultLimits, sizeof(DefaultLimits));
+		LimitCount = sizeof(DefaultLimits) / sizeof(DefaultLimits[0]);
+	}
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	printf("%s: version %u, %u meshes\n", Args[0], File.Version, File.MeshCount);
+
+	uint32_t Problems = 0;
+
+	for (uint32_t i = 0; i < File.MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &File.MeshList[i];
+		const double Triangles = Mesh->IndexCount / 3.0;
+
+		printf("  mesh %u: %u triangles, %u vertices\n", i, Mesh->IndexCount / 3, Mesh->VertexCount);
+		printf("    %-9s %8s %7s %7s %10s %8s %9s %11s %10s %8s\n", "limits", "meshlets", "v fill", "p fill", "verts/tri", "threads", "lane use", "bytes/tri", "build", "errors");
+
+		for (uint32_t l = 0; l < LimitCount; l++)
+		{
+			const uint32_t MaxVertices = Limits[l][0];
+			const uint32_t MaxPrimitives = Limits[l][1];
+
+			struct MeshletData Built;
+
+			const double Start = PlatformGetTime();
+			const enum MeshletBuildResult BuildResult = BuildMeshlets(Mesh, MaxVertices, MaxPrimitives, 0, &Built);
+			const double BuildTime = PlatformGetTime() - Start;
+
+			if (BuildResult != MESHLET_BUILD_OK)
+			{
+				printf("    %4u/%-4u %s\n", MaxVertices, MaxPrimitives, MeshletBuildResultString(BuildResult));
+				Problems++;
+				continue;
+			}
+
+			struct Mesh Rebuilt = *Mesh;
+			MeshletDataApply(&Built, &Rebuilt);
+
+			const uint32_t Errors = ValidateMeshlets(&Rebuilt, MaxVertices, MaxPrimitives);
+			const uint32_t GroupSize = MeshletGroupSize(MaxVertices, MaxPrimitives);
+
+			//each output pass keeps a lane busy per vertex or primitive, over as many rounds of the group as the larger needs
+			uint64_t Verts = 0;
+			uint64_t Prims = 0;
+			uint64_t LaneSlots = 0;
+
+			for (uint32_t m = 0; m < Built.MeshletCount; m++)
+			{
+				const uint32_t Largest = Built.Meshlets[m].VertCount > Built.Meshlets[m].PrimCount ? Built.Meshlets[m].VertCount : Built.Meshlets[m].PrimCount;
+
+				Verts += Built.Meshlets[m].VertCount;
+				Prims += Built.Meshlets[m].PrimCount;
+				LaneSlots += (uint64_t)(Largest + GroupSize - 1) / GroupSize * GroupSize;
+			}
+
+			const double Count = Built.MeshletCount ? Built.MeshletCount : 1;
+			const double Bytes = sizeof(struct Meshlet) * (double)Built.MeshletCount + Built.UniqueVertexIndexCount +
+				sizeof(struct PackedTriangle) * (double)Built.PrimitiveIndexCount + sizeof(struct CullData) * (double)Built.CullingDataCount;
+
+			printf("    %4u/%-4u %8u %6.1f%% %6.1f%% %10.3f %8u %8.1f%% %11.2f %7.2f ms %8u\n", MaxVertices, MaxPrimitives, Built.MeshletCount,
+				100.0 * Verts / Count / MaxVertices, 100.0 * Prims / Count / MaxPrimitives, Prims ? (double)Verts / Prims : 0.0,
+				GroupSize, LaneSlots ? 100.0 * (Verts > Prims ? Verts : Prims) / LaneSlots : 0.0, Triangles > 0.0 ? Bytes / Triangles : 0.0,
+				BuildTime * 1000.0, Errors);
+
+			Problems += Errors;
+			MeshletDataFree(&Built);
+		}
+	}
+
+	printf("  lane use counts the larger of each meshlet's vertex and primitive counts against the threads its group runs\n");
+	printf("  %u problems\n", Problems);
+
+	MeshFileClose(&File);
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int CommandTriangles(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool triangles <file.bin> [iters]\n");
+		return EXIT_FAILURE;
+	}
+
+	const int Iterations = ArgCount >= 2 ? atoi(Args[1]) : 20;
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	//every mesh's primitive stream back to back, the way the scene buffer holds them
+	uint32_t TriangleCount = 0;
+	for (uint32_t i = 0; i < File.MeshCount; i++)
+		TriangleCount += File.MeshList[i].PrimitiveIndexCount;
+
+	struct PackedTriangle* Triangles = malloc(sizeof(struct PackedTriangle) * ((size_t)TriangleCount + 1));
+	struct PackedTriangle* Decoded = malloc(sizeof(struct PackedTriangle) * ((size_t)TriangleCount + 1));
+	uint8_t* Encoded = malloc(sizeof(struct PackedTriangle) * ((size_t)TriangleCount + 1));
+	uint32_t* Reference = malloc(sizeof(uint32_t) * 3 * ((size_t)TriangleCount + 1));
+	uint32_t* Unpacked = malloc(sizeof(uint32_t) * 3 * ((size_t)TriangleCount + 1));
+
+	if (Triangles == NULL || Decoded == NULL || Encoded == NULL || Reference == NULL || Unpacked == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Triangles);
+		free(Decoded);
+		free(Encoded);
+		free(Reference);
+		free(Unpacked);
+		MeshFileClose(&File);
+		return EXIT_FAILURE;
+	}
+
+	for (uint32_t i = 0, Next = 0; i < File.MeshCount; Next += File.MeshList[i].PrimitiveIndexCount, i++)
+		memcpy(&Triangles[Next], File.MeshList[i].PrimitiveIndices, sizeof(struct PackedTriangle) * File.MeshList[i].PrimitiveIndexCount);
+
+	UnpackTriangles(Triangles, TriangleCount, TRIANGLE_FORMAT_PACKED10, SIMD_LEVEL_SCALAR, Reference);
+
+	printf("%s: %u meshes, %u triangles, %d iterations\n", Args[0], File.MeshCount, TriangleCount, Iterations);
+	printf("  %-9s %9s %12s %10s %8s %10s %12s %10s %10s\n", "format", "bytes/tri", "bytes", "encode", "kernel", "unpack", "Mtris/s", "GB/s in", "mismatches");
+
+	uint32_t Problems = 0;
+
+	for (int Format = 0; Format < TRIANGLE_FORMAT_COUNT; Format++)
+	{
+		double Start = PlatformGetTime();
+		const bool bEncoded = EncodeTriangles(Triangles, TriangleCount, Format, Encoded);
+		const double EncodeTime = PlatformGetTime() - Start;
+
+		if (!bEncoded)
+		{
+			printf("  %-9s indices past 255, can't be encoded\n", TriangleFormatName(Format));
+			continue;
+		}
+
+		//the round trip back to PackedTriangle has to give every index back
+		DecodeTriangles(Encoded, TriangleCount, Format, Decoded);
+
+		uint32_t RoundTripErrors = 0;
+		for (uint32_t t = 0; t < TriangleCount; t++)
+		{
+			RoundTripErrors += Decoded[t].i0 != Triangles[t].i0 || Decoded[t].i1 != Triangles[t].i1 || Decoded[t].i2 != Triangles[t].i2;
+		}
+
+		const uint64_t Bytes = TriangleFormatSize(Format, TriangleCount);
+
+		for (int Kernel = 0; Kernel < SIMD_LEVEL_COUNT; Kernel++)
+		{
+			if (!PlatformSimdSupported(Kernel))
+				continue;
+
+			memset(Unpacked, 0xff, sizeof(uint32_t) * 3 * (size_t)TriangleCount);
+			UnpackTriangles(Encoded, TriangleCount, Format, Kernel, Unpacked);
+
+			uint32_t Mismatches = RoundTripErrors;
+			for (uint32_t i = 0; i < TriangleCount * 3; i++)
+				Mismatches += Unpacked[i] != Reference[i];
+
+			Start = PlatformGetTime();
+			for (int i = 0; i < Iterations; i++)
+				UnpackTriangles(Encoded, TriangleCount, Format, Kernel, Unpacked);
+			const double Elapsed = (PlatformGetTime() - Start) / (Iterations > 0 ? Iterations : 1);
+
+			printf("  %-9s %9.2f %12llu %7.3f ms %8s %7.3f ms %12.1f %10.2f %10u\n", TriangleFormatName(Format),
+				TriangleCount ? (double)Bytes / TriangleCount : 0.0, (unsigned long long)Bytes, EncodeTime * 1000.0, PlatformSimdName(Kernel),
+				Elapsed * 1000.0, Elapsed > 0.0 ? TriangleCount / Elapsed * 1e-6 : 0.0, Elapsed > 0.0 ? Bytes / Elapsed * 1e-9 : 0.0, Mismatches);
+
+			Problems += Mismatches;
+		}
+	}
+
+	printf("  every kernel and format is checked against the scalar packed10 unpack; %u problems\n", Problems);
+
+	free(Triangles);
+	free(Decoded);
+	free(Encoded);
+	free(Reference);
+	free(Unpacked);
+	MeshFileClose(&File);
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int CommandIndexless(int ArgCount, char** Args)
+{
+	if (ArgCount < 2)
+	{
+		fprintf(stderr, "usage: MeshTool indexless <in.bin> <out.bin>\n");
+		return EXIT_FAILURE;
+	}
+
+	struct MeshFile Source;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &Source);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t MeshCount = Source.MeshCount;
+	struct IndexlessMeshData* Data = calloc(MeshCount ? MeshCount : 1, sizeof(struct IndexlessMeshData));
+	struct Mesh* Meshes = calloc(MeshCount ? MeshCount : 1, sizeof(struct Mesh));
+
+	if (Data == NULL || Meshes == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Data);
+		free(Meshes);
+		MeshFileClose(&Source);
+		return EXIT_FAILURE;
+	}
+
+	// Bytes the mesh shader fetches per meshlet vertex: a unique vertex index and then the vertex, or just the vertex.
+	printf("%s: %u meshes\n", Args[0], MeshCount);
+	printf("  %-4s %10s %12s %11s %14s %14s %14s %10s %8s\n", "mesh", "vertices", "meshlet vtx", "duplicated", "vertex bytes", "index stream", "fetch/vertex", "build", "problems");
+
+	uint64_t Problems = 0;
+	int ExitCode = EXIT_SUCCESS;
+
+	for (uint32_t i = 0; i < MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &Source.MeshList[i];
+
+		const double Start = PlatformGetTime();
+		const bool bBuilt = BuildIndexlessMesh(Mesh, &Data[i]);
+		const double BuildTime = PlatformGetTime() - Start;
+
+		if (!bBuilt)
+		{
+			fprintf(stderr, "mesh %u: can't lay out indexless (out of memory, too many vertices or mismatched subsets)\n", i);
+			ExitCode = EXIT_FAILURE;
+			break;
+		}
+
+		Meshes[i] = *Mesh;
+		IndexlessMeshDataApply(&Data[i], &Meshes[i]);
+
+		uint32_t MaxVertices, MaxPrimitives;
+		MeshMeshletLimits(Mesh, &MaxVertices, &MaxPrimitives);
+
+		// The cull data is carried over untouched, so only problems the source didn't already have count against the conversion.
+		const uint64_t Mismatches = ValidateIndexlessMesh(Mesh, &Meshes[i]);
+		const uint32_t SourceProblems = ValidateMeshlets(Mesh, MaxVertices, MaxPrimitives) + (Mesh->ClusterLodCount ? ValidateDag(Mesh) : 0);
+		const uint32_t ConvertedProblems = ValidateMeshlets(&Meshes[i], MaxVertices, MaxPrimitives) + (Meshes[i].ClusterLodCount ? ValidateDag(&Meshes[i]) : 0);
+
+		const uint64_t MeshProblems = Mismatches + (ConvertedProblems > SourceProblems ? ConvertedProblems - SourceProblems : 0);
+		Problems += MeshProblems;
+
+		if (SourceProblems)
+			fprintf(stderr, "mesh %u: the source meshlets already have %u problems\n", i, SourceProblems);
+
+		if (Mismatches)
+			fprintf(stderr, "mesh %u: %llu triangles differ from the source\n", i, (unsigned long long)Mismatches);
+
+		uint32_t VertexStride = 0;
+		for (uint32_t j = 0; j < Mesh->VertexBufferCount; j++)
+			VertexStride += Mesh->VertexBuffers[j].Stride;
+
+		const uint32_t UniqueIndexSize = (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS) ? 0 : Mesh->IndexSize;
+
+		char VertexBytes[32];
+		char IndexStream[32];
+		char Fetch[32];
+		snprintf(VertexBytes, sizeof(VertexBytes), "%.1f->%.1f MB", (double)Mesh->VertexCount * VertexStride / (1024.0 * 1024.0), (double)Meshes[i].VertexCount * VertexStride / (1024.0 * 1024.0));
+		snprintf(IndexStream, sizeof(IndexStream), "%.1f->0 MB", (double)Mesh->UniqueVertexIndexCount / (1024.0 * 1024.0));
+		snprintf(Fetch, sizeof(Fetch), "%u->%u B", UniqueIndexSize + VertexStride, VertexStride);
+
+		printf("  %-4u %10u %12u %10.1f%% %14s %14s %14s %7.1f ms %8llu\n", i, Mesh->VertexCount, Meshes[i].VertexCount,
+			Mesh->VertexCount ? 100.0 * ((double)Meshes[i].VertexCount / Mesh->VertexCount - 1.0) : 0.0,
+			VertexBytes, IndexStream, Fetch, BuildTime * 1000.0, (unsigned long long)MeshProblems);
+	}
+
+	if (ExitCode == EXIT_SUCCESS)
+	{
+		Result = MeshFileSave(Args[1], Meshes, MeshCount, false);
+
+		struct MeshFile Converted;
+
+		if (Result == MESHFILE_OK && (Result = MeshFileOpen(Args[1], &Converted)) == MESHFILE_OK)
+		{
+			uint32_t Mismatches = Converted.Version < FILE_VERSION_MESHLETS || Converted.MeshCount != MeshCount;
+
+			for (uint32_t i = 0; i < MeshCount && Mismatches == 0; i++)
+				Mismatches += CompareMeshStreams(&Meshes[i], &Converted.MeshList[i], Converted.Buffer);
+
+			printf("  wrote %s: %zu bytes (source %zu), version %u, %u mismatches, %llu problems\n", Args[1], Converted.Size, Source.Size,
+				Converted.Version, Mismatches, (unsigned long long)Problems);
+
+			Problems += Mismatches;
+			MeshFileClose(&Converted);
+		}
+
+		if (Result != MESHFILE_OK)
+		{
+			fprintf(stderr, "%s: %s\n", Args[1], MeshFileResultString(Result));
+			ExitCode = EXIT_FAILURE;
+		}
+	}
+
+	for (uint32_t i = 0; i < MeshCount; i++)
+		IndexlessMeshDataFree(&Data[i]);
+
+	free(Data);
+	free(Meshes);
+	MeshFileClose(&Source);
+
+	return ExitCode == EXIT_SUCCESS && Problems == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void PrintFetchStats(const char* Label, const struct MeshletFetchStats* Stats, uint32_t LineSize)
+{
+	const double Meshlets = Stats->MeshletCount ? (double)Stats->MeshletCount : 1.0;
+
+	printf("    %-6s %11.2f %10u %12.2f %14.2f %14.2f %12.0f\n", Label,
+		Stats->VertexLines / Meshlets, Stats->MaxVertexLines, Stats->IndexLines / Meshlets,
+		Stats->VertexMisses / Meshlets, Stats->IndexMisses / Meshlets,
+		(double)(Stats->VertexMisses + Stats->IndexMisses) * LineSize / Meshlets);
+}
+
+static int CommandLocality(int ArgCount, char** Args)
+{
+	if (ArgCount < 2)
+	{
+		fprintf(stderr, "usage: MeshTool locality <in.bin> <out.bin> [line bytes] [cache kb] [ways]\n");
+		return EXIT_FAILURE;
+	}
+
+	struct FetchCacheDesc Cache;
+	Cache.LineSize = ArgCount >= 3 ? (uint32_t)atoi(Args[2]) : 128;
+	Cache.CacheSize = (ArgCount >= 4 ? (uint32_t)atoi(Args[3]) : 16) * 1024;
+	Cache.Ways = ArgCount >= 5 ? (uint32_t)atoi(Args[4]) : 4;
+
+	if (Cache.LineSize == 0 || (Cache.LineSize & (Cache.LineSize - 1)) != 0 || Cache.Ways == 0)
+	{
+		fprintf(stderr, "line bytes must be a power of two and ways at least 1\n");
+		return EXIT_FAILURE;
+	}
+
+	struct MeshFile Source;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &Source);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t MeshCount = Source.MeshCount;
+	struct MeshletLocalityData* Data = calloc(MeshCount ? MeshCount : 1, sizeof(struct MeshletLocalityData));
+	struct Mesh* Meshes = calloc(MeshCount ? MeshCount : 1, sizeof(struct Mesh));
+
+	if (Data == NULL || Meshes == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Data);
+		free(Meshes);
+		MeshFileClose(&Source);
+		return EXIT_FAILURE;
+	}
+
+	printf("%s: %u meshes, %u byte lines, %u KB %u-way lru cache, meshlets fetched in order\n", Args[0], MeshCount, Cache.LineSize, Cache.CacheSize / 1024, Cache.Ways);
+
+	uint64_t Problems = 0;
+	int ExitCode = EXIT_SUCCESS;
+
+	for (uint32_t i = 0; i < MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &Source.MeshList[i];
+
+		const double Start = PlatformGetTime();
+		const bool bOptimized = OptimizeMeshletLocality(Mesh, &Data[i]);
+		const double OptimizeTime = PlatformGetTime() - Start;
+
+		if (!bOptimized)
+		{
+			fprintf(stderr, "mesh %u: out of memory or meshlets out of range\n", i);
+			ExitCode = EXIT_FAILURE;
+			break;
+		}
+
+		Meshes[i] = *Mesh;
+		MeshletLocalityDataApply(&Data[i], &Meshes[i]);
+
+		struct MeshletFetchStats Before, After;
+		if (!SimulateMeshletFetch(Mesh, &Cache, &Before) || !SimulateMeshletFetch(&Meshes[i], &Cache, &After))
+		{
+			fprintf(stderr, "out of memory\n");
+			ExitCode = EXIT_FAILURE;
+			break;
+		}
+
+		uint32_t MaxVertices, MaxPrimitives;
+		MeshMeshletLimits(Mesh, &MaxVertices, &MaxPrimitives);
+
+		// The cone check samples eyes in meshlet order, so a source that already fails it is only compared against.
+		const uint64_t Mismatches = ValidateMeshletLocality(Mesh, &Meshes[i], &Data[i]);
+		const uint32_t SourceProblems = ValidateMeshlets(Mesh, MaxVertices, MaxPrimitives) + (Mesh->ClusterLodCount ? ValidateDag(Mesh) : 0);
+		const uint32_t OptimizedProblems = SourceProblems ? 0 : ValidateMeshlets(&Meshes[i], MaxVertices, MaxPrimitives) + (Meshes[i].ClusterLodCount ? ValidateDag(&Meshes[i]) : 0);
+
+		const uint64_t MeshProblems = Mismatches + OptimizedProblems;
+		Problems += MeshProblems;
+
+		if (SourceProblems)
+			fprintf(stderr, "mesh %u: the source meshlets already have %u problems\n", i, SourceProblems);
+
+		uint32_t Moved = 0;
+		for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+			Moved += Data[i].MeshletOrder[m] != m;
+
+		printf("  mesh %u: %u vertices, %u meshlets (%u moved%s), %.2f ms, %llu problems\n", i, Mesh->VertexCount, Mesh->MeshletCount, Moved,
+			Mesh->ClusterLodCount ? ", dag order kept" : "", OptimizeTime * 1000.0, (unsigned long long)MeshProblems);
+		printf("    %-6s %11s %10s %12s %14s %14s %12s\n", "", "vtx lines", "max", "index lines", "vtx misses", "index misses", "bytes/mlet");
+		PrintFetchStats("before", &Before, Cache.LineSize);
+		PrintFetchStats("after", &After, Cache.LineSize);
+	}
+
+	if (ExitCode == EXIT_SUCCESS)
+	{
+		Result = MeshFileSave(Args[1], Meshes, MeshCount, false);
+
+		struct MeshFile Converted;
+
+		if (Result == MESHFILE_OK && (Result = MeshFileOpen(Args[1], &Converted)) == MESHFILE_OK)
+		{
+			uint32_t Mismatches = Converted.MeshCount != MeshCount;
+
+			for (uint32_t i = 0; i < MeshCount && Mismatches == 0; i++)
+				Mismatches += CompareMeshStreams(&Meshes[i], &Converted.MeshList[i], Converted.Buffer);
+
+			printf("  wrote %s: %zu bytes, version %u, %u mismatches, %llu problems\n", Args[1], Converted.Size, Converted.Version, Mismatches, (unsigned long long)Problems);
+
+			Problems += Mismatches;
+			MeshFileClose(&Converted);
+		}
+
+		if (Result != MESHFILE_OK)
+		{
+			fprintf(stderr, "%s: %s\n", Args[1], MeshFileResultString(Result));
+			ExitCode = EXIT_FAILURE;
+		}
+	}
+
+	for (uint32_t i = 0; i < MeshCount; i++)
+		MeshletLocalityDataFree(&Data[i]);
+
+	free(Data);
+	free(Meshes);
+	MeshFileClose(&Source);
+
+	return ExitCode == EXIT_SUCCESS && Problems == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//normal cone half angles in 15 degree bins, then the meshlets without a usable cone
+#define STATS_CONE_BINS 7
+#define STATS_RADIUS_BINS 8
+
+struct MeshletRangeStats
+{
+	uint32_t MeshletCount;
+	uint64_t Triangles;
+	uint64_t Vertices;//meshlet vertices, shared ones counted in every meshlet
+	uint32_t ConeBins[STATS_CONE_BINS];
+	uint32_t RadiusBins[STATS_RADIUS_BINS];
+	float MinRadius;
+	float MaxRadius;
+	double RadiusSum;
+	uint64_t StreamBytes[sizeof(StreamNames) / sizeof(StreamNames[0])];
+};
+
+//meshlets [First, First + Count) of a mesh; the radius bins split [0, MaxRadius]
+static void GatherMeshletStats(const struct Mesh* Mesh, uint32_t First, uint32_t Count, float MaxRadius, struct MeshletRangeStats* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+	Out->MinRadius = Count ? FLT_MAX : 0.0f;
+
+	const uint32_t UniqueIndexSize = (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS) ? 0 : Mesh->IndexSize;
+
+	for (uint32_t m = First; m < First + Count; m++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+
+		Out->MeshletCount++;
+		Out->Triangles += Meshlet->PrimCount;
+		Out->Vertices += Meshlet->VertCount;
+
+		Out->StreamBytes[MESH_STREAM_MESHLETS] += sizeof(struct Meshlet);
+		Out->StreamBytes[MESH_STREAM_UNIQUE_VERTEX_INDICES] += (uint64_t)Meshlet->VertCount * UniqueIndexSize;
+		Out->StreamBytes[MESH_STREAM_PRIMITIVE_INDICES] += (uint64_t)Meshlet->PrimCount * sizeof(struct PackedTriangle);
+
+		if (m >= Mesh->CullingDataCount)
+		{
+			Out->ConeBins[STATS_CONE_BINS - 1]++;
+			continue;
+		}
+
+		const struct CullData* CullData = &Mesh->CullingData[m];
+		Out->StreamBytes[MESH_STREAM_CULL_DATA] += sizeof(struct CullData);
+
+		// The cone's w is sin of the half angle, rounded up to 1/255ths; 0xFF means there is no cone to cull with.
+		if (CullData->NormalCone[3] == 0xFF)
+		{
+			Out->ConeBins[STATS_CONE_BINS - 1]++;
+		}
+		else
+		{
+			const float Angle = asinf(CullData->NormalCone[3] * (1.0f / 255.0f)) * (180.0f / 3.14159265f);
+			const uint32_t Bin = (uint32_t)(Angle / 15.0f);
+			Out->ConeBins[Bin < STATS_CONE_BINS - 2 ? Bin : STATS_CONE_BINS - 2]++;
+		}
+
+		const float Radius = CullData->BoundingSphere[3];
+		const uint32_t Bin = MaxRadius > 0.0f ? (uint32_t)(Radius / MaxRadius * STATS_RADIUS_BINS) : 0;
+
+		Out->RadiusBins[Bin < STATS_RADIUS_BINS ? Bin : STATS_RADIUS_BINS - 1]++;
+		Out->MinRadius = fminf(Out->MinRadius, Radius);
+		Out->MaxRadius = fmaxf(Out->MaxRadius, Radius);
+		Out->RadiusSum += Radius;
+	}
+
+	if (Out->MinRadius == FLT_MAX)
+		Out->MinRadius = 0.0f;
+}
+
+static void PrintJsonKey(const char* Name)
+{
+	putchar('"');
+	for (const char* c = Name; *c; c++)
+		putchar(*c == ' ' ? '_' : *c);
+	putchar('"');
+}
+
+//the members of one stats object; bMore puts a comma after the last one
+static void PrintStatsJson(const struct MeshletRangeStats* Stats, uint32_t MaxVertices, uint32_t MaxPrimitives, const char* Indent, bool bMore)
+{
+	const double Meshlets = Stats->MeshletCount ? (double)Stats->MeshletCount : 1.0;
+	const double Triangles = Stats->Triangles ? (double)Stats->Triangles : 1.0;
+
+	printf("%s\"meshlets\": %u,\n", Indent, Stats->MeshletCount);
+	printf("%s\"triangles\": %llu,\n", Indent, (unsigned long long)Stats->Triangles);
+	printf("%s\"vertex_fill\": %.4f,\n", Indent, Stats->Vertices / Meshlets / MaxVertices);
+	printf("%s\"primitive_fill\": %.4f,\n", Indent, Stats->Triangles / Meshlets / MaxPrimitives);
+	printf("%s\"vertex_reuse\": %.4f,\n", Indent, Stats->Vertices ? 3.0 * Stats->Triangles / Stats->Vertices : 0.0);
+
+	printf("%s\"cone_angle_histogram\": [", Indent);
+	for (uint32_t b = 0; b < STATS_CONE_BINS; b++)
+		printf("%s%u", b ? ", " : "", Stats->ConeBins[b]);
+	printf("],\n");
+
+	printf("%s\"radius\": { \"min\": %g, \"mean\": %g, \"max\": %g },\n", Indent, Stats->MinRadius, Stats->RadiusSum / Meshlets, Stats->MaxRadius);
+
+	printf("%s\"radius_histogram\": [", Indent);
+	for (uint32_t b = 0; b < STATS_RADIUS_BINS; b++)
+		printf("%s%u", b ? ", " : "", Stats->RadiusBins[b]);
+	printf("],\n");
+
+	printf("%s\"bytes_per_triangle\": {", Indent);
+
+	uint64_t Total = 0;
+	for (uint32_t k = 0; k < sizeof(StreamNames) / sizeof(StreamNames[0]); k++)
+	{
+		if (Stats->StreamBytes[k] == 0)
+			continue;
+
+		putchar(' ');
+		PrintJsonKey(StreamNames[k]);
+		printf(": %.3f,", Stats->StreamBytes[k] / Triangles);
+		Total += Stats->StreamBytes[k];
+	}
+
+	printf(" \"total\": %.3f }%s\n", Total / Triangles, bMore ? "," : "");
+}
+
+static void PrintStatsCsv(const char* Path, uint32_t MeshIndex, int32_t SubsetIndex, const struct MeshletRangeStats* Stats, uint32_t MaxVertices, uint32_t MaxPrimitives)
+{
+	const double Meshlets = Stats->MeshletCount ? (double)Stats->MeshletCount : 1.0;
+	const double Triangles = Stats->Triangles ? (double)Stats->Triangles : 1.0;
+
+	printf("%s,%u,", Path, MeshIndex);
+
+	if (SubsetIndex < 0)
+		printf("all,");
+	else
+		printf("%d,", SubsetIndex);
+
+	printf("%u,%u,%u,%llu,%.4f,%.4f,%.4f", MaxVertices, MaxPrimitives, Stats->MeshletCount, (unsigned long long)Stats->Triangles,
+		Stats->Vertices / Meshlets / MaxVertices, Stats->Triangles / Meshlets / MaxPrimitives, Stats->Vertices ? 3.0 * Stats->Triangles / Stats->Vertices : 0.0);
+
+	for (uint32_t b = 0; b < STATS_CONE_BINS; b++)
+		printf(",%u", Stats->ConeBins[b]);
+
+	printf(",%g,%g,%g", Stats->MinRadius, Stats->RadiusSum / Meshlets, Stats->MaxRadius);
+
+	for (uint32_t b = 0; b < STATS_RADIUS_BINS; b++)
+		printf(",%u", Stats->RadiusBins[b]);
+
+	uint64_t Total = 0;
+	for (uint32_t k = 0; k < sizeof(StreamNames) / sizeof(StreamNames[0]); k++)
+	{
+		printf(",%.3f", Stats->StreamBytes[k] / Triangles);
+		Total += Stats->StreamBytes[k];
+	}
+
+	printf(",%.3f\n", Total / Triangles);
+}
+
+static int CommandStats(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool stats <file.bin> [json|csv]\n");
+		return EXIT_FAILURE;
+	}
+
+	const bool bCsv = ArgCount >= 2 && strcmp(Args[1], "csv") == 0;
+
+	if (ArgCount >= 2 && !bCsv && strcmp(Args[1], "json") != 0)
+	{
+		fprintf(stderr, "unknown format %s, expected json or csv\n", Args[1]);
+		return EXIT_FAILURE;
+	}
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	// Subset rows cover only the meshlets and index buffer range of that subset; vertices are shared, so only mesh rows have them.
+	if (bCsv)
+	{
+		printf("file,mesh,subset,max_vertices,max_primitives,meshlets,triangles,vertex_fill,primitive_fill,vertex_reuse");
+
+		for (uint32_t b = 0; b < STATS_CONE_BINS - 1; b++)
+			printf(",cone_%u_%u", b * 15, b * 15 + 15);
+
+		printf(",cone_none,radius_min,radius_mean,radius_max");
+
+		for (uint32_t b = 0; b < STATS_RADIUS_BINS; b++)
+			printf(",radius_bin_%u", b);
+
+		for (uint32_t k = 0; k < sizeof(StreamNames) / sizeof(StreamNames[0]); k++)
+		{
+			printf(",bpt_");
+			for (const char* c = StreamNames[k]; *c; c++)
+				putchar(*c == ' ' ? '_' : *c);
+		}
+
+		printf(",bpt_total\n");
+	}
+	else
+	{
+		printf("{\n  \"file\": \"");
+		for (const char* c = Args[0]; *c; c++)
+		{
+			if (*c == '"' || *c == '\\')
+				putchar('\\');
+			putchar(*c);
+		}
+		printf("\",\n  \"version\": %u,\n", File.Version);
+		printf("  \"cone_angle_bins\": \"15 degree half angle bins from 0 to 90, then meshlets without a cone\",\n");
+		printf("  \"meshes\": [\n");
+	}
+
+	for (uint32_t i = 0; i < File.MeshCount; i++)
+	{
+		const struct Mesh* Mesh = &File.MeshList[i];
+
+		uint32_t MaxVertices, MaxPrimitives;
+		MeshMeshletLimits(Mesh, &MaxVertices, &MaxPrimitives);
+
+		float MaxRadius = 0.0f;
+		for (uint32_t m = 0; m < Mesh->CullingDataCount && m < Mesh->MeshletCount; m++)
+			MaxRadius = fmaxf(MaxRadius, Mesh->CullingData[m].BoundingSphere[3]);
+
+		struct MeshletRangeStats Stats;
+		GatherMeshletStats(Mesh, 0, Mesh->MeshletCount, MaxRadius, &Stats);
+
+		// Whole mesh rows count every stream at its full size, per index buffer triangle.
+		memset(Stats.StreamBytes, 0, sizeof(Stats.StreamBytes));
+		for (uint32_t s = 0; s < MESH_STREAM_COUNT; s++)
+			Stats.StreamBytes[StreamKind(s)] += MeshStreamSize(Mesh, s);
+
+		const uint64_t MeshletTriangles = Stats.Triangles;
+		Stats.Triangles = Mesh->IndexCount / 3;
+
+		if (bCsv)
+		{
+			PrintStatsCsv(Args[0], i, -1, &Stats, MaxVertices, MaxPrimitives);
+		}
+		else
+		{
+			printf("    {\n      \"mesh\": %u,\n      \"vertices\": %u,\n      \"meshlet_triangles\": %llu,\n", i, Mesh->VertexCount, (unsigned long long)MeshletTriangles);
+			printf("      \"limits\": { \"vertices\": %u, \"primitives\": %u },\n", MaxVertices, MaxPrimitives);
+			printf("      \"layout\": \"%s\",\n", (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS) ? "indexless" : "indexed");
+			printf("      \"radius_bin_width\": %g,\n", MaxRadius / STATS_RADIUS_BINS);
+			PrintStatsJson(&Stats, MaxVertices, MaxPrimitives, "      ", true);
+			printf("      \"subsets\": [\n");
+		}
+
+		for (uint32_t s = 0; s < Mesh->MeshletSubsetCount; s++)
+		{
+			const struct Subset* Subset = &Mesh->MeshletSubsets[s];
+			GatherMeshletStats(Mesh, Subset->Offset, Subset->Count, MaxRadius, &Stats);
+
+			if (s < Mesh->IndexSubsetCount)
+				Stats.StreamBytes[MESH_STREAM_INDICES] = (uint64_t)Mesh->IndexSubsets[s].Count * Mesh->IndexSize;
+
+			if (bCsv)
+			{
+				PrintStatsCsv(Args[0], i, (int32_t)s, &Stats, MaxVertices, MaxPrimitives);
+			}
+			else
+			{
+				printf("        {\n          \"subset\": %u,\n", s);
+				PrintStatsJson(&Stats, MaxVertices, MaxPrimitives, "          ", false);
+				printf("        }%s\n", s + 1 < Mesh->MeshletSubsetCount ? "," : "");
+			}
+		}
+
+		if (!bCsv)
+			printf("      ]\n    }%s\n", i + 1 < File.MeshCount ? "," : "");
+	}
+
+	if (!bCsv)
+		printf("  ]\n}\n");
+
+	MeshFileClose(&File);
+	return EXIT_SUCCESS;
+}
+
+struct RingAllocation
+{
+	uint64_t Offset;
+	uint64_t Size;
+	uint64_t FenceValue;//0 until submitted
+	uint8_t Pattern;
+};
+
+struct RingSimulation
+{
+	struct StagingRing Ring;
+	uint8_t* Memory;
+	struct RingAllocation* Live;
+	uint32_t LiveCount;
+	uint64_t FenceValue;//last one submitted
+	uint64_t Completed;//last one the simulated gpu finished
+	uint32_t Problems;
+};
+
+static inline uint32_t NextRandom(uint32_t* Seed)
+{
+	*Seed = *Seed * 1664525u + 1013904223u;
+	return *Seed >> 8;
+}
+
+//false if the ring already has its most batches in flight
+static bool RingSubmit(struct RingSimulation* Sim)
+{
+	if (!StagingRingSubmit(&Sim->Ring, Sim->FenceValue + 1))
+		return false;
+
+	Sim->FenceValue++;
+
+	for (uint32_t a = 0; a < Sim->LiveCount; a++)
+	{
+		if (Sim->Live[a].FenceValue == 0)
+			Sim->Live[a].FenceValue = Sim->FenceValue;
+	}
+
+	return true;
+}
+
+//the gpu finishes everything up to Completed; what retires must still hold its pattern
+static void RingComplete(struct RingSimulation* Sim, uint64_t Completed)
+{
+	Sim->Completed = Completed > Sim->Completed ? Completed : Sim->Completed;
+	StagingRingRetire(&Sim->Ring, Sim->Completed);
+
+	for (uint32_t a = 0; a < Sim->LiveCount; a++)
+	{
+		const struct RingAllocation* Allocation = &Sim->Live[a];
+
+		if (Allocation->FenceValue == 0 || Allocation->FenceValue > Sim->Completed)
+			continue;
+
+		for (uint64_t b = 0; b < Allocation->Size; b++)
+		{
+			if (Sim->Memory[Allocation->Offset + b] != Allocation->Pattern)
+			{
+				if (Sim->Problems++ == 0)
+					fprintf(stderr, "  allocation of %llu bytes at %llu was overwritten while in flight\n", (unsigned long long)Allocation->Size, (unsigned long long)Allocation->Offset);
+				break;
+			}
+		}
+
+		Sim->Live[a--] = Sim->Live[--Sim->LiveCount];
+	}
+}
+
+static int CommandRing(int ArgCount, char** Args)
+{
+	const uint64_t Capacity = (uint64_t)(ArgCount >= 1 ? atoi(Args[0]) : 1024) * 1024;
+	const uint32_t Iterations = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : 200000;
+	const uint32_t MaxBatches = 8;
+	const uint32_t MaxLive = 1 << 20;
+
+	if (Capacity == 0)
+	{
+		fprintf(stderr, "the ring needs at least 1 KB\n");
+		return EXIT_FAILURE;
+	}
+
+	struct RingSimulation Sim = { 0 };
+	Sim.Memory = malloc(Capacity);
+	Sim.Live = malloc(sizeof(struct RingAllocation) * MaxLive);
+
+	if (Sim.Memory == NULL || Sim.Live == NULL || !StagingRingInit(&Sim.Ring, Capacity, MaxBatches))
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Sim.Memory);
+		free(Sim.Live);
+		return EXIT_FAILURE;
+	}
+
+	// Random sizes and alignments, a submit every few allocations and a gpu that finishes batches a few submits
+	// late. Each allocation is filled with its own byte and checked when it retires, so overlapping live
+	// allocations show up as a clobbered pattern.
+	uint32_t Seed = 7;
+	uint64_t Allocations = 0;
+	uint64_t Stalls = 0;
+	uint64_t Bytes = 0;
+
+	for (uint32_t i = 0; i < Iterations && Sim.Problems == 0; i++)
+	{
+		const uint64_t Alignment = 1ull << (NextRandom(&Seed) % 9);
+		const uint64_t Size = NextRandom(&Seed) % 8 == 0 ? NextRandom(&Seed) % (Capacity / 2 + 1) : NextRandom(&Seed) % 4096;
+
+		uint64_t Offset;
+		bool bAllocated = true;
+
+		while (!StagingRingAlloc(&Sim.Ring, Size, Alignment, &Offset))
+		{
+			// Out of room: close the open batch if there is one, else wait for the oldest in flight.
+			if (StagingRingPending(&Sim.Ring) != 0 && RingSubmit(&Sim))
+				continue;
+
+			if (Sim.Ring.BatchCount == 0)
+			{
+				// Nothing left to wait for, so only a request bigger than the ring may fail.
+				if (Size <= Capacity && Sim.Problems++ == 0)
+					fprintf(stderr, "  %llu bytes didn't fit an idle ring\n", (unsigned long long)Size);
+
+				bAllocated = false;
+				break;
+			}
+
+			RingComplete(&Sim, StagingRingOldestFence(&Sim.Ring));
+			Stalls++;
+		}
+
+		if (!bAllocated)
+			continue;
+
+		if (Offset % Alignment != 0 || Offset + Size > Capacity || Sim.LiveCount == MaxLive)
+		{
+			if (Sim.Problems++ == 0)
+				fprintf(stderr, "  %llu bytes at %llu with alignment %llu: out of bounds or misaligned\n", (unsigned long long)Size, (unsigned long long)Offset, (unsigned long long)Alignment);
+			break;
+		}
+
+		const uint8_t Pattern = (uint8_t)(i * 37 + 11);
+		memset(Sim.Memory + Offset, Pattern, Size);
+		Sim.Live[Sim.LiveCount++] = (struct RingAllocation){ Offset, Size, 0, Pattern };
+		Allocations++;
+		Bytes += Size;
+
+		if (NextRandom(&Seed) % 4 == 0)
+			RingSubmit(&Sim);
+
+		if (NextRandom(&Seed) % 3 == 0 && Sim.FenceValue > 2)
+			RingComplete(&Sim, Sim.FenceValue - NextRandom(&Seed) % 3);
+	}
+
+	RingSubmit(&Sim);
+	RingComplete(&Sim, Sim.FenceValue);
+
+	if (Sim.LiveCount != 0 && Sim.Problems++ == 0)
+		fprintf(stderr, "  %u allocations never retired\n", Sim.LiveCount);
+
+	printf("ring %llu KB, %u batches in flight at most\n", (unsigned long long)Capacity / 1024, MaxBatches);
+	printf("  %llu allocations, %.1f MB, %llu fences submitted, %llu stalls, %u problems\n", (unsigned long long)Allocations, Bytes / (1024.0 * 1024.0),
+		(unsigned long long)Sim.FenceValue, (unsigned long long)Stalls, Sim.Problems);
+
+	// Throughput: 256 byte aligned uploads of mixed size, a submit every 64 and the gpu a batch behind.
+	StagingRingFree(&Sim.Ring);
+
+	if (!StagingRingInit(&Sim.Ring, Capacity, MaxBatches))
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Sim.Memory);
+		free(Sim.Live);
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t BenchmarkCount = 10000000;
+	uint64_t FenceValue = 0;
+	uint64_t OffsetSum = 0;
+	Seed = 7;
+
+	const double Start = PlatformGetTime();
+
+	for (uint32_t i = 0; i < BenchmarkCount; i++)
+	{
+		const uint64_t Size = 64 + (NextRandom(&Seed) & 4095);
+		uint64_t Offset;
+
+		while (!StagingRingAlloc(&Sim.Ring, Size, 256, &Offset))
+		{
+			if (StagingRingPending(&Sim.Ring) != 0 && StagingRingSubmit(&Sim.Ring, FenceValue + 1))
+				FenceValue++;
+			else
+				StagingRingRetire(&Sim.Ring, StagingRingOldestFence(&Sim.Ring));
+		}
+
+		OffsetSum += Offset;
+
+		if ((i & 63) == 63 && StagingRingSubmit(&Sim.Ring, FenceValue + 1))
+		{
+			FenceValue++;
+			StagingRingRetire(&Sim.Ring, FenceValue - 1);
+		}
+	}
+
+	const double Elapsed = PlatformGetTime() - Start;
+	printf("  benchmark: %u allocations in %.2f ms, %.1f ns each (offset checksum %llu)\n", BenchmarkCount, Elapsed * 1000.0, Elapsed * 1e9 / BenchmarkCount, (unsigned long long)OffsetSum);
+
+	StagingRingFree(&Sim.Ring);
+	free(Sim.Memory);
+	free(Sim.Live);
+
+	return Sim.Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//a heap for HeapAllocator that is plain memory, so what lands in it can be checked
+struct MockHeaps
+{
+	uint8_t** Memory;
+	uint32_t Capacity;
+	uint32_t CreateCount;
+	uint32_t DestroyCount;
+};
+
+static bool MockCreateHeap(void* Context, uint32_t HeapIndex, uint64_t Size)
+{
+	struct MockHeaps* Heaps = Context;
+
+	if (HeapIndex >= Heaps->Capacity)
+	{
+		const uint32_t NewCapacity = HeapIndex * 2 + 1;
+		uint8_t** NewMemory = realloc(Heaps->Memory, sizeof(uint8_t*) * NewCapacity);
+
+		if (NewMemory == NULL)
+			return false;
+
+		memset(NewMemory + Heaps->Capacity, 0, sizeof(uint8_t*) * (NewCapacity - Heaps->Capacity));
+		Heaps->Memory = NewMemory;
+		Heaps->Capacity = NewCapacity;
+	}
+
+	Heaps->Memory[HeapIndex] = malloc(Size);
+	Heaps->CreateCount++;
+	return Heaps->Memory[HeapIndex] != NULL;
+}
+
+static void MockDestroyHeap(void* Context, uint32_t HeapIndex)
+{
+	struct MockHeaps* Heaps = Context;
+
+	free(Heaps->Memory[HeapIndex]);
+	Heaps->Memory[HeapIndex] = NULL;
+	Heaps->DestroyCount++;
+}
+
+struct HeapBuffer
+{
+	struct HeapAllocation Allocation;
+	uint64_t Size;//what was asked for
+	uint8_t Pattern;
+};
+
+struct HeapSimulation
+{
+	struct HeapAllocator Allocator;
+	struct MockHeaps Heaps;
+	struct HeapBuffer* Live;
+	uint32_t LiveCount;
+	uint32_t LiveCapacity;
+	uint32_t Problems;
+	uint32_t Seed;
+};
+
+//the buffers a mesh brings, smallest to largest: mesh info, cull data, meshlets, indices, vertices
+static const uint64_t HEAP_BUFFER_SIZES[][2] = { { 32, 256 }, { 256, 16384 }, { 1024, 65536 }, { 4096, 262144 }, { 4096, 1048576 } };
+#define HEAP_BUFFERS_PER_MESH ((uint32_t)(sizeof(HEAP_BUFFER_SIZES) / sizeof(HEAP_BUFFER_SIZES[0])))
+
+//log uniform between the bounds, so small buffers are as common as they are in real scenes
+static uint64_t RandomBufferSize(uint32_t* Seed, uint64_t Min, uint64_t Max)
+{
+	const double t = (NextRandom(Seed) & 0xFFFF) / 65535.0;
+	return (uint64_t)(Min * pow((double)Max / Min, t));
+}
+
+static bool HeapSimAlloc(struct HeapSimulation* Sim, uint64_t Size, uint64_t Alignment)
+{
+	if (Sim->LiveCount == Sim->LiveCapacity)
+	{
+		const uint32_t NewCapacity = Sim->LiveCapacity ? Sim->LiveCapacity * 2 : 1024;
+		struct HeapBuffer* NewLive = realloc(Sim->Live, sizeof(struct HeapBuffer) * NewCapacity);
+
+		if (NewLive == NULL)
+			return false;
+
+		Sim->Live = NewLive;
+		Sim->LiveCapacity = NewCapacity;
+	}
+
+	struct HeapBuffer* Buffer = &Sim->Live[Sim->LiveCount];
+
+	if (!HeapAllocatorAlloc(&Sim->Allocator, Size, Alignment, &Buffer->Allocation))
+		return false;
+
+	const struct HeapAllocation* Allocation = &Buffer->Allocation;
+
+	if (Allocation->Offset % Alignment != 0 || Allocation->Size < Size || Allocation->Offset + Allocation->Size > Sim->Allocator.Heaps[Allocation->Heap].Size)
+	{
+		if (Sim->Problems++ == 0)
+			fprintf(stderr, "  %llu bytes at %llu in heap %u: out of bounds or misaligned\n", (unsigned long long)Size, (unsigned long long)Allocation->Offset, Allocation->Heap);
+	}
+
+	Buffer->Size = Size;
+	Buffer->Pattern = (uint8_t)NextRandom(&Sim->Seed);
+	memset(Sim->Heaps.Memory[Allocation->Heap] + Allocation->Offset, Buffer->Pattern, Size);
+	Sim->LiveCount++;
+	return true;
+}
+
+static void HeapSimCheck(struct HeapSimulation* Sim, const struct HeapBuffer* Buffer)
+{
+	const uint8_t* Bytes = Sim->Heaps.Memory[Buffer->Allocation.Heap] + Buffer->Allocation.Offset;
+
+	for (uint64_t b = 0; b < Buffer->Size; b++)
+	{
+		if (Bytes[b] != Buffer->Pattern)
+		{
+			if (Sim->Problems++ == 0)
+				fprintf(stderr, "  %llu bytes at %llu in heap %u were overwritten\n", (unsigned long long)Buffer->Size, (unsigned long long)Buffer->Allocation.Offset, Buffer->Allocation.Heap);
+			return;
+		}
+	}
+}
+
+static void HeapSimRelease(struct HeapSimulation* Sim, uint32_t Index)
+{
+	HeapSimCheck(Sim, &Sim->Live[Index]);
+	HeapAllocatorRelease(&Sim->Allocator, Sim->Live[Index].Allocation.Handle);
+	Sim->Live[Index] = Sim->Live[--Sim->LiveCount];
+}
+
+static bool HeapSimAllocMesh(struct HeapSimulation* Sim)
+{
+	for (uint32_t k = 0; k < HEAP_BUFFERS_PER_MESH; k++)
+	{
+		if (!HeapSimAlloc(Sim, RandomBufferSize(&Sim->Seed, HEAP_BUFFER_SIZES[k][0], HEAP_BUFFER_SIZES[k][1]), 256))
+			return false;
+	}
+
+	return true;
+}
+
+static void HeapSimValidate(struct HeapSimulation* Sim, const char* Step)
+{
+	const uint32_t Problems = HeapAllocatorValidate(&Sim->Allocator);
+
+	if (Problems != 0 && Sim->Problems == 0)
+		fprintf(stderr, "  allocator state is inconsistent after %s (%u problems)\n", Step, Problems);
+
+	Sim->Problems += Problems;
+}
+
+static void PrintHeapStats(const struct HeapSimulation* Sim, const char* Step)
+{
+	struct HeapAllocatorStats Stats;
+	HeapAllocatorGetStats(&Sim->Allocator, &Stats);
+
+	//each buffer as its own committed resource takes whole 64 KB pages
+	uint64_t Committed = 0;
+
+	for (uint32_t i = 0; i < Sim->LiveCount; i++)
+		Committed += (Sim->Live[i].Size + 65535) / 65536 * 65536;
+
+	printf("  %-12s %6u buffers %3u heaps, %8.1f MB reserved %8.1f MB used %8.1f MB free in %5u blocks, largest %6.1f MB, fragmentation %.3f | committed %8.1f MB\n",
+		Step, Stats.AllocationCount, Stats.HeapCount, Stats.ReservedBytes / (1024.0 * 1024.0), Stats.UsedBytes / (1024.0 * 1024.0), Stats.FreeBytes / (1024.0 * 1024.0),
+		Stats.FreeBlockCount, Stats.LargestFreeBlock / (1024.0 * 1024.0), Stats.Fragmentation, Committed / (1024.0 * 1024.0));
+}
+
+static int CommandHeap(int ArgCount, char** Args)
+{
+	const uint64_t HeapSize = (uint64_t)(ArgCount >= 1 ? atoi(Args[0]) : 64) * 1024 * 1024;
+	const uint32_t MeshCount = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : 1000;
+
+	if (HeapSize == 0 || MeshCount == 0)
+	{
+		fprintf(stderr, "the heaps need at least 1 MB and one mesh\n");
+		return EXIT_FAILURE;
+	}
+
+	struct HeapSimulation Sim = { 0 };
+	Sim.Seed = 7;
+
+	struct HeapAllocatorDesc Desc = { 0 };
+	Desc.HeapSize = HeapSize;
+	Desc.Granularity = 256;
+	Desc.Context = &Sim.Heaps;
+	Desc.CreateHeap = MockCreateHeap;
+	Desc.DestroyHeap = MockDestroyHeap;
+
+	if (!HeapAllocatorInit(&Sim.Allocator, &Desc))
+	{
+		fprintf(stderr, "bad heap description\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("%llu MB heaps, %u meshes of %u buffers\n", (unsigned long long)HeapSize / (1024 * 1024), MeshCount, HEAP_BUFFERS_PER_MESH);
+
+	// A scene loads, then streams: a tenth of the buffers go and as many meshes come in, round after round
+	bool bOk = true;
+
+	for (uint32_t i = 0; i < MeshCount && bOk; i++)
+		bOk = HeapSimAllocMesh(&Sim);
+
+	HeapSimValidate(&Sim, "loading");
+	PrintHeapStats(&Sim, "loaded");
+
+	for (uint32_t Round = 0; Round < 20 && bOk; Round++)
+	{
+		const uint32_t Released = Sim.LiveCount / 10;
+
+		for (uint32_t i = 0; i < Released; i++)
+			HeapSimRelease(&Sim, NextRandom(&Sim.Seed) % Sim.LiveCount);
+
+		for (uint32_t i = 0; i < Released / HEAP_BUFFERS_PER_MESH && bOk; i++)
+			bOk = HeapSimAllocMesh(&Sim);
+
+		HeapSimValidate(&Sim, "streaming");
+	}
+
+	PrintHeapStats(&Sim, "streamed");
+
+	// Half the scene unloads, which leaves holes everywhere, then the defragmenter empties heaps into the others
+	for (uint32_t i = 0, Released = Sim.LiveCount / 2; i < Released; i++)
+		HeapSimRelease(&Sim, NextRandom(&Sim.Seed) % Sim.LiveCount);
+
+	HeapSimValidate(&Sim, "unloading");
+	PrintHeapStats(&Sim, "half freed");
+
+	struct HeapMove Moves[256];
+	uint64_t MovedBytes = 0;
+	uint32_t MoveTotal = 0;
+	uint32_t Trimmed = HeapAllocatorTrim(&Sim.Allocator);
+
+	for (uint32_t MoveCount; bOk && (MoveCount = HeapAllocatorDefragment(&Sim.Allocator, Moves, sizeof(Moves) / sizeof(Moves[0]))) != 0;)
+	{
+		for (uint32_t m = 0; m < MoveCount; m++)
+		{
+			uint32_t Index = 0;
+			while (Index < Sim.LiveCount && Sim.Live[Index].Allocation.Handle != Moves[m].From.Handle)
+				Index++;
+
+			if (Index == Sim.LiveCount)
+			{
+				if (Sim.Problems++ == 0)
+					fprintf(stderr, "  the defragmenter moved an allocation that isn't live\n");
+				bOk = false;
+				break;
+			}
+
+			struct HeapBuffer* Buffer = &Sim.Live[Index];
+			HeapSimCheck(&Sim, Buffer);
+
+			memcpy(Sim.Heaps.Memory[Moves[m].To.Heap] + Moves[m].To.Offset, Sim.Heaps.Memory[Moves[m].From.Heap] + Moves[m].From.Offset, Buffer->Size);
+			HeapAllocatorRelease(&Sim.Allocator, Moves[m].From.Handle);
+			Buffer->Allocation = Moves[m].To;
+
+			MovedBytes += Buffer->Size;
+			MoveTotal++;
+		}
+
+		Trimmed += HeapAllocatorTrim(&Sim.Allocator);
+		HeapSimValidate(&Sim, "defragmenting");
+	}
+
+	printf("  defragment moved %u buffers, %.1f MB, and gave back %u heaps\n", MoveTotal, MovedBytes / (1024.0 * 1024.0), Trimmed);
+	PrintHeapStats(&Sim, "compacted");
+
+	while (Sim.LiveCount != 0)
+		HeapSimRelease(&Sim, Sim.LiveCount - 1);
+
+	HeapSimValidate(&Sim, "unloading everything");
+
+	struct HeapAllocatorStats Stats;
+	HeapAllocatorGetStats(&Sim.Allocator, &Stats);
+
+	if ((Stats.AllocationCount != 0 || Stats.FreeBlockCount != Stats.HeapCount) && Sim.Problems++ == 0)
+		fprintf(stderr, "  free blocks didn't merge back into whole heaps\n");
+
+	// Throughput: small buffers coming and going against a few thousand live ones
+	const uint32_t BenchmarkCount = 1000000;
+	uint32_t Handles[4096];
+	uint64_t OffsetSum = 0;
+
+	for (uint32_t i = 0; i < sizeof(Handles) / sizeof(Handles[0]); i++)
+	{
+		struct HeapAllocation Allocation;
+		bOk = bOk && HeapAllocatorAlloc(&Sim.Allocator, RandomBufferSize(&Sim.Seed, 32, 65536), 256, &Allocation);
+		Handles[i] = bOk ? Allocation.Handle : HEAP_ALLOCATION_NONE;
+	}
+
+	const double Start = PlatformGetTime();
+
+	for (uint32_t i = 0; i < BenchmarkCount && bOk; i++)
+	{
+		const uint32_t Slot = NextRandom(&Sim.Seed) % sizeof(Handles) / sizeof(Handles[0]);
+		HeapAllocatorRelease(&Sim.Allocator, Handles[Slot]);
+
+		struct HeapAllocation Allocation;
+		bOk = HeapAllocatorAlloc(&Sim.Allocator, 32 + (NextRandom(&Sim.Seed) & 65535), 256, &Allocation);
+		Handles[Slot] = bOk ? Allocation.Handle : HEAP_ALLOCATION_NONE;
+		OffsetSum += Allocation.Offset;
+	}
+
+	const double Elapsed = PlatformGetTime() - Start;
+	HeapSimValidate(&Sim, "the benchmark");
+
+	printf("  benchmark: %u release and allocate pairs in %.2f ms, %.1f ns each (offset checksum %llu)\n", BenchmarkCount, Elapsed * 1000.0, Elapsed * 1e9 / BenchmarkCount, (unsigned long long)OffsetSum);
+
+	if (!bOk && Sim.Problems++ == 0)
+		fprintf(stderr, "  out of memory\n");
+
+	printf("  %u heaps created, %u destroyed, %u problems\n", Sim.Heaps.CreateCount, Sim.Heaps.DestroyCount, Sim.Problems);
+
+	HeapAllocatorFree(&Sim.Allocator);
+	free(Sim.Heaps.Memory);
+	free(Sim.Live);
+
+	return Sim.Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+struct SimulatedCopy
+{
+	uint64_t Offset;
+	uint64_t RingOffset;
+	uint64_t Size;
+	uint64_t FenceValue;//0 until submitted
+};
+
+struct SimulatedSubmit
+{
+	uint64_t FenceValue;
+	uint32_t Frame;
+};
+
+//a copy queue whose copies run when their submit completes, a fixed number of frames after it was made, so a ring
+//range reused too early shows up as wrong bytes at the destination
+struct SimulatedQueue
+{
+	const uint8_t* RingMemory;
+	uint8_t* Destination;
+
+	struct SimulatedCopy* Copies;
+	uint32_t CopyCount;
+	uint32_t CopyCapacity;
+	uint32_t FirstCopy;//first not run
+
+	struct SimulatedSubmit* Submits;
+	uint32_t SubmitCount;
+	uint32_t SubmitCapacity;
+	uint32_t FirstSubmit;//first not completed
+
+	uint64_t Completed;
+	uint32_t Frame;
+	uint32_t Latency;
+	uint64_t FrameBytes;//recorded since the frame began
+	bool bOutOfMemory;
+};
+
+static void SimulatedCopy(void* Context, uint32_t Heap, uint64_t Offset, uint64_t RingOffset, uint64_t Size)
+{
+	struct SimulatedQueue* Queue = Context;
+	(void)Heap;
+
+	if (Queue->CopyCount == Queue->CopyCapacity)
+	{
+		const uint32_t NewCapacity = Queue->CopyCapacity ? Queue->CopyCapacity * 2 : 256;
+		struct SimulatedCopy* NewCopies = realloc(Queue->Copies, sizeof(struct SimulatedCopy) * NewCapacity);
+
+		if (NewCopies == NULL)
+		{
+			Queue->bOutOfMemory = true;
+			return;
+		}
+
+		Queue->Copies = NewCopies;
+		Queue->CopyCapacity = NewCapacity;
+	}
+
+	Queue->Copies[Queue->CopyCount++] = (struct SimulatedCopy){ Offset, RingOffset, Size, 0 };
+	Queue->FrameBytes += Size;
+}
+
+static void SimulatedSubmit(void* Context, uint64_t FenceValue)
+{
+	struct SimulatedQueue* Queue = Context;
+
+	if (Queue->SubmitCount == Queue->SubmitCapacity)
+	{
+		const uint32_t NewCapacity = Queue->SubmitCapacity ? Queue->SubmitCapacity * 2 : 256;
+		struct SimulatedSubmit* NewSubmits = realloc(Queue->Submits, sizeof(struct SimulatedSubmit) * NewCapacity);
+
+		if (NewSubmits == NULL)
+		{
+			Queue->bOutOfMemory = true;
+			return;
+		}
+
+		Queue->Submits = NewSubmits;
+		Queue->SubmitCapacity = NewCapacity;
+	}
+
+	for (uint32_t c = Queue->FirstCopy; c < Queue->CopyCount; c++)
+	{
+		if (Queue->Copies[c].FenceValue == 0)
+			Queue->Copies[c].FenceValue = FenceValue;
+	}
+
+	Queue->Submits[Queue->SubmitCount++] = (struct SimulatedSubmit){ FenceValue, Queue->Frame };
+}
+
+static uint64_t SimulatedCompletedValue(void* Context)
+{
+	return ((struct SimulatedQueue*)Context)->Completed;
+}
+
+//runs every submitted copy up to FenceValue and completes it
+static void SimulatedComplete(struct SimulatedQueue* Queue, uint64_t FenceValue)
+{
+	while (Queue->FirstCopy < Queue->CopyCount && Queue->Copies[Queue->FirstCopy].FenceValue != 0 && Queue->Copies[Queue->FirstCopy].FenceValue <= FenceValue)
+	{
+		const struct SimulatedCopy* Copy = &Queue->Copies[Queue->FirstCopy++];
+		memcpy(Queue->Destination + Copy->Offset, Queue->RingMemory + Copy->RingOffset, Copy->Size);
+	}
+
+	while (Queue->FirstSubmit < Queue->SubmitCount && Queue->Submits[Queue->FirstSubmit].FenceValue <= FenceValue)
+		Queue->Completed = Queue->Submits[Queue->FirstSubmit++].FenceValue;
+}
+
+static void SimulatedWait(void* Context, uint64_t FenceValue)
+{
+	SimulatedComplete(Context, FenceValue);
+}
+
+//the gpu side of a frame: submits made Latency frames ago finish
+static void SimulatedFrame(struct SimulatedQueue* Queue)
+{
+	uint64_t FenceValue = Queue->Completed;
+
+	for (uint32_t s = Queue->FirstSubmit; s < Queue->SubmitCount && Queue->Submits[s].Frame + Queue->Latency <= Queue->Frame; s++)
+		FenceValue = Queue->Submits[s].FenceValue;
+
+	SimulatedComplete(Queue, FenceValue);
+	Queue->Frame++;
+	Queue->FrameBytes = 0;
+}
+
+struct UploadRun
+{
+	uint32_t ItemCount;
+	uint32_t FirstResidentFrame;
+	uint32_t LastResidentFrame;
+	uint64_t MaxFrameBytes;
+	double MaxUpdateTime;
+	double UpdateTime;
+	uint32_t Problems;
+};
+
+//uploads Scene bytes cut into items of mesh buffer sizes, one Update a frame, or all at once with Flush
+static bool RunUploads(const uint8_t* Scene, uint64_t SceneSize, uint8_t* RingMemory, uint64_t RingSize, uint64_t Budget, bool bFlush, struct UploadRun* Run)
+{
+	memset(Run, 0, sizeof(*Run));
+
+	struct SimulatedQueue Queue = { 0 };
+	Queue.RingMemory = RingMemory;
+	Queue.Destination = calloc(SceneSize, 1);
+	Queue.Latency = 2;
+
+	struct UploadQueue Callbacks = { 0 };
+	Callbacks.Context = &Queue;
+	Callbacks.Copy = SimulatedCopy;
+	Callbacks.Submit = SimulatedSubmit;
+	Callbacks.CompletedValue = SimulatedCompletedValue;
+	Callbacks.Wait = SimulatedWait;
+
+	struct UploadScheduler Scheduler;
+
+	if (Queue.Destination == NULL || !UploadSchedulerInit(&Scheduler, &Callbacks, RingMemory, RingSize, 8, 0))
+	{
+		free(Queue.Destination);
+		return false;
+	}
+
+	uint32_t Seed = 11;
+	bool bOk = true;
+
+	for (uint64_t Offset = 0; Offset < SceneSize && bOk;)
+	{
+		uint64_t Size = RandomBufferSize(&Seed, 256, 4 * 1024 * 1024);
+		Size = Size < SceneSize - Offset ? Size : SceneSize - Offset;
+
+		bOk = UploadSchedulerAdd(&Scheduler, Scene + Offset, Size, 0, Offset) != UINT32_MAX;
+		Offset += Size;
+	}
+
+	Run->ItemCount = Scheduler.ItemCount;
+	Run->FirstResidentFrame = UINT32_MAX;
+
+	uint32_t Checked = 0;
+
+	while (bOk && !UploadSchedulerDone(&Scheduler))
+	{
+		const double Start = PlatformGetTime();
+
+		if (bFlush)
+			UploadSchedulerFlush(&Scheduler);
+		else
+			UploadSchedulerUpdate(&Scheduler, Budget);
+
+		const double Elapsed = PlatformGetTime() - Start;
+		Run->UpdateTime += Elapsed;
+		Run->MaxUpdateTime = Elapsed > Run->MaxUpdateTime ? Elapsed : Run->MaxUpdateTime;
+		Run->MaxFrameBytes = Queue.FrameBytes > Run->MaxFrameBytes ? Queue.FrameBytes : Run->MaxFrameBytes;
+
+		// What just became resident must already be at its destination
+		for (; Checked < Scheduler.FirstPending; Checked++)
+		{
+			const struct UploadItem* Item = &Scheduler.Items[Checked];
+
+			if (Run->FirstResidentFrame == UINT32_MAX)
+				Run->FirstResidentFrame = Queue.Frame;
+
+			if (!UploadSchedulerIsResident(&Scheduler, Checked) || memcmp(Queue.Destination + Item->Offset, Item->Source, Item->Size) != 0)
+			{
+				if (Run->Problems++ == 0)
+					fprintf(stderr, "  item %u, %llu bytes at %llu, is resident but its bytes didn't arrive\n", Checked, (unsigned long long)Item->Size, (unsigned long long)Item->Offset);
+			}
+		}
+
+		Run->LastResidentFrame = Queue.Frame;
+		SimulatedFrame(&Queue);
+		bOk = !Queue.bOutOfMemory && Queue.Frame < 1000000;
+	}
+
+	UploadSchedulerFree(&Scheduler);
+	free(Queue.Copies);
+	free(Queue.Submits);
+	free(Queue.Destination);
+
+	return bOk;
+}
+
+static int CommandUpload(int ArgCount, char** Args)
+{
+	const uint64_t SceneSize = (uint64_t)(ArgCount >= 1 ? atoi(Args[0]) : 128) * 1024 * 1024;
+	const uint64_t Budget = (uint64_t)(ArgCount >= 2 ? atoi(Args[1]) : 8192) * 1024;
+	const uint64_t RingSize = (uint64_t)(ArgCount >= 3 ? atoi(Args[2]) : 32) * 1024 * 1024;
+
+	if (SceneSize < 16 * 1024 * 1024 || Budget == 0 || RingSize == 0)
+	{
+		fprintf(stderr, "the scene needs at least 16 MB, the budget 1 KB and the ring 1 MB\n");
+		return EXIT_FAILURE;
+	}
+
+	uint8_t* Scene = malloc(SceneSize);
+	uint8_t* RingMemory = malloc(RingSize);
+
+	if (Scene == NULL || RingMemory == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		free(Scene);
+		free(RingMemory);
+		return EXIT_FAILURE;
+	}
+
+	uint32_t Seed = 3;
+	for (uint64_t i = 0; i < SceneSize; i++)
+		Scene[i] = (uint8_t)NextRandom(&Seed);
+
+	printf("%llu KB a frame through a %llu MB ring, copies take 2 frames\n", (unsigned long long)Budget / 1024, (unsigned long long)RingSize / (1024 * 1024));
+
+	// The same scene at a sixteenth, a quarter and full size: the first frames should look the same for all three.
+	// Then the full scene again without a budget, the way a loading screen would
+	uint32_t Problems = 0;
+
+	for (uint32_t Pass = 0; Pass < 4; Pass++)
+	{
+		const bool bFlush = Pass == 3;
+		const uint64_t PassSize = Pass == 0 ? SceneSize / 16 : Pass == 1 ? SceneSize / 4 : SceneSize;
+
+		struct UploadRun Run;
+		if (!RunUploads(Scene, PassSize, RingMemory, RingSize, Budget, bFlush, &Run))
+		{
+			fprintf(stderr, "out of memory\n");
+			Problems++;
+			break;
+		}
+
+		printf("  %-6s %6.1f MB in %5u items: first resident at frame %u, all by frame %u, at most %.1f MB a frame, update %.3f ms mean %.3f ms max, %u problems\n",
+			bFlush ? "flush" : "frames", PassSize / (1024.0 * 1024.0), Run.ItemCount, Run.FirstResidentFrame, Run.LastResidentFrame,
+			Run.MaxFrameBytes / (1024.0 * 1024.0), Run.UpdateTime * 1000.0 / (Run.LastResidentFrame + 1), Run.MaxUpdateTime * 1000.0, Run.Problems);
+
+		Problems += Run.Problems;
+	}
+
+	free(Scene);
+	free(RingMemory);
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//a gpu that runs frames one after another, each taking its own time, against a cpu clock that only moves as frames
+//are recorded or waited for. times are in milliseconds
+struct SimulatedGpu
+{
+	double* CompleteTimes;//by fence value
+	uint64_t Signalled;
+	uint64_t Completed;//as of Now
+	double Now;
+	double BusyUntil;
+	double FrameTime;//gpu time of the frame being recorded
+};
+
+static void SimulatedSignal(void* Context, uint64_t Value)
+{
+	struct SimulatedGpu* Gpu = Context;
+
+	const double Start = Gpu->BusyUntil > Gpu->Now ? Gpu->BusyUntil : Gpu->Now;
+	Gpu->BusyUntil = Start + Gpu->FrameTime;
+	Gpu->CompleteTimes[Value] = Gpu->BusyUntil;
+	Gpu->Signalled = Value;
+}
+
+static uint64_t SimulatedFenceValue(void* Context)
+{
+	struct SimulatedGpu* Gpu = Context;
+
+	while (Gpu->Completed < Gpu->Signalled && Gpu->CompleteTimes[Gpu->Completed + 1] <= Gpu->Now)
+		Gpu->Completed++;
+
+	return Gpu->Completed;
+}
+
+static void SimulatedFenceWait(void* Context, uint64_t Value)
+{
+	struct SimulatedGpu* Gpu = Context;
+
+	if (Gpu->CompleteTimes[Value] > Gpu->Now)
+		Gpu->Now = Gpu->CompleteTimes[Value];
+}
+
+struct PacingRun
+{
+	double FrameTime;//mean cpu time from one frame's start to the next
+	uint64_t WaitCount;
+	uint32_t MostInFlight;
+	uint32_t Problems;
+};
+
+//CpuTime and GpuTime are means; each frame takes between half and one and a half times as long
+static bool RunPacing(uint32_t SlotCount, uint32_t MaxFramesInFlight, uint32_t FrameCount, double CpuTime, double GpuTime, struct PacingRun* Run)
+{
+	memset(Run, 0, sizeof(*Run));
+
+	struct SimulatedGpu Gpu = { 0 };
+	Gpu.CompleteTimes = calloc((size_t)FrameCount + 1, sizeof(double));
+
+	if (Gpu.CompleteTimes == NULL)
+		return false;
+
+	struct FrameFence Fence = { 0 };
+	Fence.Context = &Gpu;
+	Fence.Signal = SimulatedSignal;
+	Fence.CompletedValue = SimulatedFenceValue;
+	Fence.Wait = SimulatedFenceWait;
+
+	struct FramePacer Pacer;
+	if (!FramePacerInit(&Pacer, &Fence, SlotCount, MaxFramesInFlight))
+	{
+		free(Gpu.CompleteTimes);
+		return false;
+	}
+
+	uint32_t Seed = 11;
+
+	for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+	{
+		// A flip model swap chain hands out its buffers in turn
+		const uint32_t Slot = Frame % SlotCount;
+		const uint64_t SlotValue = Pacer.SlotFenceValues[Slot];
+
+		const uint64_t Value = FramePacerBeginFrame(&Pacer, Slot);
+		const uint64_t Completed = SimulatedFenceValue(&Gpu);
+
+		// The slot's last frame must be done, and this one must fit in the frames allowed in flight
+		if (Value != Gpu.Signalled + 1 || Completed < SlotValue || Value - Completed > Pacer.MaxFramesInFlight)
+		{
+			if (Run->Problems++ < 5)
+				fprintf(stderr, "frame %u: slot %u last used by %llu, %llu of %llu completed\n", Frame, Slot, (unsigned long long)SlotValue, (unsigned long long)Completed, (unsigned long long)Value);
+		}
+
+		if (Value - Completed > Run->MostInFlight)
+			Run->MostInFlight = (uint32_t)(Value - Completed);
+
+		Gpu.Now += CpuTime * (0.5 + (NextRandom(&Seed) & 0xffff) / 65536.0);
+		Gpu.FrameTime = GpuTime * (0.5 + (NextRandom(&Seed) & 0xffff) / 65536.0);
+
+		FramePacerEndFrame(&Pacer);
+	}
+
+	FramePacerFlush(&Pacer);
+
+	if (SimulatedFenceValue(&Gpu) != Gpu.Signalled || FramePacerFramesInFlight(&Pacer) != 0)
+		Run->Problems++;
+
+	Run->FrameTime = Gpu.Now / FrameCount;
+	Run->WaitCount = Pacer.WaitCount;
+
+	free(Gpu.CompleteTimes);
+	return true;
+}
+
+static int CommandFrames(int ArgCount, char** Args)
+{
+	const uint32_t SlotCount = ArgCount >= 1 ? (uint32_t)atoi(Args[0]) : 3;
+	const uint32_t FrameCount = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : 10000;
+
+	if (SlotCount == 0 || SlotCount > FRAME_PACER_MAX_SLOTS || FrameCount == 0)
+	{
+		fprintf(stderr, "1 to %u buffers and at least one frame\n", FRAME_PACER_MAX_SLOTS);
+		return EXIT_FAILURE;
+	}
+
+	static const struct
+	{
+		const char* Name;
+		double CpuTime;
+		double GpuTime;
+	} Loads[] = { { "cpu bound", 8.0, 4.0 }, { "balanced", 6.0, 6.0 }, { "gpu bound", 4.0, 8.0 } };
+
+	printf("%u buffers, %u frames; 1 in flight is a full stall every frame\n", SlotCount, FrameCount);
+
+	uint32_t Problems = 0;
+
+	for (uint32_t l = 0; l < sizeof(Loads) / sizeof(Loads[0]); l++)
+	{
+		printf("  %-9s cpu %.1f ms gpu %.1f ms\n", Loads[l].Name, Loads[l].CpuTime, Loads[l].GpuTime);
+
+		for (uint32_t InFlight = 1; InFlight <= SlotCount; InFlight++)
+		{
+			struct PacingRun Run;
+			if (!RunPacing(SlotCount, InFlight, FrameCount, Loads[l].CpuTime, Loads[l].GpuTime, &Run))
+			{
+				fprintf(stderr, "out of memory\n");
+				return EXIT_FAILURE;
+			}
+
+			printf("    %u in flight: %6.2f ms a frame, %5.1f%% of frames waited, at most %u in flight, %u problems\n",
+				InFlight, Run.FrameTime, 100.0 * Run.WaitCount / FrameCount, Run.MostInFlight, Run.Problems);
+
+			Problems += Run.Problems;
+		}
+	}
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//a 60 hz frame that now and then stutters to three to five times as long, split across the phases the renderer times
+static void SyntheticFrame(uint32_t* Seed, uint64_t Frame, double* Time, struct FrameSample* Out)
+{
+	float Milliseconds = 16.667f * (0.9f + 0.2f * (NextRandom(Seed) & 0xffff) / 65536.0f);
+
+	if (NextRandom(Seed) % 100 == 0)
+		Milliseconds *= 3.0f + 2.0f * (NextRandom(Seed) & 0xffff) / 65536.0f;
+
+	Out->Frame = Frame;
+	Out->Time = *Time;
+	Out->Milliseconds[FRAME_PHASE_FRAME] = Milliseconds;
+	Out->Milliseconds[FRAME_PHASE_WAIT] = Milliseconds * 0.55f;
+	Out->Milliseconds[FRAME_PHASE_UPDATE] = Milliseconds * 0.05f;
+	Out->Milliseconds[FRAME_PHASE_RECORD] = Milliseconds * 0.3f;
+	Out->Milliseconds[FRAME_PHASE_SUBMIT] = Milliseconds * 0.02f;
+	Out->Milliseconds[FRAME_PHASE_PRESENT] = Milliseconds * 0.08f;
+	Out->Milliseconds[FRAME_PHASE_GPU] = Frame % 7 == 0 ? -1.0f : Milliseconds * 0.7f;
+
+	*Time += Milliseconds / 1000.0;
+}
+
+struct TelemetryRun
+{
+	struct FrameTelemetry Telemetry;
+	uint32_t FrameCount;
+	FILE* Out;
+	enum TelemetryFormat Format;
+	volatile uint32_t bProducerDone;
+	uint64_t Drained;
+};
+
+//task 0 renders, task 1 writes, at the same time
+static void TelemetryTask(void* Context, uint32_t TaskIndex)
+{
+	struct TelemetryRun* Run = Context;
+
+	if (TaskIndex == 0)
+	{
+		uint32_t Seed = 5;
+		double Time = 0.0;
+
+		for (uint32_t i = 0; i < Run->FrameCount; i++)
+		{
+			struct FrameSample Sample;
+			SyntheticFrame(&Seed, i, &Time, &Sample);
+			FrameTelemetryPush(&Run->Telemetry, &Sample);
+		}
+
+		PlatformAtomicStoreRelease(&Run->bProducerDone, 1);
+		return;
+	}
+
+	while (!PlatformAtomicLoadAcquire(&Run->bProducerDone))
+		Run->Drained += FrameTelemetryDrain(&Run->Telemetry, Run->Out, Run->Format);
+
+	Run->Drained += FrameTelemetryDrain(&Run->Telemetry, Run->Out, Run->Format);
+}
+
+static int CompareFloats(const void* A, const void* B)
+{
+	const float a = *(const float*)A;
+	const float b = *(const float*)B;
+	return (a > b) - (a < b);
+}
+
+//pushes FrameCount synthetic frames through a ring of Capacity samples while another thread writes them to Out, then
+//reads Out back and checks the percentiles against sorted frame times. returns the problems found, UINT32_MAX if
+//memory runs out
+static uint32_t RunTelemetry(uint32_t FrameCount, uint32_t Capacity, FILE* Out, enum TelemetryFormat Format, bool bSummary)
+{
+	struct TelemetryRun Run = { 0 };
+	Run.FrameCount = FrameCount;
+	Run.Format = Format;
+	Run.Out = Out;
+
+	float* Frames = malloc(sizeof(float) * FrameCount);
+
+	if (Frames == NULL || !FrameTelemetryInit(&Run.Telemetry, Capacity))
+	{
+		free(Frames);
+		return UINT32_MAX;
+	}
+
+	FrameTelemetryWriteHeader(Out, Format);
+
+	const double Start = PlatformGetTime();
+	PlatformParallelFor(2, 2, TelemetryTask, &Run);
+	const double Elapsed = PlatformGetTime() - Start;
+
+	uint32_t Problems = 0;
+
+	if (Run.Drained + Run.Telemetry.Dropped != FrameCount)
+	{
+		fprintf(stderr, "%llu samples written and %llu dropped out of %u\n", (unsigned long long)Run.Drained, (unsigned long long)Run.Telemetry.Dropped, FrameCount);
+		Problems++;
+	}
+
+	// Read the export back: frames in order, none twice, each with the values it was pushed with
+	{
+		uint32_t Seed = 5;
+		double Time = 0.0;
+
+		for (uint32_t i = 0; i < FrameCount; i++)
+		{
+			struct FrameSample Sample;
+			SyntheticFrame(&Seed, i, &Time, &Sample);
+			Frames[i] = Sample.Milliseconds[FRAME_PHASE_FRAME];
+		}
+	}
+
+	rewind(Out);
+
+	char Line[1024];
+	uint64_t Rows = 0;
+	int64_t LastFrame = -1;
+
+	if (Format == TELEMETRY_FORMAT_CSV && fgets(Line, sizeof(Line), Out) == NULL)
+		Problems++;
+
+	while (fgets(Line, sizeof(Line), Out) != NULL)
+	{
+		unsigned long long Frame;
+		double Time;
+		float Milliseconds;
+
+		const int Read = Format == TELEMETRY_FORMAT_CSV ? sscanf(Line, "%llu,%lf,%f", &Frame, &Time, &Milliseconds) : sscanf(Line, "{\"frame\":%llu,\"time\":%lf,\"frame_ms\":%f", &Frame, &Time, &Milliseconds);
+
+		if (Read != 3 || (int64_t)Frame <= LastFrame || Frame >= FrameCount || fabsf(Milliseconds - Frames[Frame]) > 0.0001f)
+		{
+			if (Problems++ < 5)
+				fprintf(stderr, "bad row after frame %lld: %s", (long long)LastFrame, Line);
+			continue;
+		}
+
+		LastFrame = (int64_t)Frame;
+		Rows++;
+	}
+
+	if (Rows != Run.Drained)
+	{
+		fprintf(stderr, "%llu rows for %llu samples written\n", (unsigned long long)Rows, (unsigned long long)Run.Drained);
+		Problems++;
+	}
+
+	fprintf(stderr, "%u frames in %.3f ms through a %u sample ring: %llu written, %llu dropped\n", FrameCount, Elapsed * 1000.0,
+		Run.Telemetry.Capacity, (unsigned long long)Run.Drained, (unsigned long long)Run.Telemetry.Dropped);
+
+	// Percentiles from the histogram are the top of a bin, never below the exact ones and at most a bin above
+	qsort(Frames, FrameCount, sizeof(float), CompareFloats);
+
+	static const double Percentiles[] = { 50.0, 95.0, 99.0, 99.9, 100.0 };
+
+	for (uint32_t i = 0; i < sizeof(Percentiles) / sizeof(Percentiles[0]); i++)
+	{
+		uint64_t Rank = (uint64_t)ceil(Percentiles[i] / 100.0 * FrameCount);
+		if (Rank < 1)
+			Rank = 1;
+
+		const float Exact = Frames[Rank - 1];
+		const float Binned = FrameHistogramPercentile(&Run.Telemetry.Totals[FRAME_PHASE_FRAME], Percentiles[i]);
+		const bool bOk = Binned >= Exact && Binned <= Exact * 1.022f;
+
+		fprintf(stderr, "  p%-5g %8.3f ms, exact %8.3f ms%s\n", Percentiles[i], Binned, Exact, bOk ? "" : "  WRONG");
+		Problems += !bOk;
+	}
+
+	if (bSummary)
+		FrameTelemetryWriteSummary(&Run.Telemetry, stdout, Format);
+
+	free(Frames);
+	FrameTelemetryFree(&Run.Telemetry);
+
+	return Problems;
+}
+
+static int CommandTelemetry(int ArgCount, char** Args)
+{
+	const uint32_t FrameCount = ArgCount >= 1 ? (uint32_t)atoi(Args[0]) : 100000;
+	const enum TelemetryFormat Format = ArgCount >= 2 && strcmp(Args[1], "json") == 0 ? TELEMETRY_FORMAT_JSON : TELEMETRY_FORMAT_CSV;
+	const char* OutPath = ArgCount >= 3 ? Args[2] : NULL;
+
+	if (FrameCount == 0)
+	{
+		fprintf(stderr, "at least one frame\n");
+		return EXIT_FAILURE;
+	}
+
+	// First with a ring that holds every frame, so the export has to be complete, then with a small one whose writer
+	// falls behind and drops samples rather than stalling frames. Checks and timings go to stderr, the summary of
+	// the first run to stdout
+	uint32_t Problems = 0;
+
+	for (uint32_t Pass = 0; Pass < 2 && Problems != UINT32_MAX; Pass++)
+	{
+		FILE* Out = Pass == 0 && OutPath != NULL ? fopen(OutPath, "w+") : tmpfile();
+
+		if (Out == NULL)
+		{
+			fprintf(stderr, "can't open %s\n", Pass == 0 && OutPath != NULL ? OutPath : "a temporary file");
+			return EXIT_FAILURE;
+		}
+
+		const uint32_t Result = RunTelemetry(FrameCount, Pass == 0 ? FrameCount : 1024, Out, Format, Pass == 0);
+		fclose(Out);
+
+		if (Result == UINT32_MAX)
+		{
+			fprintf(stderr, "out of memory\n");
+			return EXIT_FAILURE;
+		}
+
+		Problems += Result;
+	}
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//fnv-1a, to tell whether two runs produced the same draws
+static uint64_t HashBytes(uint64_t Hash, const void* Data, size_t Size)
+{
+	const uint8_t* Bytes = Data;
+
+	for (size_t i = 0; i < Size; i++)
+		Hash = (Hash ^ Bytes[i]) * 1099511628211ULL;
+
+	return Hash;
+}
+
+#define BENCH_TIME_STEP (1.0f / 60.0f)
+#define BENCH_VIEWPORT_WIDTH 1920.0f
+#define BENCH_VIEWPORT_HEIGHT 1080.0f
+#define BENCH_FOV_Y (3.14159265f / 3.0f)
+#define BENCH_PIXEL_ERROR 1.0f
+
+struct BenchRun
+{
+	const struct MeshScene* Scene;
+	const struct CameraPath* Path;
+	uint32_t FrameCount;
+	enum SimdLevel Kernel;
+	bool bCullMeshlets;//false is the renderer with bAmplificationCulling: the gpu culls meshlets, the cpu still culls instances
+	const struct SceneInstances* Instances;//NULL draws every chain once
+
+	uint32_t* Visible;
+	uint32_t* VisibleInstances;
+	void* Scratch;
+	struct FrameDraw* Draws;
+
+	//per frame, FrameCount of each
+	double* Meshlets;
+	double* Triangles;
+	double* DrawCounts;
+
+	struct FrameHistogram Update;//camera, frustum and lod view
+	struct FrameHistogram Record;//lod selection, dag cuts, culling and the draw list
+	struct FrameHistogram Frame;
+	uint64_t Checksum;
+	uint64_t InstanceChecksum;//the visible instances alone, in draw order
+};
+
+//flies the path the way the renderer's WM_PAINT would, without a window or a gpu: every frame steps the camera at
+//the fixed timestep, builds the frustum and lod view, and lists the frame's draws
+static void RunBench(struct BenchRun* Run)
+{
+	memset(&Run->Update, 0, sizeof(Run->Update));
+	memset(&Run->Record, 0, sizeof(Run->Record));
+	memset(&Run->Frame, 0, sizeof(Run->Frame));
+	Run->Checksum = 14695981039346656037ULL;
+	Run->InstanceChecksum = 14695981039346656037ULL;
+
+	struct CameraState Camera = Run->Path->Start;
+
+	for (uint32_t f = 0; f < Run->FrameCount; f++)
+	{
+		const double Start = PlatformGetTime();
+
+		CameraPathAdvance(Run->Path, f, BENCH_TIME_STEP, &Camera);
+
+		float ViewProj[16];
+		CameraViewProjection(&Camera, BENCH_FOV_Y, BENCH_VIEWPORT_WIDTH / BENCH_VIEWPORT_HEIGHT, 1.0f, 1000.0f, ViewProj);
+
+		struct CullFrustum Frustum;
+		CullFrustumFromMatrix(ViewProj, Camera.Position, &Frustum);
+
+		struct LodView View;
+		LodViewInit(Camera.Position, BENCH_FOV_Y, BENCH_VIEWPORT_HEIGHT, BENCH_PIXEL_ERROR, &View);
+
+		const double Updated = PlatformGetTime();
+
+		struct FrameDrawDesc Desc = { 0 };
+		Desc.Scene = Run->Scene;
+		Desc.View = &View;
+		Desc.Frustum = &Frustum;
+		Desc.bCullMeshlets = Run->bCullMeshlets;
+		Desc.bCullInstances = true;
+		Desc.Kernel = Run->Kernel;
+		Desc.Instances = Run->Instances;
+		Desc.Scratch = Run->Scratch;
+
+		struct FrameDrawStats Stats;
+		const uint32_t DrawCount = BuildFrameDraws(&Desc, Run->Visible, Run->VisibleInstances, Run->Draws, &Stats);
+
+		const double End = PlatformGetTime();
+
+		FrameHistogramAdd(&Run->Update, (float)((Updated - Start) * 1000.0));
+		FrameHistogramAdd(&Run->Record, (float)((End - Updated) * 1000.0));
+		FrameHistogramAdd(&Run->Frame, (float)((End - Start) * 1000.0));
+
+		Run->Meshlets[f] = Stats.MeshletsDispatched;
+		Run->Triangles[f] = (double)Stats.TrianglesSubmitted;
+		Run->DrawCounts[f] = DrawCount;
+
+		//the draws and the meshlets and instances each one reads, which is everything the command list is recorded from
+		for (uint32_t d = 0; d < DrawCount; d++)
+		{
+			Run->Checksum = HashBytes(Run->Checksum, &Run->Draws[d], sizeof(Run->Draws[d]));
+			Run->Checksum = HashBytes(Run->Checksum, Run->Visible + Run->Draws[d].VisibleOffset, sizeof(uint32_t) * Run->Draws[d].VisibleCount);
+
+			if (Run->Instances != NULL)
+				Run->Checksum = HashBytes(Run->Checksum, Run->VisibleInstances + Run->Draws[d].InstanceOffset, sizeof(uint32_t) * Run->Draws[d].InstanceCount);
+		}
+
+		if (Run->Instances != NULL)
+			Run->InstanceChecksum = HashBytes(Run->InstanceChecksum, Run->VisibleInstances, sizeof(uint32_t) * Stats.InstancesVisible);
+	}
+}
+
+static void BenchRunFree(struct BenchRun* Run)
+{
+	free(Run->Visible);
+	free(Run->VisibleInstances);
+	free(Run->Scratch);
+	free(Run->Draws);
+	free(Run->Meshlets);
+	free(Run->Triangles);
+	free(Run->DrawCounts);
+}
+
+static int CompareDoubles(const void* A, const void* B)
+{
+	const double a = *(const double*)A;
+	const double b = *(const double*)B;
+	return (a > b) - (a < b);
+}
+
+//total, mean, p50, p95, p99 and max of Count values; sorts them
+static void SummarizeCounts(double* Values, uint32_t Count, double Out[6])
+{
+	qsort(Values, Count, sizeof(double), CompareDoubles);
+
+	double Total = 0.0;
+	for (uint32_t i = 0; i < Count; i++)
+		Total += Values[i];
+
+	static const double Percentiles[] = { 50.0, 95.0, 99.0 };
+
+	Out[0] = Total;
+	Out[1] = Total / Count;
+
+	for (uint32_t p = 0; p < 3; p++)
+	{
+		uint32_t Rank = (uint32_t)ceil(Percentiles[p] / 100.0 * Count);
+		Out[2 + p] = Values[Rank < 1 ? 0 : Rank - 1];
+	}
+
+	Out[5] = Values[Count - 1];
+}
+
+static int CommandBench(int ArgCount, char** Args)
+{
+	if (ArgCount < 2)
+	{
+		fprintf(stderr, "usage: MeshTool bench <manifest.txt|file.bin> <path.txt> [frames] [json|csv] [instances]\n");
+		return EXIT_FAILURE;
+	}
+
+	const bool bCsv = ArgCount >= 4 && strcmp(Args[3], "csv") == 0;
+
+	if (ArgCount >= 4 && !bCsv && strcmp(Args[3], "json") != 0)
+	{
+		fprintf(stderr, "unknown format %s, expected json or csv\n", Args[3]);
+		return EXIT_FAILURE;
+	}
+
+	struct CameraPath Path;
+	uint32_t ErrorLine;
+
+	if (!CameraPathLoad(Args[1], &Path, &ErrorLine))
+	{
+		if (ErrorLine != 0)
+			fprintf(stderr, "%s:%u: bad line\n", Args[1], ErrorLine);
+		else
+			fprintf(stderr, "%s: can't read\n", Args[1]);
+		return EXIT_FAILURE;
+	}
+
+	//by default the whole path: every recorded frame, or the spline sampled at the timestep up to its last key
+	uint32_t FrameCount = Path.Type == CAMERA_PATH_INPUT ? Path.FrameCount : (uint32_t)ceilf(Path.Duration / BENCH_TIME_STEP) + 1;
+
+	if (ArgCount >= 3)
+		FrameCount = (uint32_t)atoi(Args[2]);
+
+	if (FrameCount == 0)
+	{
+		fprintf(stderr, "at least one frame\n");
+		CameraPathFree(&Path);
+		return EXIT_FAILURE;
+	}
+
+	//a .bin is one file, anything else a manifest
+	const size_t NameLength = strlen(Args[0]);
+	const bool bSingleFile = NameLength >= 4 && strcmp(Args[0] + NameLength - 4, ".bin") == 0;
+
+	struct MeshScene Scene;
+	struct MeshSceneStats LoadStats;
+	enum MeshFileResult Result = bSingleFile ? MeshSceneLoadFiles((const char* const*)&Args[0], 1, 0, NULL, &Scene, &LoadStats) : MeshSceneLoad(Args[0], 0, NULL, &Scene, &LoadStats);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", LoadStats.FailedFile == UINT32_MAX ? Args[0] : LoadStats.FailedPath, MeshFileResultString(Result));
+		CameraPathFree(&Path);
+		return EXIT_FAILURE;
+	}
+
+	//instances are laid out on a grid around each chain, the way the renderer's INSTANCES_PER_CHAIN does
+	const uint32_t InstancesPerChain = ArgCount >= 5 ? (uint32_t)atoi(Args[4]) : 0;
+	struct SceneInstances Instances = { 0 };
+
+	if (InstancesPerChain != 0 && !SceneInstancesGrid(&Scene, InstancesPerChain, 0.0f, 1, &Instances))
+	{
+		fprintf(stderr, "out of memory\n");
+		MeshSceneFree(&Scene);
+		CameraPathFree(&Path);
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t DrawCapacity = FrameDrawCapacity(&Scene, InstancesPerChain != 0 ? &Instances : NULL);
+
+	struct BenchRun Run = { 0 };
+	Run.Scene = &Scene;
+	Run.Path = &Path;
+	Run.FrameCount = FrameCount;
+	Run.bCullMeshlets = true;
+	Run.Instances = InstancesPerChain != 0 ? &Instances : NULL;
+	Run.Visible = malloc(sizeof(uint32_t) * (Scene.MeshletCount ? Scene.MeshletCount : 1));
+	Run.VisibleInstances = malloc(sizeof(uint32_t) * (Instances.Count ? Instances.Count : 1));
+	Run.Scratch = malloc(FrameDrawScratchSize(&Scene, Run.Instances) ? FrameDrawScratchSize(&Scene, Run.Instances) : 1);
+	Run.Draws = malloc(sizeof(struct FrameDraw) * (DrawCapacity ? DrawCapacity : 1));
+	Run.Meshlets = malloc(sizeof(double) * FrameCount);
+	Run.Triangles = malloc(sizeof(double) * FrameCount);
+	Run.DrawCounts = malloc(sizeof(double) * FrameCount);
+
+	if (Run.Visible == NULL || Run.VisibleInstances == NULL || Run.Scratch == NULL || Run.Draws == NULL || Run.Meshlets == NULL || Run.Triangles == NULL || Run.DrawCounts == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		BenchRunFree(&Run);
+		SceneInstancesFree(&Instances);
+		MeshSceneFree(&Scene);
+		CameraPathFree(&Path);
+		return EXIT_FAILURE;
+	}
+
+	if (Run.Instances != NULL)
+		fprintf(stderr, "%u instances of each chain, %u in all\n", InstancesPerChain, Instances.Count);
+
+	fprintf(stderr, "%s: %u files, %u meshes in %u lod chains, %u meshlets\n", Args[0], Scene.FileCount, Scene.MeshCount, Scene.LodChainCount, Scene.MeshletCount);
+	fprintf(stderr, "%s: %s path, %u frames at %.4f s\n", Args[1], Path.Type == CAMERA_PATH_INPUT ? "input" : "spline", FrameCount, BENCH_TIME_STEP);
+
+	//the scalar kernel first: a reference the timed run has to match draw for draw, and a warm up for the caches
+	Run.Kernel = SIMD_LEVEL_SCALAR;
+	RunBench(&Run);
+	const uint64_t ReferenceChecksum = Run.Checksum;
+	const uint64_t ReferenceInstances = Run.InstanceChecksum;
+
+	int ExitCode = EXIT_SUCCESS;
+
+	// With the meshlets left to the amplification shader the cpu has to keep every instance it culled before
+	if (Run.Instances != NULL)
+	{
+		Run.bCullMeshlets = false;
+		RunBench(&Run);
+		Run.bCullMeshlets = true;
+
+		if (Run.InstanceChecksum != ReferenceInstances)
+		{
+			fprintf(stderr, "instances differ without the cpu meshlet cull: %016llx against %016llx\n", (unsigned long long)Run.InstanceChecksum, (unsigned long long)ReferenceInstances);
+			ExitCode = EXIT_FAILURE;
+		}
+	}
+
+	Run.Kernel = PlatformSimdBest();
+	RunBench(&Run);
+
+	if (Run.Checksum != ReferenceChecksum)
+	{
+		fprintf(stderr, "%s draws differ from scalar: %016llx against %016llx\n", PlatformSimdName(Run.Kernel), (unsigned long long)Run.Checksum, (unsigned long long)ReferenceChecksum);
+		ExitCode = EXIT_FAILURE;
+	}
+
+	double Meshlets[6], Triangles[6], Draws[6];
+	SummarizeCounts(Run.Meshlets, FrameCount, Meshlets);
+	SummarizeCounts(Run.Triangles, FrameCount, Triangles);
+	SummarizeCounts(Run.DrawCounts, FrameCount, Draws);
+
+	const struct FrameHistogram* Timings[] = { &Run.Frame, &Run.Update, &Run.Record };
+	static const char* TimingNames[] = { "frame", "update", "record" };
+
+	const double* Counts[] = { Meshlets, Triangles, Draws };
+	static const char* CountNames[] = { "meshlets_dispatched", "triangles_submitted", "draws" };
+
+	// Timings are cpu milliseconds a frame; counts are per frame, and the checksum covers every draw of the run so two
+	// builds can be compared for doing the same work as well as for speed
+	if (bCsv)
+	{
+		printf("metric,total,mean,p50,p95,p99,max\n");
+
+		for (uint32_t t = 0; t < 3; t++)
+		{
+			const struct FrameHistogram* Histogram = Timings[t];
+			printf("%s_ms,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n", TimingNames[t], Histogram->Sum, Histogram->Sum / Histogram->Count, FrameHistogramPercentile(Histogram, 50.0),
+				FrameHistogramPercentile(Histogram, 95.0), FrameHistogramPercentile(Histogram, 99.0), Histogram->Max);
+		}
+
+		for (uint32_t c = 0; c < 3; c++)
+			printf("%s,%.0f,%.2f,%.0f,%.0f,%.0f,%.0f\n", CountNames[c], Counts[c][0], Counts[c][1], Counts[c][2], Counts[c][3], Counts[c][4], Counts[c][5]);
+
+		printf("frames,%u,,,,,\n", FrameCount);
+		printf("instances,%u,,,,,\n", Instances.Count);
+		printf("checksum,%016llx,,,,,\n", (unsigned long long)Run.Checksum);
+	}
+	else
+	{
+		printf("{\n  \"frames\": %u,\n  \"instances\": %u,\n  \"time_step\": %.6f,\n  \"kernel\": \"%s\",\n  \"checksum\": \"%016llx\",\n  \"cpu_ms\": {\n",
+			FrameCount, Instances.Count, BENCH_TIME_STEP, PlatformSimdName(Run.Kernel), (unsigned long long)Run.Checksum);
+
+		for (uint32_t t = 0; t < 3; t++)
+		{
+			const struct FrameHistogram* Histogram = Timings[t];
+			printf("    \"%s\": { \"total\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }%s\n", TimingNames[t], Histogram->Sum, Histogram->Sum / Histogram->Count,
+				FrameHistogramPercentile(Histogram, 50.0), FrameHistogramPercentile(Histogram, 95.0), FrameHistogramPercentile(Histogram, 99.0), Histogram->Max, t + 1 < 3 ? "," : "");
+		}
+
+		printf("  },\n");
+
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			printf("  \"%s\": { \"total\": %.0f, \"mean\": %.2f, \"p50\": %.0f, \"p95\": %.0f, \"p99\": %.0f, \"max\": %.0f }%s\n", CountNames[c],
+				Counts[c][0], Counts[c][1], Counts[c][2], Counts[c][3], Counts[c][4], Counts[c][5], c + 1 < 3 ? "," : "");
+		}
+
+		printf("}\n");
+	}
+
+	BenchRunFree(&Run);
+	SceneInstancesFree(&Instances);
+	MeshSceneFree(&Scene);
+	CameraPathFree(&Path);
+
+	return ExitCode;
+}
+
+//world spheres of random affine transforms, shear and all, have to hold every vertex of the chain they came from
+static uint32_t CheckInstanceBounds(const struct MeshScene* Scene, uint32_t* Seed)
+{
+	uint32_t Problems = 0;
+
+	for (uint32_t c = 0; c < Scene->LodChainCount; c++)
+	{
+		const struct MeshLodChain* Chain = &Scene->LodChains[c];
+		const struct Mesh* Mesh = &Scene->MeshList[Chain->Meshes[0]];
+
+		const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+		const uint8_t* PositionBase = Mesh->VertexBuffers[Slot].Verts + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_POSITION];
+		const uint32_t Stride = Mesh->VertexBuffers[Slot].Stride;
+		const uint32_t Step = Mesh->VertexCount > 65536 ? Mesh->VertexCount / 65536 : 1;
+
+		for (uint32_t t = 0; t < 16; t++)
+		{
+			struct InstanceTransform Transform;
+			for (int r = 0; r < 3; r++)
+			{
+				for (int k = 0; k < 4; k++)
+					Transform.Rows[r][k] = ((float)NextRandom(Seed) / 16777216.0f * 2.0f - 1.0f) * (k == 3 ? 100.0f : 2.0f);
+			}
+
+			struct BoundingSphere World;
+			TransformBoundingSphere(&Transform, &Chain->Bounds, &World);
+
+			for (uint32_t v = 0; v < Mesh->VertexCount; v += Step)
+			{
+				float p[3];
+				memcpy(p, PositionBase + (size_t)v * Stride, sizeof(p));
+
+				float Distance = 0.0f;
+				for (int r = 0; r < 3; r++)
+				{
+					const float d = Transform.Rows[r][0] * p[0] + Transform.Rows[r][1] * p[1] + Transform.Rows[r][2] * p[2] + Transform.Rows[r][3] - World.Center[r];
+					Distance += d * d;
+				}
+
+				if (sqrtf(Distance) > World.Radius * 1.0001f + 1e-4f)
+				{
+					if (Problems++ < 5)
+						fprintf(stderr, "chain %u transform %u: vertex %u is %g from the centre of a %g sphere\n", c, t, v, sqrtf(Distance), World.Radius);
+					break;
+				}
+			}
+		}
+	}
+
+	return Problems;
+}
+
+#define INSTANCE_VIEW_COUNT 8
+
+static int CommandInstances(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool instances <manifest.txt|file.bin> [max instances]\n");
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t MaxInstances = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : 1000000;
+
+	const size_t NameLength = strlen(Args[0]);
+	const bool bSingleFile = NameLength >= 4 && strcmp(Args[0] + NameLength - 4, ".bin") == 0;
+
+	struct MeshScene Scene;
+	struct MeshSceneStats LoadStats;
+	enum MeshFileResult Result = bSingleFile ? MeshSceneLoadFiles((const char* const*)&Args[0], 1, 0, NULL, &Scene, &LoadStats) : MeshSceneLoad(Args[0], 0, NULL, &Scene, &LoadStats);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", LoadStats.FailedFile == UINT32_MAX ? Args[0] : LoadStats.FailedPath, MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	if (Scene.LodChainCount == 0)
+	{
+		fprintf(stderr, "%s: nothing to instance\n", Args[0]);
+		MeshSceneFree(&Scene);
+		return EXIT_FAILURE;
+	}
+
+	printf("%s: %u meshes in %u lod chains, %u meshlets\n", Args[0], Scene.MeshCount, Scene.LodChainCount, Scene.MeshletCount);
+
+	uint32_t Seed = 7;
+	uint32_t Problems = CheckInstanceBounds(&Scene, &Seed);
+
+	static const enum SimdLevel Kernels[] = { SIMD_LEVEL_SCALAR, SIMD_LEVEL_SSE2, SIMD_LEVEL_AVX2 };
+
+	printf("  %9s %9s %7s %12s %14s", "instances", "visible", "draws", "meshlets", "triangles");
+	for (uint32_t k = 0; k < sizeof(Kernels) / sizeof(Kernels[0]); k++)
+	{
+		if (PlatformSimdSupported(Kernels[k]))
+			printf(" %6s ms", PlatformSimdName(Kernels[k]));
+	}
+	printf(" %9s\n", "frame ms");
+
+	// Each count is split evenly over the chains, and every row is the average of views orbiting the grid
+	uint32_t LastPerChain = 0;
+
+	for (uint64_t Target = 1; Target <= MaxInstances && Problems == 0; Target *= 10)
+	{
+		const uint32_t PerChain = Target / Scene.LodChainCount > 0 ? (uint32_t)(Target / Scene.LodChainCount) : 1;
+
+		if (PerChain == LastPerChain)
+			continue;
+
+		LastPerChain = PerChain;
+
+		struct SceneInstances Instances;
+		if (!SceneInstancesGrid(&Scene, PerChain, 0.0f, 1, &Instances))
+		{
+			fprintf(stderr, "out of memory\n");
+			Problems++;
+			break;
+		}
+
+		const uint32_t DrawCapacity = FrameDrawCapacity(&Scene, &Instances);
+		uint32_t* Visible = malloc(sizeof(uint32_t) * (Scene.MeshletCount ? Scene.MeshletCount : 1));
+		uint32_t* VisibleInstances = malloc(sizeof(uint32_t) * Instances.Count);
+		uint32_t* Reference = malloc(sizeof(uint32_t) * Instances.Count);
+		uint32_t* Culled = malloc(sizeof(uint32_t) * Instances.Count);
+		uint8_t* Seen = malloc(Instances.Count);
+		void* Scratch = malloc(FrameDrawScratchSize(&Scene, &Instances));
+		struct FrameDraw* Draws = malloc(sizeof(struct FrameDraw) * (DrawCapacity ? DrawCapacity : 1));
+
+		if (Visible == NULL || VisibleInstances == NULL || Reference == NULL || Culled == NULL || Seen == NULL || Scratch == NULL || Draws == NULL)
+		{
+			fprintf(stderr, "out of memory\n");
+			Problems++;
+		}
+
+		//the grid spans about Side * 2r; orbit outside its middle, looking in, with the far plane past its far edge
+		float Extent = 0.0f;
+		float Centre[3] = { 0.0f, 0.0f, 0.0f };
+		for (uint32_t c = 0; c < Scene.LodChainCount; c++)
+		{
+			const struct BoundingSphere* Bounds = &Scene.LodChains[c].Bounds;
+			Extent = fmaxf(Extent, 2.0f * Bounds->Radius * ceilf(sqrtf((float)PerChain)));
+			for (int k = 0; k < 3; k++)
+				Centre[k] += Bounds->Center[k] / Scene.LodChainCount;
+		}
+
+		double CullTimes[3] = { 0.0, 0.0, 0.0 };
+		double FrameTime = 0.0;
+		struct FrameDrawStats Totals = { 0 };
+
+		for (uint32_t v = 0; v < INSTANCE_VIEW_COUNT && Problems == 0; v++)
+		{
+			const float Angle = 6.2831853f * v / INSTANCE_VIEW_COUNT;
+			const float Distance = Extent * 0.35f + Scene.LodChains[0].Bounds.Radius * 3.0f;
+			const float Eye[3] =
+			{
+				Centre[0] + cosf(Angle) * Distance,
+				Centre[1] + Distance * 0.3f,
+				Centre[2] + sinf(Angle) * Distance
+			};
+
+			float ViewProj[16];
+			BuildViewProjection(Eye, Centre, 3.14159265f / 3.0f, 16.0f / 9.0f, 1.0f, Distance + Extent * 1.5f, ViewProj);
+
+			struct CullFrustum Frustum;
+			CullFrustumFromMatrix(ViewProj, Eye, &Frustum);
+
+			struct LodView View;
+			LodViewInit(Eye, 3.14159265f / 3.0f, 1080.0f, 1.0f, &View);
+
+			const uint32_t ReferenceCount = CullInstances(&Frustum, Instances.Bounds, 0, Instances.Count, SIMD_LEVEL_SCALAR, Reference);
+
+			for (uint32_t k = 0; k < sizeof(Kernels) / sizeof(Kernels[0]); k++)
+			{
+				if (!PlatformSimdSupported(Kernels[k]))
+					continue;
+
+				const double Start = PlatformGetTime();
+				const uint32_t Count = CullInstances(&Frustum, Instances.Bounds, 0, Instances.Count, Kernels[k], Culled);
+				CullTimes[k] += PlatformGetTime() - Start;
+
+				if (Count != ReferenceCount || memcmp(Culled, Reference, sizeof(uint32_t) * Count) != 0)
+				{
+					fprintf(stderr, "  %u instances, view %u: %s culls %u, scalar %u\n", Instances.Count, v, PlatformSimdName(Kernels[k]), Count, ReferenceCount);
+					Problems++;
+				}
+			}
+
+			struct FrameDrawDesc Desc = { 0 };
+			Desc.Scene = &Scene;
+			Desc.View = &View;
+			Desc.Frustum = &Frustum;
+			Desc.bCullMeshlets = true;
+			Desc.bCullInstances = true;
+			Desc.Kernel = PlatformSimdBest();
+			Desc.Instances = &Instances;
+			Desc.Scratch = Scratch;
+
+			struct FrameDrawStats Stats;
+			const double Start = PlatformGetTime();
+			const uint32_t DrawCount = BuildFrameDraws(&Desc, Visible, VisibleInstances, Draws, &Stats);
+			FrameTime += PlatformGetTime() - Start;
+
+			// Every visible instance is drawn at exactly one level, and every draw fits one DispatchMesh
+			if (Stats.InstancesVisible != ReferenceCount || DrawCount > DrawCapacity)
+			{
+				fprintf(stderr, "  %u instances, view %u: %u visible, %u drawn in %u draws of %u\n", Instances.Count, v, ReferenceCount, Stats.InstancesVisible, DrawCount, DrawCapacity);
+				Problems++;
+			}
+
+			memset(Seen, 0, Instances.Count);
+			for (uint32_t k = 0; k < Stats.InstancesVisible; k++)
+				Seen[VisibleInstances[k]]++;
+			for (uint32_t k = 0; k < ReferenceCount; k++)
+				Problems += Seen[Reference[k]] != 1;
+
+			uint64_t Dispatched = 0;
+			for (uint32_t d = 0; d < DrawCount; d++)
+			{
+				const struct FrameDraw* Draw = &Draws[d];
+				Dispatched += (uint64_t)Draw->VisibleCount * Draw->InstanceCount;
+
+				if (Draw->VisibleCount == 0 || Draw->VisibleCount > FRAME_DRAW_MAX_GROUPS_PER_AXIS || Draw->InstanceCount == 0 || Draw->InstanceCount > FRAME_DRAW_MAX_GROUPS_PER_AXIS ||
+					(uint64_t)Draw->VisibleCount * Draw->InstanceCount > FRAME_DRAW_MAX_GROUPS || Draw->InstanceOffset + Draw->InstanceCount > Stats.InstancesVisible)
+				{
+					if (Problems++ < 5)
+						fprintf(stderr, "  draw %u: %u meshlets x %u instances from %u\n", d, Draw->VisibleCount, Draw->InstanceCount, Draw->InstanceOffset);
+				}
+			}
+
+			Problems += Dispatched != Stats.MeshletsDispatched;
+
+			Totals.InstancesVisible += Stats.InstancesVisible;
+			Totals.DrawCount += Stats.DrawCount;
+			Totals.MeshletsDispatched += Stats.MeshletsDispatched;
+			Totals.TrianglesSubmitted += Stats.TrianglesSubmitted;
+		}
+
+		printf("  %9u %9u %7u %12llu %14llu", Instances.Count, Totals.InstancesVisible / INSTANCE_VIEW_COUNT, Totals.DrawCount / INSTANCE_VIEW_COUNT,
+			(unsigned long long)(Totals.MeshletsDispatched / INSTANCE_VIEW_COUNT), (unsigned long long)(Totals.TrianglesSubmitted / INSTANCE_VIEW_COUNT));
+
+		for (uint32_t k = 0; k < sizeof(Kernels) / sizeof(Kernels[0]); k++)
+		{
+			if (PlatformSimdSupported(Kernels[k]))
+				printf(" %9.3f", CullTimes[k] * 1000.0 / INSTANCE_VIEW_COUNT);
+		}
+
+		printf(" %9.3f\n", FrameTime * 1000.0 / INSTANCE_VIEW_COUNT);
+
+		free(Visible);
+		free(VisibleInstances);
+		free(Reference);
+		free(Culled);
+		free(Seen);
+		free(Scratch);
+		free(Draws);
+		SceneInstancesFree(&Instances);
+	}
+
+	MeshSceneFree(&Scene);
+
+	if (Problems != 0)
+		fprintf(stderr, "%u problems\n", Problems);
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//MeshletAS.hlsl's IsVisible over one record of the gpu copy of the cull data, loaded the way the shader loads it
+static bool AmplificationVisible(const struct CullFrustum* Frustum, const struct CullData* GpuCullData)
+{
+	uint32_t Words[6];
+	memcpy(Words, GpuCullData, sizeof(Words));
+
+	float Sphere[4];
+	memcpy(Sphere, Words, sizeof(Sphere));
+
+	for (int i = 0; i < 6; i++)
+	{
+		const float* Plane = Frustum->Planes[i];
+
+		if (!CullSpherePlane(Sphere[0], Sphere[1], Sphere[2], Sphere[3], Plane[0], Plane[1], Plane[2], Plane[3]))
+			return false;
+	}
+
+	const uint32_t Cutoff = Words[4] >> 24;
+
+	if (Cutoff == 0xFF)
+		return true;
+
+	float ApexScale;
+	memcpy(&ApexScale, &Words[5], sizeof(ApexScale));
+
+	return CullNormalCone(Sphere[0], Sphere[1], Sphere[2],
+		CullDecodeAxis((float)(Words[4] & 0xFF)), CullDecodeAxis((float)((Words[4] >> 8) & 0xFF)), CullDecodeAxis((float)((Words[4] >> 16) & 0xFF)),
+		CullDecodeCutoff((float)Cutoff), ApexScale,
+		Frustum->ViewPosition[0], Frustum->ViewPosition[1], Frustum->ViewPosition[2]);
+}
+
+//true when the compiler fused MeshletCullMath.h's multiplies and adds into fmas, which the gpu never does: random
+//spheres are put on either side of a plane's edge with every step rounded on its own, and a fused sum lands on the
+//wrong side now and then
+static bool CullMathContracted(void)
+{
+	uint32_t Seed = 7;
+
+	for (int i = 0; i < 4096; i++)
+	{
+		float v[7];
+		volatile float Copy[7];
+		for (int k = 0; k < 7; k++)
+			Copy[k] = v[k] = NextRandom(&Seed) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+
+		// The reference reads volatile copies and stores every step, so the compiler can neither fuse it nor share
+		// its products with the test
+		volatile float X = Copy[0] * Copy[3];
+		volatile float Y = Copy[1] * Copy[4];
+		volatile float Z = Copy[2] * Copy[5];
+		volatile float XY = X + Y;
+		volatile float ZW = Z + Copy[6];
+		const float Distance = XY + ZW;
+
+		// Visible exactly on the edge, culled one step further out
+		if (!CullSpherePlane(v[0], v[1], v[2], -Distance, v[3], v[4], v[5], v[6]) ||
+			CullSpherePlane(v[0], v[1], v[2], -nextafterf(Distance, INFINITY), v[3], v[4], v[5], v[6]))
+			return true;
+	}
+
+	return false;
+}
+
+static uint32_t CountBits(uint32_t Value)
+{
+	uint32_t Count = 0;
+	for (; Value != 0; Value &= Value - 1)
+		Count++;
+
+	return Count;
+}
+
+//MeshletAS.hlsl's group size
+#define AMPLIFICATION_GROUP_SIZE 32
+
+//one MeshletAS.hlsl group over Candidates[0 .. Count), Count <= AMPLIFICATION_GROUP_SIZE: each thread sets its bit
+//of a mask and the survivors are packed into Payload by the bits below theirs. returns the mesh shader groups launched
+static uint32_t AmplificationGroup(const struct CullFrustum* Frustum, const struct CullData* GpuCullData, const uint32_t* Candidates, uint32_t Count, uint32_t* Payload)
+{
+	uint32_t Mask = 0;
+
+	for (uint32_t t = 0; t < Count; t++)
+		Mask |= (uint32_t)AmplificationVisible(Frustum, &GpuCullData[Candidates[t]]) << t;
+
+	for (uint32_t t = 0; t < Count; t++)
+	{
+		if ((Mask >> t) & 1)
+			Payload[CountBits(Mask & ((1u << t) - 1))] = Candidates[t];
+	}
+
+	return CountBits(Mask);
+}
+
+//true when no triangle of the meshlet can be seen: each has all its vertices outside one frustum plane, or faces away
+//from the view. Tolerance is how far outside a plane a vertex may be taken to be when it is just inside
+static bool MeshletHidden(const struct Mesh* Mesh, uint32_t MeshletIndex, const struct CullFrustum* Frustum, float Tolerance)
+{
+	const struct Meshlet* Meshlet = &Mesh->Meshlets[MeshletIndex];
+	const float* Eye = Frustum->ViewPosition;
+
+	for (uint32_t p = 0; p < Meshlet->PrimCount; p++)
+	{
+		const struct PackedTriangle Triangle = Mesh->PrimitiveIndices[Meshlet->PrimOffset + p];
+		const float* Corners[3] =
+		{
+			MeshPosition(Mesh, MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i0)),
+			MeshPosition(Mesh, MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i1)),
+			MeshPosition(Mesh, MeshletVertexIndex(Mesh, Meshlet->VertOffset + Triangle.i2)),
+		};
+
+		bool bOutside = false;
+
+		for (int i = 0; i < 6 && !bOutside; i++)
+		{
+			const float* Plane = Frustum->Planes[i];
+			bOutside = true;
+
+			for (int c = 0; c < 3; c++)
+				bOutside &= Corners[c][0] * Plane[0] + Corners[c][1] * Plane[1] + Corners[c][2] * Plane[2] + Plane[3] < Tolerance;
+		}
+
+		if (bOutside)
+			continue;
+
+		const float* p0 = Corners[0];
+		const float e0[3] = { Corners[1][0] - p0[0], Corners[1][1] - p0[1], Corners[1][2] - p0[2] };
+		const float e1[3] = { Corners[2][0] - p0[0], Corners[2][1] - p0[1], Corners[2][2] - p0[2] };
+		const float n[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+		const float ToEye[3] = { Eye[0] - p0[0], Eye[1] - p0[1], Eye[2] - p0[2] };
+
+		//the same slack ValidateMeshlets gives the cones
+		const float Facing = n[0] * ToEye[0] + n[1] * ToEye[1] + n[2] * ToEye[2];
+		const float Scale = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * sqrtf(ToEye[0] * ToEye[0] + ToEye[1] * ToEye[1] + ToEye[2] * ToEye[2]);
+
+		if (Facing > Scale * 1e-3f)
+			return false;
+	}
+
+	return true;
+}
+
+enum AmplificationView
+{
+	AMPLIFICATION_VIEW_ORBIT,//around the mesh, looking at its center
+	AMPLIFICATION_VIEW_OUTSIDE,//anywhere near it, looking anywhere
+	AMPLIFICATION_VIEW_INSIDE,//within its bounds, looking anywhere
+	AMPLIFICATION_VIEW_COUNT
+};
+
+static const char* AmplificationViewNames[AMPLIFICATION_VIEW_COUNT] = { "orbit", "outside", "inside" };
+
+struct AmplificationTotals
+{
+	uint32_t Views;
+	uint64_t Tested;
+	uint64_t FrustumCulled;
+	uint64_t ConeCulled;
+	uint64_t AmplificationGroups;
+	uint64_t MeshGroups;
+	uint64_t PayloadMismatches;//draws whose packed survivors differ from CullMeshlets
+	uint64_t KernelMismatches;//draws where a simd kernel differs from the scalar reference
+	uint64_t CulledVisible;//culled meshlets with a triangle in view
+};
+
+static int CommandAmplificationCull(int ArgCount, char** Args)
+{
+	if (ArgCount < 1)
+	{
+		fprintf(stderr, "usage: MeshTool ascull <file.bin> [views]\n");
+		return EXIT_FAILURE;
+	}
+
+	const uint32_t ViewCount = ArgCount >= 2 ? (uint32_t)atoi(Args[1]) : 256;
+
+	struct MeshFile File;
+	enum MeshFileResult Result = MeshFileOpen(Args[0], &File);
+
+	if (Result != MESHFILE_OK)
+	{
+		fprintf(stderr, "%s: %s\n", Args[0], MeshFileResultString(Result));
+		return EXIT_FAILURE;
+	}
+
+	struct BoundingSphere Scene;
+	ComputeMeshBounds(File.MeshList, File.MeshCount, PlatformSimdBest(), 0, &Scene);
+
+	//the gpu copy of every mesh's cull data, as MeshSceneEncodeCullData uploads it, and the unculled list the cpu
+	//gives the amplification shader: every meshlet in order
+	struct CullData** GpuCullData = calloc(File.MeshCount ? File.MeshCount : 1, sizeof(struct CullData*));
+	bool* bCheckSight = calloc(File.MeshCount ? File.MeshCount : 1, sizeof(bool));
+	uint32_t MaxMeshletCount = 0;
+	uint64_t TotalMeshletCount = 0;
+	bool bOutOfMemory = GpuCullData == NULL || bCheckSight == NULL;
+
+	for (uint32_t i = 0; i < File.MeshCount && !bOutOfMemory; i++)
+	{
+		const struct Mesh* Mesh = &File.MeshList[i];
+
+		GpuCullData[i] = malloc(sizeof(struct CullData) * (Mesh->CullingDataCount ? Mesh->CullingDataCount : 1));
+		bOutOfMemory = GpuCullData[i] == NULL;
+
+		if (!bOutOfMemory)
+			CullDataToGpu(Mesh->CullingData, Mesh->CullingDataCount, GpuCullData[i]);
+
+		MaxMeshletCount = Mesh->CullingDataCount > MaxMeshletCount ? Mesh->CullingDataCount : MaxMeshletCount;
+		TotalMeshletCount += Mesh->CullingDataCount;
+	}
+
+	// Cones another tool stored can disagree with the triangles; such a mesh is only checked against the reference, and
+	// the run fails, since a build that fuses the cull math into fmas shows up here too
+	uint32_t UncheckedMeshes = 0;
+	const bool bContracted = CullMathContracted();
+
+	if (bContracted)
+		fprintf(stderr, "the cull math was compiled with fused multiply-adds and can't match the gpu, build with -ffp-contract=off\n");
+
+	for (uint32_t i = 0; i < File.MeshCount && !bOutOfMemory; i++)
+	{
+		uint32_t MaxVertices, MaxPrimitives;
+		MeshMeshletLimits(&File.MeshList[i], &MaxVertices, &MaxPrimitives);
+
+		const uint32_t SourceProblems = ValidateMeshlets(&File.MeshList[i], MaxVertices, MaxPrimitives);
+		bCheckSight[i] = SourceProblems == 0;
+		UncheckedMeshes += SourceProblems != 0;
+
+		if (SourceProblems)
+			fprintf(stderr, "mesh %u: the source meshlets already have %u problems, not checking what is in sight\n", i, SourceProblems);
+	}
+
+	const size_t ListSize = sizeof(uint32_t) * (MaxMeshletCount ? MaxMeshletCount : 1);
+	uint32_t* Candidates = malloc(ListSize);
+	uint32_t* Reference = malloc(ListSize);
+	uint32_t* Visible = malloc(ListSize);
+	uint32_t* Packed = malloc(ListSize);
+
+	if (bOutOfMemory || Candidates == NULL || Reference == NULL || Visible == NULL || Packed == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+
+		for (uint32_t i = 0; GpuCullData != NULL && i < File.MeshCount; i++)
+			free(GpuCullData[i]);
+
+		free(GpuCullData);
+		free(bCheckSight);
+		free(Candidates);
+		free(Reference);
+		free(Visible);
+		free(Packed);
+		MeshFileClose(&File);
+		return EXIT_FAILURE;
+	}
+
+	for (uint32_t m = 0; m < MaxMeshletCount; m++)
+		Candidates[m] = m;
+
+	printf("%s: %u meshes, %llu meshlets, %u views\n", Args[0], File.MeshCount, (unsigned long long)TotalMeshletCount, ViewCount);
+
+	//near and far follow the mesh's size so every plane cuts through it from some view
+	const float NearZ = Scene.Radius * 0.01f;
+	const float FarZ = Scene.Radius * 4.0f;
+	const float Tolerance = Scene.Radius * 1e-5f;
+
+	struct AmplificationTotals Totals[AMPLIFICATION_VIEW_COUNT] = { 0 };
+	uint32_t Seed = 25;
+
+	for (uint32_t v = 0; v < ViewCount; v++)
+	{
+		const enum AmplificationView Kind = (enum AmplificationView)(v % AMPLIFICATION_VIEW_COUNT);
+
+		float Eye[3];
+		float Target[3];
+
+		for (int a = 0; a < 3; a++)
+		{
+			const float Unit = NextRandom(&Seed) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+			const float Look = NextRandom(&Seed) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+
+			switch (Kind)
+			{
+			case AMPLIFICATION_VIEW_ORBIT:
+				Eye[a] = Scene.Center[a];
+				Target[a] = Scene.Center[a];
+				break;
+			case AMPLIFICATION_VIEW_OUTSIDE:
+				Eye[a] = Scene.Center[a] + Unit * Scene.Radius * 3.0f;
+				Target[a] = Eye[a] + Look;
+				break;
+			default:
+				Eye[a] = Scene.Center[a] + Unit * Scene.Radius * 0.5f;
+				Target[a] = Eye[a] + Look;
+				break;
+			}
+		}
+
+		if (Kind == AMPLIFICATION_VIEW_ORBIT)
+		{
+			const float Angle = 6.2831853f * v / ViewCount;
+			const float Distance = Scene.Radius * (1.2f + 1.8f * ((v * 7) % 11) / 10.0f);
+
+			Eye[0] += cosf(Angle) * Distance;
+			Eye[1] += Scene.Radius * 0.5f * sinf(Angle * 3.0f);
+			Eye[2] += sinf(Angle) * Distance;
+		}
+
+		//looking straight up or down has no side vector
+		if (fabsf(Target[0] - Eye[0]) + fabsf(Target[2] - Eye[2]) < 1e-3f * (fabsf(Target[1] - Eye[1]) + 1e-3f))
+			Target[0] += 1.0f;
+
+		float ViewProj[16];
+		BuildViewProjection(Eye, Target, 3.14159265f / 3.0f, 16.0f / 9.0f, NearZ, FarZ, ViewProj);
+
+		struct CullFrustum Frustum;
+		CullFrustumFromMatrix(ViewProj, Eye, &Frustum);
+
+		struct AmplificationTotals* Total = &Totals[Kind];
+		Total->Views++;
+
+		for (uint32_t i = 0; i < File.MeshCount; i++)
+		{
+			const struct Mesh* Mesh = &File.MeshList[i];
+
+			//every meshlet, dag levels included, in draws of at most a dispatch's worth
+			for (uint32_t Offset = 0; Offset < Mesh->CullingDataCount; Offset += FRAME_DRAW_MAX_GROUPS_PER_AXIS)
+			{
+				const uint32_t Count = Mesh->CullingDataCount - Offset < FRAME_DRAW_MAX_GROUPS_PER_AXIS ? Mesh->CullingDataCount - Offset : FRAME_DRAW_MAX_GROUPS_PER_AXIS;
+				const uint32_t ReferenceCount = CullMeshlets(&Frustum, Mesh->CullingData, Offset, Count, SIMD_LEVEL_SCALAR, Reference);
+
+				uint32_t PackedCount = 0;
+
+				for (uint32_t g = 0; g < Count; g += AMPLIFICATION_GROUP_SIZE)
+				{
+					const uint32_t GroupCount = Count - g < AMPLIFICATION_GROUP_SIZE ? Count - g : AMPLIFICATION_GROUP_SIZE;
+					PackedCount += AmplificationGroup(&Frustum, GpuCullData[i], &Candidates[Offset + g], GroupCount, &Packed[PackedCount]);
+					Total->AmplificationGroups++;
+				}
+
+				Total->Tested += Count;
+				Total->MeshGroups += PackedCount;
+
+				if (PackedCount != ReferenceCount || memcmp(Packed, Reference, sizeof(uint32_t) * PackedCount) != 0)
+					Total->PayloadMismatches++;
+
+				for (int Kernel = SIMD_LEVEL_SCALAR + 1; Kernel < SIMD_LEVEL_COUNT; Kernel++)
+				{
+					if (!PlatformSimdSupported(Kernel))
+						continue;
+
+					const uint32_t VisibleCount = CullMeshlets(&Frustum, Mesh->CullingData, Offset, Count, Kernel, Visible);
+
+					if (VisibleCount != ReferenceCount || memcmp(Visible, Reference, sizeof(uint32_t) * VisibleCount) != 0)
+						Total->KernelMismatches++;
+				}
+
+				//every meshlet the reference dropped has to be out of sight; Reference is ascending
+				for (uint32_t m = Offset, r = 0; m < Offset + Count; m++)
+				{
+					if (r < ReferenceCount && Reference[r] == m)
+					{
+						r++;
+						continue;
+					}
+
+					bool bInside = true;
+					const float* Sphere = Mesh->CullingData[m].BoundingSphere;
+
+					for (int p = 0; p < 6 && bInside; p++)
+						bInside = CullSpherePlane(Sphere[0], Sphere[1], Sphere[2], Sphere[3], Frustum.Planes[p][0], Frustum.Planes[p][1], Frustum.Planes[p][2], Frustum.Planes[p][3]);
+
+					Total->FrustumCulled += !bInside;
+					Total->ConeCulled += bInside;
+
+					if (bCheckSight[i] && m < Mesh->MeshletCount && !MeshletHidden(Mesh, m, &Frustum, Tolerance))
+					{
+						if (Total->CulledVisible++ == 0)
+							fprintf(stderr, "    %s view %u, mesh %u: meshlet %u culled with a triangle in sight\n", AmplificationViewNames[Kind], v, i, m);
+					}
+				}
+			}
+		}
+	}
+
+	printf("  %-8s %6s %12s %8s %8s %8s %10s %10s %9s %9s %9s\n", "views", "count", "meshlets", "visible", "frustum", "cone", "as groups", "ms groups", "payload", "kernels", "in sight");
+
+	uint64_t Problems = 0;
+
+	for (int k = 0; k < AMPLIFICATION_VIEW_COUNT; k++)
+	{
+		const struct AmplificationTotals* Total = &Totals[k];
+		const double Tested = Total->Tested ? (double)Total->Tested : 1.0;
+
+		printf("  %-8s %6u %12llu %7.1f%% %7.1f%% %7.1f%% %10llu %10llu %9llu %9llu %9llu\n",
+			AmplificationViewNames[k], Total->Views, (unsigned long long)Total->Tested,
+			100.0 * Total->MeshGroups / Tested, 100.0 * Total->FrustumCulled / Tested, 100.0 * Total->ConeCulled / Tested,
+			(unsigned long long)Total->AmplificationGroups, (unsigned long long)Total->MeshGroups,
+			(unsigned long long)Total->PayloadMismatches, (unsigned long long)Total->KernelMismatches, (unsigned long long)Total->CulledVisible);
+
+		Problems += Total->PayloadMismatches + Total->KernelMismatches + Total->CulledVisible;
+	}
+
+	if (UncheckedMeshes != 0)
+		fprintf(stderr, "%u meshes weren't checked for what is in sight\n", UncheckedMeshes);
+
+	Problems += UncheckedMeshes + bContracted;
+
+	for (uint32_t i = 0; i < File.MeshCount; i++)
+		free(GpuCullData[i]);
+
+	free(GpuCullData);
+	free(bCheckSight);
+	free(Candidates);
+	free(Reference);
+	free(Visible);
+	free(Packed);
+	MeshFileClose(&File);
+
+	if (Problems != 0)
+		fprintf(stderr, "%llu problems\n", (unsigned long long)Problems);
+
+	return Problems ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+struct Command
+{
+	const char* Name;
+	int (*Run)(int ArgCount, char** Args);
+	const char* Help;
+};
+
+static const struct Command Commands[] =
+{
+	{ "info", CommandInfo, "info <file.bin>...            per-mesh stats and load throughput" },
+	{ "bounds", CommandBounds, "bounds <file.bin> [iters]     benchmark bounding-sphere kernels" },
+	{ "meshlets", CommandMeshlets, "meshlets <file.bin> [v p t]   rebuild and validate meshlets" },
+	{ "cull", CommandCull, "cull <file.bin> [views]       benchmark meshlet frustum/cone culling" },
+	{ "convert", CommandConvert, "convert <in> <out> [v p]      write a gpu-ready blob file and verify it" },
+	{ "compress", CommandCompress, "compress <in> <out> [iters]   write a compressed file, benchmark decoding" },
+	{ "stream", CommandStream, "stream <file.bin> [kb depth]  benchmark the streaming loader, cold and warm" },
+	{ "scene", CommandScene, "scene <manifest> [threads]    load a scene with 1..threads workers and verify the merge" },
+	{ "lodgen", CommandLodGen, "lodgen <in> <prefix> [levels] write a simplified _LOD0.._LODn chain" },
+	{ "lod", CommandLod, "lod <file_LOD0.bin> [count]   check and benchmark level selection over many instances" },
+	{ "dag", CommandDag, "dag <in> <out> [v p]          build, validate and write cluster lod dags" },
+	{ "dagcut", CommandDagCut, "dagcut <file.bin> [views]     cut the dags from many views, check against brute force and for cracks" },
+	{ "quantize", CommandQuantize, "quantize <file.bin> [iters]   quantize vertices like the renderer, measure position and normal error" },
+	{ "meshletpos", CommandMeshletPositions, "meshletpos <file.bin> [bits]  encode positions per meshlet, measure size, error and cracks" },
+	{ "limits", CommandLimits, "limits <file.bin> [v/p]...    compare meshlet fill and shader occupancy across limits" },
+	{ "triangles", CommandTriangles, "triangles <file.bin> [iters]  convert primitives to each triangle format, benchmark unpacking" },
+	{ "indexless", CommandIndexless, "indexless <in> <out>          lay meshlet vertices out contiguously, report duplication and verify" },
+	{ "locality", CommandLocality, "locality <in> <out> [line kb] reorder meshlets and vertices for locality, simulate cache line fetches" },
+	{ "stats", CommandStats, "stats <file.bin> [json|csv]   per mesh and subset meshlet statistics for scripts" },
+	{ "ring", CommandRing, "ring [kb] [iters]             check the staging ring allocator and benchmark it" },
+	{ "heap", CommandHeap, "heap [heap mb] [meshes]       check the placed heap sub-allocator against a mock heap" },
+	{ "upload", CommandUpload, "upload [mb] [kb/frame] [ring] stream a scene through the upload scheduler and a simulated copy queue" },
+	{ "frames", CommandFrames, "frames [buffers] [frames]     check frame pacing against a simulated gpu for each frames in flight limit" },
+	{ "telemetry", CommandTelemetry, "telemetry [frames] [csv|json] [out] stream synthetic frame timings through telemetry, check export and percentiles" },
+	{ "bench", CommandBench, "bench <scene> <path> [frames] [json|csv] [instances] fly a camera path headless at a fixed timestep, summarize frame work" },
+	{ "instances", CommandInstances, "instances <scene> [max]       cull and draw 1..max instances of every chain, check kernels and dispatch limits" },
+	{ "ascull", CommandAmplificationCull, "ascull <file.bin> [views]     run MeshletAS.hlsl's culling on the cpu from many views, check it against the reference" },
+};
+
+int main(int argc, char** argv)
+{
+	if (argc >= 2)
+	{
+		for (size_t i = 0; i < sizeof(Commands) / sizeof(Commands[0]); i++)
+		{
+			if (strcmp(argv[1], Commands[i].Name) == 0)
+				return Commands[i].Run(argc - 2, argv + 2);
+		}
+	}
+
+	fprintf(stderr, "usage: MeshTool <command> [args]\n");
+
+	for (size_t i = 0; i < sizeof(Commands) / sizeof(Commands[0]); i++)
+		fprintf(stderr, "  %s\n", Commands[i].Help);
+
+	return EXIT_FAILURE;
+}
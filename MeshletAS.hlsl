@@ -0,0 +1,135 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Culls a draw's meshlets before the mesh shader runs. The cpu lists each draw's meshlets as it does without this
+// stage, lod levels and dag cuts included, but leaves them unculled; every thread here tests one against the frustum
+// and its normal cone with the math MeshletCull.c runs, and the group launches a mesh shader group per survivor.
+
+#include "MeshletCullMath.h"
+
+// Matches MESHLET_AS_GROUP_SIZE in MeshletMS.hlsl and the renderer's dispatch.
+#define MESHLET_AS_GROUP_SIZE 32
+
+struct Constants
+{
+    float4x4 World;
+    float4x4 WorldView;
+    float4x4 WorldViewProj;
+    uint DrawMeshlets;
+    float4 CullPlanes[6]; // The object space frustum, as CullFrustumFromMatrix builds it.
+    float4 CullViewPosition;
+};
+
+// Matches MeshConstants in MinimalDx12MeshShaders.c.
+struct MeshInfoType
+{
+    float3 PositionOffset;
+    uint IndexBytes;
+    float3 PositionScale;
+    uint MeshletOffset;
+    uint QuantizedVertices;
+    uint MeshletPositions;
+    uint TriangleFormat;
+    uint InstanceOffset;
+    uint Instanced;
+    uint MeshletCount;
+    uint CullMeshlets;
+};
+
+// Matches Payload in MeshletMS.hlsl.
+struct Payload
+{
+    uint MeshletIndices[MESHLET_AS_GROUP_SIZE];
+    uint InstanceIndex;
+};
+
+ConstantBuffer<Constants> Globals : register(b0);
+ConstantBuffer<MeshInfoType> MeshInfo : register(b1);
+
+StructuredBuffer<uint> VisibleMeshlets : register(t4);
+StructuredBuffer<uint> VisibleInstances : register(t8);
+ByteAddressBuffer CullData : register(t9);
+
+groupshared Payload s_Payload;
+groupshared uint s_VisibleMask;
+
+bool IsVisible(uint meshletIndex)
+{
+    // 24 byte CullData: the sphere, the cone's bytes, then ApexOffset already divided by the axis length (CullDataToGpu).
+    float4 sphere = asfloat(CullData.Load4(meshletIndex * 24));
+    uint2 cone = CullData.Load2(meshletIndex * 24 + 16);
+
+    [unroll]
+    for (uint i = 0; i < 6; i++)
+    {
+        float4 plane = Globals.CullPlanes[i];
+
+        if (!CullSpherePlane(sphere.x, sphere.y, sphere.z, sphere.w, plane.x, plane.y, plane.z, plane.w))
+            return false;
+    }
+
+    // Cone is degenerate - spread is wider than a hemisphere.
+    uint cutoff = cone.x >> 24;
+
+    if (cutoff == 0xFF)
+        return true;
+
+    return CullNormalCone(sphere.x, sphere.y, sphere.z,
+        CullDecodeAxis(float(cone.x & 0xFF)), CullDecodeAxis(float((cone.x >> 8) & 0xFF)), CullDecodeAxis(float((cone.x >> 16) & 0xFF)),
+        CullDecodeCutoff(float(cutoff)), asfloat(cone.y),
+        Globals.CullViewPosition.x, Globals.CullViewPosition.y, Globals.CullViewPosition.z);
+}
+
+[NumThreads(MESHLET_AS_GROUP_SIZE, 1, 1)]
+void main(
+    uint gtid : SV_GroupThreadID,
+    uint2 gid : SV_GroupID
+)
+{
+    if (gtid == 0)
+    {
+        s_VisibleMask = 0;
+        s_Payload.InstanceIndex = MeshInfo.Instanced ? VisibleInstances[MeshInfo.InstanceOffset + gid.y] : 0;
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+
+    // MeshletOffset points into the cpu's list of the draw's MeshletCount meshlets, a group of them along x per
+    // amplification group; instanced draws have an instance per group along y.
+    uint candidate = gid.x * MESHLET_AS_GROUP_SIZE + gtid;
+    uint meshletIndex = 0;
+    bool visible = false;
+
+    if (candidate < MeshInfo.MeshletCount)
+    {
+        meshletIndex = VisibleMeshlets[MeshInfo.MeshletOffset + candidate];
+        visible = !MeshInfo.CullMeshlets || IsVisible(meshletIndex);
+    }
+
+    if (visible)
+    {
+        InterlockedOr(s_VisibleMask, 1u << gtid);
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+
+    // Survivors are packed in the order they came in, as CullMeshlets lists them, whatever the wave size.
+    if (visible)
+    {
+        s_Payload.MeshletIndices[countbits(s_VisibleMask & ((1u << gtid) - 1))] = meshletIndex;
+    }
+
+    DispatchMesh(countbits(s_VisibleMask), 1, 1, s_Payload);
+}
@@ -0,0 +1,855 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "MeshletBuilder.h"
+#include "MeshBounds.h"
+#include "Platform.h"
+
+//triangles per parallel work item, in morton order. big enough that the ragged meshlets at chunk edges are noise
+#define MESHLET_CHUNK_TRIANGLES 16384
+
+//open addressing table mapping mesh vertex -> meshlet local index, at least twice MESHLET_MAX_VERTICES_LIMIT
+#define MESHLET_VERTEX_TABLE_SIZE 512
+
+static const uint32_t EMPTY_SLOT = UINT32_MAX;
+
+struct BuildJob
+{
+	const struct Mesh* Mesh;
+	const float* Positions;
+	uint32_t PositionStride;
+
+	uint32_t MaxVertices;
+	uint32_t MaxPrimitives;
+
+	//per triangle, indexed by global triangle id (index offset / 3)
+	uint32_t* Triangles;//3 vertex ids
+	float* Centroids;//xyz
+	uint32_t* Rank;//position in the sorted order; chunk = Rank / MESHLET_CHUNK_TRIANGLES
+	uint8_t* Used;
+	uint32_t* Stamp;//chunk local meshlet number + 1 that last queued the triangle as a candidate
+	uint8_t* Missing;//vertices of a queued triangle not yet in the meshlet, valid while Stamp matches
+
+	//vertex -> adjacent triangles, CSR
+	uint32_t* AdjacencyOffsets;
+	uint32_t* Adjacency;
+
+	uint32_t* SortedTriangles;//triangle ids in morton order, subsets back to back
+
+	struct Chunk* Chunks;
+	uint32_t ChunkCount;
+
+	volatile uint32_t bOutOfMemory;
+};
+
+struct Chunk
+{
+	uint32_t Begin;//into SortedTriangles
+	uint32_t End;
+	uint32_t SubsetIndex;
+
+	struct Meshlet* Meshlets;
+	uint32_t MeshletCount;
+
+	uint32_t* VertexIndices;
+	uint32_t VertexIndexCount;
+
+	struct PackedTriangle* Primitives;
+	uint32_t PrimitiveCount;
+};
+
+static inline uint32_t ReadIndex(const struct Mesh* Mesh, uint32_t i)
+{
+	if (Mesh->IndexSize == 2)
+		return ((const uint16_t*)Mesh->IndexBuffer)[i];
+
+	return ((const uint32_t*)Mesh->IndexBuffer)[i];
+}
+
+static inline uint32_t ReadUniqueVertexIndex(const struct Mesh* Mesh, const uint8_t* UniqueVertexIndices, uint32_t i)
+{
+	if (Mesh->IndexSize == 2)
+		return ((const uint16_t*)UniqueVertexIndices)[i];
+
+	return ((const uint32_t*)UniqueVertexIndices)[i];
+}
+
+static inline const float* GetPosition(const struct BuildJob* Job, uint32_t Vertex)
+{
+	return (const float*)((const uint8_t*)Job->Positions + (size_t)Vertex * Job->PositionStride);
+}
+
+static inline uint32_t SpreadBits10(uint32_t x)
+{
+	x &= 0x3FF;
+	x = (x | (x << 16)) & 0x030000FF;
+	x = (x | (x << 8)) & 0x0300F00F;
+	x = (x | (x << 4)) & 0x030C30C3;
+	x = (x | (x << 2)) & 0x09249249;
+	return x;
+}
+
+//lsd radix sort of Values by 30 bit Keys, 3 passes of 10 bits. Scratch holds Count keys and values
+static void RadixSort30(uint32_t* Keys, uint32_t* Values, uint32_t* ScratchKeys, uint32_t* ScratchValues, uint32_t Count)
+{
+	for (uint32_t Shift = 0; Shift < 30; Shift += 10)
+	{
+		uint32_t Histogram[1024] = { 0 };
+
+		for (uint32_t i = 0; i < Count; i++)
+			Histogram[(Keys[i] >> Shift) & 0x3FF]++;
+
+		uint32_t Sum = 0;
+		for (uint32_t i = 0; i < 1024; i++)
+		{
+			const uint32_t c = Histogram[i];
+			Histogram[i] = Sum;
+			Sum += c;
+		}
+
+		for (uint32_t i = 0; i < Count; i++)
+		{
+			const uint32_t Slot = Histogram[(Keys[i] >> Shift) & 0x3FF]++;
+			ScratchKeys[Slot] = Keys[i];
+			ScratchValues[Slot] = Values[i];
+		}
+
+		memcpy(Keys, ScratchKeys, sizeof(uint32_t) * Count);
+		memcpy(Values, ScratchValues, sizeof(uint32_t) * Count);
+	}
+}
+
+static inline uint32_t HashVertex(uint32_t Vertex)
+{
+	return (Vertex * 2654435761u) & (MESHLET_VERTEX_TABLE_SIZE - 1);
+}
+
+struct VertexTable
+{
+	uint32_t Keys[MESHLET_VERTEX_TABLE_SIZE];
+	uint8_t Values[MESHLET_VERTEX_TABLE_SIZE];//local index, < MESHLET_MAX_VERTICES_LIMIT
+};
+
+static inline int32_t FindVertex(const struct VertexTable* Table, uint32_t Vertex)
+{
+	for (uint32_t Slot = HashVertex(Vertex);; Slot = (Slot + 1) & (MESHLET_VERTEX_TABLE_SIZE - 1))
+	{
+		if (Table->Keys[Slot] == Vertex)
+			return Table->Values[Slot];
+
+		if (Table->Keys[Slot] == EMPTY_SLOT)
+			return -1;
+	}
+}
+
+static inline void InsertVertex(struct VertexTable* Table, uint32_t Vertex, uint32_t LocalIndex)
+{
+	uint32_t Slot = HashVertex(Vertex);
+
+	while (Table->Keys[Slot] != EMPTY_SLOT)
+		Slot = (Slot + 1) & (MESHLET_VERTEX_TABLE_SIZE - 1);
+
+	Table->Keys[Slot] = Vertex;
+	Table->Values[Slot] = (uint8_t)LocalIndex;
+}
+
+static inline uint32_t CountNewVertices(const struct VertexTable* Table, const uint32_t* Triangle)
+{
+	uint32_t NewCount = 0;
+
+	for (int k = 0; k < 3; k++)
+	{
+		if (FindVertex(Table, Triangle[k]) < 0)
+			NewCount++;
+	}
+
+	return NewCount;
+}
+
+void ComputeMeshletCullData(const struct Mesh* Mesh, const struct Meshlet* Meshlet, const uint8_t* UniqueVertexIndices, const struct PackedTriangle* PrimitiveIndices, struct CullData* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+	const uint8_t* PositionBase = Mesh->VertexBuffers[Slot].Verts + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_POSITION];
+	const uint32_t Stride = Mesh->VertexBuffers[Slot].Stride;
+
+	float Points[MESHLET_MAX_VERTICES_LIMIT][3];
+	const uint32_t VertCount = Meshlet->VertCount < MESHLET_MAX_VERTICES_LIMIT ? Meshlet->VertCount : MESHLET_MAX_VERTICES_LIMIT;
+
+	for (uint32_t i = 0; i < VertCount; i++)
+	{
+		const uint32_t Vertex = ReadUniqueVertexIndex(Mesh, UniqueVertexIndices, Meshlet->VertOffset + i);
+		memcpy(Points[i], PositionBase + (size_t)Vertex * Stride, sizeof(float) * 3);
+	}
+
+	struct BoundingSphere Sphere;
+	ComputeBoundingSphere(&Points[0][0], sizeof(float) * 3, VertCount, SIMD_LEVEL_SCALAR, 1, &Sphere);
+
+	memcpy(Out->BoundingSphere, Sphere.Center, sizeof(float) * 3);
+	Out->BoundingSphere[3] = Sphere.Radius;
+
+	// Face normals of the non degenerate triangles.
+	float Normals[MESHLET_MAX_PRIMITIVES_LIMIT][3];
+	uint32_t FirstPoint[MESHLET_MAX_PRIMITIVES_LIMIT];
+	uint32_t NormalCount = 0;
+
+	for (uint32_t i = 0; i < Meshlet->PrimCount && NormalCount < MESHLET_MAX_PRIMITIVES_LIMIT; i++)
+	{
+		const struct PackedTriangle Triangle = PrimitiveIndices[Meshlet->PrimOffset + i];
+
+		if (Triangle.i0 >= VertCount || Triangle.i1 >= VertCount || Triangle.i2 >= VertCount)
+			continue;
+
+		const float* p0 = Points[Triangle.i0];
+		const float* p1 = Points[Triangle.i1];
+		const float* p2 = Points[Triangle.i2];
+
+		const float e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const float e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+		//cross(p1 - p0, p2 - p0), the same convention DirectXMesh's ComputeCullData uses by default
+		float n[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+		const float Length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+		if (!(Length > FLT_MIN))
+			continue;
+
+		Normals[NormalCount][0] = n[0] / Length;
+		Normals[NormalCount][1] = n[1] / Length;
+		Normals[NormalCount][2] = n[2] / Length;
+		FirstPoint[NormalCount] = Triangle.i0;
+		NormalCount++;
+	}
+
+	// 0xFF in w marks the cone as degenerate; the culler then only runs the frustum test.
+	Out->NormalCone[3] = 0xFF;
+
+	if (NormalCount == 0)
+		return;
+
+	// Axis = center of the sphere around the normal tips.
+	struct BoundingSphere NormalSphere;
+	ComputeBoundingSphere(&Normals[0][0], sizeof(float) * 3, NormalCount, SIMD_LEVEL_SCALAR, 1, &NormalSphere);
+
+	float Axis[3] = { NormalSphere.Center[0], NormalSphere.Center[1], NormalSphere.Center[2] };
+	float AxisLength = sqrtf(Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2]);
+
+	if (!(AxisLength > 1e-6f))
+		return;
+
+	// Quantize the axis, then measure the spread against the axis the culler will actually decode.
+	uint8_t Quantized[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const float Unorm = (Axis[i] / AxisLength) * 0.5f + 0.5f;
+		const float Scaled = floorf(Unorm * 255.0f + 0.5f);
+		Quantized[i] = (uint8_t)(Scaled < 0.0f ? 0.0f : Scaled > 255.0f ? 255.0f : Scaled);
+		Axis[i] = Quantized[i] * (1.0f / 255.0f) * 2.0f - 1.0f;
+	}
+
+	AxisLength = sqrtf(Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2]);
+	for (int i = 0; i < 3; i++)
+		Axis[i] /= AxisLength;
+
+	float MinDot = 1.0f;
+	for (uint32_t i = 0; i < NormalCount; i++)
+	{
+		const float d = Normals[i][0] * Axis[0] + Normals[i][1] * Axis[1] + Normals[i][2] * Axis[2];
+		MinDot = fminf(MinDot, d);
+	}
+
+	// Spread wider than ~84 degrees: the apex would run off to infinity, so don't cone cull at all.
+	if (MinDot <= 0.1f)
+		return;
+
+	// w = -cos(a + 90) = sin(a); rounded up so the quantized cone is never narrower than the real one.
+	const float Sin = sqrtf(fmaxf(0.0f, 1.0f - MinDot * MinDot));
+	const float Cutoff = ceilf(Sin * 255.0f);
+
+	if (Cutoff >= 255.0f)
+		return;
+
+	// The apex sits far enough behind the center that every triangle plane is in front of it.
+	float ApexOffset = 0.0f;
+	for (uint32_t i = 0; i < NormalCount; i++)
+	{
+		const float* p = Points[FirstPoint[i]];
+		const float c[3] = { Sphere.Center[0] - p[0], Sphere.Center[1] - p[1], Sphere.Center[2] - p[2] };
+
+		const float dc = c[0] * Normals[i][0] + c[1] * Normals[i][1] + c[2] * Normals[i][2];
+		const float dn = Axis[0] * Normals[i][0] + Axis[1] * Normals[i][1] + Axis[2] * Normals[i][2];
+
+		ApexOffset = fmaxf(ApexOffset, dc / dn);
+	}
+
+	Out->NormalCone[0] = Quantized[0];
+	Out->NormalCone[1] = Quantized[1];
+	Out->NormalCone[2] = Quantized[2];
+	Out->NormalCone[3] = (uint8_t)Cutoff;
+	Out->ApexOffset = ApexOffset;
+}
+
+static void BuildChunk(struct BuildJob* Job, struct Chunk* Chunk)
+{
+	const uint32_t TriangleCount = Chunk->End - Chunk->Begin;
+	const uint32_t ChunkIndex = (uint32_t)(Chunk - Job->Chunks);
+
+	Chunk->Meshlets = malloc(sizeof(struct Meshlet) * TriangleCount);
+	Chunk->VertexIndices = malloc(sizeof(uint32_t) * TriangleCount * 3);
+	Chunk->Primitives = malloc(sizeof(struct PackedTriangle) * TriangleCount);
+
+	//candidates hold triangles adjacent to the current meshlet; when a meshlet closes, its leftovers seed the next one
+	uint32_t CandidateCapacity = 1024;
+	uint32_t* Candidates = malloc(sizeof(uint32_t) * CandidateCapacity);
+
+	struct VertexTable* Table = malloc(sizeof(struct VertexTable));
+
+	if (Chunk->Meshlets == NULL || Chunk->VertexIndices == NULL || Chunk->Primitives == NULL || Candidates == NULL || Table == NULL)
+	{
+		free(Candidates);
+		free(Table);
+		Job->bOutOfMemory = 1;
+		return;
+	}
+
+	uint32_t CandidateCount = 0;
+	uint32_t ScanCursor = Chunk->Begin;
+	uint32_t Remaining = TriangleCount;
+
+	while (Remaining > 0)
+	{
+		memset(Table->Keys, 0xFF, sizeof(Table->Keys));
+
+		struct Meshlet* Meshlet = &Chunk->Meshlets[Chunk->MeshletCount];
+		Meshlet->VertOffset = Chunk->VertexIndexCount;
+		Meshlet->VertCount = 0;
+		Meshlet->PrimOffset = Chunk->PrimitiveCount;
+		Meshlet->PrimCount = 0;
+
+		float CentroidSum[3] = { 0.0f, 0.0f, 0.0f };
+
+		while (Meshlet->PrimCount < Job->MaxPrimitives && Remaining > 0)
+		{
+			const float Inverse = Meshlet->PrimCount ? 1.0f / Meshlet->PrimCount : 0.0f;
+			const float Center[3] = { CentroidSum[0] * Inverse, CentroidSum[1] * Inverse, CentroidSum[2] * Inverse };
+
+			uint32_t Best = UINT32_MAX;
+			uint32_t BestSlot = 0;
+			uint32_t BestNew = 4;
+			float BestDistance = FLT_MAX;
+
+			uint32_t Kept = 0;
+
+			for (uint32_t i = 0; i < CandidateCount; i++)
+			{
+				const uint32_t Triangle = Candidates[i];
+
+				if (Job->Used[Triangle])
+					continue;
+
+				Candidates[Kept++] = Triangle;
+
+				const uint32_t NewCount = Meshlet->PrimCount ? Job->Missing[Triangle] : 3;
+
+				if (Meshlet->VertCount + NewCount > Job->MaxVertices || NewCount > BestNew)
+					continue;
+
+				// A fresh meshlet seeds from the earliest leftover in morton order, which fills holes left behind.
+				float Distance;
+				if (Meshlet->PrimCount == 0)
+				{
+					Distance = (float)Job->Rank[Triangle];
+				}
+				else
+				{
+					const float* c = &Job->Centroids[Triangle * 3];
+					Distance = (c[0] - Center[0]) * (c[0] - Center[0]) + (c[1] - Center[1]) * (c[1] - Center[1]) + (c[2] - Center[2]) * (c[2] - Center[2]);
+				}
+
+				if (NewCount < BestNew || Distance < BestDistance)
+				{
+					Best = Triangle;
+					BestSlot = Kept - 1;
+					BestNew = NewCount;
+					BestDistance = Distance;
+				}
+			}
+
+			CandidateCount = Kept;
+
+			if (Best != UINT32_MAX)
+			{
+				Candidates[BestSlot] = Candidates[--CandidateCount];
+			}
+			else
+			{
+				// Nothing connected fits: restart from the next unused triangle along the curve, if it fits.
+				while (Job->Used[Job->SortedTriangles[ScanCursor]])
+					ScanCursor++;
+
+				Best = Job->SortedTriangles[ScanCursor];
+
+				if (Meshlet->VertCount + CountNewVertices(Table, &Job->Triangles[Best * 3]) > Job->MaxVertices)
+					break;
+			}
+
+			Job->Used[Best] = 1;
+			Remaining--;
+
+			// The seed is picked; the previous meshlet's leftovers are no longer interesting.
+			if (Meshlet->PrimCount == 0)
+				CandidateCount = 0;
+
+			const uint32_t MeshletStamp = Chunk->MeshletCount + 1;
+
+			const uint32_t* Triangle = &Job->Triangles[Best * 3];
+			uint32_t Local[3];
+
+			for (int k = 0; k < 3; k++)
+			{
+				int32_t Index = FindVertex(Table, Triangle[k]);
+
+				if (Index < 0)
+				{
+					Index = (int32_t)Meshlet->VertCount++;
+					InsertVertex(Table, Triangle[k], (uint32_t)Index);
+					Chunk->VertexIndices[Chunk->VertexIndexCount++] = Triangle[k];
+
+					// Every unused neighbor in this chunk becomes a candidate.
+					for (uint32_t a = Job->AdjacencyOffsets[Triangle[k]]; a < Job->AdjacencyOffsets[Triangle[k] + 1]; a++)
+					{
+						const uint32_t Neighbor = Job->Adjacency[a];
+
+						//rank first: Used flags of other chunks are being written by other threads
+						if (Job->Rank[Neighbor] / MESHLET_CHUNK_TRIANGLES != ChunkIndex || Job->Used[Neighbor])
+							continue;
+
+						// Already queued: it just lost one missing vertex. New: count once, then keep it up to date.
+						if (Job->Stamp[Neighbor] == MeshletStamp)
+						{
+							Job->Missing[Neighbor]--;
+							continue;
+						}
+
+						Job->Stamp[Neighbor] = MeshletStamp;
+						Job->Missing[Neighbor] = (uint8_t)CountNewVertices(Table, &Job->Triangles[Neighbor * 3]);
+
+						if (CandidateCount == CandidateCapacity)
+						{
+							uint32_t* Grown = realloc(Candidates, sizeof(uint32_t) * CandidateCapacity * 2);
+
+							if (Grown == NULL)
+								continue;
+
+							Candidates = Grown;
+							CandidateCapacity *= 2;
+						}
+
+						Candidates[CandidateCount++] = Neighbor;
+					}
+				}
+
+				Local[k] = (uint32_t)Index;
+			}
+
+			//cleared first so the two spare bits are deterministic
+			struct PackedTriangle Packed;
+			memset(&Packed, 0, sizeof(Packed));
+			Packed.i0 = Local[0];
+			Packed.i1 = Local[1];
+			Packed.i2 = Local[2];
+			Chunk->Primitives[Chunk->PrimitiveCount++] = Packed;
+			Meshlet->PrimCount++;
+
+			const float* c = &Job->Centroids[Best * 3];
+			CentroidSum[0] += c[0];
+			CentroidSum[1] += c[1];
+			CentroidSum[2] += c[2];
+		}
+
+		Chunk->MeshletCount++;
+	}
+
+	free(Candidates);
+	free(Table);
+}
+
+static void BuildChunkTask(void* Context, uint32_t TaskIndex)
+{
+	struct BuildJob* Job = Context;
+	BuildChunk(Job, &Job->Chunks[TaskIndex]);
+}
+
+struct CullDataJob
+{
+	const struct Mesh* Mesh;
+	struct MeshletData* Data;
+};
+
+static void CullDataTask(void* Context, uint32_t TaskIndex)
+{
+	struct CullDataJob* Job = Context;
+
+	//one task per 256 meshlets
+	const uint32_t Begin = TaskIndex * 256;
+	const uint32_t End = Begin + 256 < Job->Data->MeshletCount ? Begin + 256 : Job->Data->MeshletCount;
+
+	for (uint32_t i = Begin; i < End; i++)
+		ComputeMeshletCullData(Job->Mesh, &Job->Data->Meshlets[i], Job->Data->UniqueVertexIndices, Job->Data->PrimitiveIndices, &Job->Data->CullingData[i]);
+}
+
+static void FreeBuildJob(struct BuildJob* Job)
+{
+	if (Job->Chunks)
+	{
+		for (uint32_t i = 0; i < Job->ChunkCount; i++)
+		{
+			free(Job->Chunks[i].Meshlets);
+			free(Job->Chunks[i].VertexIndices);
+			free(Job->Chunks[i].Primitives);
+		}
+	}
+
+	free(Job->Chunks);
+	free(Job->Triangles);
+	free(Job->Centroids);
+	free(Job->Rank);
+	free(Job->Used);
+	free(Job->Stamp);
+	free(Job->Missing);
+	free(Job->AdjacencyOffsets);
+	free(Job->Adjacency);
+	free(Job->SortedTriangles);
+}
+
+enum MeshletBuildResult BuildMeshlets(const struct Mesh* Mesh, uint32_t MaxVertices, uint32_t MaxPrimitives, uint32_t ThreadCount, struct MeshletData* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	//a triangle needs 3 vertices, and 10 bit packed triangle indices cap out well above the shader limits
+	if (MaxVertices < 3 || MaxVertices > MESHLET_MAX_VERTICES_LIMIT || MaxPrimitives < 1 || MaxPrimitives > MESHLET_MAX_PRIMITIVES_LIMIT)
+		return MESHLET_BUILD_ERROR_LIMITS;
+
+	const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+
+	if (Slot == MESHFILE_ATTRIBUTE_NONE)
+		return MESHLET_BUILD_ERROR_NO_POSITIONS;
+
+	if (Mesh->IndexSize != 2 && Mesh->IndexSize != 4)
+		return MESHLET_BUILD_ERROR_INDICES;
+
+	uint64_t TotalTriangleCount = 0;
+
+	for (uint32_t i = 0; i < Mesh->IndexSubsetCount; i++)
+	{
+		const struct Subset* IndexSubset = &Mesh->IndexSubsets[i];
+
+		if (IndexSubset->Count % 3 != 0 || (uint64_t)IndexSubset->Offset + IndexSubset->Count > Mesh->IndexCount)
+			return MESHLET_BUILD_ERROR_INDICES;
+
+		TotalTriangleCount += IndexSubset->Count / 3;
+	}
+
+	for (uint32_t i = 0; i < Mesh->IndexCount; i++)
+	{
+		if (ReadIndex(Mesh, i) >= Mesh->VertexCount)
+			return MESHLET_BUILD_ERROR_INDICES;
+	}
+
+	if (TotalTriangleCount > UINT32_MAX / 3)
+		return MESHLET_BUILD_ERROR_INDICES;
+
+	struct BuildJob Job = { 0 };
+	Job.Mesh = Mesh;
+	Job.Positions = (const float*)(Mesh->VertexBuffers[Slot].Verts + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_POSITION]);
+	Job.PositionStride = Mesh->VertexBuffers[Slot].Stride;
+	Job.MaxVertices = MaxVertices;
+	Job.MaxPrimitives = MaxPrimitives;
+
+	//triangle ids are index offset / 3 so overlapping subsets never alias
+	const uint32_t TriangleIdCount = Mesh->IndexCount / 3;
+
+	Job.Triangles = malloc(sizeof(uint32_t) * 3 * (size_t)TriangleIdCount + 1);
+	Job.Centroids = malloc(sizeof(float) * 3 * (size_t)TriangleIdCount + 1);
+	Job.Rank = malloc(sizeof(uint32_t) * (size_t)TriangleIdCount + 1);
+	Job.Used = calloc((size_t)TriangleIdCount + 1, 1);
+	Job.Stamp = calloc((size_t)TriangleIdCount + 1, sizeof(uint32_t));
+	Job.Missing = malloc((size_t)TriangleIdCount + 1);
+	Job.AdjacencyOffsets = calloc((size_t)Mesh->VertexCount + 1, sizeof(uint32_t));
+	Job.Adjacency = malloc(sizeof(uint32_t) * 3 * (size_t)TotalTriangleCount + 1);
+	Job.SortedTriangles = malloc(sizeof(uint32_t) * (size_t)TotalTriangleCount + 1);
+
+	uint32_t* Keys = malloc(sizeof(uint32_t) * (size_t)TotalTriangleCount + 1);
+	uint32_t* ScratchKeys = malloc(sizeof(uint32_t) * (size_t)TotalTriangleCount + 1);
+	uint32_t* ScratchValues = malloc(sizeof(uint32_t) * (size_t)TotalTriangleCount + 1);
+
+	Job.ChunkCount = 0;
+	for (uint32_t i = 0; i < Mesh->IndexSubsetCount; i++)
+		Job.ChunkCount += (Mesh->IndexSubsets[i].Count / 3 + MESHLET_CHUNK_TRIANGLES - 1) / MESHLET_CHUNK_TRIANGLES;
+
+	Job.Chunks = calloc(Job.ChunkCount + 1, sizeof(struct Chunk));
+
+	Out->MeshletSubsets = calloc(Mesh->IndexSubsetCount + 1, sizeof(struct Subset));
+
+	if (Job.Triangles == NULL || Job.Centroids == NULL || Job.Rank == NULL || Job.Used == NULL || Job.Stamp == NULL || Job.Missing == NULL || Job.AdjacencyOffsets == NULL || Job.Adjacency == NULL ||
+		Job.SortedTriangles == NULL || Keys == NULL || ScratchKeys == NULL || ScratchValues == NULL || Job.Chunks == NULL || Out->MeshletSubsets == NULL)
+		goto out_of_memory;
+
+	for (uint32_t t = 0; t < TriangleIdCount; t++)
+	{
+		float* c = &Job.Centroids[t * 3];
+		c[0] = c[1] = c[2] = 0.0f;
+
+		for (int k = 0; k < 3; k++)
+		{
+			const uint32_t Vertex = ReadIndex(Mesh, t * 3 + k);
+			const float* p = GetPosition(&Job, Vertex);
+
+			Job.Triangles[t * 3 + k] = Vertex;
+			c[0] += p[0] * (1.0f / 3.0f);
+			c[1] += p[1] * (1.0f / 3.0f);
+			c[2] += p[2] * (1.0f / 3.0f);
+		}
+	}
+
+	// Sort each subset's triangles along a morton curve over the subset's bounds and cut it into chunks.
+	uint32_t SortedCount = 0;
+	uint32_t ChunkCount = 0;
+
+	for (uint32_t s = 0; s < Mesh->IndexSubsetCount; s++)
+	{
+		const uint32_t First = Mesh->IndexSubsets[s].Offset / 3;
+		const uint32_t Count = Mesh->IndexSubsets[s].Count / 3;
+
+		float Min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float Max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (uint32_t t = First; t < First + Count; t++)
+		{
+			for (int a = 0; a < 3; a++)
+			{
+				Min[a] = fminf(Min[a], Job.Centroids[t * 3 + a]);
+				Max[a] = fmaxf(Max[a], Job.Centroids[t * 3 + a]);
+			}
+		}
+
+		float Scale[3];
+		for (int a = 0; a < 3; a++)
+			Scale[a] = Max[a] > Min[a] ? 1023.0f / (Max[a] - Min[a]) : 0.0f;
+
+		uint32_t* SubsetKeys = Keys + SortedCount;
+		uint32_t* SubsetTriangles = Job.SortedTriangles + SortedCount;
+
+		for (uint32_t i = 0; i < Count; i++)
+		{
+			const float* c = &Job.Centroids[(First + i) * 3];
+
+			SubsetKeys[i] =
+				SpreadBits10((uint32_t)((c[0] - Min[0]) * Scale[0])) |
+				SpreadBits10((uint32_t)((c[1] - Min[1]) * Scale[1])) << 1 |
+				SpreadBits10((uint32_t)((c[2] - Min[2]) * Scale[2])) << 2;
+
+			SubsetTriangles[i] = First + i;
+		}
+
+		RadixSort30(SubsetKeys, SubsetTriangles, ScratchKeys, ScratchValues, Count);
+
+		for (uint32_t Begin = 0; Begin < Count; Begin += MESHLET_CHUNK_TRIANGLES)
+		{
+			struct Chunk* Chunk = &Job.Chunks[ChunkCount];
+			Chunk->Begin = SortedCount + Begin;
+			Chunk->End = SortedCount + (Begin + MESHLET_CHUNK_TRIANGLES < Count ? Begin + MESHLET_CHUNK_TRIANGLES : Count);
+			Chunk->SubsetIndex = s;
+
+			//ranks are padded so every chunk starts on a multiple of MESHLET_CHUNK_TRIANGLES
+			for (uint32_t i = Chunk->Begin; i < Chunk->End; i++)
+				Job.Rank[Job.SortedTriangles[i]] = ChunkCount * MESHLET_CHUNK_TRIANGLES + (i - Chunk->Begin);
+
+			ChunkCount++;
+		}
+
+		SortedCount += Count;
+	}
+
+	free(Keys);
+	free(ScratchKeys);
+	free(ScratchValues);
+	Keys = ScratchKeys = ScratchValues = NULL;
+
+	// Vertex -> triangle adjacency over every triangle that belongs to some subset.
+	for (uint32_t i = 0; i < SortedCount; i++)
+	{
+		for (int k = 0; k < 3; k++)
+			Job.AdjacencyOffsets[Job.Triangles[Job.SortedTriangles[i] * 3 + k] + 1]++;
+	}
+
+	for (uint32_t v = 0; v < Mesh->VertexCount; v++)
+		Job.AdjacencyOffsets[v + 1] += Job.AdjacencyOffsets[v];
+
+	for (uint32_t i = 0; i < SortedCount; i++)
+	{
+		const uint32_t Triangle = Job.SortedTriangles[i];
+
+		for (int k = 0; k < 3; k++)
+		{
+			//reuse the adjacency offsets as fill cursors, then shift them back
+			Job.Adjacency[Job.AdjacencyOffsets[Job.Triangles[Triangle * 3 + k]]++] = Triangle;
+		}
+	}
+
+	for (uint32_t v = Mesh->VertexCount; v > 0; v--)
+		Job.AdjacencyOffsets[v] = Job.AdjacencyOffsets[v - 1];
+	Job.AdjacencyOffsets[0] = 0;
+
+	PlatformParallelFor(Job.ChunkCount, ThreadCount, BuildChunkTask, &Job);
+
+	if (Job.bOutOfMemory)
+		goto out_of_memory;
+
+	// Concatenate the chunks in order and rebase their offsets.
+	uint64_t MeshletCount = 0;
+	uint64_t VertexIndexCount = 0;
+	uint64_t PrimitiveCount = 0;
+
+	for (uint32_t i = 0; i < Job.ChunkCount; i++)
+	{
+		MeshletCount += Job.Chunks[i].MeshletCount;
+		VertexIndexCount += Job.Chunks[i].VertexIndexCount;
+		PrimitiveCount += Job.Chunks[i].PrimitiveCount;
+	}
+
+	if (VertexIndexCount * Mesh->IndexSize > UINT32_MAX)
+		goto out_of_memory;
+
+	Out->MeshletSubsetCount = Mesh->IndexSubsetCount;
+	Out->Meshlets = malloc(sizeof(struct Meshlet) * MeshletCount + 1);
+	//padded to whole dwords: the mesh shader reads 16 bit indices in pairs through a ByteAddressBuffer
+	Out->UniqueVertexIndices = calloc((Mesh->IndexSize * VertexIndexCount + 3) & ~3ull, 1);
+	Out->PrimitiveIndices = malloc(sizeof(struct PackedTriangle) * PrimitiveCount + 1);
+	Out->CullingData = malloc(sizeof(struct CullData) * MeshletCount + 1);
+
+	if (Out->Meshlets == NULL || Out->UniqueVertexIndices == NULL || Out->PrimitiveIndices == NULL || Out->CullingData == NULL)
+		goto out_of_memory;
+
+	for (uint32_t i = 0; i < Job.ChunkCount; i++)
+	{
+		const struct Chunk* Chunk = &Job.Chunks[i];
+		struct Subset* MeshletSubset = &Out->MeshletSubsets[Chunk->SubsetIndex];
+
+		if (MeshletSubset->Count == 0)
+			MeshletSubset->Offset = Out->MeshletCount;
+
+		MeshletSubset->Count += Chunk->MeshletCount;
+
+		for (uint32_t m = 0; m < Chunk->MeshletCount; m++)
+		{
+			struct Meshlet Meshlet = Chunk->Meshlets[m];
+			Meshlet.VertOffset += Out->UniqueVertexIndexCount / Mesh->IndexSize;
+			Meshlet.PrimOffset += Out->PrimitiveIndexCount;
+			Out->Meshlets[Out->MeshletCount++] = Meshlet;
+		}
+
+		for (uint32_t v = 0; v < Chunk->VertexIndexCount; v++)
+		{
+			if (Mesh->IndexSize == 2)
+				((uint16_t*)Out->UniqueVertexIndices)[Out->UniqueVertexIndexCount / 2 + v] = (uint16_t)Chunk->VertexIndices[v];
+			else
+				((uint32_t*)Out->UniqueVertexIndices)[Out->UniqueVertexIndexCount / 4 + v] = Chunk->VertexIndices[v];
+		}
+
+		Out->UniqueVertexIndexCount += Chunk->VertexIndexCount * Mesh->IndexSize;
+
+		memcpy(Out->PrimitiveIndices + Out->PrimitiveIndexCount, Chunk->Primitives, sizeof(struct PackedTriangle) * Chunk->PrimitiveCount);
+		Out->PrimitiveIndexCount += Chunk->PrimitiveCount;
+	}
+
+	// Empty subsets still get a valid offset.
+	for (uint32_t s = 0; s < Out->MeshletSubsetCount; s++)
+	{
+		if (Out->MeshletSubsets[s].Count == 0)
+			Out->MeshletSubsets[s].Offset = s > 0 ? Out->MeshletSubsets[s - 1].Offset + Out->MeshletSubsets[s - 1].Count : 0;
+	}
+
+	Out->UniqueVertexIndexCount = (Out->UniqueVertexIndexCount + 3) & ~3u;
+	Out->CullingDataCount = Out->MeshletCount;
+	Out->MaxVertices = MaxVertices;
+	Out->MaxPrimitives = MaxPrimitives;
+
+	struct CullDataJob CullJob = { .Mesh = Mesh, .Data = Out };
+	PlatformParallelFor((Out->MeshletCount + 255) / 256, ThreadCount, CullDataTask, &CullJob);
+
+	FreeBuildJob(&Job);
+	return MESHLET_BUILD_OK;
+
+out_of_memory:
+	free(Keys);
+	free(ScratchKeys);
+	free(ScratchValues);
+	FreeBuildJob(&Job);
+	MeshletDataFree(Out);
+	return MESHLET_BUILD_ERROR_OUT_OF_MEMORY;
+}
+
+void MeshletDataApply(const struct MeshletData* Data, struct Mesh* Mesh)
+{
+	Mesh->MeshletSubsets = Data->MeshletSubsets;
+	Mesh->MeshletSubsetCount = Data->MeshletSubsetCount;
+	Mesh->Meshlets = Data->Meshlets;
+	Mesh->MeshletCount = Data->MeshletCount;
+	Mesh->UniqueVertexIndices = Data->UniqueVertexIndices;
+	Mesh->UniqueVertexIndexCount = Data->UniqueVertexIndexCount;
+	Mesh->PrimitiveIndices = Data->PrimitiveIndices;
+	Mesh->PrimitiveIndexCount = Data->PrimitiveIndexCount;
+	Mesh->CullingData = Data->CullingData;
+	Mesh->CullingDataCount = Data->CullingDataCount;
+	Mesh->MeshletMaxVertices = Data->MaxVertices;
+	Mesh->MeshletMaxPrimitives = Data->MaxPrimitives;
+	Mesh->MeshletFlags = 0;
+}
+
+void MeshletDataFree(struct MeshletData* Data)
+{
+	free(Data->MeshletSubsets);
+	free(Data->Meshlets);
+	free(Data->UniqueVertexIndices);
+	free(Data->PrimitiveIndices);
+	free(Data->CullingData);
+	memset(Data, 0, sizeof(*Data));
+}
+
+const char* MeshletBuildResultString(enum MeshletBuildResult Result)
+{
+	switch (Result)
+	{
+	case MESHLET_BUILD_OK:
+		return "ok";
+	case MESHLET_BUILD_ERROR_LIMITS:
+		return "meshlet limits out of range";
+	case MESHLET_BUILD_ERROR_NO_POSITIONS:
+		return "mesh has no position attribute";
+	case MESHLET_BUILD_ERROR_INDICES:
+		return "index buffer or index subsets out of range";
+	case MESHLET_BUILD_ERROR_OUT_OF_MEMORY:
+		return "out of memory";
+	default:
+		return "unknown error";
+	}
+}
@@ -0,0 +1,73 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "MeshFile.h"
+
+//builds meshlets from a mesh's IndexBuffer/IndexSubsets and position stream.
+//triangles of each index subset are sorted along a morton curve and cut into fixed size chunks that are
+//meshletized in parallel; inside a chunk meshlets grow greedily, preferring triangles that add the fewest
+//new vertices and then the ones closest to the meshlet's centroid. chunking doesn't depend on the thread
+//count, so the output is identical for any ThreadCount
+
+enum MeshletBuildResult
+{
+	MESHLET_BUILD_OK,
+	MESHLET_BUILD_ERROR_LIMITS,
+	MESHLET_BUILD_ERROR_NO_POSITIONS,
+	MESHLET_BUILD_ERROR_INDICES,
+	MESHLET_BUILD_ERROR_OUT_OF_MEMORY
+};
+
+//owned copies of the meshlet streams of one mesh, laid out exactly like the MSHL file streams
+struct MeshletData
+{
+	struct Subset* MeshletSubsets;//one per index subset
+	uint32_t MeshletSubsetCount;
+
+	struct Meshlet* Meshlets;
+	uint32_t MeshletCount;
+
+	uint8_t* UniqueVertexIndices;//IndexSize wide, like the source index buffer
+	uint32_t UniqueVertexIndexCount;//in bytes
+
+	struct PackedTriangle* PrimitiveIndices;
+	uint32_t PrimitiveIndexCount;
+
+	struct CullData* CullingData;
+	uint32_t CullingDataCount;
+
+	//what the meshlets were built with
+	uint32_t MaxVertices;
+	uint32_t MaxPrimitives;
+};
+
+//ThreadCount 0 = one per processor
+enum MeshletBuildResult BuildMeshlets(const struct Mesh* Mesh, uint32_t MaxVertices, uint32_t MaxPrimitives, uint32_t ThreadCount, struct MeshletData* Out);
+
+//points Mesh's meshlet fields at Data; Data must outlive Mesh's use of them. the meshlets are indexed, whatever
+//Mesh's MeshletFlags were
+void MeshletDataApply(const struct MeshletData* Data, struct Mesh* Mesh);
+
+void MeshletDataFree(struct MeshletData* Data);
+
+//fills in the bounding sphere and normal cone of one meshlet the same way the builder does
+void ComputeMeshletCullData(const struct Mesh* Mesh, const struct Meshlet* Meshlet, const uint8_t* UniqueVertexIndices, const struct PackedTriangle* PrimitiveIndices, struct CullData* Out);
+
+const char* MeshletBuildResultString(enum MeshletBuildResult Result);
@@ -0,0 +1,302 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include "MeshletCull.h"
+#include "MeshletCullMath.h"
+
+#ifdef PLATFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef PLATFORM_AVX2
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(struct CullData) == 24, "simd loads assume the packed 24 byte CullData layout");
+
+void CullFrustumFromMatrix(const float ViewProj[16], const float ViewPosition[3], struct CullFrustum* Out)
+{
+	//row r of a column-major matrix is { m[r], m[4 + r], m[8 + r], m[12 + r] }
+	float Rows[4][4];
+	for (int r = 0; r < 4; r++)
+	{
+		for (int c = 0; c < 4; c++)
+			Rows[r][c] = ViewProj[c * 4 + r];
+	}
+
+	for (int c = 0; c < 4; c++)
+	{
+		Out->Planes[0][c] = Rows[3][c] + Rows[0][c];// left
+		Out->Planes[1][c] = Rows[3][c] - Rows[0][c];// right
+		Out->Planes[2][c] = Rows[3][c] + Rows[1][c];// bottom
+		Out->Planes[3][c] = Rows[3][c] - Rows[1][c];// top
+		Out->Planes[4][c] = Rows[3][c] + Rows[2][c];// near, -w <= z; also conservative for [0,1] depth
+		Out->Planes[5][c] = Rows[3][c] - Rows[2][c];// far
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		const float Length = sqrtf(Out->Planes[i][0] * Out->Planes[i][0] + Out->Planes[i][1] * Out->Planes[i][1] + Out->Planes[i][2] * Out->Planes[i][2]);
+		const float Scale = Length > 0.0f ? 1.0f / Length : 0.0f;
+
+		for (int c = 0; c < 4; c++)
+			Out->Planes[i][c] *= Scale;
+	}
+
+	Out->ViewPosition[0] = ViewPosition[0];
+	Out->ViewPosition[1] = ViewPosition[1];
+	Out->ViewPosition[2] = ViewPosition[2];
+}
+
+float CullApexScale(const struct CullData* CullData)
+{
+	const float LengthSquared = CullAxisLengthSquared(CullDecodeAxis(CullData->NormalCone[0]), CullDecodeAxis(CullData->NormalCone[1]), CullDecodeAxis(CullData->NormalCone[2]));
+
+	//no byte decodes to 0, so the axis never has zero length
+	return CullData->ApexOffset / sqrtf(LengthSquared);
+}
+
+void CullDataToGpu(const struct CullData* In, uint32_t Count, struct CullData* Out)
+{
+	for (uint32_t i = 0; i < Count; i++)
+	{
+		struct CullData CullData = In[i];
+		CullData.ApexOffset = CullApexScale(&In[i]);
+		Out[i] = CullData;
+	}
+}
+
+bool CullMeshletVisible(const struct CullFrustum* Frustum, const struct CullData* CullData)
+{
+	const float* Sphere = CullData->BoundingSphere;
+
+	// Do a cull test of the bounding sphere against the view frustum planes.
+	for (int i = 0; i < 6; i++)
+	{
+		const float* Plane = Frustum->Planes[i];
+
+		if (!CullSpherePlane(Sphere[0], Sphere[1], Sphere[2], Sphere[3], Plane[0], Plane[1], Plane[2], Plane[3]))
+			return false;
+	}
+
+	// Cone is degenerate - spread is wider than a hemisphere.
+	if (CullData->NormalCone[3] == 0xFF)
+		return true;
+
+	return CullNormalCone(Sphere[0], Sphere[1], Sphere[2],
+		CullDecodeAxis(CullData->NormalCone[0]), CullDecodeAxis(CullData->NormalCone[1]), CullDecodeAxis(CullData->NormalCone[2]),
+		CullDecodeCutoff(CullData->NormalCone[3]), CullApexScale(CullData),
+		Frustum->ViewPosition[0], Frustum->ViewPosition[1], Frustum->ViewPosition[2]);
+}
+
+static uint32_t ScalarCull(const struct CullFrustum* Frustum, const struct CullData* CullingData, uint32_t Begin, uint32_t End, uint32_t* Visible)
+{
+	uint32_t VisibleCount = 0;
+
+	for (uint32_t i = Begin; i < End; i++)
+	{
+		if (CullMeshletVisible(Frustum, &CullingData[i]))
+			Visible[VisibleCount++] = i;
+	}
+
+	return VisibleCount;
+}
+
+#ifdef PLATFORM_SSE2
+static uint32_t Sse2Cull(const struct CullFrustum* Frustum, const struct CullData* CullingData, uint32_t Begin, uint32_t End, uint32_t* Visible)
+{
+	uint32_t VisibleCount = 0;
+	uint32_t i = Begin;
+
+	const __m128 Inv255 = _mm_set1_ps(CULL_BYTE_SCALE);
+	const __m128 Two = _mm_set1_ps(2.0f);
+	const __m128 One = _mm_set1_ps(1.0f);
+	const __m128i ByteMask = _mm_set1_epi32(0xFF);
+
+	for (; i + 4 <= End; i += 4)
+	{
+		const struct CullData* Block = &CullingData[i];
+
+		// Spheres: four 16 byte loads transposed into x/y/z/r lanes.
+		__m128 X = _mm_loadu_ps(Block[0].BoundingSphere);
+		__m128 Y = _mm_loadu_ps(Block[1].BoundingSphere);
+		__m128 Z = _mm_loadu_ps(Block[2].BoundingSphere);
+		__m128 R = _mm_loadu_ps(Block[3].BoundingSphere);
+		_MM_TRANSPOSE4_PS(X, Y, Z, R);
+
+		__m128 Outside = _mm_setzero_ps();
+		const __m128 NegR = _mm_sub_ps(_mm_setzero_ps(), R);
+
+		for (int p = 0; p < 6; p++)
+		{
+			const float* Plane = Frustum->Planes[p];
+
+			const __m128 Dist = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(X, _mm_set1_ps(Plane[0])), _mm_mul_ps(Y, _mm_set1_ps(Plane[1]))),
+				_mm_add_ps(_mm_mul_ps(Z, _mm_set1_ps(Plane[2])), _mm_set1_ps(Plane[3])));
+
+			Outside = _mm_or_ps(Outside, _mm_cmplt_ps(Dist, NegR));
+		}
+
+		int CulledMask = _mm_movemask_ps(Outside);
+
+		if (CulledMask != 0xF)
+		{
+			uint32_t ConeWords[4];
+			float ApexOffsets[4];
+			for (int Lane = 0; Lane < 4; Lane++)
+			{
+				memcpy(&ConeWords[Lane], Block[Lane].NormalCone, sizeof(uint32_t));
+				ApexOffsets[Lane] = Block[Lane].ApexOffset;
+			}
+
+			const __m128i Cone = _mm_loadu_si128((const __m128i*)ConeWords);
+			const __m128 Apex = _mm_loadu_ps(ApexOffsets);
+
+			const __m128 Ax = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(Cone, ByteMask)), Inv255), Two), One);
+			const __m128 Ay = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Cone, 8), ByteMask)), Inv255), Two), One);
+			const __m128 Az = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Cone, 16), ByteMask)), Inv255), Two), One);
+			const __m128i ConeW = _mm_srli_epi32(Cone, 24);
+			const __m128 Cutoff = _mm_mul_ps(_mm_cvtepi32_ps(ConeW), Inv255);
+
+			//the same steps as CullApexScale and CullNormalCone
+			const __m128 AxisLengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Ax, Ax), _mm_mul_ps(Ay, Ay)), _mm_mul_ps(Az, Az));
+			const __m128 ApexScale = _mm_div_ps(Apex, _mm_sqrt_ps(AxisLengthSquared));
+
+			const __m128 Vx = _mm_sub_ps(_mm_set1_ps(Frustum->ViewPosition[0]), _mm_sub_ps(X, _mm_mul_ps(Ax, ApexScale)));
+			const __m128 Vy = _mm_sub_ps(_mm_set1_ps(Frustum->ViewPosition[1]), _mm_sub_ps(Y, _mm_mul_ps(Ay, ApexScale)));
+			const __m128 Vz = _mm_sub_ps(_mm_set1_ps(Frustum->ViewPosition[2]), _mm_sub_ps(Z, _mm_mul_ps(Az, ApexScale)));
+
+			const __m128 NegDot = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_add_ps(_mm_mul_ps(Vx, Ax), _mm_mul_ps(Vy, Ay)), _mm_mul_ps(Vz, Az)));
+			const __m128 ViewLengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Vx, Vx), _mm_mul_ps(Vy, Vy)), _mm_mul_ps(Vz, Vz));
+			const __m128 Limit = _mm_mul_ps(_mm_mul_ps(Cutoff, Cutoff), _mm_mul_ps(ViewLengthSquared, AxisLengthSquared));
+
+			const __m128 Backfacing = _mm_and_ps(_mm_cmpgt_ps(NegDot, _mm_setzero_ps()), _mm_cmpgt_ps(_mm_mul_ps(NegDot, NegDot), Limit));
+			const __m128 Degenerate = _mm_castsi128_ps(_mm_cmpeq_epi32(ConeW, ByteMask));
+
+			CulledMask |= _mm_movemask_ps(_mm_andnot_ps(Degenerate, Backfacing));
+		}
+
+		for (int Lane = 0; Lane < 4; Lane++)
+		{
+			Visible[VisibleCount] = i + Lane;
+			VisibleCount += ((CulledMask >> Lane) & 1) ^ 1;
+		}
+	}
+
+	return VisibleCount + ScalarCull(Frustum, CullingData, i, End, Visible + VisibleCount);
+}
+#endif
+
+#ifdef PLATFORM_AVX2
+static uint32_t Avx2Cull(const struct CullFrustum* Frustum, const struct CullData* CullingData, uint32_t Begin, uint32_t End, uint32_t* Visible)
+{
+	uint32_t VisibleCount = 0;
+	uint32_t i = Begin;
+
+	//one CullData is six 32-bit words; gather each field across eight meshlets
+	const __m256i Offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(6));
+
+	const __m256 Inv255 = _mm256_set1_ps(CULL_BYTE_SCALE);
+	const __m256 Two = _mm256_set1_ps(2.0f);
+	const __m256 One = _mm256_set1_ps(1.0f);
+	const __m256i ByteMask = _mm256_set1_epi32(0xFF);
+
+	for (; i + 8 <= End; i += 8)
+	{
+		const float* Base = (const float*)&CullingData[i];
+
+		const __m256 X = _mm256_i32gather_ps(Base + 0, Offsets, 4);
+		const __m256 Y = _mm256_i32gather_ps(Base + 1, Offsets, 4);
+		const __m256 Z = _mm256_i32gather_ps(Base + 2, Offsets, 4);
+		const __m256 R = _mm256_i32gather_ps(Base + 3, Offsets, 4);
+		const __m256 NegR = _mm256_sub_ps(_mm256_setzero_ps(), R);
+
+		__m256 Outside = _mm256_setzero_ps();
+
+		for (int p = 0; p < 6; p++)
+		{
+			const float* Plane = Frustum->Planes[p];
+
+			const __m256 Dist = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(X, _mm256_set1_ps(Plane[0])), _mm256_mul_ps(Y, _mm256_set1_ps(Plane[1]))),
+				_mm256_add_ps(_mm256_mul_ps(Z, _mm256_set1_ps(Plane[2])), _mm256_set1_ps(Plane[3])));
+
+			Outside = _mm256_or_ps(Outside, _mm256_cmp_ps(Dist, NegR, _CMP_LT_OQ));
+		}
+
+		int CulledMask = _mm256_movemask_ps(Outside);
+
+		if (CulledMask != 0xFF)
+		{
+			const __m256i Cone = _mm256_i32gather_epi32((const int*)(Base + 4), Offsets, 4);
+			const __m256 Apex = _mm256_i32gather_ps(Base + 5, Offsets, 4);
+
+			const __m256 Ax = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(Cone, ByteMask)), Inv255), Two), One);
+			const __m256 Ay = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(Cone, 8), ByteMask)), Inv255), Two), One);
+			const __m256 Az = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(Cone, 16), ByteMask)), Inv255), Two), One);
+			const __m256i ConeW = _mm256_srli_epi32(Cone, 24);
+			const __m256 Cutoff = _mm256_mul_ps(_mm256_cvtepi32_ps(ConeW), Inv255);
+
+			//the same steps as CullApexScale and CullNormalCone
+			const __m256 AxisLengthSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(Ax, Ax), _mm256_mul_ps(Ay, Ay)), _mm256_mul_ps(Az, Az));
+			const __m256 ApexScale = _mm256_div_ps(Apex, _mm256_sqrt_ps(AxisLengthSquared));
+
+			const __m256 Vx = _mm256_sub_ps(_mm256_set1_ps(Frustum->ViewPosition[0]), _mm256_sub_ps(X, _mm256_mul_ps(Ax, ApexScale)));
+			const __m256 Vy = _mm256_sub_ps(_mm256_set1_ps(Frustum->ViewPosition[1]), _mm256_sub_ps(Y, _mm256_mul_ps(Ay, ApexScale)));
+			const __m256 Vz = _mm256_sub_ps(_mm256_set1_ps(Frustum->ViewPosition[2]), _mm256_sub_ps(Z, _mm256_mul_ps(Az, ApexScale)));
+
+			const __m256 NegDot = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(Vx, Ax), _mm256_mul_ps(Vy, Ay)), _mm256_mul_ps(Vz, Az)));
+			const __m256 ViewLengthSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(Vx, Vx), _mm256_mul_ps(Vy, Vy)), _mm256_mul_ps(Vz, Vz));
+			const __m256 Limit = _mm256_mul_ps(_mm256_mul_ps(Cutoff, Cutoff), _mm256_mul_ps(ViewLengthSquared, AxisLengthSquared));
+
+			const __m256 Backfacing = _mm256_and_ps(_mm256_cmp_ps(NegDot, _mm256_setzero_ps(), _CMP_GT_OQ), _mm256_cmp_ps(_mm256_mul_ps(NegDot, NegDot), Limit, _CMP_GT_OQ));
+			const __m256 Degenerate = _mm256_castsi256_ps(_mm256_cmpeq_epi32(ConeW, ByteMask));
+
+			CulledMask |= _mm256_movemask_ps(_mm256_andnot_ps(Degenerate, Backfacing));
+		}
+
+		for (int Lane = 0; Lane < 8; Lane++)
+		{
+			Visible[VisibleCount] = i + Lane;
+			VisibleCount += ((CulledMask >> Lane) & 1) ^ 1;
+		}
+	}
+
+	return VisibleCount + ScalarCull(Frustum, CullingData, i, End, Visible + VisibleCount);
+}
+#endif
+
+uint32_t CullMeshlets(const struct CullFrustum* Frustum, const struct CullData* CullingData, uint32_t First, uint32_t Count, enum SimdLevel Kernel, uint32_t* Visible)
+{
+	switch (Kernel)
+	{
+#ifdef PLATFORM_AVX2
+	case SIMD_LEVEL_AVX2:
+		return Avx2Cull(Frustum, CullingData, First, First + Count, Visible);
+#endif
+#ifdef PLATFORM_SSE2
+	case SIMD_LEVEL_SSE2:
+		return Sse2Cull(Frustum, CullingData, First, First + Count, Visible);
+#endif
+	default:
+		return ScalarCull(Frustum, CullingData, First, First + Count, Visible);
+	}
+}
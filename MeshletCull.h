@@ -0,0 +1,51 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Platform.h"
+#include "MeshFile.h"
+
+//cpu meshlet culling against CullData: bounding sphere vs. the view frustum, then the normal cone
+//against the view position. everything is in the mesh's object space, so the matrix passed in is
+//world * view * projection and the view position has to be moved into object space by the caller
+//
+//the tests themselves are in MeshletCullMath.h, which MeshletAS.hlsl runs too: fed the gpu copy of the cull data
+//(CullDataToGpu) it makes the same decisions, bit for bit, as CullMeshletVisible
+
+struct CullFrustum
+{
+	float Planes[6][4];//xyz = normal pointing inside, w = distance; normalized
+	float ViewPosition[3];
+};
+
+//ViewProj is column-major (cglm's mat4 layout). works for both [0,1] and [-1,1] depth ranges
+void CullFrustumFromMatrix(const float ViewProj[16], const float ViewPosition[3], struct CullFrustum* Out);
+
+//scalar reference test for a single meshlet
+bool CullMeshletVisible(const struct CullFrustum* Frustum, const struct CullData* CullData);
+
+//ApexOffset divided by the length of the quantized cone axis, what the cone test takes instead of ApexOffset
+float CullApexScale(const struct CullData* CullData);
+
+//copies Count CullData to Out with ApexOffset replaced by CullApexScale, as MeshletAS.hlsl reads them. Out may be In
+void CullDataToGpu(const struct CullData* In, uint32_t Count, struct CullData* Out);
+
+//tests CullingData[First .. First + Count) and writes the absolute meshlet indices of the visible ones
+//to Visible in ascending order. returns how many were written
+uint32_t CullMeshlets(const struct CullFrustum* Frustum, const struct CullData* CullingData, uint32_t First, uint32_t Count, enum SimdLevel Kernel, uint32_t* Visible);
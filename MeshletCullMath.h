@@ -0,0 +1,88 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//the meshlet cull tests, written once for MeshletCull.c and MeshletAS.hlsl in the subset of c both compilers take.
+//a decision is made of adds, multiplies and compares only, each rounded on its own, so a gpu that rounds them as
+//IEEE 754 does decides exactly as the cpu does. that only holds while no multiply and add are fused into an fma:
+//hlsl is kept from it by precise, clang and msvc by the pragmas below (for the rest of the including file), and gcc,
+//which ignores them and contracts in its gnu modes, needs -ffp-contract=off on the command line. square roots
+//and divisions, which d3d doesn't round exactly, stay on the cpu: the frustum planes are normalized when they are
+//built, and the cone's apex offset is divided by the quantized axis' length before the cull data is uploaded
+//(CullApexScale). the one difference left is that d3d flushes denormals, which a view that far from a sphere or apex
+//never produces
+
+#ifdef __HLSL_VERSION
+#define CULL_FUNCTION inline
+#define CULL_PRECISE precise
+#else
+#include <stdbool.h>
+#define CULL_FUNCTION static inline
+#define CULL_PRECISE
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+#endif
+
+//1 / 255 rounded to float, spelled out so every compiler starts from the same bits
+#define CULL_BYTE_SCALE 0.0039215688593685627f
+
+//a normal cone axis component from its byte, in [-1, 1]
+CULL_FUNCTION float CullDecodeAxis(float Byte)
+{
+	CULL_PRECISE float Axis = Byte * CULL_BYTE_SCALE * 2.0f - 1.0f;
+	return Axis;
+}
+
+//the cone's cutoff, -cos(a + 90), from its byte
+CULL_FUNCTION float CullDecodeCutoff(float Byte)
+{
+	CULL_PRECISE float Cutoff = Byte * CULL_BYTE_SCALE;
+	return Cutoff;
+}
+
+//the decoded axis isn't unit length; this is its length squared
+CULL_FUNCTION float CullAxisLengthSquared(float Ax, float Ay, float Az)
+{
+	CULL_PRECISE float LengthSquared = (Ax * Ax + Ay * Ay) + Az * Az;
+	return LengthSquared;
+}
+
+//false when the sphere is wholly on the outer side of the plane, whose normal points inside
+CULL_FUNCTION bool CullSpherePlane(float X, float Y, float Z, float Radius, float Px, float Py, float Pz, float Pw)
+{
+	CULL_PRECISE float Distance = (X * Px + Y * Py) + (Z * Pz + Pw);
+	return !(Distance < -Radius);
+}
+
+//false when the view at E sees only the backs of the meshlet's triangles. with L the axis' length the apex is
+//Center - Axis * ApexScale (ApexScale = ApexOffset / L), and -dot(V, Axis / L) <= Cutoff * |V| for V = E - apex is
+//tested squared: -dot(V, Axis) <= 0 or dot(V, Axis)^2 <= Cutoff^2 * |V|^2 * L^2
+CULL_FUNCTION bool CullNormalCone(float X, float Y, float Z, float Ax, float Ay, float Az, float Cutoff, float ApexScale, float Ex, float Ey, float Ez)
+{
+	CULL_PRECISE float Vx = Ex - (X - Ax * ApexScale);
+	CULL_PRECISE float Vy = Ey - (Y - Ay * ApexScale);
+	CULL_PRECISE float Vz = Ez - (Z - Az * ApexScale);
+
+	CULL_PRECISE float NegDot = 0.0f - ((Vx * Ax + Vy * Ay) + Vz * Az);
+	CULL_PRECISE float NegDotSquared = NegDot * NegDot;
+	CULL_PRECISE float Limit = (Cutoff * Cutoff) * (((Vx * Vx + Vy * Vy) + Vz * Vz) * CullAxisLengthSquared(Ax, Ay, Az));
+
+	//written as the simd kernels' mask, so a nan is kept rather than culled
+	return !(NegDot > 0.0f && NegDotSquared > Limit);
+}
@@ -0,0 +1,924 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#include "MeshletDag.h"
+#include "MeshSimplify.h"
+#include "MeshBounds.h"
+
+//a group is only replaced when its triangles drop to this fraction, or it'd take many levels to get anywhere
+#define DAG_MIN_REDUCTION 0.75f
+
+//parents get their error and sphere grown by this much over their children's, so float rounding in the acceptance
+//test can't make a parent acceptable where a child isn't; that would draw both
+#define DAG_MARGIN (1.0f / 1024.0f)
+
+//meshlets of every level while the dag is built. records of one subset stay contiguous, level after level, and a
+//level is reordered in place when it's grouped: nothing points at a level until the next one is made from it
+struct DagBuild
+{
+	const struct Mesh* Mesh;
+	const float* Positions;
+	uint32_t PositionStride;
+	uint32_t MaxVertices;
+	uint32_t MaxPrimitives;
+	uint32_t* Weld;//vertex -> first vertex at the same position, so groups meet across attribute seams
+
+	struct Meshlet* Meshlets;
+	struct CullData* CullData;
+	struct ClusterLod* Lods;
+	uint32_t RecordCount;
+	uint32_t RecordCapacity;
+
+	uint32_t* Unique;//mesh vertex indices, 4 bytes wide until the end
+	uint32_t UniqueCount;
+	uint32_t UniqueCapacity;
+
+	struct PackedTriangle* Prims;
+	uint32_t PrimCount;
+	uint32_t PrimCapacity;
+};
+
+struct DagGroup
+{
+	uint32_t First;//member records
+	uint32_t Count;
+
+	struct MeshletData Meshlets;//4 byte local vertex indices into Vertices
+	uint32_t* Vertices;//local -> mesh vertex
+	float Error;
+	bool bSimplified;
+	bool bOutOfMemory;
+};
+
+struct DagLevel
+{
+	const struct DagBuild* Build;
+	struct DagGroup* Groups;
+};
+
+static bool Reserve(void** Array, uint32_t* Capacity, uint64_t Needed, size_t ElementSize)
+{
+	if (Needed <= *Capacity)
+		return true;
+
+	if (Needed > UINT32_MAX)
+		return false;
+
+	uint64_t NewCapacity = *Capacity ? *Capacity : 1024;
+	while (NewCapacity < Needed)
+		NewCapacity *= 2;
+
+	if (NewCapacity > UINT32_MAX)
+		NewCapacity = UINT32_MAX;
+
+	void* Grown = realloc(*Array, (size_t)NewCapacity * ElementSize);
+
+	if (Grown == NULL)
+		return false;
+
+	*Array = Grown;
+	*Capacity = (uint32_t)NewCapacity;
+	return true;
+}
+
+static bool ReserveRecords(struct DagBuild* Build, uint64_t Needed)
+{
+	uint32_t Capacity = Build->RecordCapacity;
+
+	//three arrays share one capacity, so each one grows from the same old value
+	if (!Reserve((void**)&Build->Meshlets, &Capacity, Needed, sizeof(struct Meshlet)))
+		return false;
+
+	Capacity = Build->RecordCapacity;
+	if (!Reserve((void**)&Build->CullData, &Capacity, Needed, sizeof(struct CullData)))
+		return false;
+
+	Capacity = Build->RecordCapacity;
+	if (!Reserve((void**)&Build->Lods, &Capacity, Needed, sizeof(struct ClusterLod)))
+		return false;
+
+	Build->RecordCapacity = Capacity;
+	return true;
+}
+
+static int CompareU32(const void* A, const void* B)
+{
+	const uint32_t a = *(const uint32_t*)A;
+	const uint32_t b = *(const uint32_t*)B;
+	return (a > b) - (a < b);
+}
+
+static int CompareU64(const void* A, const void* B)
+{
+	const uint64_t a = *(const uint64_t*)A;
+	const uint64_t b = *(const uint64_t*)B;
+	return (a > b) - (a < b);
+}
+
+static inline uint32_t SpreadBits(uint32_t Value)
+{
+	Value &= 0x3FF;
+	Value = (Value | (Value << 16)) & 0x030000FF;
+	Value = (Value | (Value << 8)) & 0x0300F00F;
+	Value = (Value | (Value << 4)) & 0x030C30C3;
+	Value = (Value | (Value << 2)) & 0x09249249;
+	return Value;
+}
+
+//splits the records [First, First + Count) into groups of up to MESHLET_DAG_GROUP_SIZE: Order gets the records (as
+//offsets from First) group by group and GroupOffsets the start of each group. a group starts at the first record
+//left along a morton curve and keeps taking the neighbour that shares the most vertices with it. returns the group
+//count, UINT32_MAX if memory runs out
+static uint32_t PartitionClusters(const struct DagBuild* Build, uint32_t First, uint32_t Count, uint32_t* Order, uint32_t* GroupOffsets)
+{
+	uint64_t PairCount = 0;
+	for (uint32_t c = 0; c < Count; c++)
+		PairCount += Build->Meshlets[First + c].VertCount;
+
+	uint64_t* Pairs = malloc(sizeof(uint64_t) * (size_t)(PairCount + 1));
+	uint64_t* Edges = NULL;
+	uint64_t EdgeCount = 0;
+	uint64_t EdgeCapacity = 0;
+	uint32_t* AdjacencyOffsets = calloc((size_t)Count + 1, sizeof(uint32_t));
+	uint32_t* Adjacency = NULL;
+	uint32_t* Weights = NULL;
+	uint64_t* Keys = malloc(sizeof(uint64_t) * ((size_t)Count + 1));
+	uint32_t* Groups = malloc(sizeof(uint32_t) * ((size_t)Count + 1));
+	uint32_t* Rank = malloc(sizeof(uint32_t) * ((size_t)Count + 1));
+	uint32_t* Scores = calloc((size_t)Count + 1, sizeof(uint32_t));
+	uint32_t* Candidates = malloc(sizeof(uint32_t) * ((size_t)Count + 1));
+	uint32_t GroupCount = UINT32_MAX;
+
+	if (Pairs == NULL || AdjacencyOffsets == NULL || Keys == NULL || Groups == NULL || Rank == NULL || Scores == NULL || Candidates == NULL)
+		goto done;
+
+	//records that touch the same welded vertex are neighbours, weighted by how many they share
+	uint64_t p = 0;
+	for (uint32_t c = 0; c < Count; c++)
+	{
+		const struct Meshlet* m = &Build->Meshlets[First + c];
+
+		for (uint32_t v = 0; v < m->VertCount; v++)
+			Pairs[p++] = (uint64_t)Build->Weld[Build->Unique[m->VertOffset + v]] << 32 | c;
+	}
+
+	qsort(Pairs, (size_t)PairCount, sizeof(uint64_t), CompareU64);
+
+	for (uint64_t Begin = 0, End; Begin < PairCount; Begin = End)
+	{
+		for (End = Begin + 1; End < PairCount && Pairs[End] >> 32 == Pairs[Begin] >> 32; End++)
+			;
+
+		for (uint64_t a = Begin; a < End; a++)
+		{
+			for (uint64_t b = a + 1; b < End; b++)
+			{
+				const uint32_t ca = (uint32_t)Pairs[a];
+				const uint32_t cb = (uint32_t)Pairs[b];
+
+				if (ca == cb)
+					continue;
+
+				if (EdgeCount + 2 > EdgeCapacity)
+				{
+					EdgeCapacity = EdgeCapacity ? EdgeCapacity * 2 : 4096;
+					uint64_t* Grown = realloc(Edges, sizeof(uint64_t) * (size_t)EdgeCapacity);
+
+					if (Grown == NULL)
+						goto done;
+
+					Edges = Grown;
+				}
+
+				Edges[EdgeCount++] = (uint64_t)ca << 32 | cb;
+				Edges[EdgeCount++] = (uint64_t)cb << 32 | ca;
+			}
+		}
+	}
+
+	qsort(Edges, (size_t)EdgeCount, sizeof(uint64_t), CompareU64);
+
+	Adjacency = malloc(sizeof(uint32_t) * (size_t)(EdgeCount + 1));
+	Weights = malloc(sizeof(uint32_t) * (size_t)(EdgeCount + 1));
+
+	if (Adjacency == NULL || Weights == NULL)
+		goto done;
+
+	uint32_t AdjacencyCount = 0;
+	for (uint64_t e = 0; e < EdgeCount; e++)
+	{
+		if (e > 0 && Edges[e] == Edges[e - 1])
+		{
+			Weights[AdjacencyCount - 1]++;
+			continue;
+		}
+
+		Adjacency[AdjacencyCount] = (uint32_t)Edges[e];
+		Weights[AdjacencyCount] = 1;
+		AdjacencyCount++;
+		AdjacencyOffsets[(Edges[e] >> 32) + 1]++;
+	}
+
+	for (uint32_t c = 0; c < Count; c++)
+		AdjacencyOffsets[c + 1] += AdjacencyOffsets[c];
+
+	//seed order: morton code of each meshlet's own sphere center
+	float Min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float Max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	for (uint32_t c = 0; c < Count; c++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			Min[k] = fminf(Min[k], Build->CullData[First + c].BoundingSphere[k]);
+			Max[k] = fmaxf(Max[k], Build->CullData[First + c].BoundingSphere[k]);
+		}
+	}
+
+	for (uint32_t c = 0; c < Count; c++)
+	{
+		uint32_t Code = 0;
+
+		for (int k = 0; k < 3; k++)
+		{
+			const float Extent = Max[k] - Min[k];
+			const float t = Extent > 0.0f ? (Build->CullData[First + c].BoundingSphere[k] - Min[k]) / Extent : 0.0f;
+			Code |= SpreadBits((uint32_t)(t * 1023.0f)) << k;
+		}
+
+		Keys[c] = (uint64_t)Code << 32 | c;
+	}
+
+	qsort(Keys, Count, sizeof(uint64_t), CompareU64);
+
+	for (uint32_t c = 0; c < Count; c++)
+	{
+		Rank[(uint32_t)Keys[c]] = c;
+		Groups[c] = UINT32_MAX;
+	}
+
+	uint32_t Placed = 0;
+	GroupCount = 0;
+
+	for (uint32_t s = 0; s < Count; s++)
+	{
+		const uint32_t Seed = (uint32_t)Keys[s];
+
+		if (Groups[Seed] != UINT32_MAX)
+			continue;
+
+		GroupOffsets[GroupCount] = Placed;
+
+		uint32_t Size = 0;
+		uint32_t CandidateCount = 0;
+		uint32_t Next = Seed;
+
+		while (Next != UINT32_MAX)
+		{
+			Groups[Next] = GroupCount;
+			Order[Placed++] = Next;
+
+			if (++Size == MESHLET_DAG_GROUP_SIZE)
+				break;
+
+			//scores are the vertices each candidate shares with the whole group
+			for (uint32_t a = AdjacencyOffsets[Next]; a < AdjacencyOffsets[Next + 1]; a++)
+			{
+				const uint32_t Neighbor = Adjacency[a];
+
+				if (Groups[Neighbor] != UINT32_MAX)
+					continue;
+
+				if (Scores[Neighbor] == 0)
+					Candidates[CandidateCount++] = Neighbor;
+
+				Scores[Neighbor] += Weights[a];
+			}
+
+			Next = UINT32_MAX;
+
+			for (uint32_t k = 0; k < CandidateCount; k++)
+			{
+				const uint32_t Candidate = Candidates[k];
+
+				if (Groups[Candidate] != UINT32_MAX)
+					continue;
+
+				if (Next == UINT32_MAX || Scores[Candidate] > Scores[Next] || (Scores[Candidate] == Scores[Next] && Rank[Candidate] < Rank[Next]))
+					Next = Candidate;
+			}
+		}
+
+		for (uint32_t k = 0; k < CandidateCount; k++)
+			Scores[Candidates[k]] = 0;
+
+		GroupCount++;
+	}
+
+done:
+	free(Pairs);
+	free(Edges);
+	free(AdjacencyOffsets);
+	free(Adjacency);
+	free(Weights);
+	free(Keys);
+	free(Groups);
+	free(Rank);
+	free(Scores);
+	free(Candidates);
+	return GroupCount;
+}
+
+static uint32_t FindVertex(const uint32_t* Vertices, uint32_t Count, uint32_t Vertex)
+{
+	uint32_t Low = 0;
+	uint32_t High = Count;
+
+	while (Low < High)
+	{
+		const uint32_t Mid = (Low + High) / 2;
+
+		if (Vertices[Mid] < Vertex)
+			Low = Mid + 1;
+		else
+			High = Mid;
+	}
+
+	return Low;
+}
+
+//simplifies one group on a compacted copy of its vertices, so the work is proportional to the group and not the mesh
+static void SimplifyGroup(void* Context, uint32_t GroupIndex)
+{
+	const struct DagLevel* Level = Context;
+	const struct DagBuild* Build = Level->Build;
+	struct DagGroup* Group = &Level->Groups[GroupIndex];
+
+	uint32_t IndexCount = 0;
+	for (uint32_t m = 0; m < Group->Count; m++)
+		IndexCount += Build->Meshlets[Group->First + m].PrimCount * 3;
+
+	uint32_t* Indices = malloc(sizeof(uint32_t) * ((size_t)IndexCount + 1));
+	uint32_t* Simplified = malloc(sizeof(uint32_t) * ((size_t)IndexCount + 1));
+	uint32_t* Vertices = malloc(sizeof(uint32_t) * ((size_t)IndexCount + 1));
+	float* Positions = malloc(sizeof(float) * 3 * ((size_t)IndexCount + 1));
+
+	if (Indices == NULL || Simplified == NULL || Vertices == NULL || Positions == NULL)
+	{
+		Group->bOutOfMemory = true;
+		goto done;
+	}
+
+	uint32_t i = 0;
+	for (uint32_t m = 0; m < Group->Count; m++)
+	{
+		const struct Meshlet* Meshlet = &Build->Meshlets[Group->First + m];
+
+		for (uint32_t p = 0; p < Meshlet->PrimCount; p++)
+		{
+			const struct PackedTriangle Triangle = Build->Prims[Meshlet->PrimOffset + p];
+			Indices[i++] = Build->Unique[Meshlet->VertOffset + Triangle.i0];
+			Indices[i++] = Build->Unique[Meshlet->VertOffset + Triangle.i1];
+			Indices[i++] = Build->Unique[Meshlet->VertOffset + Triangle.i2];
+		}
+	}
+
+	memcpy(Vertices, Indices, sizeof(uint32_t) * IndexCount);
+	qsort(Vertices, IndexCount, sizeof(uint32_t), CompareU32);
+
+	uint32_t VertexCount = 0;
+	for (uint32_t v = 0; v < IndexCount; v++)
+	{
+		if (VertexCount == 0 || Vertices[VertexCount - 1] != Vertices[v])
+			Vertices[VertexCount++] = Vertices[v];
+	}
+
+	for (uint32_t v = 0; v < VertexCount; v++)
+		memcpy(&Positions[v * 3], (const uint8_t*)Build->Positions + (size_t)Vertices[v] * Build->PositionStride, sizeof(float) * 3);
+
+	for (uint32_t k = 0; k < IndexCount; k++)
+		Indices[k] = FindVertex(Vertices, VertexCount, Indices[k]);
+
+	float Error;
+	const uint32_t SimplifiedCount = SimplifyMesh(Positions, sizeof(float) * 3, VertexCount, Indices, IndexCount, NULL, IndexCount / 6 * 3, FLT_MAX, Simplified, &Error);
+
+	if (Error < 0.0f)
+	{
+		Group->bOutOfMemory = true;
+		goto done;
+	}
+
+	if (SimplifiedCount == 0 || SimplifiedCount > IndexCount * DAG_MIN_REDUCTION)
+		goto done;
+
+	const struct Subset Whole = { 0, SimplifiedCount };
+
+	struct Mesh Local = { 0 };
+	Local.VertexBuffers[0] = (struct VertexBuffer){ (const uint8_t*)Positions, VertexCount * (uint32_t)sizeof(float) * 3, sizeof(float) * 3 };
+	Local.VertexBufferCount = 1;
+
+	for (uint32_t a = 0; a < ATTRIBUTE_TYPE_COUNT; a++)
+	{
+		Local.AttributeSlots[a] = MESHFILE_ATTRIBUTE_NONE;
+		Local.AttributeOffsets[a] = MESHFILE_ATTRIBUTE_NONE;
+	}
+
+	Local.AttributeSlots[ATTRIBUTE_TYPE_POSITION] = 0;
+	Local.AttributeOffsets[ATTRIBUTE_TYPE_POSITION] = 0;
+	Local.VertexCount = VertexCount;
+	Local.IndexSubsets = &Whole;
+	Local.IndexSubsetCount = 1;
+	Local.IndexBuffer = (const uint8_t*)Simplified;
+	Local.IndexBufferSize = SimplifiedCount * (uint32_t)sizeof(uint32_t);
+	Local.IndexSize = sizeof(uint32_t);
+	Local.IndexCount = SimplifiedCount;
+
+	const enum MeshletBuildResult Result = BuildMeshlets(&Local, Build->MaxVertices, Build->MaxPrimitives, 1, &Group->Meshlets);
+
+	if (Result != MESHLET_BUILD_OK)
+	{
+		Group->bOutOfMemory = Result == MESHLET_BUILD_ERROR_OUT_OF_MEMORY;
+		MeshletDataFree(&Group->Meshlets);
+		goto done;
+	}
+
+	//more meshlets than went in would let a cut grow past level 0
+	if (Group->Meshlets.MeshletCount >= Group->Count)
+	{
+		MeshletDataFree(&Group->Meshlets);
+		goto done;
+	}
+
+	Group->Vertices = Vertices;
+	Vertices = NULL;
+	Group->Error = Error;
+	Group->bSimplified = true;
+
+done:
+	free(Indices);
+	free(Simplified);
+	free(Vertices);
+	free(Positions);
+}
+
+static void CopyBounds(float Out[4], const struct BoundingSphere* Sphere)
+{
+	Out[0] = Sphere->Center[0];
+	Out[1] = Sphere->Center[1];
+	Out[2] = Sphere->Center[2];
+	Out[3] = Sphere->Radius;
+}
+
+//appends the next level made from the grouped level: every group's members get its error and sphere as their
+//parent's, and the meshlets made from it (or copies of its members) get them as their own
+static bool CommitLevel(struct DagBuild* Build, const struct DagGroup* Groups, uint32_t GroupCount)
+{
+	for (uint32_t g = 0; g < GroupCount; g++)
+	{
+		const struct DagGroup* Group = &Groups[g];
+		const uint32_t OutputCount = Group->bSimplified ? Group->Meshlets.MeshletCount : Group->Count;
+
+		if (!ReserveRecords(Build, (uint64_t)Build->RecordCount + OutputCount))
+			return false;
+
+		float ChildError = 0.0f;
+		struct BoundingSphere Sphere;
+
+		for (uint32_t m = 0; m < Group->Count; m++)
+		{
+			const struct ClusterLod* Lod = &Build->Lods[Group->First + m];
+			const struct BoundingSphere Child = { { Lod->Bounds[0], Lod->Bounds[1], Lod->Bounds[2] }, Lod->Bounds[3] };
+
+			ChildError = fmaxf(ChildError, Lod->Error);
+
+			if (m == 0)
+				Sphere = Child;
+			else
+				MergeBoundingSpheres(&Sphere, &Child, &Sphere);
+		}
+
+		float Error = ChildError + (Group->bSimplified ? Group->Error : 0.0f);
+		Error = fmaxf(Error, ChildError * (1.0f + DAG_MARGIN));
+		Sphere.Radius += Sphere.Radius * DAG_MARGIN;
+
+		for (uint32_t m = 0; m < Group->Count; m++)
+		{
+			struct ClusterLod* Lod = &Build->Lods[Group->First + m];
+			CopyBounds(Lod->ParentBounds, &Sphere);
+			Lod->ParentError = Error;
+		}
+
+		if (Group->bSimplified)
+		{
+			const struct MeshletData* Data = &Group->Meshlets;
+			const uint32_t* LocalIndices = (const uint32_t*)Data->UniqueVertexIndices;
+			const uint32_t LocalCount = Data->UniqueVertexIndexCount / sizeof(uint32_t);
+
+			if (!Reserve((void**)&Build->Unique, &Build->UniqueCapacity, (uint64_t)Build->UniqueCount + LocalCount, sizeof(uint32_t)) ||
+				!Reserve((void**)&Build->Prims, &Build->PrimCapacity, (uint64_t)Build->PrimCount + Data->PrimitiveIndexCount, sizeof(struct PackedTriangle)))
+				return false;
+
+			for (uint32_t k = 0; k < Data->MeshletCount; k++)
+			{
+				struct Meshlet Meshlet = Data->Meshlets[k];
+				Meshlet.VertOffset += Build->UniqueCount;
+				Meshlet.PrimOffset += Build->PrimCount;
+
+				Build->Meshlets[Build->RecordCount + k] = Meshlet;
+				Build->CullData[Build->RecordCount + k] = Data->CullingData[k];
+			}
+
+			for (uint32_t k = 0; k < LocalCount; k++)
+				Build->Unique[Build->UniqueCount + k] = Group->Vertices[LocalIndices[k]];
+
+			memcpy(&Build->Prims[Build->PrimCount], Data->PrimitiveIndices, sizeof(struct PackedTriangle) * Data->PrimitiveIndexCount);
+
+			Build->UniqueCount += LocalCount;
+			Build->PrimCount += Data->PrimitiveIndexCount;
+		}
+		else
+		{
+			//a copy shares its member's index data
+			for (uint32_t m = 0; m < Group->Count; m++)
+			{
+				Build->Meshlets[Build->RecordCount + m] = Build->Meshlets[Group->First + m];
+				Build->CullData[Build->RecordCount + m] = Build->CullData[Group->First + m];
+			}
+		}
+
+		for (uint32_t k = 0; k < OutputCount; k++)
+		{
+			struct ClusterLod* Lod = &Build->Lods[Build->RecordCount + k];
+			memset(Lod, 0, sizeof(*Lod));
+
+			CopyBounds(Lod->Bounds, &Sphere);
+			Lod->Error = Error;
+			Lod->ParentError = FLT_MAX;
+			Lod->ChildOffset = Group->First;
+			Lod->ChildCount = Group->Count;
+			Lod->bFirstSibling = k == 0;
+		}
+
+		Build->RecordCount += OutputCount;
+	}
+
+	return true;
+}
+
+//builds the levels of one index subset whose level 0 is the records [First, RecordCount) and returns its roots
+static enum MeshletBuildResult BuildSubsetDag(struct DagBuild* Build, uint32_t ThreadCount, struct Subset* Roots, uint32_t* LevelCount)
+{
+	uint32_t LevelFirst = Roots->Offset;
+	uint32_t LevelEnd = Build->RecordCount;
+	*LevelCount = 1;
+
+	while (LevelEnd - LevelFirst > 1)
+	{
+		const uint32_t Count = LevelEnd - LevelFirst;
+
+		uint32_t* Order = malloc(sizeof(uint32_t) * ((size_t)Count + 1));
+		uint32_t* GroupOffsets = malloc(sizeof(uint32_t) * ((size_t)Count + 1));
+		struct Meshlet* Meshlets = malloc(sizeof(struct Meshlet) * Count);
+		struct CullData* CullData = malloc(sizeof(struct CullData) * Count);
+		struct ClusterLod* Lods = malloc(sizeof(struct ClusterLod) * Count);
+		struct DagGroup* Groups = calloc((size_t)Count + 1, sizeof(struct DagGroup));
+
+		uint32_t GroupCount = UINT32_MAX;
+		bool bOutOfMemory = true;
+		bool bProgress = false;
+
+		if (Order == NULL || GroupOffsets == NULL || Meshlets == NULL || CullData == NULL || Lods == NULL || Groups == NULL ||
+			(GroupCount = PartitionClusters(Build, LevelFirst, Count, Order, GroupOffsets)) == UINT32_MAX)
+			goto level_done;
+
+		//reorder the level so each group is a contiguous child range
+		memcpy(Meshlets, &Build->Meshlets[LevelFirst], sizeof(struct Meshlet) * Count);
+		memcpy(CullData, &Build->CullData[LevelFirst], sizeof(struct CullData) * Count);
+		memcpy(Lods, &Build->Lods[LevelFirst], sizeof(struct ClusterLod) * Count);
+
+		for (uint32_t k = 0; k < Count; k++)
+		{
+			Build->Meshlets[LevelFirst + k] = Meshlets[Order[k]];
+			Build->CullData[LevelFirst + k] = CullData[Order[k]];
+			Build->Lods[LevelFirst + k] = Lods[Order[k]];
+		}
+
+		for (uint32_t g = 0; g < GroupCount; g++)
+		{
+			Groups[g].First = LevelFirst + GroupOffsets[g];
+			Groups[g].Count = (g + 1 < GroupCount ? GroupOffsets[g + 1] : Count) - GroupOffsets[g];
+		}
+
+		struct DagLevel Level = { Build, Groups };
+		PlatformParallelFor(GroupCount, ThreadCount, SimplifyGroup, &Level);
+
+		bOutOfMemory = false;
+		for (uint32_t g = 0; g < GroupCount; g++)
+		{
+			bOutOfMemory |= Groups[g].bOutOfMemory;
+			bProgress |= Groups[g].bSimplified;
+		}
+
+		if (!bOutOfMemory && bProgress)
+			bOutOfMemory = !CommitLevel(Build, Groups, GroupCount);
+
+	level_done:
+		if (Groups != NULL && GroupCount != UINT32_MAX)
+		{
+			for (uint32_t g = 0; g < GroupCount; g++)
+			{
+				MeshletDataFree(&Groups[g].Meshlets);
+				free(Groups[g].Vertices);
+			}
+		}
+
+		free(Order);
+		free(GroupOffsets);
+		free(Meshlets);
+		free(CullData);
+		free(Lods);
+		free(Groups);
+
+		if (bOutOfMemory)
+			return MESHLET_BUILD_ERROR_OUT_OF_MEMORY;
+
+		//nothing simplified, so this level is as coarse as the subset gets
+		if (!bProgress)
+			break;
+
+		LevelFirst = LevelEnd;
+		LevelEnd = Build->RecordCount;
+		(*LevelCount)++;
+	}
+
+	Roots->Offset = LevelFirst;
+	Roots->Count = LevelEnd - LevelFirst;
+	return MESHLET_BUILD_OK;
+}
+
+enum MeshletBuildResult BuildMeshletDag(const struct Mesh* Mesh, uint32_t MaxVertices, uint32_t MaxPrimitives, uint32_t ThreadCount, struct MeshletDag* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	struct MeshletData Level0;
+	enum MeshletBuildResult Result = BuildMeshlets(Mesh, MaxVertices, MaxPrimitives, ThreadCount, &Level0);
+
+	if (Result != MESHLET_BUILD_OK)
+		return Result;
+
+	const uint32_t Slot = Mesh->AttributeSlots[ATTRIBUTE_TYPE_POSITION];
+
+	struct DagBuild Build = { 0 };
+	Build.Mesh = Mesh;
+	Build.Positions = (const float*)(Mesh->VertexBuffers[Slot].Verts + Mesh->AttributeOffsets[ATTRIBUTE_TYPE_POSITION]);
+	Build.PositionStride = Mesh->VertexBuffers[Slot].Stride;
+	Build.MaxVertices = MaxVertices;
+	Build.MaxPrimitives = MaxPrimitives;
+	Build.Weld = malloc(sizeof(uint32_t) * ((size_t)Mesh->VertexCount + 1));
+
+	const uint32_t SubsetCount = Level0.MeshletSubsetCount;
+	const uint32_t Level0UniqueCount = Level0.UniqueVertexIndexCount / Mesh->IndexSize;
+
+	struct Subset* SubsetRecords = calloc((size_t)SubsetCount + 1, sizeof(struct Subset));
+	uint32_t* FinalIndices = NULL;
+
+	Out->ClusterRoots = calloc((size_t)SubsetCount + 1, sizeof(struct Subset));
+	Out->ClusterRootCount = SubsetCount;
+
+	Result = MESHLET_BUILD_ERROR_OUT_OF_MEMORY;
+
+	if (Build.Weld == NULL || SubsetRecords == NULL || Out->ClusterRoots == NULL ||
+		!WeldPositions(Build.Positions, Build.PositionStride, Mesh->VertexCount, Build.Weld) ||
+		!Reserve((void**)&Build.Unique, &Build.UniqueCapacity, Level0UniqueCount, sizeof(uint32_t)) ||
+		!Reserve((void**)&Build.Prims, &Build.PrimCapacity, Level0.PrimitiveIndexCount, sizeof(struct PackedTriangle)))
+		goto done;
+
+	//level 0 index data goes in as is, every coarser level appends to it
+	for (uint32_t v = 0; v < Level0UniqueCount; v++)
+	{
+		Build.Unique[v] = Mesh->IndexSize == 2 ? ((const uint16_t*)Level0.UniqueVertexIndices)[v] : ((const uint32_t*)Level0.UniqueVertexIndices)[v];
+	}
+
+	memcpy(Build.Prims, Level0.PrimitiveIndices, sizeof(struct PackedTriangle) * Level0.PrimitiveIndexCount);
+	Build.UniqueCount = Level0UniqueCount;
+	Build.PrimCount = Level0.PrimitiveIndexCount;
+
+	for (uint32_t s = 0; s < SubsetCount; s++)
+	{
+		const struct Subset* Level0Subset = &Level0.MeshletSubsets[s];
+
+		if (!ReserveRecords(&Build, (uint64_t)Build.RecordCount + Level0Subset->Count))
+			goto done;
+
+		SubsetRecords[s].Offset = Build.RecordCount;
+
+		for (uint32_t k = 0; k < Level0Subset->Count; k++)
+		{
+			const uint32_t Index = Level0Subset->Offset + k;
+			struct ClusterLod* Lod = &Build.Lods[Build.RecordCount];
+
+			Build.Meshlets[Build.RecordCount] = Level0.Meshlets[Index];
+			Build.CullData[Build.RecordCount] = Level0.CullingData[Index];
+
+			memset(Lod, 0, sizeof(*Lod));
+			memcpy(Lod->Bounds, Level0.CullingData[Index].BoundingSphere, sizeof(Lod->Bounds));
+			Lod->ParentError = FLT_MAX;
+
+			Build.RecordCount++;
+		}
+
+		uint32_t LevelCount;
+		Out->ClusterRoots[s].Offset = SubsetRecords[s].Offset;
+
+		if ((Result = BuildSubsetDag(&Build, ThreadCount, &Out->ClusterRoots[s], &LevelCount)) != MESHLET_BUILD_OK)
+			goto done;
+
+		Result = MESHLET_BUILD_ERROR_OUT_OF_MEMORY;
+		SubsetRecords[s].Count = Build.RecordCount - SubsetRecords[s].Offset;
+
+		if (LevelCount > Out->LevelCount)
+			Out->LevelCount = LevelCount;
+	}
+
+	//final order: every subset's level 0 where MeshletSubsets expect it, then the coarser levels subset by subset
+	FinalIndices = malloc(sizeof(uint32_t) * ((size_t)Build.RecordCount + 1));
+
+	struct MeshletData* Data = &Out->Meshlets;
+	Data->MeshletSubsets = calloc((size_t)SubsetCount + 1, sizeof(struct Subset));
+	Data->MeshletSubsetCount = SubsetCount;
+	Data->Meshlets = malloc(sizeof(struct Meshlet) * ((size_t)Build.RecordCount + 1));
+	Data->MeshletCount = Build.RecordCount;
+	Data->CullingData = malloc(sizeof(struct CullData) * ((size_t)Build.RecordCount + 1));
+	Data->CullingDataCount = Build.RecordCount;
+	Data->UniqueVertexIndices = malloc((size_t)Build.UniqueCount * Mesh->IndexSize + 1);
+	Data->UniqueVertexIndexCount = Build.UniqueCount * Mesh->IndexSize;
+	Data->PrimitiveIndices = malloc(sizeof(struct PackedTriangle) * ((size_t)Build.PrimCount + 1));
+	Data->PrimitiveIndexCount = Build.PrimCount;
+	Data->MaxVertices = MaxVertices;
+	Data->MaxPrimitives = MaxPrimitives;
+	Out->ClusterLods = malloc(sizeof(struct ClusterLod) * ((size_t)Build.RecordCount + 1));
+	Out->ClusterLodCount = Build.RecordCount;
+
+	if (FinalIndices == NULL || Data->MeshletSubsets == NULL || Data->Meshlets == NULL || Data->CullingData == NULL ||
+		Data->UniqueVertexIndices == NULL || Data->PrimitiveIndices == NULL || Out->ClusterLods == NULL)
+		goto done;
+
+	uint32_t Level0Next = 0;
+	for (uint32_t s = 0; s < SubsetCount; s++)
+	{
+		Data->MeshletSubsets[s] = (struct Subset){ Level0Next, Level0.MeshletSubsets[s].Count };
+
+		for (uint32_t k = 0; k < Level0.MeshletSubsets[s].Count; k++)
+			FinalIndices[SubsetRecords[s].Offset + k] = Level0Next++;
+	}
+
+	uint32_t CoarseNext = Level0Next;
+	for (uint32_t s = 0; s < SubsetCount; s++)
+	{
+		for (uint32_t k = Level0.MeshletSubsets[s].Count; k < SubsetRecords[s].Count; k++)
+			FinalIndices[SubsetRecords[s].Offset + k] = CoarseNext++;
+	}
+
+	for (uint32_t r = 0; r < Build.RecordCount; r++)
+	{
+		const uint32_t Final = FinalIndices[r];
+
+		Data->Meshlets[Final] = Build.Meshlets[r];
+		Data->CullingData[Final] = Build.CullData[r];
+		Out->ClusterLods[Final] = Build.Lods[r];
+
+		//child ranges never straddle level 0 and the coarser levels, so their first record maps the whole range
+		if (Build.Lods[r].ChildCount != 0)
+			Out->ClusterLods[Final].ChildOffset = FinalIndices[Build.Lods[r].ChildOffset];
+	}
+
+	for (uint32_t s = 0; s < SubsetCount; s++)
+		Out->ClusterRoots[s].Offset = FinalIndices[Out->ClusterRoots[s].Offset];
+
+	for (uint32_t v = 0; v < Build.UniqueCount; v++)
+	{
+		if (Mesh->IndexSize == 2)
+			((uint16_t*)Data->UniqueVertexIndices)[v] = (uint16_t)Build.Unique[v];
+		else
+			((uint32_t*)Data->UniqueVertexIndices)[v] = Build.Unique[v];
+	}
+
+	memcpy(Data->PrimitiveIndices, Build.Prims, sizeof(struct PackedTriangle) * Build.PrimCount);
+
+	Result = MESHLET_BUILD_OK;
+
+done:
+	MeshletDataFree(&Level0);
+	free(Build.Weld);
+	free(Build.Meshlets);
+	free(Build.CullData);
+	free(Build.Lods);
+	free(Build.Unique);
+	free(Build.Prims);
+	free(SubsetRecords);
+	free(FinalIndices);
+
+	if (Result != MESHLET_BUILD_OK)
+		MeshletDagFree(Out);
+
+	return Result;
+}
+
+void MeshletDagApply(const struct MeshletDag* Dag, struct Mesh* Mesh)
+{
+	MeshletDataApply(&Dag->Meshlets, Mesh);
+
+	Mesh->ClusterLods = Dag->ClusterLods;
+	Mesh->ClusterLodCount = Dag->ClusterLodCount;
+	Mesh->ClusterRoots = Dag->ClusterRoots;
+	Mesh->ClusterRootCount = Dag->ClusterRootCount;
+}
+
+void MeshletDagFree(struct MeshletDag* Dag)
+{
+	MeshletDataFree(&Dag->Meshlets);
+	free(Dag->ClusterLods);
+	free(Dag->ClusterRoots);
+	memset(Dag, 0, sizeof(*Dag));
+}
+
+bool ClusterErrorAcceptable(const struct LodView* View, float Error, const float Bounds[4])
+{
+	const float Dx = Bounds[0] - View->Position[0];
+	const float Dy = Bounds[1] - View->Position[1];
+	const float Dz = Bounds[2] - View->Position[2];
+
+	return Error < (sqrtf((Dx * Dx + Dy * Dy) + Dz * Dz) - Bounds[3]) * View->ErrorPerDistance;
+}
+
+//the recursion goes one level per call, and a dag is only as deep as its group count halves
+static uint32_t CutRange(const struct LodView* View, const struct ClusterLod* Lods, uint32_t First, uint32_t Count, uint32_t* Out, uint32_t OutCount)
+{
+	for (uint32_t i = First; i < First + Count; i++)
+	{
+		const struct ClusterLod* Lod = &Lods[i];
+
+		if (Lod->ChildCount == 0 || ClusterErrorAcceptable(View, Lod->Error, Lod->Bounds))
+			Out[OutCount++] = i;
+		else if (Lod->bFirstSibling)
+			OutCount = CutRange(View, Lods, Lod->ChildOffset, Lod->ChildCount, Out, OutCount);
+	}
+
+	return OutCount;
+}
+
+uint32_t CutMeshletDag(const struct LodView* View, const struct Mesh* Mesh, uint32_t SubsetIndex, uint32_t* Out)
+{
+	if (Mesh->ClusterLodCount == 0)
+	{
+		const struct Subset* Subset = &Mesh->MeshletSubsets[SubsetIndex];
+
+		for (uint32_t i = 0; i < Subset->Count; i++)
+			Out[i] = Subset->Offset + i;
+
+		return Subset->Count;
+	}
+
+	const struct Subset* Roots = &Mesh->ClusterRoots[SubsetIndex];
+	return CutRange(View, Mesh->ClusterLods, Roots->Offset, Roots->Count, Out, 0);
+}
+
+uint32_t CutMeshletDagReference(const struct LodView* View, const struct Mesh* Mesh, uint32_t* Out)
+{
+	uint32_t Count = 0;
+
+	if (Mesh->ClusterLodCount == 0)
+	{
+		for (uint32_t s = 0; s < Mesh->MeshletSubsetCount; s++)
+			Count += CutMeshletDag(View, Mesh, s, Out + Count);
+
+		return Count;
+	}
+
+	for (uint32_t i = 0; i < Mesh->ClusterLodCount; i++)
+	{
+		const struct ClusterLod* Lod = &Mesh->ClusterLods[i];
+
+		if ((Lod->ChildCount == 0 || ClusterErrorAcceptable(View, Lod->Error, Lod->Bounds)) && !ClusterErrorAcceptable(View, Lod->ParentError, Lod->ParentBounds))
+			Out[Count++] = i;
+	}
+
+	return Count;
+}
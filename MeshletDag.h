@@ -0,0 +1,66 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "MeshFile.h"
+#include "MeshLod.h"
+#include "MeshletBuilder.h"
+
+//cluster level of detail: builds the ClusterLod dag of a mesh and cuts it for a view.
+//level 0 is the mesh meshletized as usual. each level's meshlets are split into groups of up to
+//MESHLET_DAG_GROUP_SIZE that share the most vertices, seeded along a morton curve; every group is simplified to half
+//its triangles with its border locked (MeshSimplify locks open edges, and a group's border is open) and meshletized
+//again. groups that don't simplify carry their meshlets up unchanged, and the dag ends once a level stops shrinking.
+//every meshlet is drawn from the mesh's own vertex buffer, so coarser levels need no vertex data of their own
+
+#define MESHLET_DAG_GROUP_SIZE 8
+
+//owned streams of a mesh with a dag, laid out exactly like the MSHL file streams. the meshlet streams replace the
+//mesh's own: level 0 first, covered by MeshletSubsets, then every coarser level
+struct MeshletDag
+{
+	struct MeshletData Meshlets;
+
+	struct ClusterLod* ClusterLods;
+	uint32_t ClusterLodCount;
+
+	struct Subset* ClusterRoots;//one per index subset
+	uint32_t ClusterRootCount;
+
+	uint32_t LevelCount;//of the deepest subset, level 0 included
+};
+
+//ThreadCount 0 = one per processor; groups of a level are simplified in parallel and the output doesn't depend on it
+enum MeshletBuildResult BuildMeshletDag(const struct Mesh* Mesh, uint32_t MaxVertices, uint32_t MaxPrimitives, uint32_t ThreadCount, struct MeshletDag* Out);
+
+//points Mesh's meshlet and cluster fields at Dag; Dag must outlive Mesh's use of them
+void MeshletDagApply(const struct MeshletDag* Dag, struct Mesh* Mesh);
+
+void MeshletDagFree(struct MeshletDag* Dag);
+
+//the test both cuts share: an error is acceptable when it projects under the view's budget from the nearest point of
+//the sphere, the same rule SelectLod uses
+bool ClusterErrorAcceptable(const struct LodView* View, float Error, const float Bounds[4]);
+
+//walks one index subset's dag down from its roots and writes the meshlets to draw to Out, returning how many: never
+//more than the subset's level 0 meshlets, which is all it gives for meshes without a dag
+uint32_t CutMeshletDag(const struct LodView* View, const struct Mesh* Mesh, uint32_t SubsetIndex, uint32_t* Out);
+
+//brute force reference over every meshlet of the mesh, in ascending order: each one whose own error is acceptable
+//(or that is level 0) and whose parent's isn't. the same set as CutMeshletDag over all subsets
+uint32_t CutMeshletDagReference(const struct LodView* View, const struct Mesh* Mesh, uint32_t* Out);
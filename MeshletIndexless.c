@@ -0,0 +1,385 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "MeshletIndexless.h"
+
+static inline uint32_t ReadIndex(const uint8_t* Indices, uint32_t IndexSize, uint32_t i)
+{
+	return IndexSize == 2 ? ((const uint16_t*)Indices)[i] : ((const uint32_t*)Indices)[i];
+}
+
+static inline void WriteIndex(uint8_t* Indices, uint32_t IndexSize, uint32_t i, uint32_t Value)
+{
+	if (IndexSize == 2)
+		((uint16_t*)Indices)[i] = (uint16_t)Value;
+	else
+		((uint32_t*)Indices)[i] = Value;
+}
+
+bool BuildIndexlessMesh(const struct Mesh* Mesh, struct IndexlessMeshData* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	if (Mesh->MeshletSubsetCount != Mesh->IndexSubsetCount)
+		return false;
+
+	uint64_t VertexCount = 0;
+	uint64_t IndexCount = 0;
+
+	for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+		VertexCount += Mesh->Meshlets[m].VertCount;
+
+	for (uint32_t s = 0; s < Mesh->MeshletSubsetCount; s++)
+	{
+		const struct Subset* MeshletSubset = &Mesh->MeshletSubsets[s];
+
+		for (uint32_t m = MeshletSubset->Offset; m < MeshletSubset->Offset + MeshletSubset->Count; m++)
+			IndexCount += (uint64_t)Mesh->Meshlets[m].PrimCount * 3;
+	}
+
+	if (VertexCount > UINT32_MAX || IndexCount > UINT32_MAX)
+		return false;
+
+	Out->VertexBufferCount = Mesh->VertexBufferCount;
+	Out->VertexCount = (uint32_t)VertexCount;
+	Out->MeshletCount = Mesh->MeshletCount;
+	Out->IndexSize = VertexCount <= UINT16_MAX + 1 ? 2 : 4;
+	Out->IndexCount = (uint32_t)IndexCount;
+	Out->IndexSubsetCount = Mesh->IndexSubsetCount;
+
+	for (uint32_t j = 0; j < Out->VertexBufferCount; j++)
+	{
+		//+ 1 so an empty mesh still gets a pointer
+		Out->VertexBuffers[j] = malloc((size_t)VertexCount * Mesh->VertexBuffers[j].Stride + 1);
+		if (!Out->VertexBuffers[j])
+			goto fail;
+	}
+
+	Out->Meshlets = malloc(sizeof(struct Meshlet) * Out->MeshletCount + 1);
+	Out->IndexBuffer = malloc((size_t)IndexCount * Out->IndexSize + 1);
+	Out->IndexSubsets = malloc(sizeof(struct Subset) * Out->IndexSubsetCount + 1);
+
+	if (!Out->Meshlets || !Out->IndexBuffer || !Out->IndexSubsets)
+		goto fail;
+
+	//coarse dag meshlets past the subsets get their own vertices too, in meshlet order
+	uint32_t VertOffset = 0;
+	for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+	{
+		struct Meshlet Meshlet = Mesh->Meshlets[m];
+
+		for (uint32_t v = 0; v < Meshlet.VertCount; v++)
+		{
+			const uint32_t Source = MeshletVertexIndex(Mesh, Meshlet.VertOffset + v);
+			if (Source >= Mesh->VertexCount)
+				goto fail;
+
+			for (uint32_t j = 0; j < Out->VertexBufferCount; j++)
+			{
+				const uint32_t Stride = Mesh->VertexBuffers[j].Stride;
+				memcpy(Out->VertexBuffers[j] + (size_t)(VertOffset + v) * Stride, Mesh->VertexBuffers[j].Verts + (size_t)Source * Stride, Stride);
+			}
+		}
+
+		Meshlet.VertOffset = VertOffset;
+		Out->Meshlets[m] = Meshlet;
+		VertOffset += Meshlet.VertCount;
+	}
+
+	uint32_t Index = 0;
+	for (uint32_t s = 0; s < Mesh->MeshletSubsetCount; s++)
+	{
+		const struct Subset* MeshletSubset = &Mesh->MeshletSubsets[s];
+
+		Out->IndexSubsets[s].Offset = Index;
+
+		for (uint32_t m = MeshletSubset->Offset; m < MeshletSubset->Offset + MeshletSubset->Count; m++)
+		{
+			const struct Meshlet* Meshlet = &Out->Meshlets[m];
+
+			for (uint32_t p = 0; p < Meshlet->PrimCount; p++)
+			{
+				const struct PackedTriangle Triangle = Mesh->PrimitiveIndices[Meshlet->PrimOffset + p];
+
+				WriteIndex(Out->IndexBuffer, Out->IndexSize, Index++, Meshlet->VertOffset + Triangle.i0);
+				WriteIndex(Out->IndexBuffer, Out->IndexSize, Index++, Meshlet->VertOffset + Triangle.i1);
+				WriteIndex(Out->IndexBuffer, Out->IndexSize, Index++, Meshlet->VertOffset + Triangle.i2);
+			}
+		}
+
+		Out->IndexSubsets[s].Count = Index - Out->IndexSubsets[s].Offset;
+	}
+
+	return true;
+
+fail:
+	IndexlessMeshDataFree(Out);
+	return false;
+}
+
+void IndexlessMeshDataApply(const struct IndexlessMeshData* Data, struct Mesh* Mesh)
+{
+	for (uint32_t j = 0; j < Data->VertexBufferCount; j++)
+	{
+		Mesh->VertexBuffers[j].Verts = Data->VertexBuffers[j];
+		Mesh->VertexBuffers[j].Size = Data->VertexCount * Mesh->VertexBuffers[j].Stride;
+	}
+
+	Mesh->VertexCount = Data->VertexCount;
+	Mesh->Meshlets = Data->Meshlets;
+	Mesh->MeshletCount = Data->MeshletCount;
+	Mesh->IndexBuffer = Data->IndexBuffer;
+	Mesh->IndexBufferSize = Data->IndexCount * Data->IndexSize;
+	Mesh->IndexSize = Data->IndexSize;
+	Mesh->IndexCount = Data->IndexCount;
+	Mesh->IndexSubsets = Data->IndexSubsets;
+	Mesh->IndexSubsetCount = Data->IndexSubsetCount;
+	Mesh->UniqueVertexIndices = NULL;
+	Mesh->UniqueVertexIndexCount = 0;
+	Mesh->MeshletFlags |= MESHLET_FLAG_INDEXLESS;
+}
+
+void IndexlessMeshDataFree(struct IndexlessMeshData* Data)
+{
+	for (uint32_t j = 0; j < ATTRIBUTE_TYPE_COUNT; j++)
+		free(Data->VertexBuffers[j]);
+
+	free(Data->Meshlets);
+	free(Data->IndexBuffer);
+	free(Data->IndexSubsets);
+	memset(Data, 0, sizeof(*Data));
+}
+
+//rotates a triangle so its smallest index comes first; winding is kept
+static void CanonicalTriangle(uint32_t a, uint32_t b, uint32_t c, uint32_t Out[3])
+{
+	if (a <= b && a <= c)
+	{
+		Out[0] = a; Out[1] = b; Out[2] = c;
+	}
+	else if (b <= a && b <= c)
+	{
+		Out[0] = b; Out[1] = c; Out[2] = a;
+	}
+	else
+	{
+		Out[0] = c; Out[1] = a; Out[2] = b;
+	}
+}
+
+static int CompareTriangles(const void* A, const void* B)
+{
+	const uint32_t* a = A;
+	const uint32_t* b = B;
+
+	for (int k = 0; k < 3; k++)
+	{
+		if (a[k] != b[k])
+			return a[k] < b[k] ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static uint64_t SubsetTriangleCount(const struct Mesh* Mesh)
+{
+	uint64_t Count = 0;
+	for (uint32_t s = 0; s < Mesh->IndexSubsetCount; s++)
+		Count += Mesh->IndexSubsets[s].Count / 3;
+
+	return Count;
+}
+
+uint64_t ValidateIndexlessMesh(const struct Mesh* Source, const struct Mesh* Indexless)
+{
+	uint64_t Errors = 0;
+
+	if (!(Indexless->MeshletFlags & MESHLET_FLAG_INDEXLESS) || Indexless->MeshletCount != Source->MeshletCount ||
+		Indexless->VertexBufferCount != Source->VertexBufferCount)
+	{
+		for (uint32_t m = 0; m < Source->MeshletCount; m++)
+			Errors += Source->Meshlets[m].PrimCount;
+
+		return Errors + SubsetTriangleCount(Source);
+	}
+
+	for (uint32_t j = 0; j < Source->VertexBufferCount; j++)
+	{
+		if (Indexless->VertexBuffers[j].Stride != Source->VertexBuffers[j].Stride)
+		{
+			for (uint32_t m = 0; m < Source->MeshletCount; m++)
+				Errors += Source->Meshlets[m].PrimCount;
+
+			return Errors + SubsetTriangleCount(Source);
+		}
+	}
+
+	//the source vertex each indexless vertex was copied from, UINT32_MAX until a meshlet vouches for it. a vertex
+	//claimed by two meshlets with different sources stays unclaimed and fails every triangle that uses it
+	const uint32_t Unclaimed = UINT32_MAX;
+	const uint32_t Conflicted = UINT32_MAX - 1;
+
+	uint32_t* SourceVertices = malloc(sizeof(uint32_t) * Indexless->VertexCount + 1);
+	if (!SourceVertices)
+		return UINT64_MAX;
+
+	for (uint32_t v = 0; v < Indexless->VertexCount; v++)
+		SourceVertices[v] = Unclaimed;
+
+	const uint32_t SourceUniqueCount = (Source->MeshletFlags & MESHLET_FLAG_INDEXLESS) ? Source->VertexCount :
+		Source->IndexSize ? Source->UniqueVertexIndexCount / Source->IndexSize : 0;
+
+	for (uint32_t m = 0; m < Source->MeshletCount; m++)
+	{
+		const struct Meshlet* SourceMeshlet = &Source->Meshlets[m];
+		const struct Meshlet* Meshlet = &Indexless->Meshlets[m];
+
+		if (Meshlet->VertCount != SourceMeshlet->VertCount || Meshlet->PrimCount != SourceMeshlet->PrimCount ||
+			Meshlet->VertCount > MESHLET_MAX_VERTICES_LIMIT ||
+			(uint64_t)Meshlet->VertOffset + Meshlet->VertCount > Indexless->VertexCount ||
+			(uint64_t)SourceMeshlet->VertOffset + SourceMeshlet->VertCount > SourceUniqueCount ||
+			(uint64_t)Meshlet->PrimOffset + Meshlet->PrimCount > Indexless->PrimitiveIndexCount ||
+			(uint64_t)SourceMeshlet->PrimOffset + SourceMeshlet->PrimCount > Source->PrimitiveIndexCount)
+		{
+			Errors += SourceMeshlet->PrimCount;
+			continue;
+		}
+
+		bool Same[MESHLET_MAX_VERTICES_LIMIT];
+
+		for (uint32_t v = 0; v < Meshlet->VertCount; v++)
+		{
+			const uint32_t From = MeshletVertexIndex(Source, SourceMeshlet->VertOffset + v);
+			const uint32_t To = Meshlet->VertOffset + v;
+
+			Same[v] = From < Source->VertexCount;
+
+			for (uint32_t j = 0; j < Source->VertexBufferCount && Same[v]; j++)
+			{
+				const uint32_t Stride = Source->VertexBuffers[j].Stride;
+				Same[v] = memcmp(Source->VertexBuffers[j].Verts + (size_t)From * Stride, Indexless->VertexBuffers[j].Verts + (size_t)To * Stride, Stride) == 0;
+			}
+
+			if (!Same[v])
+				SourceVertices[To] = Conflicted;
+			else if (SourceVertices[To] == Unclaimed)
+				SourceVertices[To] = From;
+			else if (SourceVertices[To] != From)
+				SourceVertices[To] = Conflicted;
+		}
+
+		for (uint32_t p = 0; p < Meshlet->PrimCount; p++)
+		{
+			const struct PackedTriangle a = Source->PrimitiveIndices[SourceMeshlet->PrimOffset + p];
+			const struct PackedTriangle b = Indexless->PrimitiveIndices[Meshlet->PrimOffset + p];
+
+			if (a.i0 != b.i0 || a.i1 != b.i1 || a.i2 != b.i2 || a.i0 >= Meshlet->VertCount || a.i1 >= Meshlet->VertCount || a.i2 >= Meshlet->VertCount ||
+				!Same[a.i0] || !Same[a.i1] || !Same[a.i2])
+			{
+				Errors++;
+			}
+		}
+	}
+
+	//the index buffers, mapped back to source vertices, must hold the same triangles subset by subset
+	if (Indexless->IndexSubsetCount != Source->IndexSubsetCount)
+	{
+		free(SourceVertices);
+		return Errors + SubsetTriangleCount(Source);
+	}
+
+	for (uint32_t s = 0; s < Source->IndexSubsetCount; s++)
+	{
+		const struct Subset* Expected = &Source->IndexSubsets[s];
+		const struct Subset* Actual = &Indexless->IndexSubsets[s];
+		const uint32_t Count = Expected->Count / 3;
+
+		if (Actual->Count != Expected->Count ||
+			(uint64_t)Expected->Offset + Expected->Count > Source->IndexCount ||
+			(uint64_t)Actual->Offset + Actual->Count > Indexless->IndexCount)
+		{
+			Errors += Count;
+			continue;
+		}
+
+		uint32_t* ExpectedTriangles = malloc(sizeof(uint32_t) * 3 * Count + 1);
+		uint32_t* ActualTriangles = malloc(sizeof(uint32_t) * 3 * Count + 1);
+
+		if (!ExpectedTriangles || !ActualTriangles)
+		{
+			free(ExpectedTriangles);
+			free(ActualTriangles);
+			free(SourceVertices);
+			return UINT64_MAX;
+		}
+
+		for (uint32_t t = 0; t < Count; t++)
+		{
+			uint32_t a[3];
+			uint32_t b[3];
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				a[k] = ReadIndex(Source->IndexBuffer, Source->IndexSize, Expected->Offset + t * 3 + k);
+
+				const uint32_t Vertex = ReadIndex(Indexless->IndexBuffer, Indexless->IndexSize, Actual->Offset + t * 3 + k);
+				b[k] = Vertex < Indexless->VertexCount ? SourceVertices[Vertex] : Unclaimed;
+			}
+
+			CanonicalTriangle(a[0], a[1], a[2], &ExpectedTriangles[t * 3]);
+			CanonicalTriangle(b[0], b[1], b[2], &ActualTriangles[t * 3]);
+		}
+
+		qsort(ExpectedTriangles, Count, sizeof(uint32_t) * 3, CompareTriangles);
+		qsort(ActualTriangles, Count, sizeof(uint32_t) * 3, CompareTriangles);
+
+		//whatever doesn't pair up in the merge is a triangle that changed
+		uint32_t i = 0;
+		uint32_t j = 0;
+		uint32_t Matched = 0;
+
+		while (i < Count && j < Count)
+		{
+			const int Order = CompareTriangles(&ExpectedTriangles[i * 3], &ActualTriangles[j * 3]);
+
+			if (Order == 0)
+			{
+				Matched++;
+				i++;
+				j++;
+			}
+			else if (Order < 0)
+			{
+				i++;
+			}
+			else
+			{
+				j++;
+			}
+		}
+
+		Errors += Count - Matched;
+
+		free(ExpectedTriangles);
+		free(ActualTriangles);
+	}
+
+	free(SourceVertices);
+	return Errors;
+}
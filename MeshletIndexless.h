@@ -0,0 +1,63 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "MeshFile.h"
+
+//indexless meshlet layout (MESHLET_FLAG_INDEXLESS): every meshlet's vertices are copied, in local index order, into a
+//contiguous range of new vertex buffers, so the mesh shader reads vertex VertOffset + local index straight away
+//instead of going through UniqueVertexIndices first. vertices on the border between meshlets are stored once per
+//meshlet that uses them; that duplication is the price of dropping the index stream.
+//the index buffer is rewritten to address the new vertices with each subset's triangles in meshlet order, so the
+//index buffer and meshlets still describe the same triangles
+
+//owned copies of the streams the conversion changes; the rest of the mesh is left as it is
+struct IndexlessMeshData
+{
+	uint8_t* VertexBuffers[ATTRIBUTE_TYPE_COUNT];//VertexCount vertices at the source's strides
+	uint32_t VertexBufferCount;
+	uint32_t VertexCount;
+
+	struct Meshlet* Meshlets;//the source's with VertOffset moved into the new vertices
+	uint32_t MeshletCount;
+
+	uint8_t* IndexBuffer;//IndexSize wide, 2 if VertexCount allows it
+	uint32_t IndexSize;
+	uint32_t IndexCount;
+
+	struct Subset* IndexSubsets;
+	uint32_t IndexSubsetCount;
+};
+
+//false if memory runs out, the meshlets need more than 2^32 vertices, a meshlet addresses a vertex the mesh doesn't
+//have, or the meshlet subsets don't pair up with the index subsets
+bool BuildIndexlessMesh(const struct Mesh* Mesh, struct IndexlessMeshData* Out);
+
+//points Mesh's vertex, index and meshlet fields at Data, empties UniqueVertexIndices and sets MESHLET_FLAG_INDEXLESS.
+//Data must outlive Mesh's use of them
+void IndexlessMeshDataApply(const struct IndexlessMeshData* Data, struct Mesh* Mesh);
+
+void IndexlessMeshDataFree(struct IndexlessMeshData* Data);
+
+//checks that Indexless, converted from Source, draws the same triangles: every meshlet keeps its primitives and
+//their corners have the same vertex bytes as in Source, and each index subset holds the same triangles, winding
+//included, as Source's. returns the number of triangles that differ; a meshlet or subset whose shape doesn't match
+//counts all of its triangles
+uint64_t ValidateIndexlessMesh(const struct Mesh* Source, const struct Mesh* Indexless);
@@ -0,0 +1,567 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#include "MeshletLocality.h"
+
+static int CompareU64(const void* A, const void* B)
+{
+	const uint64_t a = *(const uint64_t*)A;
+	const uint64_t b = *(const uint64_t*)B;
+	return (a > b) - (a < b);
+}
+
+static inline uint32_t SpreadBits(uint32_t Value)
+{
+	Value &= 0x3FF;
+	Value = (Value | (Value << 16)) & 0x030000FF;
+	Value = (Value | (Value << 8)) & 0x0300F00F;
+	Value = (Value | (Value << 4)) & 0x030C30C3;
+	Value = (Value | (Value << 2)) & 0x09249249;
+	return Value;
+}
+
+static inline uint32_t ReadIndex(const uint8_t* Indices, uint32_t IndexSize, uint32_t i)
+{
+	return IndexSize == 2 ? ((const uint16_t*)Indices)[i] : ((const uint32_t*)Indices)[i];
+}
+
+static inline void WriteIndex(uint8_t* Indices, uint32_t IndexSize, uint32_t i, uint32_t Value)
+{
+	if (IndexSize == 2)
+		((uint16_t*)Indices)[i] = (uint16_t)Value;
+	else
+		((uint32_t*)Indices)[i] = Value;
+}
+
+static uint32_t MeshletVertexCapacity(const struct Mesh* Mesh)
+{
+	if (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS)
+		return Mesh->VertexCount;
+
+	return Mesh->IndexSize ? Mesh->UniqueVertexIndexCount / Mesh->IndexSize : 0;
+}
+
+//sorts the meshlets of one subset by the morton code of their sphere centres over the subset's bounds
+static void SortSubset(const struct Mesh* Mesh, const struct Subset* Subset, uint64_t* Keys, uint32_t* Order)
+{
+	float Min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float Max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	for (uint32_t m = Subset->Offset; m < Subset->Offset + Subset->Count; m++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			Min[k] = fminf(Min[k], Mesh->CullingData[m].BoundingSphere[k]);
+			Max[k] = fmaxf(Max[k], Mesh->CullingData[m].BoundingSphere[k]);
+		}
+	}
+
+	for (uint32_t i = 0; i < Subset->Count; i++)
+	{
+		const uint32_t m = Subset->Offset + i;
+		uint32_t Code = 0;
+
+		for (int k = 0; k < 3; k++)
+		{
+			const float Extent = Max[k] - Min[k];
+			const float t = Extent > 0.0f ? (Mesh->CullingData[m].BoundingSphere[k] - Min[k]) / Extent : 0.0f;
+			Code |= SpreadBits((uint32_t)(t * 1023.0f)) << k;
+		}
+
+		//the meshlet index breaks ties, so equal codes keep their order
+		Keys[i] = (uint64_t)Code << 32 | m;
+	}
+
+	qsort(Keys, Subset->Count, sizeof(uint64_t), CompareU64);
+
+	for (uint32_t i = 0; i < Subset->Count; i++)
+		Order[Subset->Offset + i] = (uint32_t)Keys[i];
+}
+
+bool OptimizeMeshletLocality(const struct Mesh* Mesh, struct MeshletLocalityData* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	const bool bIndexless = (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS) != 0;
+	const uint32_t MeshletCount = Mesh->MeshletCount;
+	const uint32_t VertexCount = Mesh->VertexCount;
+	const uint32_t UniqueCount = MeshletVertexCapacity(Mesh);
+
+	Out->VertexBufferCount = Mesh->VertexBufferCount;
+	Out->MeshletCount = MeshletCount;
+	Out->VertexCount = VertexCount;
+
+	//dag groups are meshlet ranges and meshlets without their own cull data have nothing to sort by. meshlets that
+	//keep their order keep their stream layout too, which may be shared between them; reordered ones are packed
+	const bool bReorder = Mesh->ClusterLodCount == 0 && Mesh->CullingDataCount == MeshletCount;
+
+	uint64_t VertexListSize = Mesh->UniqueVertexIndexCount;
+	uint64_t PrimitiveCount = Mesh->PrimitiveIndexCount;
+
+	if (bReorder)
+	{
+		VertexListSize = 0;
+		PrimitiveCount = 0;
+
+		for (uint32_t m = 0; m < MeshletCount; m++)
+		{
+			VertexListSize += (uint64_t)Mesh->Meshlets[m].VertCount * Mesh->IndexSize;
+			PrimitiveCount += Mesh->Meshlets[m].PrimCount;
+		}
+
+		if (VertexListSize > UINT32_MAX || PrimitiveCount > UINT32_MAX)
+			return false;
+	}
+
+	uint64_t* Keys = NULL;
+
+	for (uint32_t j = 0; j < Out->VertexBufferCount; j++)
+	{
+		Out->VertexBuffers[j] = malloc((size_t)VertexCount * Mesh->VertexBuffers[j].Stride + 1);
+		if (!Out->VertexBuffers[j])
+			goto fail;
+	}
+
+	Out->IndexBuffer = malloc((size_t)Mesh->IndexCount * Mesh->IndexSize + 1);
+	Out->Meshlets = malloc(sizeof(struct Meshlet) * MeshletCount + 1);
+	Out->PrimitiveIndices = malloc(sizeof(struct PackedTriangle) * PrimitiveCount + 1);
+	Out->MeshletOrder = malloc(sizeof(uint32_t) * MeshletCount + 1);
+	Out->VertexRemap = malloc(sizeof(uint32_t) * VertexCount + 1);
+	Keys = malloc(sizeof(uint64_t) * MeshletCount + 1);
+
+	if (!Out->IndexBuffer || !Out->Meshlets || !Out->PrimitiveIndices || !Out->MeshletOrder || !Out->VertexRemap || !Keys)
+		goto fail;
+
+	if (!bIndexless && !(Out->UniqueVertexIndices = malloc((size_t)VertexListSize + 1)))
+		goto fail;
+
+	if (Mesh->CullingDataCount && !(Out->CullingData = malloc(sizeof(struct CullData) * Mesh->CullingDataCount)))
+		goto fail;
+
+	for (uint32_t m = 0; m < MeshletCount; m++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+
+		if ((uint64_t)Meshlet->VertOffset + Meshlet->VertCount > UniqueCount ||
+			(uint64_t)Meshlet->PrimOffset + Meshlet->PrimCount > Mesh->PrimitiveIndexCount)
+			goto fail;
+
+		Out->MeshletOrder[m] = m;
+	}
+
+	if (bReorder)
+	{
+		for (uint32_t s = 0; s < Mesh->MeshletSubsetCount; s++)
+		{
+			if ((uint64_t)Mesh->MeshletSubsets[s].Offset + Mesh->MeshletSubsets[s].Count > MeshletCount)
+				goto fail;
+
+			SortSubset(Mesh, &Mesh->MeshletSubsets[s], Keys, Out->MeshletOrder);
+		}
+	}
+
+	// Vertices in the order the reordered meshlets first use them; ones no meshlet uses go last, in their old order.
+	for (uint32_t v = 0; v < VertexCount; v++)
+		Out->VertexRemap[v] = UINT32_MAX;
+
+	uint32_t Next = 0;
+	for (uint32_t i = 0; i < MeshletCount; i++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[Out->MeshletOrder[i]];
+
+		for (uint32_t k = 0; k < Meshlet->VertCount; k++)
+		{
+			const uint32_t v = MeshletVertexIndex(Mesh, Meshlet->VertOffset + k);
+			if (v >= VertexCount)
+				goto fail;
+
+			if (Out->VertexRemap[v] == UINT32_MAX)
+				Out->VertexRemap[v] = Next++;
+		}
+	}
+
+	for (uint32_t v = 0; v < VertexCount; v++)
+	{
+		if (Out->VertexRemap[v] == UINT32_MAX)
+			Out->VertexRemap[v] = Next++;
+	}
+
+	for (uint32_t j = 0; j < Out->VertexBufferCount; j++)
+	{
+		const uint32_t Stride = Mesh->VertexBuffers[j].Stride;
+
+		for (uint32_t v = 0; v < VertexCount; v++)
+			memcpy(Out->VertexBuffers[j] + (size_t)Out->VertexRemap[v] * Stride, Mesh->VertexBuffers[j].Verts + (size_t)v * Stride, Stride);
+	}
+
+	for (uint32_t i = 0; i < Mesh->IndexCount; i++)
+	{
+		const uint32_t v = ReadIndex(Mesh->IndexBuffer, Mesh->IndexSize, i);
+		if (v >= VertexCount)
+			goto fail;
+
+		WriteIndex(Out->IndexBuffer, Mesh->IndexSize, i, Out->VertexRemap[v]);
+	}
+
+	// Meshlet streams in the new order, packed back to back.
+	uint32_t VertRun = 0;
+	uint32_t PrimRun = 0;
+
+	for (uint32_t i = 0; i < MeshletCount; i++)
+	{
+		const uint32_t m = Out->MeshletOrder[i];
+		const struct Meshlet* Source = &Mesh->Meshlets[m];
+		struct Meshlet* Meshlet = &Out->Meshlets[i];
+
+		*Meshlet = *Source;
+
+		if (bIndexless)
+		{
+			//first use numbering keeps each range contiguous unless the source's ranges overlapped
+			Meshlet->VertOffset = Source->VertCount ? Out->VertexRemap[Source->VertOffset] : 0;
+
+			for (uint32_t k = 0; k < Source->VertCount; k++)
+			{
+				if (Out->VertexRemap[Source->VertOffset + k] != Meshlet->VertOffset + k)
+					goto fail;
+			}
+		}
+		else if (bReorder)
+		{
+			Meshlet->VertOffset = VertRun;
+
+			for (uint32_t k = 0; k < Source->VertCount; k++)
+				WriteIndex(Out->UniqueVertexIndices, Mesh->IndexSize, VertRun + k, Out->VertexRemap[MeshletVertexIndex(Mesh, Source->VertOffset + k)]);
+
+			VertRun += Source->VertCount;
+		}
+
+		if (bReorder)
+		{
+			Meshlet->PrimOffset = PrimRun;
+			memcpy(&Out->PrimitiveIndices[PrimRun], &Mesh->PrimitiveIndices[Source->PrimOffset], sizeof(struct PackedTriangle) * Source->PrimCount);
+			PrimRun += Source->PrimCount;
+		}
+	}
+
+	if (!bReorder)
+	{
+		if (!bIndexless)
+		{
+			for (uint32_t k = 0; k < UniqueCount; k++)
+			{
+				const uint32_t v = ReadIndex(Mesh->UniqueVertexIndices, Mesh->IndexSize, k);
+				if (v >= VertexCount)
+					goto fail;
+
+				WriteIndex(Out->UniqueVertexIndices, Mesh->IndexSize, k, Out->VertexRemap[v]);
+			}
+		}
+
+		memcpy(Out->PrimitiveIndices, Mesh->PrimitiveIndices, sizeof(struct PackedTriangle) * Mesh->PrimitiveIndexCount);
+
+		VertRun = UniqueCount;
+		PrimRun = Mesh->PrimitiveIndexCount;
+	}
+
+	if (Out->CullingData)
+	{
+		for (uint32_t i = 0; i < Mesh->CullingDataCount; i++)
+			Out->CullingData[i] = Mesh->CullingData[Mesh->CullingDataCount == MeshletCount ? Out->MeshletOrder[i] : i];
+	}
+
+	Out->UniqueVertexIndexCount = bIndexless ? 0 : VertRun * Mesh->IndexSize;
+	Out->PrimitiveIndexCount = PrimRun;
+
+	free(Keys);
+	return true;
+
+fail:
+	free(Keys);
+	MeshletLocalityDataFree(Out);
+	return false;
+}
+
+void MeshletLocalityDataApply(const struct MeshletLocalityData* Data, struct Mesh* Mesh)
+{
+	for (uint32_t j = 0; j < Data->VertexBufferCount; j++)
+		Mesh->VertexBuffers[j].Verts = Data->VertexBuffers[j];
+
+	Mesh->IndexBuffer = Data->IndexBuffer;
+	Mesh->Meshlets = Data->Meshlets;
+	Mesh->UniqueVertexIndices = Data->UniqueVertexIndices;
+	Mesh->UniqueVertexIndexCount = Data->UniqueVertexIndexCount;
+	Mesh->PrimitiveIndices = Data->PrimitiveIndices;
+	Mesh->PrimitiveIndexCount = Data->PrimitiveIndexCount;
+
+	if (Data->CullingData)
+		Mesh->CullingData = Data->CullingData;
+}
+
+void MeshletLocalityDataFree(struct MeshletLocalityData* Data)
+{
+	for (uint32_t j = 0; j < ATTRIBUTE_TYPE_COUNT; j++)
+		free(Data->VertexBuffers[j]);
+
+	free(Data->IndexBuffer);
+	free(Data->Meshlets);
+	free(Data->UniqueVertexIndices);
+	free(Data->PrimitiveIndices);
+	free(Data->CullingData);
+	free(Data->MeshletOrder);
+	free(Data->VertexRemap);
+	memset(Data, 0, sizeof(*Data));
+}
+
+static bool SameVertex(const struct Mesh* A, uint32_t a, const struct Mesh* B, uint32_t b)
+{
+	if (a >= A->VertexCount || b >= B->VertexCount)
+		return false;
+
+	for (uint32_t j = 0; j < A->VertexBufferCount; j++)
+	{
+		const uint32_t Stride = A->VertexBuffers[j].Stride;
+
+		if (memcmp(A->VertexBuffers[j].Verts + (size_t)a * Stride, B->VertexBuffers[j].Verts + (size_t)b * Stride, Stride) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+uint64_t ValidateMeshletLocality(const struct Mesh* Source, const struct Mesh* Optimized, const struct MeshletLocalityData* Data)
+{
+	if (Optimized->MeshletCount != Source->MeshletCount || Optimized->IndexCount != Source->IndexCount ||
+		Optimized->VertexBufferCount != Source->VertexBufferCount || Optimized->CullingDataCount != Source->CullingDataCount)
+		return (uint64_t)Source->MeshletCount + Source->IndexCount;
+
+	uint64_t Errors = 0;
+	const uint32_t SourceCapacity = MeshletVertexCapacity(Source);
+	const uint32_t OptimizedCapacity = MeshletVertexCapacity(Optimized);
+
+	for (uint32_t i = 0; i < Optimized->MeshletCount; i++)
+	{
+		const uint32_t m = Data->MeshletOrder[i];
+		const struct Meshlet* Expected = &Source->Meshlets[m];
+		const struct Meshlet* Actual = &Optimized->Meshlets[i];
+
+		if (m >= Source->MeshletCount || Actual->VertCount != Expected->VertCount || Actual->PrimCount != Expected->PrimCount ||
+			(uint64_t)Actual->VertOffset + Actual->VertCount > OptimizedCapacity ||
+			(uint64_t)Expected->VertOffset + Expected->VertCount > SourceCapacity ||
+			(uint64_t)Actual->PrimOffset + Actual->PrimCount > Optimized->PrimitiveIndexCount ||
+			memcmp(&Optimized->PrimitiveIndices[Actual->PrimOffset], &Source->PrimitiveIndices[Expected->PrimOffset], sizeof(struct PackedTriangle) * Actual->PrimCount) != 0)
+		{
+			Errors++;
+			continue;
+		}
+
+		if (Source->CullingDataCount == Source->MeshletCount && memcmp(&Optimized->CullingData[i], &Source->CullingData[m], sizeof(struct CullData)) != 0)
+		{
+			Errors++;
+			continue;
+		}
+
+		for (uint32_t k = 0; k < Actual->VertCount; k++)
+		{
+			if (!SameVertex(Source, MeshletVertexIndex(Source, Expected->VertOffset + k), Optimized, MeshletVertexIndex(Optimized, Actual->VertOffset + k)))
+			{
+				Errors++;
+				break;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < Source->IndexCount; i++)
+	{
+		if (!SameVertex(Source, ReadIndex(Source->IndexBuffer, Source->IndexSize, i), Optimized, ReadIndex(Optimized->IndexBuffer, Optimized->IndexSize, i)))
+			Errors++;
+	}
+
+	return Errors;
+}
+
+struct FetchCache
+{
+	uint64_t* Tags;//line + 1, 0 = empty
+	uint64_t* Stamps;
+	uint32_t SetCount;
+	uint32_t Ways;
+	uint64_t Clock;
+};
+
+//true on a hit; a miss replaces the least recently used way of the line's set
+static bool TouchLine(struct FetchCache* Cache, uint64_t Line)
+{
+	uint64_t* Tags = &Cache->Tags[(Line % Cache->SetCount) * Cache->Ways];
+	uint64_t* Stamps = &Cache->Stamps[(Line % Cache->SetCount) * Cache->Ways];
+	uint32_t Oldest = 0;
+
+	Cache->Clock++;
+
+	for (uint32_t w = 0; w < Cache->Ways; w++)
+	{
+		if (Tags[w] == Line + 1)
+		{
+			Stamps[w] = Cache->Clock;
+			return true;
+		}
+
+		if (Stamps[w] < Stamps[Oldest])
+			Oldest = w;
+	}
+
+	Tags[Oldest] = Line + 1;
+	Stamps[Oldest] = Cache->Clock;
+	return false;
+}
+
+//each stream gets its own 2^40 byte address range
+static inline uint64_t StreamAddress(uint32_t Stream, uint64_t Offset)
+{
+	return (uint64_t)Stream << 40 | Offset;
+}
+
+//appends the lines [Begin, End) spans
+static uint32_t AddLines(uint64_t Begin, uint64_t End, uint32_t LineShift, uint64_t* Lines, uint32_t Count)
+{
+	if (End <= Begin)
+		return Count;
+
+	for (uint64_t Line = Begin >> LineShift; Line <= (End - 1) >> LineShift; Line++)
+		Lines[Count++] = Line;
+
+	return Count;
+}
+
+//sorts and dedups Lines, runs them through the cache and returns how many missed; *Distinct gets how many are left
+static uint32_t FetchLines(struct FetchCache* Cache, uint64_t* Lines, uint32_t Count, uint32_t* Distinct)
+{
+	qsort(Lines, Count, sizeof(uint64_t), CompareU64);
+
+	uint32_t Unique = 0;
+	uint32_t Misses = 0;
+
+	for (uint32_t i = 0; i < Count; i++)
+	{
+		if (i > 0 && Lines[i] == Lines[i - 1])
+			continue;
+
+		Unique++;
+		Misses += !TouchLine(Cache, Lines[i]);
+	}
+
+	*Distinct = Unique;
+	return Misses;
+}
+
+bool SimulateMeshletFetch(const struct Mesh* Mesh, const struct FetchCacheDesc* Desc, struct MeshletFetchStats* Out)
+{
+	memset(Out, 0, sizeof(*Out));
+
+	if (Desc->LineSize == 0 || (Desc->LineSize & (Desc->LineSize - 1)) != 0 || Desc->Ways == 0)
+		return false;
+
+	uint32_t LineShift = 0;
+	while ((1u << LineShift) < Desc->LineSize)
+		LineShift++;
+
+	struct FetchCache Cache = { 0 };
+	Cache.Ways = Desc->Ways;
+	Cache.SetCount = Desc->CacheSize / (Desc->LineSize * Desc->Ways);
+	if (Cache.SetCount == 0)
+		Cache.SetCount = 1;
+
+	//a vertex spans at most stride / line + 2 lines of each buffer; an index range at most its size / line + 2
+	uint32_t MaxVertCount = 0;
+	uint32_t MaxPrimCount = 0;
+	for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+	{
+		MaxVertCount = Mesh->Meshlets[m].VertCount > MaxVertCount ? Mesh->Meshlets[m].VertCount : MaxVertCount;
+		MaxPrimCount = Mesh->Meshlets[m].PrimCount > MaxPrimCount ? Mesh->Meshlets[m].PrimCount : MaxPrimCount;
+	}
+
+	uint64_t LinesPerVertex = 0;
+	for (uint32_t j = 0; j < Mesh->VertexBufferCount; j++)
+		LinesPerVertex += Mesh->VertexBuffers[j].Stride / Desc->LineSize + 2;
+
+	const uint64_t Capacity = (uint64_t)MaxVertCount * LinesPerVertex + ((uint64_t)MaxVertCount * 4 + (uint64_t)MaxPrimCount * sizeof(struct PackedTriangle) + sizeof(struct Meshlet)) / Desc->LineSize + 6;
+
+	uint64_t* Lines = malloc(sizeof(uint64_t) * Capacity);
+	Cache.Tags = calloc((size_t)Cache.SetCount * Cache.Ways, sizeof(uint64_t));
+	Cache.Stamps = calloc((size_t)Cache.SetCount * Cache.Ways, sizeof(uint64_t));
+
+	if (!Lines || !Cache.Tags || !Cache.Stamps)
+	{
+		free(Lines);
+		free(Cache.Tags);
+		free(Cache.Stamps);
+		return false;
+	}
+
+	const bool bIndexless = (Mesh->MeshletFlags & MESHLET_FLAG_INDEXLESS) != 0;
+	const uint32_t UniqueCount = MeshletVertexCapacity(Mesh);
+
+	for (uint32_t m = 0; m < Mesh->MeshletCount; m++)
+	{
+		const struct Meshlet* Meshlet = &Mesh->Meshlets[m];
+
+		if ((uint64_t)Meshlet->VertOffset + Meshlet->VertCount > UniqueCount)
+			continue;
+
+		// The meshlet, its vertex list and its primitives come first, then the vertices those indices point at.
+		uint32_t Count = AddLines(StreamAddress(MESH_STREAM_MESHLETS, (uint64_t)m * sizeof(struct Meshlet)), StreamAddress(MESH_STREAM_MESHLETS, (uint64_t)(m + 1) * sizeof(struct Meshlet)), LineShift, Lines, 0);
+
+		if (!bIndexless)
+		{
+			Count = AddLines(StreamAddress(MESH_STREAM_UNIQUE_VERTEX_INDICES, (uint64_t)Meshlet->VertOffset * Mesh->IndexSize),
+				StreamAddress(MESH_STREAM_UNIQUE_VERTEX_INDICES, ((uint64_t)Meshlet->VertOffset + Meshlet->VertCount) * Mesh->IndexSize), LineShift, Lines, Count);
+		}
+
+		Count = AddLines(StreamAddress(MESH_STREAM_PRIMITIVE_INDICES, (uint64_t)Meshlet->PrimOffset * sizeof(struct PackedTriangle)),
+			StreamAddress(MESH_STREAM_PRIMITIVE_INDICES, ((uint64_t)Meshlet->PrimOffset + Meshlet->PrimCount) * sizeof(struct PackedTriangle)), LineShift, Lines, Count);
+
+		uint32_t Distinct;
+		Out->IndexMisses += FetchLines(&Cache, Lines, Count, &Distinct);
+		Out->IndexLines += Distinct;
+
+		Count = 0;
+		for (uint32_t k = 0; k < Meshlet->VertCount; k++)
+		{
+			const uint64_t v = MeshletVertexIndex(Mesh, Meshlet->VertOffset + k);
+
+			for (uint32_t j = 0; j < Mesh->VertexBufferCount; j++)
+			{
+				const uint32_t Stride = Mesh->VertexBuffers[j].Stride;
+				Count = AddLines(StreamAddress(MESH_STREAM_VERTICES + j, v * Stride), StreamAddress(MESH_STREAM_VERTICES + j, (v + 1) * Stride), LineShift, Lines, Count);
+			}
+		}
+
+		Out->VertexMisses += FetchLines(&Cache, Lines, Count, &Distinct);
+		Out->VertexLines += Distinct;
+		Out->MaxVertexLines = Distinct > Out->MaxVertexLines ? Distinct : Out->MaxVertexLines;
+		Out->MeshletCount++;
+	}
+
+	free(Lines);
+	free(Cache.Tags);
+	free(Cache.Stamps);
+	return true;
+}
@@ -0,0 +1,92 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "MeshFile.h"
+
+//memory locality pass over a built mesh: meshlets of each subset are put in morton order of their cull sphere
+//centres, so meshlets drawn one after another sit next to each other, and vertices are renumbered in the order
+//those meshlets first use them, so a meshlet's vertices share cache lines with each other and with its neighbours'.
+//the unique vertex index, primitive and cull data streams follow the new meshlet order and the index buffer is
+//remapped; triangles and their order within the index buffer don't change.
+//meshes with a cluster dag keep their meshlet order, since dag groups are contiguous meshlet ranges, and only get
+//their vertices renumbered. indexless meshes stay indexless: every meshlet's range moves as a whole
+
+//owned copies of the streams the pass rewrites
+struct MeshletLocalityData
+{
+	uint8_t* VertexBuffers[ATTRIBUTE_TYPE_COUNT];
+	uint32_t VertexBufferCount;
+
+	uint8_t* IndexBuffer;
+	struct Meshlet* Meshlets;
+	uint8_t* UniqueVertexIndices;//NULL for indexless meshes
+	uint32_t UniqueVertexIndexCount;//in bytes, only what the meshlets use
+
+	struct PackedTriangle* PrimitiveIndices;
+	uint32_t PrimitiveIndexCount;
+
+	struct CullData* CullingData;//NULL if the mesh has none
+
+	uint32_t* MeshletOrder;//meshlet i is the source's MeshletOrder[i]
+	uint32_t* VertexRemap;//the source's vertex v is vertex VertexRemap[v]
+	uint32_t MeshletCount;
+	uint32_t VertexCount;
+};
+
+//false if memory runs out or a meshlet addresses a vertex, index or primitive the mesh doesn't have
+bool OptimizeMeshletLocality(const struct Mesh* Mesh, struct MeshletLocalityData* Out);
+
+//points Mesh's rewritten streams at Data; Data must outlive Mesh's use of them
+void MeshletLocalityDataApply(const struct MeshletLocalityData* Data, struct Mesh* Mesh);
+
+void MeshletLocalityDataFree(struct MeshletLocalityData* Data);
+
+//checks Optimized against Source through Data's orders: every meshlet keeps its primitives, cull data and corner
+//vertex bytes, and every index buffer entry points at the same vertex bytes as before. returns the number of
+//meshlets and indices that differ
+uint64_t ValidateMeshletLocality(const struct Mesh* Source, const struct Mesh* Optimized, const struct MeshletLocalityData* Data);
+
+//set associative lru cache the fetch simulation runs through
+struct FetchCacheDesc
+{
+	uint32_t LineSize;//bytes, a power of two
+	uint32_t CacheSize;//bytes
+	uint32_t Ways;
+};
+
+struct MeshletFetchStats
+{
+	uint64_t MeshletCount;
+
+	//distinct cache lines each meshlet's fetches span, summed over meshlets; what a meshlet costs with a cold cache
+	uint64_t VertexLines;
+	uint64_t IndexLines;//meshlet, unique vertex index and primitive lines
+	uint32_t MaxVertexLines;
+
+	//lines that missed the cache with the meshlets fetched in order, as the mesh shader dispatch walks them
+	uint64_t VertexMisses;
+	uint64_t IndexMisses;
+};
+
+//replays the reads the mesh shader makes for each meshlet (the meshlet, its unique vertex indices, its primitives
+//and every attribute stream of its vertices) through the cache. streams are addressed as laid out in the mesh, each
+//in its own address range
+bool SimulateMeshletFetch(const struct Mesh* Mesh, const struct FetchCacheDesc* Cache, struct MeshletFetchStats* Out);
@@ -1,129 +1,331 @@
-//*********************************************************
-//
-// Copyright (c) Microsoft. All rights reserved.
-// This code is licensed under the MIT License (MIT).
-// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
-// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
-// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
-// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
-//
-//*********************************************************
-
-struct Constants
-{
-    float4x4 World;
-    float4x4 WorldView;
-    float4x4 WorldViewProj;
-    uint DrawMeshlets;
-};
-
-struct MeshInfoType
-{
-    uint IndexBytes;
-    uint MeshletOffset;
-};
-
-struct Vertex
-{
-    float3 Position;
-    float3 Normal;
-};
-
-struct VertexOut
-{
-    float4 PositionHS : SV_Position;
-    float3 PositionVS : POSITION0;
-    float3 Normal : NORMAL0;
-    uint MeshletIndex : COLOR0;
-};
-
-struct Meshlet
-{
-    uint VertCount;
-    uint VertOffset;
-    uint PrimCount;
-    uint PrimOffset;
-};
-
-ConstantBuffer<Constants> Globals : register(b0);
-ConstantBuffer<MeshInfoType> MeshInfo : register(b1);
-
-StructuredBuffer<Vertex> Vertices : register(t0);
-StructuredBuffer<Meshlet> Meshlets : register(t1);
-ByteAddressBuffer UniqueVertexIndices : register(t2);
-StructuredBuffer<uint> PrimitiveIndices : register(t3);
-
-
-/////
-// Data Loaders
-
-uint3 UnpackPrimitive(uint primitive)
-{
-    // Unpacks a 10 bits per index triangle from a 32-bit uint.
-    return uint3(primitive & 0x3FF, (primitive >> 10) & 0x3FF, (primitive >> 20) & 0x3FF);
-}
-
-uint3 GetPrimitive(Meshlet m, uint index)
-{
-    return UnpackPrimitive(PrimitiveIndices[m.PrimOffset + index]);
-}
-
-uint GetVertexIndex(Meshlet m, uint localIndex)
-{
-    localIndex = m.VertOffset + localIndex;
-
-    if (MeshInfo.IndexBytes == 4) // 32-bit Vertex Indices
-    {
-        return UniqueVertexIndices.Load(localIndex * 4);
-    }
-    else // 16-bit Vertex Indices
-    {
-        // Byte address must be 4-byte aligned.
-        uint wordOffset = (localIndex & 0x1);
-        uint byteOffset = (localIndex / 2) * 4;
-
-        // Grab the pair of 16-bit indices, shift & mask off proper 16-bits.
-        uint indexPair = UniqueVertexIndices.Load(byteOffset);
-        uint index = (indexPair >> (wordOffset * 16)) & 0xffff;
-
-        return index;
-    }
-}
-
-VertexOut GetVertexAttributes(uint meshletIndex, uint vertexIndex)
-{
-    Vertex v = Vertices[vertexIndex];
-
-    VertexOut vout;
-    vout.PositionVS = mul(float4(v.Position, 1), Globals.WorldView).xyz;
-    vout.PositionHS = mul(float4(v.Position, 1), Globals.WorldViewProj);
-    vout.Normal = mul(float4(v.Normal, 0), Globals.World).xyz;
-    vout.MeshletIndex = meshletIndex;
-
-    return vout;
-}
-
-[NumThreads(128, 1, 1)]
-[OutputTopology("triangle")]
-void main(
-    uint gtid : SV_GroupThreadID,
-    uint gid : SV_GroupID,
-    out indices uint3 tris[126],
-    out vertices VertexOut verts[64]
-)
-{
-    Meshlet m = Meshlets[MeshInfo.MeshletOffset + gid];
-
-    SetMeshOutputCounts(m.VertCount, m.PrimCount);
-
-    if (gtid < m.PrimCount)
-    {
-        tris[gtid] = GetPrimitive(m, gtid);
-    }
-
-    if (gtid < m.VertCount)
-    {
-        uint vertexIndex = GetVertexIndex(m, gtid);
-        verts[gtid] = GetVertexAttributes(gid, vertexIndex);
-    }
-}
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+// Meshlet limits this variant is compiled for, overridden with -D; see the README for the variants the renderer loads.
+#ifndef MESHLET_MAX_VERTICES
+#define MESHLET_MAX_VERTICES 64
+#endif
+
+#ifndef MESHLET_MAX_PRIMITIVES
+#define MESHLET_MAX_PRIMITIVES 126
+#endif
+
+#if MESHLET_MAX_VERTICES > MESHLET_MAX_PRIMITIVES
+#define MESHLET_LARGEST_OUTPUT MESHLET_MAX_VERTICES
+#else
+#define MESHLET_LARGEST_OUTPUT MESHLET_MAX_PRIMITIVES
+#endif
+
+// One thread per output rounded up to whole 32 lane waves. Mesh shader groups stop at 128 threads, so bigger
+// meshlets have each thread write several outputs.
+#if MESHLET_LARGEST_OUTPUT > 128
+#define MESHLET_GROUP_SIZE 128
+#else
+#define MESHLET_GROUP_SIZE ((MESHLET_LARGEST_OUTPUT + 31) / 32 * 32)
+#endif
+
+struct Constants
+{
+    float4x4 World;
+    float4x4 WorldView;
+    float4x4 WorldViewProj;
+    uint DrawMeshlets;
+};
+
+// Matches MeshConstants in MinimalDx12MeshShaders.c.
+struct MeshInfoType
+{
+    float3 PositionOffset;
+    uint IndexBytes; // 0 for indexless meshes, whose meshlet vertices are contiguous in the vertex buffer
+    float3 PositionScale;
+    uint MeshletOffset;
+    uint QuantizedVertices;
+    uint MeshletPositions;
+    uint TriangleFormat;
+    uint InstanceOffset;
+    uint Instanced;
+    uint MeshletCount; // Only read by MeshletAS.hlsl
+    uint CullMeshlets;
+};
+
+// Matches struct InstanceTransform in MeshInstances.h: world = Rows * (x, y, z, 1).
+struct InstanceTransform
+{
+    float4 Rows[3];
+};
+
+#ifdef MESHLET_AMPLIFICATION
+// Compiled with -D MESHLET_AMPLIFICATION the meshlets come from MeshletAS.hlsl, which culled them. Matches its Payload.
+#define MESHLET_AS_GROUP_SIZE 32
+
+struct Payload
+{
+    uint MeshletIndices[MESHLET_AS_GROUP_SIZE];
+    uint InstanceIndex;
+};
+#endif
+
+// Matches enum TriangleFormat in MeshletTriangles.h.
+#define TRIANGLE_FORMAT_PACKED10 0
+#define TRIANGLE_FORMAT_UINT8X3 1
+#define TRIANGLE_FORMAT_UINT8X4 2
+
+struct Vertex
+{
+    float3 Position;
+    float3 Normal;
+};
+
+struct VertexOut
+{
+    float4 PositionHS : SV_Position;
+    float3 PositionVS : POSITION0;
+    float3 Normal : NORMAL0;
+    uint MeshletIndex : COLOR0;
+};
+
+struct Meshlet
+{
+    uint VertCount;
+    uint VertOffset;
+    uint PrimCount;
+    uint PrimOffset;
+};
+
+ConstantBuffer<Constants> Globals : register(b0);
+ConstantBuffer<MeshInfoType> MeshInfo : register(b1);
+
+ByteAddressBuffer Vertices : register(t0);
+StructuredBuffer<Meshlet> Meshlets : register(t1);
+ByteAddressBuffer UniqueVertexIndices : register(t2);
+ByteAddressBuffer PrimitiveIndices : register(t3);
+StructuredBuffer<uint> VisibleMeshlets : register(t4);
+ByteAddressBuffer MeshletPositionHeaders : register(t5);
+ByteAddressBuffer MeshletPositionData : register(t6);
+StructuredBuffer<InstanceTransform> Instances : register(t7);
+StructuredBuffer<uint> VisibleInstances : register(t8);
+
+
+/////
+// Data Loaders
+
+uint3 UnpackPrimitive(uint primitive)
+{
+    // Unpacks a 10 bits per index triangle from a 32-bit uint.
+    return uint3(primitive & 0x3FF, (primitive >> 10) & 0x3FF, (primitive >> 20) & 0x3FF);
+}
+
+uint3 UnpackBytePrimitive(uint primitive)
+{
+    // One byte per index in the low three bytes.
+    return uint3(primitive & 0xFF, (primitive >> 8) & 0xFF, (primitive >> 16) & 0xFF);
+}
+
+uint3 GetPrimitive(Meshlet m, uint index)
+{
+    uint primitive = m.PrimOffset + index;
+
+    if (MeshInfo.TriangleFormat == TRIANGLE_FORMAT_UINT8X4)
+    {
+        return UnpackBytePrimitive(PrimitiveIndices.Load(primitive * 4));
+    }
+    else if (MeshInfo.TriangleFormat == TRIANGLE_FORMAT_UINT8X3)
+    {
+        // Three bytes may straddle two words. Both loads stay inside the stream: the second is the word holding
+        // the last byte, which is the first word again when nothing straddles.
+        uint byteOffset = primitive * 3;
+        uint shift = (byteOffset & 3) * 8;
+        uint first = PrimitiveIndices.Load(byteOffset & ~3);
+        uint last = PrimitiveIndices.Load((byteOffset + 2) & ~3);
+
+        return UnpackBytePrimitive(shift ? (first >> shift) | (last << (32 - shift)) : first);
+    }
+    else
+    {
+        return UnpackPrimitive(PrimitiveIndices.Load(primitive * 4));
+    }
+}
+
+uint GetVertexIndex(Meshlet m, uint localIndex)
+{
+    localIndex = m.VertOffset + localIndex;
+
+    if (MeshInfo.IndexBytes == 0) // No UniqueVertexIndices, the vertex is read straight away
+    {
+        return localIndex;
+    }
+    else if (MeshInfo.IndexBytes == 4) // 32-bit Vertex Indices
+    {
+        return UniqueVertexIndices.Load(localIndex * 4);
+    }
+    else // 16-bit Vertex Indices
+    {
+        // Byte address must be 4-byte aligned.
+        uint wordOffset = (localIndex & 0x1);
+        uint byteOffset = (localIndex / 2) * 4;
+
+        // Grab the pair of 16-bit indices, shift & mask off proper 16-bits.
+        uint indexPair = UniqueVertexIndices.Load(byteOffset);
+        uint index = (indexPair >> (wordOffset * 16)) & 0xffff;
+
+        return index;
+    }
+}
+
+float3 DecodeOctahedral(uint encoded)
+{
+    // Two 16-bit snorms, sign extended out of the low and high halves.
+    float2 f = max(float2(asint(uint2(encoded << 16, encoded)) >> 16) / 32767.0, -1.0);
+    float3 n = float3(f, 1.0 - abs(f.x) - abs(f.y));
+
+    // Unfold the lower hemisphere from the corners of the square.
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+
+    return normalize(n);
+}
+
+Vertex GetVertex(uint vertexIndex)
+{
+    Vertex v;
+
+    if (MeshInfo.QuantizedVertices)
+    {
+        // 12 bytes: 16-bit unorm position steps across the mesh's box, 16 reserved bits, then the octahedral normal.
+        uint3 packed = Vertices.Load3(vertexIndex * 12);
+        float3 steps = float3(packed.x & 0xffff, packed.x >> 16, packed.y & 0xffff);
+
+        v.Position = MeshInfo.PositionOffset + steps * MeshInfo.PositionScale;
+        v.Normal = DecodeOctahedral(packed.z);
+    }
+    else
+    {
+        v.Position = asfloat(Vertices.Load3(vertexIndex * 24));
+        v.Normal = asfloat(Vertices.Load3(vertexIndex * 24 + 12));
+    }
+
+    return v;
+}
+
+uint ReadBits(uint bit, uint count)
+{
+    // The data ends in a spare word, so both loads stay inside it.
+    uint2 words = MeshletPositionData.Load2((bit >> 5) * 4);
+    uint shift = bit & 31;
+    uint value = shift != 0 ? (words.x >> shift) | (words.y << (32 - shift)) : words.x;
+
+    return value & ((1u << count) - 1);
+}
+
+float3 GetMeshletPosition(uint meshletIndex, uint localIndex, uint vertCount)
+{
+    // 20 byte header: the meshlet's base cell, its first data word, then a byte per axis with the plane widths.
+    uint4 header = MeshletPositionHeaders.Load4(meshletIndex * 20);
+    uint widths = MeshletPositionHeaders.Load(meshletIndex * 20 + 16);
+
+    uint plane = header.w * 32;
+    uint3 cell;
+
+    [unroll]
+    for (uint k = 0; k < 3; k++)
+    {
+        uint width = (widths >> (k * 8)) & 0xff;
+        cell[k] = header[k] + ReadBits(plane + localIndex * width, width);
+        plane += vertCount * width;
+    }
+
+    // The cell is a whole number on the mesh's grid, so every meshlet sharing a vertex decodes it identically.
+    return MeshInfo.PositionOffset + float3(cell) * MeshInfo.PositionScale;
+}
+
+VertexOut GetVertexAttributes(uint meshletIndex, uint vertexIndex, uint localIndex, uint vertCount, float3x4 instance)
+{
+    Vertex v;
+
+    if (MeshInfo.MeshletPositions && MeshInfo.QuantizedVertices)
+    {
+        // The vertex stream holds only the octahedral normals, 4 bytes a vertex.
+        v.Position = GetMeshletPosition(meshletIndex, localIndex, vertCount);
+        v.Normal = DecodeOctahedral(Vertices.Load(vertexIndex * 4));
+    }
+    else
+    {
+        v = GetVertex(vertexIndex);
+
+        if (MeshInfo.MeshletPositions)
+        {
+            v.Position = GetMeshletPosition(meshletIndex, localIndex, vertCount);
+        }
+    }
+
+    // Normals go through the cofactor matrix, the inverse transpose times the determinant, so they stay perpendicular
+    // under any scale or shear without a divide. Its rows are cross products of the transform's rows; a mirroring
+    // transform has a negative determinant, which is taken back out. The pixel shader normalizes.
+    float3x3 m = (float3x3)instance;
+    float3x3 cofactor = float3x3(cross(m[1], m[2]), cross(m[2], m[0]), cross(m[0], m[1]));
+
+    v.Position = mul(instance, float4(v.Position, 1));
+    v.Normal = mul(cofactor, v.Normal) * (dot(m[0], cofactor[0]) < 0 ? -1.0 : 1.0);
+
+    VertexOut vout;
+    vout.PositionVS = mul(float4(v.Position, 1), Globals.WorldView).xyz;
+    vout.PositionHS = mul(float4(v.Position, 1), Globals.WorldViewProj);
+    vout.Normal = mul(float4(v.Normal, 0), Globals.World).xyz;
+    vout.MeshletIndex = meshletIndex;
+
+    return vout;
+}
+
+[NumThreads(MESHLET_GROUP_SIZE, 1, 1)]
+[OutputTopology("triangle")]
+void main(
+    uint gtid : SV_GroupThreadID,
+    uint2 gid : SV_GroupID,
+#ifdef MESHLET_AMPLIFICATION
+    in payload Payload payload,
+#endif
+    out indices uint3 tris[MESHLET_MAX_PRIMITIVES],
+    out vertices VertexOut verts[MESHLET_MAX_VERTICES]
+)
+{
+#ifdef MESHLET_AMPLIFICATION
+    uint meshletIndex = payload.MeshletIndices[gid.x];
+    uint instanceIndex = payload.InstanceIndex;
+#else
+    // MeshletOffset points into the cpu culler's compacted list of visible meshlets, InstanceOffset into its list
+    // of visible instances; instanced draws are a grid of meshlets along x times instances along y.
+    uint meshletIndex = VisibleMeshlets[MeshInfo.MeshletOffset + gid.x];
+    uint instanceIndex = MeshInfo.Instanced ? VisibleInstances[MeshInfo.InstanceOffset + gid.y] : 0;
+#endif
+    Meshlet m = Meshlets[meshletIndex];
+
+    float3x4 instance = float3x4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0);
+
+    if (MeshInfo.Instanced)
+    {
+        InstanceTransform t = Instances[instanceIndex];
+        instance = float3x4(t.Rows[0], t.Rows[1], t.Rows[2]);
+    }
+
+    SetMeshOutputCounts(m.VertCount, m.PrimCount);
+
+    for (uint p = gtid; p < m.PrimCount; p += MESHLET_GROUP_SIZE)
+    {
+        tris[p] = GetPrimitive(m, p);
+    }
+
+    for (uint v = gtid; v < m.VertCount; v += MESHLET_GROUP_SIZE)
+    {
+        uint vertexIndex = GetVertexIndex(m, v);
+        verts[v] = GetVertexAttributes(meshletIndex, vertexIndex, v, m.VertCount, instance);
+    }
+}
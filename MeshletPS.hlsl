@@ -1,67 +1,67 @@
-//*********************************************************
-//
-// Copyright (c) Microsoft. All rights reserved.
-// This code is licensed under the MIT License (MIT).
-// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
-// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
-// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
-// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
-//
-//*********************************************************
-
-struct Constants
-{
-    float4x4 World;
-    float4x4 WorldView;
-    float4x4 WorldViewProj;
-    uint DrawMeshlets;
-};
-
-struct VertexOut
-{
-    float4 PositionHS : SV_Position;
-    float3 PositionVS : POSITION0;
-    float3 Normal : NORMAL0;
-    uint MeshletIndex : COLOR0;
-};
-
-ConstantBuffer<Constants> Globals : register(b0);
-
-float4 main(VertexOut input) : SV_TARGET
-{
-    float ambientIntensity = 0.1;
-    float3 lightColor = float3(1, 1, 1);
-    float3 lightDir = -normalize(float3(1, -1, 1));
-
-    float3 diffuseColor;
-    float shininess;
-    if (Globals.DrawMeshlets)
-    {
-        uint meshletIndex = input.MeshletIndex;
-        diffuseColor = float3(
-            float(meshletIndex & 1),
-            float(meshletIndex & 3) / 4,
-            float(meshletIndex & 7) / 8);
-        shininess = 16.0;
-    }
-    else
-    {
-        diffuseColor = 0.8;
-        shininess = 64.0;
-    }
-
-    float3 normal = normalize(input.Normal);
-
-    // Do some fancy Blinn-Phong shading!
-    float cosAngle = saturate(dot(normal, lightDir));
-    float3 viewDir = -normalize(input.PositionVS);
-    float3 halfAngle = normalize(lightDir + viewDir);
-
-    float blinnTerm = saturate(dot(normal, halfAngle));
-    blinnTerm = cosAngle != 0.0 ? blinnTerm : 0.0;
-    blinnTerm = pow(blinnTerm, shininess);
-
-    float3 finalColor = (cosAngle + blinnTerm + ambientIntensity) * diffuseColor;
-
-    return float4(finalColor, 1);
-}
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+struct Constants
+{
+    float4x4 World;
+    float4x4 WorldView;
+    float4x4 WorldViewProj;
+    uint DrawMeshlets;
+};
+
+struct VertexOut
+{
+    float4 PositionHS : SV_Position;
+    float3 PositionVS : POSITION0;
+    float3 Normal : NORMAL0;
+    uint MeshletIndex : COLOR0;
+};
+
+ConstantBuffer<Constants> Globals : register(b0);
+
+float4 main(VertexOut input) : SV_TARGET
+{
+    float ambientIntensity = 0.1;
+    float3 lightColor = float3(1, 1, 1);
+    float3 lightDir = -normalize(float3(1, -1, 1));
+
+    float3 diffuseColor;
+    float shininess;
+    if (Globals.DrawMeshlets)
+    {
+        uint meshletIndex = input.MeshletIndex;
+        diffuseColor = float3(
+            float(meshletIndex & 1),
+            float(meshletIndex & 3) / 4,
+            float(meshletIndex & 7) / 8);
+        shininess = 16.0;
+    }
+    else
+    {
+        diffuseColor = 0.8;
+        shininess = 64.0;
+    }
+
+    float3 normal = normalize(input.Normal);
+
+    // Do some fancy Blinn-Phong shading!
+    float cosAngle = saturate(dot(normal, lightDir));
+    float3 viewDir = -normalize(input.PositionVS);
+    float3 halfAngle = normalize(lightDir + viewDir);
+
+    float blinnTerm = saturate(dot(normal, halfAngle));
+    blinnTerm = cosAngle != 0.0 ? blinnTerm : 0.0;
+    blinnTerm = pow(blinnTerm, shininess);
+
+    float3 finalColor = (cosAngle + blinnTerm + ambientIntensity) * diffuseColor;
+
+    return float4(finalColor, 1);
+}
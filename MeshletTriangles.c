@@ -0,0 +1,290 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <string.h>
+#include <assert.h>
+
+#include "MeshletTriangles.h"
+
+#ifdef PLATFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef PLATFORM_AVX2
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(struct PackedTriangle) == 4, "TRIANGLE_FORMAT_PACKED10 is one uint32 a triangle");
+
+uint64_t TriangleFormatSize(enum TriangleFormat Format, uint32_t Count)
+{
+	return (uint64_t)Count * (Format == TRIANGLE_FORMAT_UINT8X3 ? 3 : 4);
+}
+
+const char* TriangleFormatName(enum TriangleFormat Format)
+{
+	switch (Format)
+	{
+	case TRIANGLE_FORMAT_PACKED10: return "packed10";
+	case TRIANGLE_FORMAT_UINT8X3: return "uint8x3";
+	case TRIANGLE_FORMAT_UINT8X4: return "uint8x4";
+	default: return "unknown";
+	}
+}
+
+bool EncodeTriangles(const struct PackedTriangle* Triangles, uint32_t Count, enum TriangleFormat Format, void* Out)
+{
+	if (Format == TRIANGLE_FORMAT_PACKED10)
+	{
+		memmove(Out, Triangles, sizeof(struct PackedTriangle) * Count);
+		return true;
+	}
+
+	//checked up front so a triangle that doesn't fit leaves Out as it was
+	for (uint32_t t = 0; t < Count; t++)
+	{
+		if (Triangles[t].i0 > UINT8_MAX || Triangles[t].i1 > UINT8_MAX || Triangles[t].i2 > UINT8_MAX)
+			return false;
+	}
+
+	const uint32_t Stride = Format == TRIANGLE_FORMAT_UINT8X3 ? 3 : 4;
+	uint8_t* Bytes = Out;
+
+	for (uint32_t t = 0; t < Count; t++)
+	{
+		const struct PackedTriangle Triangle = Triangles[t];
+		uint8_t* Corners = Bytes + (size_t)t * Stride;
+
+		Corners[0] = (uint8_t)Triangle.i0;
+		Corners[1] = (uint8_t)Triangle.i1;
+		Corners[2] = (uint8_t)Triangle.i2;
+
+		if (Stride == 4)
+			Corners[3] = 0;
+	}
+
+	return true;
+}
+
+void DecodeTriangles(const void* Data, uint32_t Count, enum TriangleFormat Format, struct PackedTriangle* Out)
+{
+	if (Format == TRIANGLE_FORMAT_PACKED10)
+	{
+		memmove(Out, Data, sizeof(struct PackedTriangle) * Count);
+		return;
+	}
+
+	const uint32_t Stride = Format == TRIANGLE_FORMAT_UINT8X3 ? 3 : 4;
+	const uint8_t* Bytes = Data;
+
+	for (uint32_t t = 0; t < Count; t++)
+	{
+		const uint8_t* Corners = Bytes + (size_t)t * Stride;
+
+		struct PackedTriangle Triangle = { 0 };
+		Triangle.i0 = Corners[0];
+		Triangle.i1 = Corners[1];
+		Triangle.i2 = Corners[2];
+		Out[t] = Triangle;
+	}
+}
+
+static void ScalarUnpack(const uint8_t* Data, enum TriangleFormat Format, uint32_t Begin, uint32_t End, uint32_t* Out)
+{
+	for (uint32_t t = Begin; t < End; t++)
+	{
+		if (Format == TRIANGLE_FORMAT_PACKED10)
+		{
+			uint32_t Packed;
+			memcpy(&Packed, Data + (size_t)t * 4, sizeof(Packed));
+
+			Out[t * 3 + 0] = Packed & 0x3FF;
+			Out[t * 3 + 1] = (Packed >> 10) & 0x3FF;
+			Out[t * 3 + 2] = (Packed >> 20) & 0x3FF;
+		}
+		else
+		{
+			const uint8_t* Corners = Data + (size_t)t * (Format == TRIANGLE_FORMAT_UINT8X3 ? 3 : 4);
+
+			Out[t * 3 + 0] = Corners[0];
+			Out[t * 3 + 1] = Corners[1];
+			Out[t * 3 + 2] = Corners[2];
+		}
+	}
+}
+
+#ifdef PLATFORM_SSE2
+//the 4 lane kernels store each triangle as a whole vector at Out + 3t; its fourth lane is the next triangle's first
+//index, written properly by the next store, so they stop a triangle early and leave the last one to the scalar loop
+static void Sse2Unpack(const uint8_t* Data, enum TriangleFormat Format, uint32_t Count, uint32_t* Out)
+{
+	const __m128i Zero = _mm_setzero_si128();
+	uint32_t t = 0;
+
+	switch (Format)
+	{
+	case TRIANGLE_FORMAT_PACKED10:
+	{
+		const __m128i Mask = _mm_set1_epi32(0x3FF);
+
+		for (; t + 5 <= Count; t += 4)
+		{
+			const __m128i Packed = _mm_loadu_si128((const __m128i*)(Data + (size_t)t * 4));
+
+			__m128 I0 = _mm_castsi128_ps(_mm_and_si128(Packed, Mask));
+			__m128 I1 = _mm_castsi128_ps(_mm_and_si128(_mm_srli_epi32(Packed, 10), Mask));
+			__m128 I2 = _mm_castsi128_ps(_mm_and_si128(_mm_srli_epi32(Packed, 20), Mask));
+			__m128 Pad = _mm_setzero_ps();
+			_MM_TRANSPOSE4_PS(I0, I1, I2, Pad);
+
+			_mm_storeu_ps((float*)&Out[t * 3 + 0], I0);
+			_mm_storeu_ps((float*)&Out[t * 3 + 3], I1);
+			_mm_storeu_ps((float*)&Out[t * 3 + 6], I2);
+			_mm_storeu_ps((float*)&Out[t * 3 + 9], Pad);
+		}
+		break;
+	}
+	case TRIANGLE_FORMAT_UINT8X3:
+	{
+		//a flat byte per index, so sixteen indices at a time regardless of where triangles start
+		const uint32_t IndexCount = Count * 3;
+		uint32_t i = 0;
+
+		for (; i + 16 <= IndexCount; i += 16)
+		{
+			const __m128i Bytes = _mm_loadu_si128((const __m128i*)(Data + i));
+			const __m128i Low = _mm_unpacklo_epi8(Bytes, Zero);
+			const __m128i High = _mm_unpackhi_epi8(Bytes, Zero);
+
+			_mm_storeu_si128((__m128i*)&Out[i + 0], _mm_unpacklo_epi16(Low, Zero));
+			_mm_storeu_si128((__m128i*)&Out[i + 4], _mm_unpackhi_epi16(Low, Zero));
+			_mm_storeu_si128((__m128i*)&Out[i + 8], _mm_unpacklo_epi16(High, Zero));
+			_mm_storeu_si128((__m128i*)&Out[i + 12], _mm_unpackhi_epi16(High, Zero));
+		}
+
+		for (; i < IndexCount; i++)
+			Out[i] = Data[i];
+
+		return;
+	}
+	case TRIANGLE_FORMAT_UINT8X4:
+		for (; t + 5 <= Count; t += 4)
+		{
+			const __m128i Bytes = _mm_loadu_si128((const __m128i*)(Data + (size_t)t * 4));
+			const __m128i Low = _mm_unpacklo_epi8(Bytes, Zero);
+			const __m128i High = _mm_unpackhi_epi8(Bytes, Zero);
+
+			_mm_storeu_si128((__m128i*)&Out[t * 3 + 0], _mm_unpacklo_epi16(Low, Zero));
+			_mm_storeu_si128((__m128i*)&Out[t * 3 + 3], _mm_unpackhi_epi16(Low, Zero));
+			_mm_storeu_si128((__m128i*)&Out[t * 3 + 6], _mm_unpacklo_epi16(High, Zero));
+			_mm_storeu_si128((__m128i*)&Out[t * 3 + 9], _mm_unpackhi_epi16(High, Zero));
+		}
+		break;
+	default:
+		break;
+	}
+
+	ScalarUnpack(Data, Format, t, Count, Out);
+}
+#endif
+
+#ifdef PLATFORM_AVX2
+static void Avx2Unpack(const uint8_t* Data, enum TriangleFormat Format, uint32_t Count, uint32_t* Out)
+{
+	uint32_t t = 0;
+
+	switch (Format)
+	{
+	case TRIANGLE_FORMAT_PACKED10:
+	{
+		//eight triangles make 24 indices, three full vectors: each lane picks its triangle and shifts out its corner
+		const __m256i Mask = _mm256_set1_epi32(0x3FF);
+		const __m256i Triangles0 = _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2);
+		const __m256i Triangles1 = _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5);
+		const __m256i Triangles2 = _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7);
+		const __m256i Shifts0 = _mm256_setr_epi32(0, 10, 20, 0, 10, 20, 0, 10);
+		const __m256i Shifts1 = _mm256_setr_epi32(20, 0, 10, 20, 0, 10, 20, 0);
+		const __m256i Shifts2 = _mm256_setr_epi32(10, 20, 0, 10, 20, 0, 10, 20);
+
+		for (; t + 8 <= Count; t += 8)
+		{
+			const __m256i Packed = _mm256_loadu_si256((const __m256i*)(Data + (size_t)t * 4));
+
+			_mm256_storeu_si256((__m256i*)&Out[t * 3 + 0], _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(Packed, Triangles0), Shifts0), Mask));
+			_mm256_storeu_si256((__m256i*)&Out[t * 3 + 8], _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(Packed, Triangles1), Shifts1), Mask));
+			_mm256_storeu_si256((__m256i*)&Out[t * 3 + 16], _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(Packed, Triangles2), Shifts2), Mask));
+		}
+		break;
+	}
+	case TRIANGLE_FORMAT_UINT8X3:
+	{
+		const uint32_t IndexCount = Count * 3;
+		uint32_t i = 0;
+
+		for (; i + 16 <= IndexCount; i += 16)
+		{
+			const __m128i Bytes = _mm_loadu_si128((const __m128i*)(Data + i));
+
+			_mm256_storeu_si256((__m256i*)&Out[i + 0], _mm256_cvtepu8_epi32(Bytes));
+			_mm256_storeu_si256((__m256i*)&Out[i + 8], _mm256_cvtepu8_epi32(_mm_srli_si128(Bytes, 8)));
+		}
+
+		for (; i < IndexCount; i++)
+			Out[i] = Data[i];
+
+		return;
+	}
+	case TRIANGLE_FORMAT_UINT8X4:
+	{
+		//drops every fourth byte while widening, so four triangles fill twelve lanes with no overlapping stores
+		const __m128i CompactLow = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+		for (; t + 4 <= Count; t += 4)
+		{
+			const __m128i Bytes = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(Data + (size_t)t * 4)), CompactLow);
+
+			_mm256_storeu_si256((__m256i*)&Out[t * 3], _mm256_cvtepu8_epi32(Bytes));
+			_mm_storeu_si128((__m128i*)&Out[t * 3 + 8], _mm_cvtepu8_epi32(_mm_srli_si128(Bytes, 8)));
+		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	ScalarUnpack(Data, Format, t, Count, Out);
+}
+#endif
+
+void UnpackTriangles(const void* Data, uint32_t Count, enum TriangleFormat Format, enum SimdLevel Kernel, uint32_t* Out)
+{
+	switch (Kernel)
+	{
+#ifdef PLATFORM_AVX2
+	case SIMD_LEVEL_AVX2:
+		Avx2Unpack(Data, Format, Count, Out);
+		break;
+#endif
+#ifdef PLATFORM_SSE2
+	case SIMD_LEVEL_SSE2:
+		Sse2Unpack(Data, Format, Count, Out);
+		break;
+#endif
+	default:
+		ScalarUnpack(Data, Format, 0, Count, Out);
+		break;
+	}
+}
@@ -0,0 +1,52 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Platform.h"
+#include "MeshFile.h"
+
+//alternative encodings of a meshlet's primitive stream. local vertex indices stay under the meshlet vertex limit,
+//at most MESHLET_MAX_VERTICES_LIMIT, so a byte per corner holds them: UINT8X3 is three bytes a triangle back to
+//back, a quarter smaller than PackedTriangle, and UINT8X4 pads each to four so a triangle is one aligned load with
+//no masking. Meshlet.PrimOffset still counts triangles, whatever their size.
+//the values are what MeshletMS.hlsl's TRIANGLE_FORMAT_ defines expect
+
+enum TriangleFormat
+{
+	TRIANGLE_FORMAT_PACKED10,//struct PackedTriangle
+	TRIANGLE_FORMAT_UINT8X3,
+	TRIANGLE_FORMAT_UINT8X4,//the fourth byte is 0
+	TRIANGLE_FORMAT_COUNT
+};
+
+//bytes Count triangles take
+uint64_t TriangleFormatSize(enum TriangleFormat Format, uint32_t Count);
+
+const char* TriangleFormatName(enum TriangleFormat Format);
+
+//converts from PackedTriangle. false, with nothing written, if an index doesn't fit the format
+bool EncodeTriangles(const struct PackedTriangle* Triangles, uint32_t Count, enum TriangleFormat Format, void* Out);
+
+//converts back to PackedTriangle
+void DecodeTriangles(const void* Data, uint32_t Count, enum TriangleFormat Format, struct PackedTriangle* Out);
+
+//expands Count triangles to three uint32 indices each. every kernel gives the same output as the scalar one and
+//reads nothing past the TriangleFormatSize bytes of Data
+void UnpackTriangles(const void* Data, uint32_t Count, enum TriangleFormat Format, enum SimdLevel Kernel, uint32_t* Out);
@@ -0,0 +1,239 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#endif
+
+#include <stdlib.h>
+
+#include "Platform.h"
+
+bool PlatformSimdSupported(enum SimdLevel Level)
+{
+	switch (Level)
+	{
+	case SIMD_LEVEL_SCALAR:
+		return true;
+#ifdef PLATFORM_SSE2
+	case SIMD_LEVEL_SSE2:
+		return true;
+#endif
+#ifdef PLATFORM_AVX2
+	case SIMD_LEVEL_AVX2:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+enum SimdLevel PlatformSimdBest(void)
+{
+#if defined(PLATFORM_AVX2)
+	return SIMD_LEVEL_AVX2;
+#elif defined(PLATFORM_SSE2)
+	return SIMD_LEVEL_SSE2;
+#else
+	return SIMD_LEVEL_SCALAR;
+#endif
+}
+
+const char* PlatformSimdName(enum SimdLevel Level)
+{
+	switch (Level)
+	{
+	case SIMD_LEVEL_SCALAR: return "scalar";
+	case SIMD_LEVEL_SSE2: return "sse2";
+	case SIMD_LEVEL_AVX2: return "avx2";
+	default: return "unknown";
+	}
+}
+
+double PlatformGetTime(void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER Frequency = { 0 };
+
+	if (Frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&Frequency);
+
+	LARGE_INTEGER Counter;
+	QueryPerformanceCounter(&Counter);
+
+	return (double)Counter.QuadPart / (double)Frequency.QuadPart;
+#else
+	struct timespec Now;
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (double)Now.tv_sec + (double)Now.tv_nsec * 1e-9;
+#endif
+}
+
+bool PlatformDropFileCache(const char* Path)
+{
+#ifdef _WIN32
+	(void)Path;
+	return false;
+#else
+	int File = open(Path, O_RDONLY);
+	if (File < 0)
+		return false;
+
+	//dirty pages aren't dropped, so flush first
+	fdatasync(File);
+	bool bDropped = posix_fadvise(File, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(File);
+	return bDropped;
+#endif
+}
+
+uint32_t PlatformGetProcessorCount(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO SystemInfo;
+	GetSystemInfo(&SystemInfo);
+
+	return SystemInfo.dwNumberOfProcessors;
+#else
+	long Count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return Count > 0 ? (uint32_t)Count : 1;
+#endif
+}
+
+uint32_t PlatformAtomicIncrement(volatile uint32_t* Value)
+{
+#ifdef _WIN32
+	return (uint32_t)InterlockedIncrement((volatile LONG*)Value);
+#else
+	return __atomic_add_fetch(Value, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+uint32_t PlatformAtomicLoadAcquire(const volatile uint32_t* Value)
+{
+#ifdef _WIN32
+	return (uint32_t)InterlockedCompareExchange((volatile LONG*)Value, 0, 0);
+#else
+	return __atomic_load_n(Value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void PlatformAtomicStoreRelease(volatile uint32_t* Value, uint32_t NewValue)
+{
+#ifdef _WIN32
+	InterlockedExchange((volatile LONG*)Value, (LONG)NewValue);
+#else
+	__atomic_store_n(Value, NewValue, __ATOMIC_RELEASE);
+#endif
+}
+
+struct ParallelForContext
+{
+	void (*Task)(void* Context, uint32_t TaskIndex);
+	void* Context;
+	uint32_t TaskCount;
+	volatile uint32_t NextTask;
+};
+
+static void RunParallelTasks(struct ParallelForContext* ParallelFor)
+{
+	for (;;)
+	{
+		const uint32_t TaskIndex = PlatformAtomicIncrement(&ParallelFor->NextTask) - 1;
+
+		if (TaskIndex >= ParallelFor->TaskCount)
+			break;
+
+		ParallelFor->Task(ParallelFor->Context, TaskIndex);
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI ParallelForWorker(LPVOID Parameter)
+{
+	RunParallelTasks(Parameter);
+	return 0;
+}
+#else
+static void* ParallelForWorker(void* Parameter)
+{
+	RunParallelTasks(Parameter);
+	return NULL;
+}
+#endif
+
+void PlatformParallelFor(uint32_t TaskCount, uint32_t ThreadCount, void (*Task)(void* Context, uint32_t TaskIndex), void* Context)
+{
+	if (ThreadCount == 0)
+		ThreadCount = PlatformGetProcessorCount();
+
+	if (ThreadCount > TaskCount)
+		ThreadCount = TaskCount;
+
+	struct ParallelForContext ParallelFor = { 0 };
+	ParallelFor.Task = Task;
+	ParallelFor.Context = Context;
+	ParallelFor.TaskCount = TaskCount;
+	ParallelFor.NextTask = 0;
+
+	//the calling thread is worker 0; if a thread can't be created the remaining workers just pick up its share
+	uint32_t WorkerCount = ThreadCount > 1 ? ThreadCount - 1 : 0;
+
+#ifdef _WIN32
+	HANDLE* Workers = WorkerCount ? malloc(sizeof(HANDLE) * WorkerCount) : NULL;
+#else
+	pthread_t* Workers = WorkerCount ? malloc(sizeof(pthread_t) * WorkerCount) : NULL;
+#endif
+
+	if (Workers == NULL)
+		WorkerCount = 0;
+
+	uint32_t StartedCount = 0;
+
+	for (uint32_t i = 0; i < WorkerCount; i++)
+	{
+#ifdef _WIN32
+		Workers[StartedCount] = CreateThread(NULL, 0, ParallelForWorker, &ParallelFor, 0, NULL);
+		if (Workers[StartedCount] != NULL)
+			StartedCount++;
+#else
+		if (pthread_create(&Workers[StartedCount], NULL, ParallelForWorker, &ParallelFor) == 0)
+			StartedCount++;
+#endif
+	}
+
+	RunParallelTasks(&ParallelFor);
+
+	for (uint32_t i = 0; i < StartedCount; i++)
+	{
+#ifdef _WIN32
+		WaitForSingleObject(Workers[i], INFINITE);
+		CloseHandle(Workers[i]);
+#else
+		pthread_join(Workers[i], NULL);
+#endif
+	}
+
+	free(Workers);
+}
@@ -0,0 +1,67 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+//the handful of os services the headless modules need, so they build on windows and linux alike
+
+//simd paths are picked at compile time (/arch:AVX2 or -mavx2); sse2 is always there on x64
+#if defined(__AVX2__)
+#define PLATFORM_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PLATFORM_SSE2 1
+#endif
+
+//kernel selector shared by the simd modules; scalar is always available and is the reference the others are checked against
+enum SimdLevel
+{
+	SIMD_LEVEL_SCALAR,
+	SIMD_LEVEL_SSE2,
+	SIMD_LEVEL_AVX2,
+	SIMD_LEVEL_COUNT
+};
+
+bool PlatformSimdSupported(enum SimdLevel Level);
+enum SimdLevel PlatformSimdBest(void);
+const char* PlatformSimdName(enum SimdLevel Level);
+
+//seconds since an arbitrary fixed point
+double PlatformGetTime(void);
+
+
+//asks the os to evict Path from the page cache so the next read comes from disk. returns false where
+//that isn't possible without extra privileges (windows) or the file can't be opened
+bool PlatformDropFileCache(const char* Path);
+
+//number of logical processors available to this process
+uint32_t PlatformGetProcessorCount(void);
+
+//returns the incremented value
+uint32_t PlatformAtomicIncrement(volatile uint32_t* Value);
+
+//a load nothing after it can move above, and a store nothing before it can move below: enough to hand data from
+//one thread to another through an index
+uint32_t PlatformAtomicLoadAcquire(const volatile uint32_t* Value);
+void PlatformAtomicStoreRelease(volatile uint32_t* Value, uint32_t NewValue);
+
+//runs Task(Context, 0..TaskCount-1) across ThreadCount workers (0 = one per processor) and returns once all are done.
+//tasks are handed out in order from a shared counter, so uneven tasks still balance
+void PlatformParallelFor(uint32_t TaskCount, uint32_t ThreadCount, void (*Task)(void* Context, uint32_t TaskIndex), void* Context);
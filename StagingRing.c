@@ -0,0 +1,104 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "StagingRing.h"
+
+bool StagingRingInit(struct StagingRing* Ring, uint64_t Capacity, uint32_t MaxBatches)
+{
+	memset(Ring, 0, sizeof(*Ring));
+
+	Ring->Batches = malloc(sizeof(struct StagingRingBatch) * (MaxBatches ? MaxBatches : 1));
+	if (!Ring->Batches)
+		return false;
+
+	Ring->Capacity = Capacity;
+	Ring->BatchCapacity = MaxBatches ? MaxBatches : 1;
+	return true;
+}
+
+void StagingRingFree(struct StagingRing* Ring)
+{
+	free(Ring->Batches);
+	memset(Ring, 0, sizeof(*Ring));
+}
+
+bool StagingRingAlloc(struct StagingRing* Ring, uint64_t Size, uint64_t Alignment, uint64_t* OutOffset)
+{
+	if (Size > Ring->Capacity || Ring->Capacity == 0)
+		return false;
+
+	const uint64_t Offset = Ring->Head % Ring->Capacity;
+	uint64_t Aligned = (Offset + Alignment - 1) & ~(Alignment - 1);
+
+	//an allocation never straddles the end; what's left there is skipped and comes back with the batch
+	uint64_t Start = Ring->Head + (Aligned - Offset);
+	if (Aligned + Size > Ring->Capacity)
+	{
+		Start = Ring->Head + (Ring->Capacity - Offset);
+		Aligned = 0;
+	}
+
+	if (Start + Size - Ring->Tail > Ring->Capacity)
+		return false;
+
+	Ring->Head = Start + Size;
+	*OutOffset = Aligned;
+	return true;
+}
+
+bool StagingRingSubmit(struct StagingRing* Ring, uint64_t FenceValue)
+{
+	if (Ring->Head == Ring->Submitted)
+		return true;
+
+	if (Ring->BatchCount == Ring->BatchCapacity)
+		return false;
+
+	struct StagingRingBatch* Batch = &Ring->Batches[(Ring->FirstBatch + Ring->BatchCount) % Ring->BatchCapacity];
+	Batch->FenceValue = FenceValue;
+	Batch->End = Ring->Head;
+
+	Ring->BatchCount++;
+	Ring->Submitted = Ring->Head;
+	return true;
+}
+
+void StagingRingRetire(struct StagingRing* Ring, uint64_t CompletedValue)
+{
+	while (Ring->BatchCount != 0 && Ring->Batches[Ring->FirstBatch].FenceValue <= CompletedValue)
+	{
+		Ring->Tail = Ring->Batches[Ring->FirstBatch].End;
+		Ring->FirstBatch = (Ring->FirstBatch + 1) % Ring->BatchCapacity;
+		Ring->BatchCount--;
+	}
+
+	//an idle ring starts over at offset 0, so the next allocations don't wrap for nothing
+	if (Ring->BatchCount == 0 && Ring->Head == Ring->Submitted)
+		Ring->Head = Ring->Tail = Ring->Submitted = (Ring->Head + Ring->Capacity - 1) / Ring->Capacity * Ring->Capacity;
+}
+
+uint64_t StagingRingOldestFence(const struct StagingRing* Ring)
+{
+	return Ring->BatchCount ? Ring->Batches[Ring->FirstBatch].FenceValue : 0;
+}
+
+uint64_t StagingRingPending(const struct StagingRing* Ring)
+{
+	return Ring->Head - Ring->Submitted;
+}
@@ -0,0 +1,69 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//linear sub-allocator over one persistently mapped staging buffer of Capacity bytes, used as a ring. allocations
+//are handed out front to back and wrap to offset 0 when the rest of the buffer can't hold them; nothing is freed
+//one by one. instead every allocation made since the last StagingRingSubmit belongs to the fence value passed to
+//it, and StagingRingRetire gives back all batches whose fence has completed, oldest first.
+//
+//positions are 64 bit byte counts that only grow; the offset in the buffer is the position modulo Capacity. the
+//ring knows nothing about the gpu, so it runs the same against a d3d12 fence or a simulated one
+
+struct StagingRingBatch
+{
+	uint64_t FenceValue;
+	uint64_t End;//position just past the batch's last allocation
+};
+
+struct StagingRing
+{
+	uint64_t Capacity;
+	uint64_t Head;//position of the next allocation
+	uint64_t Tail;//position of the oldest byte still in use
+	uint64_t Submitted;//Head at the last StagingRingSubmit
+
+	struct StagingRingBatch* Batches;//in flight, oldest at FirstBatch
+	uint32_t BatchCapacity;
+	uint32_t FirstBatch;
+	uint32_t BatchCount;
+};
+
+//MaxBatches is how many submits may be in flight at once. false if memory runs out
+bool StagingRingInit(struct StagingRing* Ring, uint64_t Capacity, uint32_t MaxBatches);
+
+void StagingRingFree(struct StagingRing* Ring);
+
+//Alignment is a power of two. writes the buffer offset of Size free bytes; false if they don't fit until older
+//batches retire, or never will (Size > Capacity)
+bool StagingRingAlloc(struct StagingRing* Ring, uint64_t Size, uint64_t Alignment, uint64_t* OutOffset);
+
+//closes the open batch: everything allocated since the last submit is in use until FenceValue completes. fence
+//values must increase. false if MaxBatches are already in flight; an empty batch is not recorded
+bool StagingRingSubmit(struct StagingRing* Ring, uint64_t FenceValue);
+
+//gives back every batch whose fence value is at most CompletedValue
+void StagingRingRetire(struct StagingRing* Ring, uint64_t CompletedValue);
+
+//fence value of the oldest batch in flight, 0 if there is none. waiting on it is the least that frees space
+uint64_t StagingRingOldestFence(const struct StagingRing* Ring);
+
+//bytes allocated since the last submit
+uint64_t StagingRingPending(const struct StagingRing* Ring);
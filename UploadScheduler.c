@@ -0,0 +1,184 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "UploadScheduler.h"
+
+//ring allocations start here, which keeps copies off shared cache lines and suits every copy source
+#define UPLOAD_RING_ALIGNMENT 256
+
+bool UploadSchedulerInit(struct UploadScheduler* Scheduler, const struct UploadQueue* Queue, void* RingMemory, uint64_t RingSize, uint32_t MaxBatches, uint64_t ChunkSize)
+{
+	memset(Scheduler, 0, sizeof(*Scheduler));
+
+	if (!StagingRingInit(&Scheduler->Ring, RingSize, MaxBatches))
+		return false;
+
+	Scheduler->Queue = *Queue;
+	Scheduler->RingMemory = RingMemory;
+	Scheduler->ChunkSize = ChunkSize ? ChunkSize : RingSize / 4;
+
+	if (Scheduler->ChunkSize == 0 || Scheduler->ChunkSize > RingSize)
+		Scheduler->ChunkSize = RingSize;
+
+	return true;
+}
+
+void UploadSchedulerFree(struct UploadScheduler* Scheduler)
+{
+	StagingRingFree(&Scheduler->Ring);
+	free(Scheduler->Items);
+	memset(Scheduler, 0, sizeof(*Scheduler));
+}
+
+uint32_t UploadSchedulerAdd(struct UploadScheduler* Scheduler, const void* Source, uint64_t Size, uint32_t Heap, uint64_t Offset)
+{
+	if (Scheduler->ItemCount == Scheduler->ItemCapacity)
+	{
+		const uint32_t NewCapacity = Scheduler->ItemCapacity ? Scheduler->ItemCapacity * 2 : 64;
+		struct UploadItem* NewItems = realloc(Scheduler->Items, sizeof(struct UploadItem) * NewCapacity);
+
+		if (!NewItems)
+			return UINT32_MAX;
+
+		Scheduler->Items = NewItems;
+		Scheduler->ItemCapacity = NewCapacity;
+	}
+
+	struct UploadItem* Item = &Scheduler->Items[Scheduler->ItemCount];
+	memset(Item, 0, sizeof(*Item));
+	Item->Source = Source;
+	Item->Size = Size;
+	Item->Heap = Heap;
+	Item->Offset = Offset;
+	Item->State = UPLOAD_STATE_QUEUED;
+
+	return Scheduler->ItemCount++;
+}
+
+bool UploadSchedulerIsResident(const struct UploadScheduler* Scheduler, uint32_t Item)
+{
+	return Scheduler->Items[Item].State == UPLOAD_STATE_RESIDENT;
+}
+
+bool UploadSchedulerDone(const struct UploadScheduler* Scheduler)
+{
+	return Scheduler->FirstPending == Scheduler->ItemCount;
+}
+
+static uint32_t Retire(struct UploadScheduler* Scheduler, uint64_t CompletedValue)
+{
+	StagingRingRetire(&Scheduler->Ring, CompletedValue);
+
+	uint32_t Count = 0;
+
+	while (Scheduler->FirstPending < Scheduler->NextItem && Scheduler->Items[Scheduler->FirstPending].FenceValue <= CompletedValue)
+	{
+		struct UploadItem* Item = &Scheduler->Items[Scheduler->FirstPending++];
+		Item->State = UPLOAD_STATE_RESIDENT;
+
+		if (Item->FenceValue > Scheduler->ResidentFenceValue)
+			Scheduler->ResidentFenceValue = Item->FenceValue;
+
+		Count++;
+	}
+
+	return Count;
+}
+
+//records up to Budget bytes, stopping early when the ring is full. true if anything needs submitting
+static bool Record(struct UploadScheduler* Scheduler, uint64_t Budget)
+{
+	//every submit is a ring batch; with none to spare the copies would have nothing to hold their space
+	if (Scheduler->Ring.BatchCount == Scheduler->Ring.BatchCapacity)
+		return false;
+
+	const uint64_t FenceValue = Scheduler->FenceValue + 1;
+	bool bRecorded = false;
+
+	while (Scheduler->NextItem < Scheduler->ItemCount)
+	{
+		struct UploadItem* Item = &Scheduler->Items[Scheduler->NextItem];
+
+		if (Item->Recorded < Item->Size)
+		{
+			uint64_t Size = Item->Size - Item->Recorded;
+			Size = Size < Scheduler->ChunkSize ? Size : Scheduler->ChunkSize;
+			Size = Size < Budget ? Size : Budget;
+
+			uint64_t RingOffset;
+			if (Size == 0 || !StagingRingAlloc(&Scheduler->Ring, Size, UPLOAD_RING_ALIGNMENT, &RingOffset))
+				break;
+
+			memcpy(Scheduler->RingMemory + RingOffset, (const uint8_t*)Item->Source + Item->Recorded, Size);
+			Scheduler->Queue.Copy(Scheduler->Queue.Context, Item->Heap, Item->Offset + Item->Recorded, RingOffset, Size);
+
+			Item->Recorded += Size;
+			Item->State = UPLOAD_STATE_COPYING;
+			Budget -= Size;
+		}
+
+		bRecorded = true;
+
+		if (Item->Recorded < Item->Size)
+			break;
+
+		//empty items ride along with the next submit
+		Item->State = UPLOAD_STATE_SUBMITTED;
+		Item->FenceValue = FenceValue;
+		Scheduler->NextItem++;
+	}
+
+	return bRecorded;
+}
+
+static void Submit(struct UploadScheduler* Scheduler)
+{
+	Scheduler->FenceValue++;
+	Scheduler->Queue.Submit(Scheduler->Queue.Context, Scheduler->FenceValue);
+	StagingRingSubmit(&Scheduler->Ring, Scheduler->FenceValue);
+}
+
+uint32_t UploadSchedulerUpdate(struct UploadScheduler* Scheduler, uint64_t Budget)
+{
+	const uint32_t Count = Retire(Scheduler, Scheduler->Queue.CompletedValue(Scheduler->Queue.Context));
+
+	if (Record(Scheduler, Budget))
+		Submit(Scheduler);
+
+	return Count;
+}
+
+void UploadSchedulerFlush(struct UploadScheduler* Scheduler)
+{
+	while (!UploadSchedulerDone(Scheduler))
+	{
+		if (Record(Scheduler, UINT64_MAX))
+			Submit(Scheduler);
+		else if (Scheduler->Ring.BatchCount != 0)
+		{
+			//the ring is full: wait for the oldest copies to free their part of it
+			const uint64_t OldestFence = StagingRingOldestFence(&Scheduler->Ring);
+			Scheduler->Queue.Wait(Scheduler->Queue.Context, OldestFence);
+		}
+		else
+			Scheduler->Queue.Wait(Scheduler->Queue.Context, Scheduler->FenceValue);
+
+		Retire(Scheduler, Scheduler->Queue.CompletedValue(Scheduler->Queue.Context));
+	}
+}
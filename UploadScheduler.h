@@ -0,0 +1,108 @@
+/*
+* (C) 2025 badasahog. All Rights Reserved
+*
+* The above copyright notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "StagingRing.h"
+
+//streams buffers to the gpu a frame at a time through a staging ring, on a queue of their own. every frame
+//UploadSchedulerUpdate retires the copies the queue has finished, then copies up to a byte budget of what's left
+//into the ring, records ring to destination copies and submits them under the next fence value. it never waits:
+//when the ring is full the rest goes next frame, so how long a frame takes doesn't grow with what is queued.
+//
+//an item is QUEUED until its first bytes are recorded, COPYING while big ones are split across frames, SUBMITTED
+//once its last bytes are, and RESIDENT when that submit's fence has completed. items are taken in the order they
+//were added and, since fences complete in order, become resident in that order too.
+//
+//the queue is a set of callbacks, so the same scheduler drives a d3d12 copy queue or a simulated one
+
+enum UploadState
+{
+	UPLOAD_STATE_QUEUED,
+	UPLOAD_STATE_COPYING,
+	UPLOAD_STATE_SUBMITTED,
+	UPLOAD_STATE_RESIDENT,
+};
+
+struct UploadItem
+{
+	const void* Source;//read until the item is SUBMITTED
+	uint64_t Size;
+	uint32_t Heap;//destination
+	uint64_t Offset;
+
+	enum UploadState State;
+	uint64_t Recorded;//bytes already in the ring
+	uint64_t FenceValue;//the submit that carried its last bytes
+};
+
+struct UploadQueue
+{
+	void* Context;
+
+	//records a copy of Size bytes from RingOffset in the staging ring to Offset in Heap
+	void (*Copy)(void* Context, uint32_t Heap, uint64_t Offset, uint64_t RingOffset, uint64_t Size);
+
+	//sends what was recorded since the last submit, then signals FenceValue. may be called with nothing recorded
+	void (*Submit)(void* Context, uint64_t FenceValue);
+
+	uint64_t (*CompletedValue)(void* Context);
+
+	//blocks until FenceValue has completed; only UploadSchedulerFlush waits
+	void (*Wait)(void* Context, uint64_t FenceValue);
+};
+
+struct UploadScheduler
+{
+	struct UploadQueue Queue;
+	struct StagingRing Ring;
+	uint8_t* RingMemory;
+	uint64_t ChunkSize;//most bytes one ring allocation takes
+
+	struct UploadItem* Items;
+	uint32_t ItemCount;
+	uint32_t ItemCapacity;
+	uint32_t NextItem;//first item not fully recorded
+	uint32_t FirstPending;//first item not resident
+
+	uint64_t FenceValue;//last one submitted
+	uint64_t ResidentFenceValue;//every item submitted under this value or lower is resident
+};
+
+//RingMemory is RingSize bytes the queue's copies read from. MaxBatches is how many submits may be in flight at once.
+//ChunkSize 0 = a quarter of the ring. false if memory runs out
+bool UploadSchedulerInit(struct UploadScheduler* Scheduler, const struct UploadQueue* Queue, void* RingMemory, uint64_t RingSize, uint32_t MaxBatches, uint64_t ChunkSize);
+
+void UploadSchedulerFree(struct UploadScheduler* Scheduler);
+
+//queues Size bytes of Source for Offset in Heap and returns the item's index, UINT32_MAX if memory runs out.
+//Source must stay valid until the item is SUBMITTED
+uint32_t UploadSchedulerAdd(struct UploadScheduler* Scheduler, const void* Source, uint64_t Size, uint32_t Heap, uint64_t Offset);
+
+//one frame's work: retires finished copies, then records and submits up to Budget bytes of new ones. returns how
+//many items became resident
+uint32_t UploadSchedulerUpdate(struct UploadScheduler* Scheduler, uint64_t Budget);
+
+bool UploadSchedulerIsResident(const struct UploadScheduler* Scheduler, uint32_t Item);
+
+//every item is resident
+bool UploadSchedulerDone(const struct UploadScheduler* Scheduler);
+
+//uploads everything left without a budget and waits for it, then marks it resident
+void UploadSchedulerFlush(struct UploadScheduler* Scheduler);